@@ -51,39 +51,17 @@ namespace analysis{
             logging::exit();
         }
 
-        mpi::Communicator& comm = getInputCommunicator();
-        int width = getSource().getWidth();
-        int height = getSource().getHeight();
-        double widthUm = getSource().getWidthUm();
-        double heightUm = getSource().getHeightUm();
-        buffer = new data::ContiguousMatrix(comm, width, height, widthUm, heightUm, 0.0);
-
         double dt = Application::getInstance().getMethod().getIntegrationTime();
         acquisition_ts = (unsigned long long)std::round(getAcquisitionStep() / dt);
     }
 
-    void PrimaryVsdAnalyzer::finalizeProcessor(bool destruct) noexcept {
-        delete buffer;
-        buffer = nullptr;
-    }
+    void PrimaryVsdAnalyzer::finalizeProcessor(bool destruct) noexcept {}
 
     void PrimaryVsdAnalyzer::update(double time) {
-        auto it_source = getSource().begin();
-        auto buf_source = buffer->begin();
-        for (; buf_source != buffer->end(); ++buf_source, ++it_source){
-            *buf_source = *it_source;
-        }
-
-        buffer->synchronize();
-
-        for (auto it = output->begin(); it != output->end(); ++it){
-            int i = it.getRow();
-            int j = it.getColumn();
-            int I = (buffer->getHeight() - output->getHeight())/2 + i;
-            int J = (buffer->getWidth() - output->getWidth())/2 + j;
-            data::ContiguousMatrix::ConstantIterator src(*buffer, I, J);
-            *it = *src;
-        }
+        /* Only the processes owning the pixels of the imaging area send them, and only to the processes
+         * responsible for these pixels in the output matrix */
+        auto imagingArea = data::MatrixView::centered(getSource(), output->getHeight(), output->getWidth());
+        imagingArea.copyTo(*output);
     }
 
     int PrimaryVsdAnalyzer::getMatrixWidth() {
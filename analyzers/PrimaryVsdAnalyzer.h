@@ -7,7 +7,7 @@
 
 #include "PrimaryAnalyzer.h"
 #include "VsdAnalyzer.h"
-#include "../data/ContiguousMatrix.h"
+#include "../data/MatrixView.h"
 
 namespace analysis {
 
@@ -22,8 +22,6 @@ namespace analysis {
         double acquisition_step;
         unsigned long long acquisition_ts;
 
-        data::ContiguousMatrix* buffer = nullptr;
-
     protected:
         [[nodiscard]] std::string getProcessorName() override { return "analysis::PrimaryVsdAnalyzer"; };
         void loadAnalysisParameters(const param::Object& source) override;
@@ -124,4 +124,60 @@
  */
 #define AUTO_INITIALIZATION 1
 
+/********************************************************************************************************************/
+
+/**
+ * Alignment of the matrix buffers in bytes (see data::MatrixAllocator). Shall be a power of two not less than the
+ * widest SIMD register (64 bytes for AVX-512)
+ */
+#define MATRIX_ALIGNMENT 64
+
+/**
+ * When 1, the matrix buffers of MATRIX_HUGE_PAGE_SIZE bytes or more will be advised to be backed by transparent
+ * huge pages. When 0, the ordinary pages will be used
+ */
+#define MATRIX_HUGE_PAGES 1
+
+/**
+ * Size of the huge page in bytes
+ */
+#define MATRIX_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * Default maximum number of bytes kept in the pool of released matrix buffers by each process (see
+ * data::MatrixAllocator::setPoolLimit). All processes of the node keep up to this value times the number of processes
+ * per node idle
+ */
+#define MATRIX_POOL_LIMIT (64ULL * 1024 * 1024)
+
+/**
+ * Number of bits of the element found at each step of the distributed selection (see Matrix::orderStatistic).
+ * Each step sends 2^MATRIX_SELECTION_BITS integers, 64 / MATRIX_SELECTION_BITS steps are required
+ */
+#define MATRIX_SELECTION_BITS 8
+
+/**
+ * Block size of the two-dimensional block-cyclic distribution used by data::LuDecomposer. The trailing matrix update
+ * is performed by the matrix multiplication of the blockSize-wide panels, the larger blocks make this update faster
+ * while the smaller blocks give better load balance
+ */
+#define LU_BLOCK_SIZE 64
+
+/**
+ * Maximum number of the iterative refinement steps made by data::LuDecomposer in the mixed precision mode
+ */
+#define LU_REFINEMENT_ITERATIONS 30
+
+/**
+ * The iterative refinement is treated as stalled when the residual decreases less than LU_REFINEMENT_RATIO times
+ * per step. Then data::LuDecomposer falls back to the double precision factorization
+ */
+#define LU_REFINEMENT_RATIO 2.0
+
+/**
+ * Default number of iterations between the restarts of data::solvers::Gmres. Each process stores
+ * SOLVER_GMRES_RESTART + 1 basis vectors of its responsibility area
+ */
+#define SOLVER_GMRES_RESTART 30
+
 #endif //MPI2_COMPILE_OPTIONS_H
@@ -0,0 +1,47 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "BlockCyclicDistribution.h"
+#include "BlockDecomposition.h"
+
+namespace data {
+
+    BlockCyclicDistribution::BlockCyclicDistribution(mpi::Communicator &comm, int m, int n, int nb, int gr):
+        communicator(comm), rowCommunicator(MPI_COMM_NULL), columnCommunicator(MPI_COMM_NULL),
+        rows(m), columns(n), blockSize(nb){
+
+        int nprocs = communicator.getProcessorNumber();
+        if (gr > 0 && nprocs % gr == 0){
+            gridRows = gr;
+            gridColumns = nprocs / gr;
+        } else {
+            int dims[2];
+            BlockDecomposition::getOptimalGrid(nprocs, dims);
+            gridRows = dims[0];
+            gridColumns = dims[1];
+        }
+        int rank = communicator.getRank();
+        gridRow = rank / gridColumns;
+        gridColumn = rank % gridColumns;
+        rowCommunicator = communicator.split(gridRow, gridColumn);
+        columnCommunicator = communicator.split(gridColumn, gridRow);
+
+        localRows = getLocalRowsBefore(rows);
+        localColumns = getLocalColumnsBefore(columns);
+    }
+
+    int BlockCyclicDistribution::getLocalBefore(int index, int blockSize, int coordinate, int gridSize){
+        int block = index / blockSize;
+        int count = (block / gridSize) * blockSize;
+        int rest = block % gridSize;
+        if (coordinate < rest){
+            count += blockSize;
+        } else if (coordinate == rest){
+            count += index % blockSize;
+        }
+        return count;
+    }
+
+}
@@ -0,0 +1,186 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_BLOCKCYCLICDISTRIBUTION_H
+#define MPI2_BLOCKCYCLICDISTRIBUTION_H
+
+#include "../mpi/Communicator.h"
+
+namespace data {
+
+    /**
+     * Two-dimensional block-cyclic distribution of the matrix (the same as used by ScaLAPACK). The processes are
+     * arranged into the gridRows x gridColumns grid, the process with rank r has coordinates
+     * (r / gridColumns, r % gridColumns). The matrix is separated into the square blocks of blockSize x blockSize
+     * elements (the last block row and the last block column may be smaller). The block (I, J) belongs to the
+     * process (I % gridRows, J % gridColumns). Each process stores its blocks as a single row-major local matrix of
+     * getLocalRows() x getLocalColumns() elements, the order of the rows and columns is preserved.
+     *
+     * Unlike the flat distribution used by data::Matrix, any block row or block column of the matrix is shared among
+     * gridColumns or gridRows processes, so all processes remain busy when the algorithm works with the trailing part
+     * of the matrix (as in LU decomposition) and each process stores O(N^2 / P) elements only.
+     *
+     * Usage:
+     * data::BlockCyclicDistribution distribution(comm, rows, columns);
+     * for (int li = 0; li < distribution.getLocalRows(); ++li){
+     *      int i = distribution.getGlobalRow(li);
+     *      ...
+     * }
+     */
+    class BlockCyclicDistribution {
+    private:
+        mpi::Communicator& communicator;
+        mpi::Communicator rowCommunicator;
+        mpi::Communicator columnCommunicator;
+        int rows, columns, blockSize;
+        int gridRows, gridColumns, gridRow, gridColumn;
+        int localRows, localColumns;
+
+        static int getLocalBefore(int index, int blockSize, int coordinate, int gridSize);
+
+    public:
+        /**
+         * Creates the distribution
+         * Collective routine
+         *
+         * @param comm communicator which processes shall keep the matrix. The communicator shall not be destroyed
+         * before the distribution
+         * @param m number of matrix rows
+         * @param n number of matrix columns
+         * @param nb block size (see LU_BLOCK_SIZE in compile_options.h)
+         * @param gr number of rows in the process grid or 0 to choose the grid as square as possible
+         */
+        BlockCyclicDistribution(mpi::Communicator& comm, int m, int n, int nb, int gr = 0);
+
+        BlockCyclicDistribution(const BlockCyclicDistribution& other) = delete;
+
+        [[nodiscard]] mpi::Communicator& getCommunicator() const { return communicator; }
+
+        /**
+         *
+         * @return communicator containing all processes from the same row of the process grid. The rank within
+         * this communicator equals to the column of the process grid
+         */
+        [[nodiscard]] const mpi::Communicator& getRowCommunicator() const { return rowCommunicator; }
+
+        /**
+         *
+         * @return communicator containing all processes from the same column of the process grid. The rank within
+         * this communicator equals to the row of the process grid
+         */
+        [[nodiscard]] const mpi::Communicator& getColumnCommunicator() const { return columnCommunicator; }
+
+        [[nodiscard]] int getRows() const { return rows; }
+        [[nodiscard]] int getColumns() const { return columns; }
+        [[nodiscard]] int getBlockSize() const { return blockSize; }
+        [[nodiscard]] int getGridRows() const { return gridRows; }
+        [[nodiscard]] int getGridColumns() const { return gridColumns; }
+        [[nodiscard]] int getGridRow() const { return gridRow; }
+        [[nodiscard]] int getGridColumn() const { return gridColumn; }
+        [[nodiscard]] int getLocalRows() const { return localRows; }
+        [[nodiscard]] int getLocalColumns() const { return localColumns; }
+
+        /**
+         *
+         * @param i global row index
+         * @return row of the process grid containing this matrix row
+         */
+        [[nodiscard]] int getRowOwner(int i) const { return (i / blockSize) % gridRows; }
+
+        /**
+         *
+         * @param j global column index
+         * @return column of the process grid containing this matrix column
+         */
+        [[nodiscard]] int getColumnOwner(int j) const { return (j / blockSize) % gridColumns; }
+
+        /**
+         *
+         * @param i global row index
+         * @param j global column index
+         * @return rank of the process containing the element
+         */
+        [[nodiscard]] int getOwner(int i, int j) const { return getRowOwner(i) * gridColumns + getColumnOwner(j); }
+
+        /**
+         *
+         * @param i global row index
+         * @return local row index at the process from the grid row getRowOwner(i)
+         */
+        [[nodiscard]] int getLocalRow(int i) const {
+            return (i / blockSize / gridRows) * blockSize + i % blockSize;
+        }
+
+        /**
+         *
+         * @param j global column index
+         * @return local column index at the process from the grid column getColumnOwner(j)
+         */
+        [[nodiscard]] int getLocalColumn(int j) const {
+            return (j / blockSize / gridColumns) * blockSize + j % blockSize;
+        }
+
+        /**
+         *
+         * @param li local row index
+         * @return the global row index
+         */
+        [[nodiscard]] int getGlobalRow(int li) const {
+            return ((li / blockSize) * gridRows + gridRow) * blockSize + li % blockSize;
+        }
+
+        /**
+         *
+         * @param lj local column index
+         * @return the global column index
+         */
+        [[nodiscard]] int getGlobalColumn(int lj) const {
+            return ((lj / blockSize) * gridColumns + gridColumn) * blockSize + lj % blockSize;
+        }
+
+        /**
+         *
+         * @param i global row index
+         * @return number of local rows which global indices are less than i. The local rows from this number
+         * to getLocalRows()-1 correspond to the global rows from i to getRows()-1
+         */
+        [[nodiscard]] int getLocalRowsBefore(int i) const {
+            return getLocalBefore(i, blockSize, gridRow, gridRows);
+        }
+
+        /**
+         *
+         * @param j global column index
+         * @return number of local columns which global indices are less than j
+         */
+        [[nodiscard]] int getLocalColumnsBefore(int j) const {
+            return getLocalBefore(j, blockSize, gridColumn, gridColumns);
+        }
+
+        /**
+         *
+         * @param i global row index
+         * @param p row of the process grid
+         * @return number of rows with global indices less than i stored by the processes from the grid row p
+         */
+        [[nodiscard]] int getLocalRowsBefore(int i, int p) const {
+            return getLocalBefore(i, blockSize, p, gridRows);
+        }
+
+        /**
+         *
+         * @param j global column index
+         * @param q column of the process grid
+         * @return number of columns with global indices less than j stored by the processes from the grid column q
+         */
+        [[nodiscard]] int getLocalColumnsBefore(int j, int q) const {
+            return getLocalBefore(j, blockSize, q, gridColumns);
+        }
+    };
+
+}
+
+
+#endif //MPI2_BLOCKCYCLICDISTRIBUTION_H
@@ -0,0 +1,115 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "BlockDecomposition.h"
+#include "exceptions.h"
+
+namespace data {
+
+    BlockDecomposition::BlockDecomposition(mpi::CartesianCommunicator &comm, int w, int h):
+        communicator(comm), width(w), height(h){
+
+        auto& dims = comm.getDimensions();
+        if (dims.size() != 2 || dims[0] > height || dims[1] > width){
+            throw incorrect_decomposition_topology();
+        }
+        gridHeight = dims[0];
+        gridWidth = dims[1];
+
+        rowBounds.resize(gridHeight + 1);
+        for (int p = 0; p <= gridHeight; ++p){
+            rowBounds[p] = (int)((long long)p * height / gridHeight);
+        }
+        columnBounds.resize(gridWidth + 1);
+        for (int q = 0; q <= gridWidth; ++q){
+            columnBounds[q] = (int)((long long)q * width / gridWidth);
+        }
+
+        localTile = getTile(comm.getRank());
+    }
+
+    BlockDecomposition::Tile BlockDecomposition::getTile(int rank){
+        int coords[2];
+        communicator.getCoordinates(coords, rank);
+        Tile tile;
+        tile.rank = rank;
+        tile.rowStart = rowBounds[coords[0]];
+        tile.rowFinish = rowBounds[coords[0] + 1];
+        tile.columnStart = columnBounds[coords[1]];
+        tile.columnFinish = columnBounds[coords[1] + 1];
+        return tile;
+    }
+
+    std::vector<BlockDecomposition::Neighbor> BlockDecomposition::getNeighbors(int halo){
+        std::vector<Neighbor> neighbors;
+        if (halo <= 0){
+            return neighbors;
+        }
+        if (halo > height / gridHeight || halo > width / gridWidth){
+            throw halo_too_large();
+        }
+
+        auto& coords = communicator.getCoordinates();
+        int tileHeight = localTile.getHeight();
+        int tileWidth = localTile.getWidth();
+        for (int rowShift = -1; rowShift <= 1; ++rowShift){
+            for (int columnShift = -1; columnShift <= 1; ++columnShift){
+                int neighborCoords[] = {coords[0] + rowShift, coords[1] + columnShift};
+                if ((rowShift == 0 && columnShift == 0) ||
+                    neighborCoords[0] < 0 || neighborCoords[0] >= gridHeight ||
+                    neighborCoords[1] < 0 || neighborCoords[1] >= gridWidth){
+                    continue;
+                }
+
+                Neighbor neighbor;
+                neighbor.rank = communicator.getRankByCoordinates(neighborCoords);
+                neighbor.rowShift = rowShift;
+                neighbor.columnShift = columnShift;
+                switch (rowShift){
+                    case -1:
+                        neighbor.sendRow = 0;
+                        neighbor.receiveRow = -halo;
+                        neighbor.rows = halo;
+                        break;
+                    case 0:
+                        neighbor.sendRow = neighbor.receiveRow = 0;
+                        neighbor.rows = tileHeight;
+                        break;
+                    default:
+                        neighbor.sendRow = tileHeight - halo;
+                        neighbor.receiveRow = tileHeight;
+                        neighbor.rows = halo;
+                }
+                switch (columnShift){
+                    case -1:
+                        neighbor.sendColumn = 0;
+                        neighbor.receiveColumn = -halo;
+                        neighbor.columns = halo;
+                        break;
+                    case 0:
+                        neighbor.sendColumn = neighbor.receiveColumn = 0;
+                        neighbor.columns = tileWidth;
+                        break;
+                    default:
+                        neighbor.sendColumn = tileWidth - halo;
+                        neighbor.receiveColumn = tileWidth;
+                        neighbor.columns = halo;
+                }
+                neighbors.push_back(neighbor);
+            }
+        }
+
+        return neighbors;
+    }
+
+    void BlockDecomposition::getOptimalGrid(int nprocs, int dims[]){
+        dims[0] = dims[1] = 0;
+        int errcode;
+        if ((errcode = MPI_Dims_create(nprocs, 2, dims)) != MPI_SUCCESS){
+            mpi::throw_exception(errcode);
+        }
+    }
+
+}
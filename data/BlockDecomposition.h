@@ -0,0 +1,151 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_BLOCKDECOMPOSITION_H
+#define MPI2_BLOCKDECOMPOSITION_H
+
+#include <vector>
+#include "../mpi/CartesianCommunicator.h"
+
+namespace data {
+
+    /**
+     * Provides two-dimensional block decomposition of the matrix among processes of the two-dimensional cartesian
+     * communicator. The matrix is separated into rectangular tiles aligned by rows and columns. The tile for the
+     * process with coordinates (p, q) contains rows from getRowStart(p) to getRowStart(p+1)-1 and columns from
+     * getColumnStart(q) to getColumnStart(q+1)-1. The first dimension of the communicator grid corresponds to the
+     * matrix rows while the second dimension corresponds to the matrix columns.
+     *
+     * Unlike the flat decomposition used by data::Matrix, each process needs only the halo around its tile in order
+     * to apply the stencil, and the halo surface is O(N/sqrt(P)) instead of O(N).
+     *
+     * Usage:
+     * int dims[2];
+     * data::BlockDecomposition::getOptimalGrid(comm.getProcessorNumber(), dims);
+     * bool periods[] = {false, false};
+     * mpi::CartesianCommunicator cart = comm.createCartesianTopology(2, dims, periods, false);
+     * data::BlockDecomposition decomposition(cart, width, height);
+     * data::TiledMatrix A(decomposition, widthUm, heightUm, halo);
+     */
+    class BlockDecomposition {
+    public:
+
+        /**
+         * Position of a certain tile within the matrix
+         */
+        struct Tile{
+            int rank;
+            int rowStart, rowFinish;
+            int columnStart, columnFinish;
+
+            [[nodiscard]] int getHeight() const { return rowFinish - rowStart; }
+            [[nodiscard]] int getWidth() const { return columnFinish - columnStart; }
+        };
+
+        /**
+         * Info about the neighbor tile. All indices are given relatively to the top left corner of the local tile
+         *
+         * rank - rank of the neighbor process
+         * rowShift, columnShift - position of the neighbor tile relatively to the local tile: -1, 0 or 1
+         * sendRow, sendColumn - top left corner of the local tile area that shall be sent to the neighbor
+         * receiveRow, receiveColumn - top left corner of the halo area where the neighbor data will be received
+         * rows, columns - size of both areas
+         */
+        struct Neighbor{
+            int rank;
+            int rowShift, columnShift;
+            int sendRow, sendColumn;
+            int receiveRow, receiveColumn;
+            int rows, columns;
+        };
+
+    private:
+        mpi::CartesianCommunicator& communicator;
+        int width, height;
+        int gridHeight, gridWidth;
+        std::vector<int> rowBounds, columnBounds;
+        Tile localTile;
+
+    public:
+        /**
+         * Creates the decomposition. This is not a collective routine
+         *
+         * @param comm two-dimensional cartesian communicator. The communicator shall not be destroyed before
+         * the decomposition
+         * @param w matrix width in pixels
+         * @param h matrix height in pixels
+         * @throws incorrect_decomposition_topology if the communicator is not two-dimensional or its grid is
+         * larger than the matrix
+         */
+        BlockDecomposition(mpi::CartesianCommunicator& comm, int w, int h);
+
+        /**
+         *
+         * @return the communicator used for the decomposition
+         */
+        mpi::CartesianCommunicator& getCommunicator() { return communicator; }
+
+        /**
+         *
+         * @return the matrix width in pixels
+         */
+        [[nodiscard]] int getWidth() const { return width; }
+
+        /**
+         *
+         * @return the matrix height in pixels
+         */
+        [[nodiscard]] int getHeight() const { return height; }
+
+        /**
+         *
+         * @param p grid row, from 0 to the number of grid rows inclusively
+         * @return the first matrix row of the tile in the p-th grid row
+         */
+        [[nodiscard]] int getRowStart(int p) const { return rowBounds[p]; }
+
+        /**
+         *
+         * @param q grid column, from 0 to the number of grid columns inclusively
+         * @return the first matrix column of the tile in the q-th grid column
+         */
+        [[nodiscard]] int getColumnStart(int q) const { return columnBounds[q]; }
+
+        /**
+         *
+         * @return the tile processed by the calling process
+         */
+        [[nodiscard]] const Tile& getLocalTile() const { return localTile; }
+
+        /**
+         *
+         * @param rank rank of the process within the cartesian communicator
+         * @return the tile processed by a given process
+         */
+        Tile getTile(int rank);
+
+        /**
+         * Returns all neighbors which data are required to fill the halo around the local tile. The boundaries
+         * of the matrix are not periodic irrespectively of the communicator periods
+         *
+         * @param halo number of rows and columns around the tile
+         * @return list of neighbors
+         * @throws halo_too_large if the halo is larger than the size of some tile
+         */
+        std::vector<Neighbor> getNeighbors(int halo);
+
+        /**
+         * Computes the most square process grid
+         *
+         * @param nprocs number of processes
+         * @param dims the array of two items where number of grid rows and grid columns will be written
+         */
+        static void getOptimalGrid(int nprocs, int dims[]);
+    };
+
+}
+
+
+#endif //MPI2_BLOCKDECOMPOSITION_H
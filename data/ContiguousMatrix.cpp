@@ -3,50 +3,111 @@
 // (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
 //
 
+#include <algorithm>
 #include "ContiguousMatrix.h"
+#include "MatrixAllocator.h"
 #include "../Application.h"
 
 namespace data{
 
-    ContiguousMatrix::ContiguousMatrix(mpi::Communicator &comm, int width, int height, double widthUm, double heightUm,
-                                       double filler):
-                                       Matrix(comm, width, height, widthUm, heightUm, filler){
-        createBuffers();
-        for (int i=0; i < size; i++){
-            bigData[i] = filler;
+    template<typename T> BasicContiguousMatrix<T>::BasicContiguousMatrix(mpi::Communicator &comm, int width,
+            int height, double widthUm, double heightUm, double filler):
+            BasicContiguousMatrix(comm, width, height, widthUm, heightUm, filler, true) {}
+
+    template<typename T> BasicContiguousMatrix<T>::BasicContiguousMatrix(mpi::Communicator &comm, int width,
+            int height, double widthUm, double heightUm, double filler, bool allocate):
+            Matrix(comm, width, height, widthUm, heightUm, filler){
+        bigData = nullptr;
+        synchronizationBuffer = nullptr;
+        if (allocate){
+            createBuffers();
+            for (int i=0; i < size; i++){
+                bigData[i] = filler;
+            }
         }
     }
 
-    void ContiguousMatrix::createBuffers(){
+    template<typename T> void BasicContiguousMatrix<T>::createBuffers(){
         allocatorSize = ceil((double)size/communicator.getProcessorNumber());
-        bigData = new double[allocatorSize * communicator.getProcessorNumber()];
-        synchronizationBuffer = new double[allocatorSize * communicator.getProcessorNumber()];
+        bigData = MatrixAllocator::allocate<T>(allocatorSize * communicator.getProcessorNumber());
+        synchronizationBuffer = MatrixAllocator::allocate<T>(allocatorSize * communicator.getProcessorNumber());
         data = bigData + iStart;
     }
 
-    void ContiguousMatrix::deleteBuffers(){
+    template<typename T> void BasicContiguousMatrix<T>::deleteBuffers(){
         if (bigData != nullptr) {
-            delete[] bigData;
-            delete[] synchronizationBuffer;
+            MatrixAllocator::deallocate(bigData);
+            MatrixAllocator::deallocate(synchronizationBuffer);
             bigData = nullptr;
             synchronizationBuffer = nullptr;
         }
     }
 
-    ContiguousMatrix::ContiguousMatrix(const ContiguousMatrix &other):
+    template<typename T> BasicContiguousMatrix<T>::BasicContiguousMatrix(const BasicContiguousMatrix &other):
         Matrix(other.communicator, other.width, other.height, other.widthUm, other.heightUm){
         createBuffers();
-        memcpy(data, other.data, localSize * sizeof(double));
+        memcpy(data, other.data, localSize * sizeof(T));
     }
 
-    ContiguousMatrix::~ContiguousMatrix() {
+    template<typename T> BasicContiguousMatrix<T>::~BasicContiguousMatrix() {
+        if (synchronizationStarted){
+            try{
+                synchronizationRequest.wait();
+            } catch (std::exception& e){
+                std::cerr << e.what() << std::endl;
+            }
+        }
+        if (haloRequests != nullptr){
+            try{
+                haloRequests->waitAll();
+            } catch (std::exception& e){
+                std::cerr << e.what() << std::endl;
+            }
+            delete haloRequests;
+        }
         deleteBuffers();
     }
 
-    void ContiguousMatrix::synchronize(int root) {
-        double* temporaryBuffer;
-        communicator.gather(data, allocatorSize, MPI_DOUBLE, synchronizationBuffer, allocatorSize, MPI_DOUBLE, root);
-        if (rank == root) {
+    template<typename T> void BasicContiguousMatrix<T>::synchronize(int root) {
+        startSynchronize(root);
+        waitSynchronize();
+    }
+
+    template<typename T> void BasicContiguousMatrix<T>::synchronize() {
+        startSynchronize();
+        waitSynchronize();
+    }
+
+    template<typename T> void BasicContiguousMatrix<T>::startSynchronize(int root) {
+        if (synchronizationStarted){
+            waitSynchronize();
+        }
+        MPI_Datatype datatype = Matrix::getElementDatatype();
+        synchronizationRequest = communicator.igather(data, allocatorSize, datatype, synchronizationBuffer,
+                allocatorSize, datatype, root);
+        synchronizationRoot = root;
+        synchronizationStarted = true;
+    }
+
+    template<typename T> void BasicContiguousMatrix<T>::startSynchronize() {
+        if (synchronizationStarted){
+            waitSynchronize();
+        }
+        MPI_Datatype datatype = Matrix::getElementDatatype();
+        synchronizationRequest = communicator.iallGather(data, allocatorSize, datatype, synchronizationBuffer,
+                allocatorSize, datatype);
+        synchronizationRoot = -1;
+        synchronizationStarted = true;
+    }
+
+    template<typename T> void BasicContiguousMatrix<T>::waitSynchronize() {
+        if (!synchronizationStarted){
+            return;
+        }
+        T* temporaryBuffer;
+        synchronizationRequest.wait();
+        synchronizationStarted = false;
+        if (synchronizationRoot == -1 || rank == synchronizationRoot) {
             temporaryBuffer = bigData;
             bigData = synchronizationBuffer;
             synchronizationBuffer = temporaryBuffer;
@@ -54,21 +115,68 @@ namespace data{
         }
     }
 
-    void ContiguousMatrix::synchronize() {
-        double* temporaryBuffer;
-        communicator.allGather(data, allocatorSize, MPI_DOUBLE, synchronizationBuffer, allocatorSize, MPI_DOUBLE);
-        temporaryBuffer = bigData;
-        bigData = synchronizationBuffer;
-        synchronizationBuffer = temporaryBuffer;
-        data = bigData + iStart;
+    template<typename T> void BasicContiguousMatrix<T>::getHaloArea(int processRank, int halo, int &start,
+            int &finish) const {
+        int processStart = processRank * allocatorSize;
+        int processFinish = std::min(processStart + allocatorSize, size);
+        if (processStart >= processFinish){
+            start = finish = 0;
+            return;
+        }
+        int firstRow = std::max(processStart / width - halo, 0);
+        int lastRow = std::min((processFinish - 1) / width + halo, height - 1);
+        start = firstRow * width;
+        finish = (lastRow + 1) * width;
     }
 
-    ContiguousMatrix& ContiguousMatrix::operator=(const ContiguousMatrix& other){
+    template<typename T> void BasicContiguousMatrix<T>::startHaloExchange(int halo) {
+        int nprocs = communicator.getProcessorNumber();
+        if (haloRequests != nullptr){
+            finishHaloExchange();
+        }
+        haloRequests = new mpi::Requests(2 * nprocs);
+
+        int haloStart, haloFinish;
+        getHaloArea(rank, halo, haloStart, haloFinish);
+        for (int r = 0; r < nprocs; ++r){
+            if (r == rank) continue;
+            int processStart = r * allocatorSize;
+            int processFinish = std::min(processStart + allocatorSize, size);
+
+            int recvStart = std::max(haloStart, processStart);
+            int recvFinish = std::min(haloFinish, processFinish);
+            if (recvStart < recvFinish){
+                *haloRequests = communicator.irecv(bigData + recvStart, recvFinish - recvStart,
+                        Matrix::getElementDatatype(), r, HALO_EXCHANGE_TAG);
+            }
+
+            int neighborStart, neighborFinish;
+            getHaloArea(r, halo, neighborStart, neighborFinish);
+            int sendStart = std::max(neighborStart, iStart);
+            int sendFinish = std::min(neighborFinish, iFinish);
+            if (sendStart < sendFinish){
+                *haloRequests = communicator.isend(bigData + sendStart, sendFinish - sendStart,
+                        Matrix::getElementDatatype(), r, HALO_EXCHANGE_TAG);
+            }
+        }
+    }
+
+    template<typename T> void BasicContiguousMatrix<T>::finishHaloExchange() {
+        if (haloRequests != nullptr){
+            haloRequests->waitAll();
+            delete haloRequests;
+            haloRequests = nullptr;
+        }
+    }
+
+    template<typename T>
+    BasicContiguousMatrix<T>& BasicContiguousMatrix<T>::operator=(const BasicContiguousMatrix& other){
+        waitSynchronize();
         if (width == other.width && height == other.height &&
             communicator.getProcessorNumber() == other.communicator.getProcessorNumber()){
             int nprocs = communicator.getProcessorNumber();
             localSize = ceil((double) size / nprocs);
-            iStart = localSize * rank;
+            iStart = std::min(localSize * rank, size);
             iFinish = iStart + localSize;
             if (iFinish > size) {
                 iFinish = size;
@@ -84,7 +192,7 @@ namespace data{
             rank = communicator.getRank();
             int nprocs = communicator.getProcessorNumber();
             localSize = ceil((double) size / nprocs);
-            iStart = localSize * rank;
+            iStart = std::min(localSize * rank, size);
             iFinish = iStart + localSize;
             if (iFinish > size) {
                 iFinish = size;
@@ -93,14 +201,21 @@ namespace data{
             deleteBuffers();
             createBuffers();
         }
-        memcpy(data, other.data, localSize * sizeof(double));
+        memcpy(data, other.data, localSize * sizeof(T));
+        this->touch();
         return *this;
     }
 
-    ContiguousMatrix& ContiguousMatrix::operator=(ContiguousMatrix&& other){
+    template<typename T>
+    BasicContiguousMatrix<T>& BasicContiguousMatrix<T>::operator=(BasicContiguousMatrix&& other){
         if (communicator.getProcessorNumber() != other.communicator.getProcessorNumber()){
             throw matrix_move_error();
         }
+        if (sharedBuffers || other.sharedBuffers){
+            return *this = static_cast<const BasicContiguousMatrix&>(other);
+        }
+        waitSynchronize();
+        other.waitSynchronize();
         deleteBuffers();
         width = other.width;
         height = other.height;
@@ -118,34 +233,58 @@ namespace data{
         other.bigData = nullptr;
         synchronizationBuffer = other.synchronizationBuffer;
         other.synchronizationBuffer = nullptr;
+        this->touch();
         return *this;
     }
 
-    ContiguousMatrix ContiguousMatrix::operator-() const{
-        ContiguousMatrix B(communicator, width, height, widthUm, heightUm);
-        B.calculate(*this, [](Matrix::ConstantIterator& a){
+    template<typename T> BasicContiguousMatrix<T> BasicContiguousMatrix<T>::operator-() const{
+        BasicContiguousMatrix B(communicator, width, height, widthUm, heightUm);
+        B.calculate(*this, [](typename Matrix::ConstantIterator& a){
             return -*a;
         });
         return B;
     }
 
-    ContiguousMatrix& ContiguousMatrix::transpose(){
-        Iterator b(*this, 0, 0);
-        for (auto a = begin(); a != end(); ++a){
-            int i = a.getRow();
-            int j = a.getColumn();
-            *a = b.val(j, i);
+    template<typename T> BasicContiguousMatrix<T>& BasicContiguousMatrix<T>::transpose(){
+        constexpr int tileSize = 32;
+        if (width != height){
+            throw matrix_dimensions_mismatch();
+        }
+        if (localSize <= 0){
+            return *this;
+        }
+        int firstRow = iStart / width;
+        int lastRow = (iFinish - 1) / width + 1;
+        for (int i0 = firstRow; i0 < lastRow; i0 += tileSize){
+            int i1 = std::min(i0 + tileSize, lastRow);
+            for (int j0 = 0; j0 < width; j0 += tileSize){
+                int j1 = std::min(j0 + tileSize, width);
+                for (int i = i0; i < i1; ++i){
+                    for (int j = j0; j < j1; ++j){
+                        int index = i * width + j;
+                        int mirror = j * width + i;
+                        if (index < iStart || index >= iFinish){
+                            continue;
+                        }
+                        if (mirror < iStart || mirror >= iFinish){
+                            bigData[index] = bigData[mirror];
+                        } else if (i < j){
+                            std::swap(bigData[index], bigData[mirror]);
+                        }
+                    }
+                }
+            }
         }
         return *this;
     }
 
 #if DEBUG==1
-    ContiguousMatrix ContiguousMatrix::magic(mpi::Communicator& comm, int n){
+    template<typename T> BasicContiguousMatrix<T> BasicContiguousMatrix<T>::magic(mpi::Communicator& comm, int n){
         if (n % 2 == 0){
             throw std::runtime_error("The method was not implemented for even matrix sizes");
         }
 
-        ContiguousMatrix A(comm, n, n, 1.0, 1.0);
+        BasicContiguousMatrix A(comm, n, n, 1.0, 1.0);
         Iterator a(A, 0, 0);
         int i = n/2;
         int j = n-1;
@@ -178,4 +317,7 @@ namespace data{
 #endif
 
 
+    template class BasicContiguousMatrix<double>;
+    template class BasicContiguousMatrix<float>;
+
 }
\ No newline at end of file
@@ -8,14 +8,16 @@
 
 
 #include "../mpi/Communicator.h"
+#include "../mpi/Request.h"
 #include "Matrix.h"
+#include "MatrixExpression.h"
 #include "exceptions.h"
 
 namespace data {
 
     /**
-     * Represents so called contiguous matrix. A contiguous matrix allocates 8*w*h bytes of memory for each process
-     * where w is matrix width and h is matrix height. The whole matrix is separated into N pieces where N is
+     * Represents so called contiguous matrix. A contiguous matrix allocates sizeof(T)*w*h bytes of memory for each
+     * process where w is matrix width and h is matrix height. The whole matrix is separated into N pieces where N is
      * number of processes in the communicator. Each piece is so called responsibility area for a certain process.
      * Any matrix operations write the data only to the responsibility area. Each process may access the whole matrix
      * but the data outside the responsibility area may be old. Special synchronization routines were applied in order
@@ -38,16 +40,56 @@ namespace data {
      * Use matrix iterator to ensure that you always access the responsibility area
      *
      * The object requires synchronization buffer. Its size is as many as the size of the matrix
+     *
+     * @tparam T element type: double (data::ContiguousMatrix) or float (data::ContiguousMatrixF). The synchronization
+     * and halo exchange transmit the elements of this type
      */
-    class ContiguousMatrix: public Matrix {
-    private:
-        double* bigData;
-        double* synchronizationBuffer;
+    template<typename T> class BasicContiguousMatrix: public BasicMatrix<T> {
+    public:
+        using Matrix = BasicMatrix<T>;
+
+    protected:
+        using Matrix::size;
+        using Matrix::localSize;
+        using Matrix::iStart;
+        using Matrix::iFinish;
+        using Matrix::rank;
+        using Matrix::width;
+        using Matrix::height;
+        using Matrix::communicator;
+        using Matrix::widthUm;
+        using Matrix::heightUm;
+        using Matrix::data;
+
+        friend class BasicMatrix<T>;
+
+        T* bigData;
+        T* synchronizationBuffer;
 
         int allocatorSize;
 
-        void createBuffers();
-        void deleteBuffers();
+        mpi::Requests* haloRequests = nullptr;
+        static constexpr int HALO_EXCHANGE_TAG = 1001;
+
+        mpi::Request synchronizationRequest;
+        int synchronizationRoot = -1;
+        bool synchronizationStarted = false;
+
+        /**
+         * true if the buffers are not owned by the object and hence can't be moved to another matrix
+         */
+        bool sharedBuffers = false;
+
+        virtual void createBuffers();
+        virtual void deleteBuffers();
+        void getHaloArea(int processRank, int halo, int& start, int& finish) const;
+
+        /**
+         * Initializes the matrix without allocating the buffers. The derived class is responsible for calling
+         * its createBuffers() and filling the matrix
+         */
+        BasicContiguousMatrix(mpi::Communicator& comm, int width, int height, double widthUm, double heightUm,
+                double filler, bool allocate);
 
     public:
 
@@ -61,11 +103,11 @@ namespace data {
          * @param heightUm matrix height in um or any other units
          * @param filler default value for all data within the matrix
          */
-        ContiguousMatrix(mpi::Communicator& comm, int width, int height, double widthUm, double heightUm,
+        BasicContiguousMatrix(mpi::Communicator& comm, int width, int height, double widthUm, double heightUm,
                 double filler = 0.0);
-        virtual ~ContiguousMatrix();
+        virtual ~BasicContiguousMatrix();
 
-        ContiguousMatrix(const ContiguousMatrix& other);
+        BasicContiguousMatrix(const BasicContiguousMatrix& other);
 
         /**
          * Provides an access to the matrix element with a specified index
@@ -73,7 +115,7 @@ namespace data {
          * @param index index of an item to access
          * @return the item alias
          */
-        double& operator[](int index){
+        T& operator[](int index){
             if (index >= 0 && index < size) {
                 return bigData[index];
             } else {
@@ -81,7 +123,7 @@ namespace data {
             }
         }
 
-        double operator[](int index) const{
+        T operator[](int index) const{
             if (index >= 0 && index < size) {
                 return bigData[index];
             } else {
@@ -89,8 +131,9 @@ namespace data {
             }
         }
 
-        ContiguousMatrix& operator=(const ContiguousMatrix& other);
-        ContiguousMatrix& operator=(ContiguousMatrix&& other);
+        using Matrix::operator=;
+        BasicContiguousMatrix& operator=(const BasicContiguousMatrix& other);
+        BasicContiguousMatrix& operator=(BasicContiguousMatrix&& other);
 
 
 
@@ -104,7 +147,7 @@ namespace data {
          *
          * @param root rank of the root process in the communicator used for the matrix creation
          */
-        void synchronize(int root);
+        void synchronize(int root) override;
 
 
         /**
@@ -114,7 +157,70 @@ namespace data {
          * WARNING. Synchronization makes all iterators incorrect
          * Collective routine
          */
-        void synchronize();
+        void synchronize() override;
+
+        /**
+         * Starts the synchronization. See synchronize() for details. The routine uses the non-blocking collective
+         * and returns immediately. The data outside the responsibility area may be read until waitSynchronize()
+         * is called but they are still deprecated. The data within the responsibility area shall not be changed.
+         * The iterators remain valid until waitSynchronize()
+         * Collective routine
+         */
+        void startSynchronize() override;
+
+        /**
+         * Starts the synchronization to the root process. See synchronize(int root) and startSynchronize() for
+         * details
+         * Collective routine
+         *
+         * @param root rank of the root process in the communicator used for the matrix creation
+         */
+        void startSynchronize(int root) override;
+
+        /**
+         * Waits until the synchronization completes
+         *
+         * WARNING. The routine makes all iterators incorrect
+         */
+        void waitSynchronize() override;
+
+        /**
+         *
+         * @return true if the synchronization was started but waitSynchronize() was not called
+         */
+        [[nodiscard]] bool isSynchronizationStarted() const { return synchronizationStarted; }
+
+        /**
+         * Starts the halo exchange. The halo exchange sends the recent version of the data within the responsibility
+         * area only to those processes which responsibility areas are not further than a given number of rows from it.
+         * When the exchange completes, each process has the recent version of all rows that are closer than halo rows
+         * to its responsibility area. The data outside these rows remain deprecated. The amount of transmitted data
+         * depends on the halo size but not on the matrix size
+         *
+         * The routine doesn't wait for the transmission to complete. The data within the responsibility area shall
+         * not be changed and the data outside the responsibility area shall not be read before finishHaloExchange()
+         * Unlike synchronize(), the routine doesn't make iterators incorrect
+         * Collective routine
+         *
+         * @param halo number of rows above and below the responsibility area that shall be updated
+         */
+        virtual void startHaloExchange(int halo);
+
+        /**
+         * Waits until the halo exchange started by startHaloExchange(...) completes
+         */
+        virtual void finishHaloExchange();
+
+        /**
+         * Provides the halo exchange and waits for its completion. See startHaloExchange(...) for details
+         * Collective routine
+         *
+         * @param halo number of rows above and below the responsibility area that shall be updated
+         */
+        void synchronizeHalo(int halo){
+            startHaloExchange(halo);
+            finishHaloExchange();
+        }
 
 
 
@@ -143,9 +249,9 @@ namespace data {
              * @param matrix reference to the matrix
              * @param index single index
              */
-            Iterator(ContiguousMatrix& matrix, int index): Matrix::Iterator(matrix, index), AbstractIterator(index),
-                Matrix::AbstractIterator(index){
-                pointer = matrix.bigData + index;
+            Iterator(BasicContiguousMatrix& matrix, int index): Matrix::Iterator(matrix, index),
+                AbstractIterator(index), Matrix::AbstractIterator(index){
+                this->pointer = matrix.bigData + index;
             }
 
                 /**
@@ -155,7 +261,7 @@ namespace data {
                  * @param row the row index
                  * @param column the column index
                  */
-            Iterator(ContiguousMatrix& matrix, int row, int column):
+            Iterator(BasicContiguousMatrix& matrix, int row, int column):
                 Iterator(matrix, row * matrix.width + column) {}
 
             /**
@@ -163,7 +269,7 @@ namespace data {
              *
              * @param matrix reference to the matrix
              */
-            Iterator(ContiguousMatrix& matrix): Iterator(matrix, matrix.iStart) {}
+            Iterator(BasicContiguousMatrix& matrix): Iterator(matrix, matrix.iStart) {}
 
             /**
              * Copy constructor
@@ -171,7 +277,7 @@ namespace data {
              * @param other reference to the source iterator
              */
             Iterator(const Iterator& other):
-                Iterator(*static_cast<ContiguousMatrix*>(other.parent), other.index) {}
+                Iterator(*static_cast<BasicContiguousMatrix*>(other.parent), other.index) {}
         };
 
         /**
@@ -185,9 +291,9 @@ namespace data {
              * @param matrix reference to the matrix
              * @param index the single index
              */
-            ConstantIterator(const ContiguousMatrix& matrix, int index):
+            ConstantIterator(const BasicContiguousMatrix& matrix, int index):
                 Matrix::ConstantIterator(matrix, index), AbstractIterator(index), Matrix::AbstractIterator(index){
-                pointer = matrix.bigData + index;
+                this->pointer = matrix.bigData + index;
             }
 
                 /**
@@ -197,7 +303,7 @@ namespace data {
                  * @param row horizontal index
                  * @param col vertical index
                  */
-            ConstantIterator(const ContiguousMatrix& matrix, int row, int col):
+            ConstantIterator(const BasicContiguousMatrix& matrix, int row, int col):
                 ConstantIterator(matrix, row * matrix.width + col) {}
 
             /**
@@ -205,29 +311,29 @@ namespace data {
              *
              * @param matrix reference to the matrix
              */
-            ConstantIterator(const ContiguousMatrix& matrix): ConstantIterator(matrix, matrix.iStart) {}
+            ConstantIterator(const BasicContiguousMatrix& matrix): ConstantIterator(matrix, matrix.iStart) {}
 
             ConstantIterator(const ConstantIterator& other):
-                ConstantIterator(*static_cast<const ContiguousMatrix*>(other.parent), other.index) {}
+                ConstantIterator(*static_cast<const BasicContiguousMatrix*>(other.parent), other.index) {}
         };
 
-        Matrix::Iterator begin(){
+        typename Matrix::Iterator begin(){
             return Iterator(*this);
         }
 
-        Matrix::ConstantIterator cbegin() const{
+        typename Matrix::ConstantIterator cbegin() const{
             return ConstantIterator(*this);
         }
 
-        Matrix::Iterator end(){
+        typename Matrix::Iterator end(){
             return Iterator(*this, iFinish);
         }
 
-        Matrix::ConstantIterator cend() const{
+        typename Matrix::ConstantIterator cend() const{
             return ConstantIterator(*this, iFinish);
         }
 
-        ContiguousMatrix operator-() const;
+        BasicContiguousMatrix operator-() const;
 
         /**
          * Transposes the matrix and writes the result to itself
@@ -235,20 +341,27 @@ namespace data {
          * Precaution # 2. The function transposes cells only belonging to the current process. In order to transpose
          * full set of the data please, synchronize the matrix after the function call. See synchronize() method
          * for details
-         * Precaution # 3. Matrix A shall be squared. In another case, the calculations will be performed incorrectly
-         * This is an unsafe method
+         *
+         * The matrix is processed by 32x32 tiles. When both an element and its mirror belong to the responsibility
+         * area they are swapped, so no value is overwritten before it has been read
          *
          * @return reference to the result
+         * @throws matrix_dimensions_mismatch if the matrix is not square
          */
-        ContiguousMatrix& transpose();
+        virtual BasicContiguousMatrix& transpose();
 
         /**
-         * See Matrix::transpose for details
+         * See Matrix::transpose for details. When A is the matrix itself, the in-place transpose() is applied
          *
          * @param A
          * @return
          */
-        Matrix& transpose(const ContiguousMatrix& A) override { return Matrix::transpose(A); }
+        Matrix& transpose(const BasicContiguousMatrix& A) override {
+            if (&A == this){
+                return transpose();
+            }
+            return Matrix::transpose(A);
+        }
 
 
 
@@ -263,7 +376,7 @@ namespace data {
          * @param n number of sides in the magic square
          * @return ContiguousMatrix object
          */
-        static ContiguousMatrix magic(mpi::Communicator& comm, int n);
+        static BasicContiguousMatrix magic(mpi::Communicator& comm, int n);
 #endif
 
 
@@ -0,0 +1,415 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include <algorithm>
+#include "Convolver.h"
+
+namespace data {
+
+    template<typename T>
+    Convolver::Convolver(const ContiguousMatrix &K, const BasicMatrix<T> &target, bool norm, Method m):
+        kernel(K), normalize(norm), method(m){
+
+        if (method == AutoMethod || method == SeparableMethod){
+            if (!factorize(K, horizontalFactor, verticalFactor) && method == SeparableMethod){
+                throw non_separable_kernel();
+            }
+        }
+        initialize(target);
+    }
+
+    template<typename T>
+    Convolver::Convolver(const ContiguousMatrix &K, const std::vector<double> &horizontal,
+            const std::vector<double> &vertical, const BasicMatrix<T> &target, bool norm, Method m):
+        kernel(K), normalize(norm), method(m), horizontalFactor(horizontal), verticalFactor(vertical){
+
+        if (horizontalFactor.size() != (std::size_t)K.getWidth() ||
+                verticalFactor.size() != (std::size_t)K.getHeight()){
+            throw matrix_dimensions_mismatch();
+        }
+        initialize(target);
+    }
+
+    template<typename T> void Convolver::initialize(const BasicMatrix<T>& target){
+        width = target.getWidth();
+        height = target.getHeight();
+        iStart = target.getIstart();
+        iFinish = target.getIfinish();
+        W = (kernel.getWidth() - 1)/2;
+        H = (kernel.getHeight() - 1)/2;
+
+        if (iFinish > iStart) {
+            firstRow = iStart / width;
+            lastRow = (iFinish - 1) / width;
+        } else {
+            firstRow = 0;
+            lastRow = -1;
+        }
+        stripStart = std::max(firstRow - H, 0);
+        stripFinish = std::min(lastRow + H + 1, height);
+        paddedWidth = fft::Fft::getOptimalSize(width + 2*W);
+        paddedHeight = fft::Fft::getOptimalSize(std::max(stripFinish - stripStart, 1) + 2*H);
+
+        /* Interior pixels are the pixels which rows are not closer than H rows to the partially owned rows */
+        interiorStart = interiorFinish = iStart;
+        if (iFinish > iStart){
+            int ownedStart = (iStart + width - 1) / width;
+            int ownedFinish = iFinish / width;
+            int interiorFirstRow = ownedStart == 0 ? 0 : ownedStart + H;
+            int interiorLastRow = ownedFinish == height ? height - 1 : ownedFinish - H - 1;
+            if (interiorFirstRow <= interiorLastRow){
+                interiorStart = std::max(iStart, interiorFirstRow * width);
+                interiorFinish = std::min(iFinish, (interiorLastRow + 1) * width);
+                if (interiorStart >= interiorFinish){
+                    interiorStart = interiorFinish = iStart;
+                }
+            }
+        }
+
+        if (method == AutoMethod){
+            method = chooseMethod();
+        }
+        if (method == DirectMethod){
+            kernelValues.resize((2*H + 1) * (2*W + 1));
+            ContiguousMatrix::ConstantIterator k(kernel, 0);
+            for (int p = 0; p <= 2*H; ++p){
+                for (int q = 0; q <= 2*W; ++q){
+                    kernelValues[p * (2*W + 1) + q] = k.val(p, q);
+                }
+            }
+        }
+        if (method == FourierMethod){
+            initializeFourier();
+        }
+        if (method == SeparableMethod){
+            initializeSeparable();
+        }
+    }
+
+    Convolver::~Convolver(){
+        delete rowFft;
+        delete columnFft;
+    }
+
+    Convolver::Method Convolver::chooseMethod() const{
+        if (iFinish <= iStart){
+            return DirectMethod;
+        }
+
+        double directCost = (double)(iFinish - iStart) * (2*H + 1) * (2*W + 1);
+        double logWidth = log2(paddedWidth);
+        double logHeight = log2(paddedHeight);
+        int stripRows = stripFinish - stripStart;
+        int localRows = lastRow - firstRow + 1;
+        double fourierCost = (double)stripRows * paddedWidth * logWidth + /* forward transform on rows */
+                2.0 * paddedWidth * paddedHeight * logHeight + /* forward and inverse transform on columns */
+                (double)paddedWidth * paddedHeight + /* spectra product */
+                (double)localRows * paddedWidth * logWidth; /* inverse transform on rows */
+
+        fourierCost *= FOURIER_COST_FACTOR;
+
+        double separableCost = (double)stripRows * width * (2*W + 1) + (double)(iFinish - iStart) * (2*H + 1);
+        if (!horizontalFactor.empty() && separableCost <= directCost && separableCost <= fourierCost){
+            return SeparableMethod;
+        } else if (fourierCost < directCost){
+            return FourierMethod;
+        } else {
+            return DirectMethod;
+        }
+    }
+
+    void Convolver::initializeFourier(){
+        rowFft = new fft::Fft(paddedWidth);
+        columnFft = new fft::Fft(paddedHeight);
+        kernelSpectrum.assign(paddedWidth * paddedHeight, 0.0);
+        workspace.assign(paddedWidth * paddedHeight, 0.0);
+        column.resize(paddedHeight);
+
+        /* Matrix::convolve provides the cross-correlation, hence the kernel shall be flipped */
+        ContiguousMatrix::ConstantIterator k(kernel, H, W);
+        for (int p = 0; p <= 2*H; ++p){
+            for (int q = 0; q <= 2*W; ++q){
+                kernelSpectrum[p * paddedWidth + q] = k.val(H - p, W - q);
+            }
+        }
+        std::swap(kernelSpectrum, workspace);
+        forwardTransform(2*H + 1);
+        std::swap(kernelSpectrum, workspace);
+
+        if (normalize){
+            /* Normalization weights are the convolution of the kernel with the matrix of ones */
+            int stripRows = stripFinish - stripStart;
+            std::fill(workspace.begin(), workspace.end(), 0.0);
+            for (int r = 0; r < stripRows; ++r){
+                std::fill(workspace.begin() + r * paddedWidth, workspace.begin() + r * paddedWidth + width, 1.0);
+            }
+            forwardTransform(stripRows);
+            for (int n = 0; n < paddedWidth * paddedHeight; ++n){
+                workspace[n] *= kernelSpectrum[n];
+            }
+            inverseTransform();
+
+            weights.resize(iFinish - iStart);
+            for (int index = iStart; index < iFinish; ++index){
+                int i = index / width;
+                int j = index % width;
+                weights[index - iStart] = workspace[(i - stripStart + H) * paddedWidth + j + W].real();
+            }
+        }
+    }
+
+    void Convolver::initializeSeparable(){
+        rowBuffer.resize((stripFinish - stripStart) * width);
+        rowReady.assign(stripFinish - stripStart, 0);
+        if (!normalize){
+            return;
+        }
+
+        horizontalWeights.assign(width, 0.0);
+        for (int j = 0; j < width; ++j){
+            for (int w = std::max(-W, -j); w <= W && j + w < width; ++w){
+                horizontalWeights[j] += horizontalFactor[W + w];
+            }
+        }
+
+        verticalWeights.assign(lastRow - firstRow + 1, 0.0);
+        for (int i = firstRow; i <= lastRow; ++i){
+            for (int h = std::max(-H, -i); h <= H && i + h < height; ++h){
+                verticalWeights[i - firstRow] += verticalFactor[H + h];
+            }
+        }
+    }
+
+    bool Convolver::factorize(const ContiguousMatrix &K, std::vector<double> &horizontal,
+            std::vector<double> &vertical, double tolerance){
+        int kernelWidth = K.getWidth();
+        int kernelHeight = K.getHeight();
+        ContiguousMatrix::ConstantIterator k(K, 0);
+
+        int p0 = 0, q0 = 0;
+        double kmax = 0.0;
+        for (int p = 0; p < kernelHeight; ++p){
+            for (int q = 0; q < kernelWidth; ++q){
+                if (fabs(k.val(p, q)) > kmax){
+                    kmax = fabs(k.val(p, q));
+                    p0 = p;
+                    q0 = q;
+                }
+            }
+        }
+
+        bool separable = kmax > 0.0;
+        horizontal.resize(kernelWidth);
+        vertical.resize(kernelHeight);
+        if (separable) {
+            for (int q = 0; q < kernelWidth; ++q) {
+                horizontal[q] = k.val(p0, q);
+            }
+            for (int p = 0; p < kernelHeight; ++p) {
+                vertical[p] = k.val(p, q0) / k.val(p0, q0);
+            }
+            for (int p = 0; p < kernelHeight && separable; ++p) {
+                for (int q = 0; q < kernelWidth && separable; ++q) {
+                    separable = fabs(k.val(p, q) - vertical[p] * horizontal[q]) <= tolerance * kmax;
+                }
+            }
+        }
+
+        if (!separable){
+            horizontal.clear();
+            vertical.clear();
+        }
+        return separable;
+    }
+
+    void Convolver::forwardTransform(int filledRows){
+        for (int r = 0; r < filledRows; ++r){
+            rowFft->forward(&workspace[r * paddedWidth]);
+        }
+        for (int c = 0; c < paddedWidth; ++c){
+            for (int r = 0; r < paddedHeight; ++r){
+                column[r] = workspace[r * paddedWidth + c];
+            }
+            columnFft->forward(&column[0]);
+            for (int r = 0; r < paddedHeight; ++r){
+                workspace[r * paddedWidth + c] = column[r];
+            }
+        }
+    }
+
+    void Convolver::inverseTransform(){
+        for (int c = 0; c < paddedWidth; ++c){
+            for (int r = 0; r < paddedHeight; ++r){
+                column[r] = workspace[r * paddedWidth + c];
+            }
+            columnFft->inverse(&column[0]);
+            for (int r = 0; r < paddedHeight; ++r){
+                workspace[r * paddedWidth + c] = column[r];
+            }
+        }
+        /* Only rows within the responsibility area are required */
+        for (int i = firstRow; i <= lastRow; ++i){
+            rowFft->inverse(&workspace[(i - stripStart + H) * paddedWidth]);
+        }
+    }
+
+    template<typename T> void Convolver::fourierConvolve(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A){
+        int stripRows = stripFinish - stripStart;
+        std::fill(workspace.begin(), workspace.end(), 0.0);
+        typename BasicContiguousMatrix<T>::ConstantIterator a(A, stripStart, 0);
+        for (int r = 0; r < stripRows; ++r){
+            for (int c = 0; c < width; ++c){
+                workspace[r * paddedWidth + c] = a.val(r, c);
+            }
+        }
+
+        forwardTransform(stripRows);
+        for (int n = 0; n < paddedWidth * paddedHeight; ++n){
+            workspace[n] *= kernelSpectrum[n];
+        }
+        inverseTransform();
+
+        int index = iStart;
+        for (auto b = output.begin(); b != output.end(); ++b, ++index){
+            int i = index / width;
+            int j = index % width;
+            *b = workspace[(i - stripStart + H) * paddedWidth + j + W].real();
+            if (normalize){
+                *b /= weights[index - iStart];
+            }
+        }
+    }
+
+    template<typename T> void Convolver::directConvolve(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A,
+            int indexStart, int indexFinish){
+        typename BasicContiguousMatrix<T>::ConstantIterator a(A, 0);
+        auto b = output.begin() + (indexStart - iStart);
+        int kernelWidth = 2*W + 1;
+        for (int index = indexStart; index < indexFinish; ++index, ++b){
+            int i = index / width;
+            int j = index % width;
+            int wmin = std::max(-W, -j);
+            int wmax = std::min(W, width - 1 - j);
+            double sum = 0.0;
+            double localSum = 0.0;
+            for (int h = std::max(-H, -i); h <= H && i + h < height; ++h){
+                const double* k = &kernelValues[(H + h) * kernelWidth + W];
+                for (int w = wmin; w <= wmax; ++w){
+                    sum += k[w] * a.val(i + h, j + w);
+                    localSum += k[w];
+                }
+            }
+            if (normalize){
+                sum /= localSum;
+            }
+            *b = sum;
+        }
+    }
+
+    template<typename T> void Convolver::separableConvolve(BasicMatrix<T> &output,
+            const BasicContiguousMatrix<T> &A, int indexStart, int indexFinish){
+        int rowStart = std::max(indexStart / width - H, 0);
+        int rowFinish = std::min((indexFinish - 1) / width + H + 1, height);
+        typename BasicContiguousMatrix<T>::ConstantIterator a(A, 0);
+        for (int i = rowStart; i < rowFinish; ++i){
+            if (rowReady[i - stripStart]) continue;
+            double* row = &rowBuffer[(i - stripStart) * width];
+            for (int j = 0; j < width; ++j){
+                double sum = 0.0;
+                for (int w = std::max(-W, -j); w <= W && j + w < width; ++w){
+                    sum += horizontalFactor[W + w] * a.val(i, j + w);
+                }
+                row[j] = sum;
+            }
+            rowReady[i - stripStart] = 1;
+        }
+
+        auto b = output.begin() + (indexStart - iStart);
+        for (int index = indexStart; index < indexFinish; ++index, ++b){
+            int i = index / width;
+            int j = index % width;
+            double sum = 0.0;
+            for (int h = std::max(-H, -i); h <= H && i + h < height; ++h){
+                sum += verticalFactor[H + h] * rowBuffer[(i + h - stripStart) * width + j];
+            }
+            if (normalize){
+                sum /= horizontalWeights[j] * verticalWeights[i - firstRow];
+            }
+            *b = sum;
+        }
+    }
+
+    template<typename T>
+    void Convolver::checkMatrices(const BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A) const{
+        if (output.getWidth() != width || output.getHeight() != height ||
+            A.getWidth() != width || A.getHeight() != height ||
+            output.getIstart() != iStart || output.getIfinish() != iFinish){
+            throw matrix_dimensions_mismatch();
+        }
+    }
+
+    template<typename T> void Convolver::convolveRange(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A,
+            int indexStart, int indexFinish){
+        if (indexStart >= indexFinish){
+            return;
+        }
+        if (method == SeparableMethod){
+            separableConvolve(output, A, indexStart, indexFinish);
+        } else {
+            directConvolve(output, A, indexStart, indexFinish);
+        }
+    }
+
+    template<typename T> void Convolver::convolve(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A){
+        checkMatrices(output, A);
+        interiorDone = false;
+        if (method == FourierMethod){
+            fourierConvolve(output, A);
+        } else {
+            std::fill(rowReady.begin(), rowReady.end(), 0);
+            convolveRange(output, A, iStart, iFinish);
+        }
+    }
+
+    template<typename T>
+    void Convolver::convolveInterior(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A){
+        checkMatrices(output, A);
+        if (method != FourierMethod){
+            std::fill(rowReady.begin(), rowReady.end(), 0);
+            convolveRange(output, A, interiorStart, interiorFinish);
+            interiorDone = true;
+        }
+    }
+
+    template<typename T>
+    void Convolver::convolveBoundary(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A){
+        checkMatrices(output, A);
+        if (method == FourierMethod){
+            fourierConvolve(output, A);
+        } else if (interiorDone){
+            convolveRange(output, A, iStart, interiorStart);
+            convolveRange(output, A, interiorFinish, iFinish);
+        } else {
+            std::fill(rowReady.begin(), rowReady.end(), 0);
+            convolveRange(output, A, iStart, iFinish);
+        }
+        interiorDone = false;
+    }
+
+    template Convolver::Convolver(const ContiguousMatrix&, const Matrix&, bool, Convolver::Method);
+    template Convolver::Convolver(const ContiguousMatrix&, const MatrixF&, bool, Convolver::Method);
+    template Convolver::Convolver(const ContiguousMatrix&, const std::vector<double>&, const std::vector<double>&,
+            const Matrix&, bool, Convolver::Method);
+    template Convolver::Convolver(const ContiguousMatrix&, const std::vector<double>&, const std::vector<double>&,
+            const MatrixF&, bool, Convolver::Method);
+    template void Convolver::convolve(Matrix&, const ContiguousMatrix&);
+    template void Convolver::convolve(MatrixF&, const ContiguousMatrixF&);
+    template void Convolver::convolveInterior(Matrix&, const ContiguousMatrix&);
+    template void Convolver::convolveInterior(MatrixF&, const ContiguousMatrixF&);
+    template void Convolver::convolveBoundary(Matrix&, const ContiguousMatrix&);
+    template void Convolver::convolveBoundary(MatrixF&, const ContiguousMatrixF&);
+
+}
@@ -0,0 +1,200 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_CONVOLVER_H
+#define MPI2_CONVOLVER_H
+
+#include <vector>
+#include "ContiguousMatrix.h"
+#include "fft/Fft.h"
+
+namespace data {
+
+    /**
+     * Provides repeated spatial convolution of different matrices with the same kernel.
+     *
+     * The convolution result is the same as given by Matrix::convolve, including the border effect when
+     * normalization is on. However, the convolver prepares everything that depends on the kernel only once
+     * (during the construction) and chooses the fastest convolution method:
+     *
+     * DirectMethod - the convolution sum is calculated immediately for each pixel (see Matrix::convolve). This is
+     * the best method for small kernels
+     *
+     * FourierMethod - the convolution is computed by means of the fast Fourier transform. Each process transforms
+     * only those rows of the source matrix that are required to compute its responsibility area. The kernel spectrum
+     * and the normalization weights are computed by the constructor. This is the best method for large kernels.
+     *
+     * SeparableMethod - the kernel is a product of a function of the row and a function of the column (e.g., the
+     * gaussian kernel). The convolution is computed by two one-dimensional passes: along the rows and then along
+     * the columns. The normalization factor is the product of the row and column normalization factors because the
+     * part of the kernel overlapped with the matrix is always a rectangle. The method is available when the kernel
+     * factors were given to the constructor or when the constructor has found that the kernel is separable
+     *
+     * Usage:
+     * data::Convolver convolver(K, output); // K shall be synchronized. See ContiguousMatrix::synchronize
+     * for (...){
+     *      A.synchronize();
+     *      convolver.convolve(output, A);
+     * }
+     *
+     * The full synchronization may be replaced by the halo exchange overlapped with the computations:
+     * A.startHaloExchange(convolver.getHaloRows());
+     * convolver.convolveInterior(output, A);
+     * A.finishHaloExchange();
+     * convolver.convolveBoundary(output, A);
+     */
+    class Convolver {
+    public:
+        enum Method {AutoMethod, DirectMethod, FourierMethod, SeparableMethod};
+
+        typedef fft::Fft::Complex Complex;
+
+    private:
+        const ContiguousMatrix& kernel;
+        bool normalize;
+        Method method;
+        int width, height, iStart, iFinish;
+        int H, W;
+        int firstRow, lastRow, stripStart, stripFinish;
+        int paddedWidth, paddedHeight;
+
+        fft::Fft* rowFft = nullptr;
+        fft::Fft* columnFft = nullptr;
+        std::vector<Complex> kernelSpectrum;
+        std::vector<Complex> workspace;
+        std::vector<Complex> column;
+        std::vector<double> weights;
+        std::vector<double> horizontalFactor, verticalFactor;
+        std::vector<double> horizontalWeights, verticalWeights;
+        std::vector<double> rowBuffer;
+        std::vector<double> kernelValues;
+        std::vector<char> rowReady;
+        int interiorStart, interiorFinish;
+        bool interiorDone = false;
+
+        /**
+         * Relative cost of a single complex butterfly comparing to a single multiply-add operation
+         * of the direct convolution
+         */
+        static constexpr double FOURIER_COST_FACTOR = 4.0;
+
+        Method chooseMethod() const;
+        template<typename T> void initialize(const BasicMatrix<T>& target);
+        void initializeFourier();
+        void initializeSeparable();
+        void forwardTransform(int filledRows);
+        void inverseTransform();
+        template<typename T> void checkMatrices(const BasicMatrix<T>& output,
+                const BasicContiguousMatrix<T>& A) const;
+        template<typename T> void convolveRange(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A,
+                int indexStart, int indexFinish);
+        template<typename T> void directConvolve(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A,
+                int indexStart, int indexFinish);
+        template<typename T> void fourierConvolve(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A);
+        template<typename T> void separableConvolve(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A,
+                int indexStart, int indexFinish);
+
+    public:
+
+        /**
+         * Prepares the convolution. The kernel and all intermediate results are double precision while the source
+         * and the output matrices may be either double (T = double) or single (T = float) precision
+         *
+         * @param K the convolution kernel. The kernel shall be synchronized and shall not be destroyed before
+         * the convolver
+         * @param target any matrix which dimensions and responsibility area are the same as for the convolution
+         * results
+         * @param norm true if the convolution results shall be normalized. See Matrix::convolve for details
+         * @param m the convolution method. AutoMethod means that the method will be chosen automatically from the
+         * kernel and the matrix sizes
+         */
+        template<typename T>
+        Convolver(const ContiguousMatrix& K, const BasicMatrix<T>& target, bool norm = true, Method m = AutoMethod);
+
+        /**
+         * Prepares the convolution with the separable kernel K(i, j) = verticalFactor[i] * horizontalFactor[j]
+         *
+         * @param K the convolution kernel. The kernel shall be synchronized and shall not be destroyed before
+         * the convolver
+         * @param horizontal the kernel factor depending on the column index only, K.getWidth() items
+         * @param vertical the kernel factor depending on the row index only, K.getHeight() items
+         * @param target see above
+         * @param norm see above
+         * @param m see above
+         */
+        template<typename T>
+        Convolver(const ContiguousMatrix& K, const std::vector<double>& horizontal,
+                const std::vector<double>& vertical, const BasicMatrix<T>& target, bool norm = true,
+                Method m = AutoMethod);
+
+        Convolver(const Convolver& other) = delete;
+        Convolver& operator=(const Convolver& other) = delete;
+
+        ~Convolver();
+
+        /**
+         *
+         * @return the convolution method that was chosen for this convolver
+         */
+        [[nodiscard]] Method getMethod() const { return method; }
+
+        /**
+         * Provides the convolution. This is not a collective routine
+         *
+         * @param output the matrix where the results will be put. Dimensions of the matrix and its responsibility
+         * area shall be the same as the target matrix passed to the constructor
+         * @param A the source matrix. The matrix shall be synchronized at least within the responsibility area of
+         * the output extended by getHaloRows() rows
+         */
+        template<typename T> void convolve(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A);
+
+        /**
+         * Computes the convolution only for those pixels that don't depend on the data outside the responsibility
+         * area of the source matrix. The routine may be called during the halo exchange (see
+         * ContiguousMatrix::startHaloExchange) in order to overlap the computations with the data transmission.
+         * The remaining pixels shall be computed by convolveBoundary(...) when the exchange is finished.
+         * FourierMethod doesn't support such a splitting: all the pixels will be computed by convolveBoundary(...)
+         * This is not a collective routine
+         *
+         * @param output see convolve(...)
+         * @param A see convolve(...). Only the responsibility area of the matrix is required to be up to date
+         */
+        template<typename T> void convolveInterior(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A);
+
+        /**
+         * Computes the convolution for all pixels that were not computed by convolveInterior(...)
+         * This is not a collective routine
+         *
+         * @param output see convolve(...)
+         * @param A see convolve(...). The matrix shall be synchronized at least within getHaloRows() rows from
+         * the responsibility area (see ContiguousMatrix::synchronizeHalo)
+         */
+        template<typename T> void convolveBoundary(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A);
+
+        /**
+         *
+         * @return number of rows above and below the responsibility area which values are required for the
+         * convolution
+         */
+        [[nodiscard]] int getHaloRows() const { return H; }
+
+        /**
+         * Checks whether the kernel is separable, i.e., K(i, j) = vertical[i] * horizontal[j]
+         *
+         * @param K the kernel. The kernel shall be synchronized
+         * @param horizontal the vector where the factor depending on the column index will be written
+         * @param vertical the vector where the factor depending on the row index will be written
+         * @param tolerance maximum admissible deviation of the product from the kernel relatively to the kernel
+         * maximum
+         * @return true if the kernel is separable, false otherwise. The vectors are cleared in the last case
+         */
+        static bool factorize(const ContiguousMatrix& K, std::vector<double>& horizontal,
+                std::vector<double>& vertical, double tolerance = 1e-12);
+    };
+
+}
+
+
+#endif //MPI2_CONVOLVER_H
@@ -0,0 +1,71 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include "CoordinateGrid.h"
+
+namespace data {
+
+    template<typename T> CoordinateGrid::CoordinateGrid(const BasicMatrix<T> &matrix) {
+        auto span = matrix.localSpan();
+        x.resize(span.getSize());
+        y.resize(span.getSize());
+        for (int i = span.getFirstRow(), n = 0; i < span.getLastRow(); ++i){
+            double yi = span.getRowUm(i);
+            for (int j = span.getFirstColumn(i); j < span.getLastColumn(i); ++j, ++n){
+                x[n] = span.getColumnUm(j);
+                y[n] = yi;
+            }
+        }
+    }
+
+    std::map<CoordinateGrid::Key, std::weak_ptr<CoordinateGrid>>& CoordinateGrid::getRegistry() {
+        static std::map<Key, std::weak_ptr<CoordinateGrid>> registry;
+        return registry;
+    }
+
+    template<typename T> std::shared_ptr<CoordinateGrid> CoordinateGrid::getGrid(const BasicMatrix<T> &matrix) {
+        auto& registry = getRegistry();
+        Key key(matrix.getWidth(), matrix.getHeight(), matrix.getWidthUm(), matrix.getHeightUm(),
+                matrix.getIstart(), matrix.getIfinish());
+        auto grid = registry[key].lock();
+        if (!grid){
+            for (auto it = registry.begin(); it != registry.end();){
+                if (it->second.expired()){
+                    it = registry.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            grid = std::make_shared<CoordinateGrid>(matrix);
+            registry[key] = grid;
+        }
+        return grid;
+    }
+
+    const CoordinateGrid::Rotation& CoordinateGrid::getRotation(double theta) {
+        auto it = rotations.find(theta);
+        if (it == rotations.end()){
+            double ctheta = cos(theta);
+            double stheta = sin(theta);
+            int n = getSize();
+            Rotation rotation;
+            rotation.first.resize(n);
+            rotation.second.resize(n);
+            for (int k = 0; k < n; ++k){
+                rotation.first[k] = x[k] * ctheta + y[k] * stheta;
+                rotation.second[k] = x[k] * stheta - y[k] * ctheta;
+            }
+            it = rotations.emplace(theta, std::move(rotation)).first;
+        }
+        return it->second;
+    }
+
+    template CoordinateGrid::CoordinateGrid(const Matrix&);
+    template CoordinateGrid::CoordinateGrid(const MatrixF&);
+    template std::shared_ptr<CoordinateGrid> CoordinateGrid::getGrid(const Matrix&);
+    template std::shared_ptr<CoordinateGrid> CoordinateGrid::getGrid(const MatrixF&);
+
+}
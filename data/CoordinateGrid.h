@@ -0,0 +1,96 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_COORDINATEGRID_H
+#define MPI2_COORDINATEGRID_H
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "Matrix.h"
+
+namespace data {
+
+    /**
+     * Coordinates of the local pixels of the matrix in um. The element n of getX(), getY(), getLongitudinal(theta)
+     * or getTransverse(theta) corresponds to the local element n of the matrix (see BasicMatrix::localSpan()), so
+     * the rendering loops need no coordinate arithmetic:
+     *
+     * auto pixels = output->localSpan();
+     * const double* w = grid.getTransverse(theta);
+     * for (int n = 0; n < pixels.getSize(); ++n){
+     *     pixels[n] = L0 + A * cos(k * w[n] + phase);
+     * }
+     *
+     * The grids are shared: all matrices of the same geometry (size in pixels, size in um and the responsibility
+     * area) get the same grid from getGrid(). The grid is destroyed when the last of its owners releases it.
+     * The rotated coordinates are computed at the first request for a given orientation and kept until the grid
+     * is destroyed. The grid is created locally, getGrid() is not a collective routine
+     */
+    class CoordinateGrid {
+    private:
+        using Key = std::tuple<int, int, double, double, int, int>;
+        using Rotation = std::pair<std::vector<double>, std::vector<double>>;
+
+        std::vector<double> x, y;
+        std::map<double, Rotation> rotations;
+
+        static std::map<Key, std::weak_ptr<CoordinateGrid>>& getRegistry();
+
+        const Rotation& getRotation(double theta);
+
+    public:
+        /**
+         * Creates the grid. Use getGrid() to take the shared grid instead
+         *
+         * @param matrix the matrix which local elements shall be covered by the grid
+         */
+        template<typename T> explicit CoordinateGrid(const BasicMatrix<T>& matrix);
+
+        /**
+         *
+         * @param matrix the matrix
+         * @return the grid shared among all matrices of the same geometry
+         */
+        template<typename T> static std::shared_ptr<CoordinateGrid> getGrid(const BasicMatrix<T>& matrix);
+
+        /**
+         *
+         * @return number of the local pixels
+         */
+        [[nodiscard]] int getSize() const { return (int)x.size(); }
+
+        /**
+         *
+         * @return abscissas of all local pixels, equal to getColumnUm() of the matrix iterators
+         */
+        [[nodiscard]] const double* getX() const { return x.data(); }
+
+        /**
+         *
+         * @return ordinates of all local pixels, equal to getRowUm() of the matrix iterators
+         */
+        [[nodiscard]] const double* getY() const { return y.data(); }
+
+        /**
+         *
+         * @param theta orientation in radians
+         * @return x * cos(theta) + y * sin(theta) for all local pixels: the coordinate along the direction theta
+         */
+        const double* getLongitudinal(double theta) { return getRotation(theta).first.data(); }
+
+        /**
+         *
+         * @param theta orientation in radians
+         * @return x * sin(theta) - y * cos(theta) for all local pixels: the coordinate across the direction theta
+         */
+        const double* getTransverse(double theta) { return getRotation(theta).second.data(); }
+    };
+
+}
+
+
+#endif //MPI2_COORDINATEGRID_H
@@ -5,25 +5,27 @@
 
 #include <cstring>
 #include "LocalMatrix.h"
+#include "MatrixAllocator.h"
 #include "../Application.h"
 
 
 namespace data{
 
-    LocalMatrix::LocalMatrix(mpi::Communicator &comm, int width, int height, double widthUm, double heightUm,
-                             double filler): Matrix(comm, width, height, widthUm, heightUm, filler) {
-        data = new double[localSize];
+    template<typename T> BasicLocalMatrix<T>::BasicLocalMatrix(mpi::Communicator &comm, int width, int height,
+            double widthUm, double heightUm, double filler): Matrix(comm, width, height, widthUm, heightUm, filler) {
+        data = MatrixAllocator::allocate<T>(localSize);
         for (int i=0; i < localSize; i++){
             data[i] = filler;
         }
     }
 
-    LocalMatrix::LocalMatrix(const LocalMatrix &other):
+    template<typename T> BasicLocalMatrix<T>::BasicLocalMatrix(const BasicLocalMatrix &other):
         Matrix(other.communicator, other.width, other.height, other.widthUm, other.heightUm) {
         copyData(other);
     }
 
-    LocalMatrix& LocalMatrix::operator=(const LocalMatrix &other) {
+    template<typename T> BasicLocalMatrix<T>& BasicLocalMatrix<T>::operator=(const BasicLocalMatrix &other) {
+        bool reallocate = localSize != other.localSize;
         size = other.size;
         localSize = other.localSize;
         iStart = other.iStart;
@@ -32,16 +34,17 @@ namespace data{
         height = other.height;
         widthUm = other.widthUm;
         heightUm = other.heightUm;
-        if (width != other.width || height != other.height) {
-            delete[] data;
+        if (reallocate) {
+            MatrixAllocator::deallocate(data);
             copyData(other);
         } else {
-            memcpy(data, other.data, localSize * sizeof(double));
+            memcpy(data, other.data, localSize * sizeof(T));
         }
+        this->touch();
         return *this;
     }
 
-    LocalMatrix& LocalMatrix::operator=(LocalMatrix&& other) noexcept{
+    template<typename T> BasicLocalMatrix<T>& BasicLocalMatrix<T>::operator=(BasicLocalMatrix&& other) noexcept{
         size = other.size;
         localSize = other.localSize;
         iStart = other.iStart;
@@ -50,31 +53,33 @@ namespace data{
         height = other.height;
         widthUm = other.widthUm;
         heightUm = other.heightUm;
-        delete [] data;
+        MatrixAllocator::deallocate(data);
         data = other.data;
         other.data = nullptr;
+        this->touch();
         return *this;
     }
 
-    void LocalMatrix::copyData(const LocalMatrix& other){
-        data = new double[localSize];
-        std::memcpy(data, other.data, localSize*sizeof(double));
+    template<typename T> void BasicLocalMatrix<T>::copyData(const BasicLocalMatrix& other){
+        data = MatrixAllocator::allocate<T>(localSize);
+        std::memcpy(data, other.data, localSize*sizeof(T));
     }
 
-    LocalMatrix::~LocalMatrix() {
+    template<typename T> BasicLocalMatrix<T>::~BasicLocalMatrix() {
         if (data != nullptr) {
-            delete[] data;
+            MatrixAllocator::deallocate(data);
         }
     }
 
-    LocalMatrix LocalMatrix::operator-() const{
-        LocalMatrix B(communicator, width, height, widthUm, heightUm);
-        B.calculate(*this, [](Matrix::ConstantIterator& a){
+    template<typename T> BasicLocalMatrix<T> BasicLocalMatrix<T>::operator-() const{
+        BasicLocalMatrix B(communicator, width, height, widthUm, heightUm);
+        B.calculate(*this, [](typename Matrix::ConstantIterator& a){
             return -*a;
         });
         return B;
     }
 
-
+    template class BasicLocalMatrix<double>;
+    template class BasicLocalMatrix<float>;
 
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #define MPI2_LOCALMATRIX_H
 
 #include "Matrix.h"
+#include "MatrixExpression.h"
 #include "exceptions.h"
 
 namespace data {
@@ -19,16 +20,33 @@ namespace data {
      * generated
      *
      * Positives:
-     * The matrix requires small amount of memory (N*8/n per process, N*8 per application where N is total number
-     * of items in the matrix and n is number of processes).
+     * The matrix requires small amount of memory (N*sizeof(T)/n per process, N*sizeof(T) per application where N is
+     * total number of items in the matrix and n is number of processes).
      *
      * Negatives:
      * Any operations requiring the whole data in the matrix (e.g., transformation, nultiplication etc.) will generate
      * an exception within the local matrix
+     *
+     * @tparam T element type: double (data::LocalMatrix) or float (data::LocalMatrixF)
      */
-    class LocalMatrix: public Matrix {
+    template<typename T> class BasicLocalMatrix: public BasicMatrix<T> {
+    public:
+        using Matrix = BasicMatrix<T>;
+
+    protected:
+        using Matrix::size;
+        using Matrix::localSize;
+        using Matrix::iStart;
+        using Matrix::iFinish;
+        using Matrix::width;
+        using Matrix::height;
+        using Matrix::communicator;
+        using Matrix::widthUm;
+        using Matrix::heightUm;
+        using Matrix::data;
+
     private:
-        void copyData(const LocalMatrix& other);
+        void copyData(const BasicLocalMatrix& other);
 
     public:
 
@@ -42,7 +60,7 @@ namespace data {
          * @param heightUm matrix height in um or any other native physiological units
          * @param filler default value for all matrix items
          */
-        LocalMatrix(mpi::Communicator& comm, int width, int height, double widthUm, double heightUm,
+        BasicLocalMatrix(mpi::Communicator& comm, int width, int height, double widthUm, double heightUm,
                 double filler = 0);
 
         /**
@@ -50,9 +68,9 @@ namespace data {
          *
          * @param other the source matrix
          */
-        LocalMatrix(const LocalMatrix& other);
+        BasicLocalMatrix(const BasicLocalMatrix& other);
 
-        virtual ~LocalMatrix();
+        virtual ~BasicLocalMatrix();
 
         /**
          * Provides an access to the matrix element
@@ -60,7 +78,7 @@ namespace data {
          * @param index index of the element
          * @return alias to the element value
          */
-        double& operator[](int index) override{
+        T& operator[](int index) override{
             if (index >= iStart && index < iFinish){
                 return data[index - iStart];
             } else if (index >= 0 && index < size){
@@ -76,7 +94,7 @@ namespace data {
          * @param index index of the element
          * @return alias to the element value
          */
-        double operator[](int index) const override{
+        T operator[](int index) const override{
             if (index >= iStart && index < iFinish){
                 return data[index - iStart];
             } else if (index >= 0 && index < size){
@@ -102,8 +120,32 @@ namespace data {
             throw synchronization_error();
         }
 
-        LocalMatrix& operator=(const LocalMatrix& other);
-        LocalMatrix& operator=(LocalMatrix&& other) noexcept;
+        /**
+         * Matrix synchronization is not supported for local matrices
+         */
+        void startSynchronize() override{
+            throw synchronization_error();
+        }
+
+        /**
+         * Matrix synchronization is not supported for local matrices
+         *
+         * @param root
+         */
+        void startSynchronize(int root) override{
+            throw synchronization_error();
+        }
+
+        /**
+         * Matrix synchronization is not supported for local matrices
+         */
+        void waitSynchronize() override{
+            throw synchronization_error();
+        }
+
+        using Matrix::operator=;
+        BasicLocalMatrix& operator=(const BasicLocalMatrix& other);
+        BasicLocalMatrix& operator=(BasicLocalMatrix&& other) noexcept;
 
 
 
@@ -139,10 +181,10 @@ namespace data {
              * @param matrix reference to the matrix
              * @param index index of the element to refer to
              */
-            Iterator(LocalMatrix& matrix, int index): AbstractIterator(index), Matrix::Iterator(matrix, index),
+            Iterator(BasicLocalMatrix& matrix, int index): AbstractIterator(index), Matrix::Iterator(matrix, index),
                 Matrix::AbstractIterator(index) {
-                LocalMatrix* p = static_cast<LocalMatrix*>(parent);
-                pointer = p->data + index - p->iStart;
+                BasicLocalMatrix* p = static_cast<BasicLocalMatrix*>(this->parent);
+                this->pointer = p->data + index - p->iStart;
             }
 
             /**
@@ -152,14 +194,14 @@ namespace data {
              * @param row horizontal index
              * @param col vertical index
              */
-            Iterator(LocalMatrix& matrix, int row, int col): Iterator(matrix, row * matrix.width + col) {}
+            Iterator(BasicLocalMatrix& matrix, int row, int col): Iterator(matrix, row * matrix.width + col) {}
 
             /**
              * Default initialization: iterator points to the beginning of the responsibility area
              *
              * @param matrix iterable matrix
              */
-            Iterator(LocalMatrix& matrix): Iterator(matrix, matrix.iStart) {}
+            Iterator(BasicLocalMatrix& matrix): Iterator(matrix, matrix.iStart) {}
 
             /**
              * Copy constructor
@@ -167,7 +209,7 @@ namespace data {
              * @param other reference to the source iterator
              */
             Iterator(const Iterator& other):
-                Iterator(*static_cast<LocalMatrix*>(other.parent), other.index) {}
+                Iterator(*static_cast<BasicLocalMatrix*>(other.parent), other.index) {}
         };
 
         /**
@@ -181,10 +223,10 @@ namespace data {
              * @param matrix reference to the matrix
              * @param index single index
              */
-            ConstantIterator(const LocalMatrix& matrix, int index): AbstractIterator(index),
+            ConstantIterator(const BasicLocalMatrix& matrix, int index): AbstractIterator(index),
                 Matrix::ConstantIterator(matrix, index), Matrix::AbstractIterator(index) {
-                const LocalMatrix* p = static_cast<const LocalMatrix*>(parent);
-                pointer = p->data + index - p->iStart;
+                const BasicLocalMatrix* p = static_cast<const BasicLocalMatrix*>(this->parent);
+                this->pointer = p->data + index - p->iStart;
             }
 
             /**
@@ -194,7 +236,7 @@ namespace data {
              * @param row horizontal index
              * @param col vertical index
              */
-            ConstantIterator(const LocalMatrix& matrix, int row, int col):
+            ConstantIterator(const BasicLocalMatrix& matrix, int row, int col):
                 ConstantIterator(matrix, row * matrix.width + col) {}
 
             /**
@@ -202,7 +244,7 @@ namespace data {
              *
              * @param matrix reference to the matrix
              */
-            ConstantIterator(const LocalMatrix& matrix): ConstantIterator(matrix, matrix.iStart) {}
+            ConstantIterator(const BasicLocalMatrix& matrix): ConstantIterator(matrix, matrix.iStart) {}
 
             /**
              * Copy constructor
@@ -210,28 +252,31 @@ namespace data {
              * @param other reference to another iterator
              */
             ConstantIterator(const ConstantIterator& other):
-                ConstantIterator(*static_cast<const LocalMatrix*>(other.parent), other.index) {}
+                ConstantIterator(*static_cast<const BasicLocalMatrix*>(other.parent), other.index) {}
         };
 
-        Matrix::Iterator begin(){
+        typename Matrix::Iterator begin(){
             return Iterator(*this);
         }
 
-        Matrix::ConstantIterator cbegin() const{
+        typename Matrix::ConstantIterator cbegin() const{
             return ConstantIterator(*this);
         }
 
-        Matrix::Iterator end(){
+        typename Matrix::Iterator end(){
             return Iterator(*this, iFinish);
         }
 
-        Matrix::ConstantIterator cend() const{
+        typename Matrix::ConstantIterator cend() const{
             return ConstantIterator(*this, iFinish);
         }
 
-        LocalMatrix operator-() const;
+        BasicLocalMatrix operator-() const;
     };
 
+    using LocalMatrix = BasicLocalMatrix<double>;
+    using LocalMatrixF = BasicLocalMatrix<float>;
+
 }
 
 
@@ -0,0 +1,151 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_LOCALSPAN_H
+#define MPI2_LOCALSPAN_H
+
+#include <algorithm>
+
+namespace data {
+
+    /**
+     * A non-virtual accessor to the responsibility area of the matrix. The span is a plain view of the local data:
+     * it has no virtual functions, its methods compute nothing more than an index or a single multiplication, so
+     * loops over the span can be inlined and vectorized by the compiler. Use it instead of the matrix iterators
+     * in the hot loops.
+     *
+     * The responsibility area may start and finish in the middle of a row. The span provides:
+     * - flat access to the local elements (operator[], begin(), end(), getSize()); the local index 0 corresponds to
+     * getIstart() of the matrix. Matrices of the same size distributed among the same communicator have the same
+     * local indices, so the element-wise loops may use the flat index only;
+     * - 2D access with the global row and column (operator()(i, j)); the local rows are
+     * getFirstRow() <= i < getLastRow(), the local columns of the row i are getFirstColumn(i) <= j < getLastColumn(i);
+     * - the row and column coordinates in um, equal to getRowUm() and getColumnUm() of the matrix iterators.
+     *
+     * Example:
+     * auto span = matrix.localSpan();
+     * for (int i = span.getFirstRow(); i < span.getLastRow(); ++i){
+     *     double y = span.getRowUm(i);
+     *     for (int j = span.getFirstColumn(i); j < span.getLastColumn(i); ++j){
+     *         span(i, j) = f(span.getColumnUm(j), y);
+     *     }
+     * }
+     *
+     * The span doesn't own the data and shall not outlive the matrix. The span is invalidated by any operation
+     * that reallocates the matrix data (assignment from a matrix of other size, move etc.)
+     *
+     * @tparam T element type: double or float for read-and-write access, const double or const float for read-only
+     * access
+     */
+    template<typename T> class BasicLocalSpan {
+    private:
+        T* data;
+        int iStart, iFinish, width;
+        int rowOrigin, columnOrigin;
+        double rowScale, columnScale;
+
+    public:
+        /**
+         * Creates the span. Use BasicMatrix::localSpan() instead
+         *
+         * @param data pointer to the first element of the responsibility area
+         * @param iStart the first index within the responsibility area
+         * @param iFinish the index next to the last one within the responsibility area
+         * @param width the matrix width in pixels
+         * @param height the matrix height in pixels
+         * @param widthUm the matrix width in um
+         * @param heightUm the matrix height in um
+         */
+        BasicLocalSpan(T* data, int iStart, int iFinish, int width, int height, double widthUm, double heightUm):
+            data(data), iStart(iStart), iFinish(iFinish), width(width),
+            rowOrigin(height / 2), columnOrigin(width / 2),
+            rowScale(heightUm / (height - 1)), columnScale(widthUm / (width - 1)) {};
+
+        /**
+         *
+         * @return number of the local elements
+         */
+        [[nodiscard]] int getSize() const { return iFinish - iStart; }
+
+        /**
+         *
+         * @return the first index within the responsibility area
+         */
+        [[nodiscard]] int getIstart() const { return iStart; }
+
+        /**
+         *
+         * @return the index next to the last one within the responsibility area
+         */
+        [[nodiscard]] int getIfinish() const { return iFinish; }
+
+        /**
+         *
+         * @return the first row containing local elements
+         */
+        [[nodiscard]] int getFirstRow() const { return iStart / width; }
+
+        /**
+         *
+         * @return the row next to the last row containing local elements
+         */
+        [[nodiscard]] int getLastRow() const { return (iFinish + width - 1) / width; }
+
+        /**
+         *
+         * @param i the row, getFirstRow() <= i < getLastRow()
+         * @return the first local column of the row
+         */
+        [[nodiscard]] int getFirstColumn(int i) const { return std::max(iStart - i * width, 0); }
+
+        /**
+         *
+         * @param i the row, getFirstRow() <= i < getLastRow()
+         * @return the column next to the last local column of the row
+         */
+        [[nodiscard]] int getLastColumn(int i) const { return std::min(iFinish - i * width, width); }
+
+        /**
+         *
+         * @param i the row
+         * @return the row coordinate in um
+         */
+        [[nodiscard]] double getRowUm(int i) const { return (rowOrigin - i) * rowScale; }
+
+        /**
+         *
+         * @param j the column
+         * @return the column coordinate in um
+         */
+        [[nodiscard]] double getColumnUm(int j) const { return (j - columnOrigin) * columnScale; }
+
+        /**
+         *
+         * @param n the local index, 0 <= n < getSize()
+         * @return the local element
+         */
+        T& operator[](int n) const { return data[n]; }
+
+        /**
+         *
+         * @param i the row
+         * @param j the column
+         * @return the element (i, j) which shall belong to the responsibility area
+         */
+        T& operator()(int i, int j) const { return data[i * width + j - iStart]; }
+
+        T* begin() const { return data; }
+        T* end() const { return data + (iFinish - iStart); }
+    };
+
+    using LocalSpan = BasicLocalSpan<double>;
+    using ConstLocalSpan = BasicLocalSpan<const double>;
+    using LocalSpanF = BasicLocalSpan<float>;
+    using ConstLocalSpanF = BasicLocalSpan<const float>;
+
+}
+
+
+#endif //MPI2_LOCALSPAN_H
@@ -3,15 +3,59 @@
 // (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
 //
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include "LuDecomposer.h"
+#include "LocalMatrix.h"
+#include "MatrixAllocator.h"
+#include "simd/Kernels.h"
+#include "../mpi/Datatype.h"
 #include "../Application.h"
 #include "../log/output.h"
 
 namespace data {
 
-    LuDecomposer::LuDecomposer(ContiguousMatrix& source, const std::string& userPrompt, int userInterval):
-        A(source), comm(source.getCommunicator()), _a(source, 0), prompt(userPrompt), interval(userInterval),
-        decomposingData(nullptr){
+    namespace {
+
+        template<typename T> MPI_Datatype getFactorDatatype();
+        template<> MPI_Datatype getFactorDatatype<double>() { return MPI_DOUBLE; }
+        template<> MPI_Datatype getFactorDatatype<float>() { return MPI_FLOAT; }
+
+        const char CACHE_SIGNATURE[16] = "#!vis-brain.lu";
+        const int CACHE_VERSION = 1;
+
+        /**
+         * Header of the cache file. The header is followed by the pivots (N int numbers) and the factors (N x N float
+         * or double numbers stored by rows, L below the diagonal, U on and above the diagonal) aligned to 8 bytes
+         */
+        struct CacheHeader {
+            char signature[16];
+            int version;
+            int precision;
+            int size;
+            int reserved;
+            unsigned long long hash;
+            double norm;
+            char padding[16];
+        };
+
+        unsigned long long mixHash(unsigned long long x){
+            x += 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+
+    }
+
+    LuDecomposer::LuDecomposer(ContiguousMatrix& source, const std::string& userPrompt, int userInterval,
+            Precision userPrecision):
+        comm(source.getCommunicator()), A(source), _a(source, 0), prompt(userPrompt), interval(userInterval),
+        distribution(source.getCommunicator(), source.getHeight(), source.getWidth(), LU_BLOCK_SIZE),
+        precision(userPrecision){
 
         if (A.getWidth() != A.getHeight()){
             throw square_matrix_required();
@@ -20,402 +64,462 @@ namespace data {
         N = A.getWidth();
         n = comm.getProcessorNumber();
         r = comm.getRank();
-        i = j = -1;
-        decomposingData = new double[N*N];
-        initializeP();
-        lBest = new double[N*n];
-        lBestLocal = new double[N];
-        uLocal = lBestLocal; // Because these buffers will be used at different times
-        uTotal = lBest; // Because these buffers will be used at different times
-        uBest = new double[n];
-        pBest = new int[n];
+        blockSize = distribution.getBlockSize();
+        localRows = distribution.getLocalRows();
+        localColumns = distribution.getLocalColumns();
+        gridRow = distribution.getGridRow();
+        gridColumn = distribution.getGridColumn();
+
+        allocateBuffers();
+        pivots = new int[N];
+        P = new int[N];
+        inverseP = new int[N];
+        computationTime = 0.0;
+        transmissionTime = 0.0;
+        normA = 0.0;
+        refinementIterations = 0;
+        refinementResidual = 0.0;
 
         if (prompt != ""){
             Application::getInstance().time();
             logging::progress(0, N, prompt);
-            computationTime = 0.0;
-            transmissionTime = 0.0;
         }
 
         decompose();
     }
 
     LuDecomposer::~LuDecomposer(){
-        delete [] decomposingData;
-        delete [] lBest;
-        delete [] lBestLocal;
-        delete [] uBest;
-        delete [] pBest;
+        deleteBuffers();
+        delete [] pivots;
+        delete [] P;
+        delete [] inverseP;
     }
 
-    void LuDecomposer::initializeP() {
-        P = new int[N];
-        for (i=0; i < N; ++i){
-            P[i] = i;
-        }
+    void LuDecomposer::allocateBuffers(){
+        std::size_t elementSize = precision == MixedPrecision ? sizeof(float) : sizeof(double);
+        factors = MatrixAllocator::allocateBytes((std::size_t)localRows * localColumns * elementSize);
+        panel = MatrixAllocator::allocateBytes((std::size_t)localRows * blockSize * elementSize);
+        upperPanel = MatrixAllocator::allocateBytes((std::size_t)blockSize * localColumns * elementSize);
+    }
+
+    void LuDecomposer::deleteBuffers(){
+        MatrixAllocator::deallocate(factors);
+        MatrixAllocator::deallocate(panel);
+        MatrixAllocator::deallocate(upperPanel);
     }
 
 #if DEBUG==1
     void LuDecomposer::printDebugInformation(){
-        double value;
-        int row, col;
-
         using namespace std;
         logging::enter();
         if (r == 0){
             logging::debug("Decomposition results:");
             logging::debug("Total number of items in the matrix: " + to_string(N));
             logging::debug("Total number of processes: " + to_string(n));
-            logging::debug("Rank of the current process: " + to_string(r));
-            logging::debug("Current row: " + to_string(i));
-            logging::debug("Current column: " + to_string(j));
-            logging::debug("L matrix info:");
-            logging::debug("(0, 0): " + to_string(L(0, 0)));
-            logging::debug("(0, N-1): " + to_string(L(0, N-1)));
-            logging::debug("(N-1, 0): " + to_string(L(N-1, 0)));
-            logging::debug("(N-1, N-1): " + to_string(L(N-1, N-1)));
-            getLmax(value, row, col);
-            logging::debug("Max. value: " + to_string(value) + " at (" + to_string(row) + ", " + to_string(col) + ")");
-            getLmin(value, row, col);
-            logging::debug("Min. value: " + to_string(value) + " at (" + to_string(row) + ", " + to_string(col) + ")");
-            logging::debug("filled cells: " + to_string(getLfilled()));
-            logging::debug("U matrix info:");
-            logging::debug("(0, 0): " + to_string(U(0, 0)));
-            logging::debug("(0, N-1): " + to_string(U(0, N-1)));
-            logging::debug("(N-1, 0): " + to_string(U(N-1, 0)));
-            logging::debug("(N-1, N-1): " + to_string(U(N-1, N-1)));
-            getUmax(value, row, col);
-            logging::debug("Max. value: " + to_string(value) + " at (" + to_string(row) + ", " + to_string(col) + ")");
-            getUmin(value, row, col);
-            logging::debug("Min. value: " + to_string(value) + " at (" + to_string(row) + ", " + to_string(col) + ")");
-            logging::debug("filled cells: " + to_string(getUfilled()));
-            logging::debug("uBest:");
-            for (int k = 0; k < n; ++k){
-                logging::debug(to_string(uBest[k]));
-            }
-            logging::debug("pBest: ");
-            for (int k = 0; k < n; ++k){
-                logging::debug(to_string(pBest[k]));
-            }
-            logging::debug("lBest = uTotal = :");
-            for (int k = 0; k < n; ++k){
-                double* bestRow = lBest + N*k;
-                std::string S = "";
-                for (int j=0; j < 5; ++j){
-                    S += to_string(bestRow[j]) + "\t";
-                }
-                S += "...";
-                logging::debug(S);
-            }
+            logging::debug("Process grid: " + to_string(distribution.getGridRows()) + " x " +
+                to_string(distribution.getGridColumns()));
+            logging::debug("Block size: " + to_string(blockSize));
+            logging::debug(precision == MixedPrecision ? "Precision: mixed" : "Precision: double");
+            logging::debug("L(N-1, 0) = " + to_string(isLocal(N-1, 0) ? L(N-1, 0) : NAN));
+            logging::debug("U(0, 0) = " + to_string(U(0, 0)));
             logging::debug("");
         }
+        logging::debug("Rank of the current process: " + to_string(r));
+        logging::debug("Position in the process grid: (" + to_string(gridRow) + ", " + to_string(gridColumn) + ")");
+        logging::debug("Local part of L and U: " + to_string(localRows) + " x " + to_string(localColumns));
         logging::debug("Computation time: " + to_string(computationTime));
         logging::debug("Transmission time: " + to_string(transmissionTime));
         logging::debug("Total time: " + to_string(computationTime + transmissionTime));
-        logging::debug("pStart = " + to_string(pStart));
-        logging::debug("pFinish = " + to_string(pFinish));
-        logging::debug("pConsequtive = " + to_string(pConsequtive));
-        logging::debug("jStart = " + to_string(jStart));
-        logging::debug("jFinish = " + to_string(jFinish));
-        logging::debug("uBestLocal = " + to_string(uBestLocal));
-        logging::debug("pBestLocal = " + to_string(pBestLocal));
-        std::string S = "lBestLocal = uLocal = ";
-        for (int j=0; j < 5; ++j){
-            S += to_string(lBestLocal[j]) + "\t";
-        }
-        S += "...";
-        logging::debug(S);
         logging::debug("");
         logging::exit();
     }
+#endif
 
-    void LuDecomposer::getUmax(double &value, int &row, int &col) {
-        value = u(0, 0);
-        row = col = 0;
-        for (i=1; i < N; ++i){
-            for (j=i; j < N; ++j){
-                if (abs(u(i,j)) > abs(value)){
-                    value = u(i,j);
-                    row = i;
-                    col = j;
-                }
-            }
-        }
+    void LuDecomposer::checkComputationTime(){
+        Application::getInstance().time();
+        computationTime += Application::getInstance().getLocalDifference();
     }
 
-    void LuDecomposer::getUmin(double &value, int &row, int &col) {
-        value = u(0, 0);
-        row = col = 0;
-        for (int i=1; i < N; ++i){
-            for (int j=i; j < N; ++j){
-                if (abs(u(i, j)) < abs(value)){
-                    value = u(i, j);
-                    row = i;
-                    col = j;
-                }
-            }
-        }
+    void LuDecomposer::checkTransmissionTime(){
+        Application::getInstance().time();
+        transmissionTime += Application::getInstance().getLocalDifference();
     }
 
-    void LuDecomposer::getLmax(double &value, int &row, int &col) {
-        value = l(1, 0);
-        row = 1, col = 0;
-        for (i = 2; i < N; ++i){
-            for (j = 0; j < i; ++j){
-                if (abs(l(i, j)) > abs(value)){
-                    value = l(i, j);
-                    row = i;
-                    col = j;
-                }
+    void LuDecomposer::decompose(){
+        std::string filename;
+        unsigned long long hash = 0;
+        if (!getCacheDirectory().empty()){
+            hash = getSourceHash();
+            filename = getCacheFilename(hash);
+            if (loadFactors(filename, hash)){
+                return;
             }
         }
+        if (precision == MixedPrecision){
+            decomposeFactors<float>();
+        } else {
+            decomposeFactors<double>();
+        }
+        if (!filename.empty()){
+            saveFactors(filename, hash);
+        }
     }
 
-    void LuDecomposer::getLmin(double &value, int &row, int &col) {
-        value = l(1, 0);
-        row = 1, col = 0;
-        for (i = 2; i < N; ++i){
-            for (j = 0; j < i; ++j){
-                if (abs(l(i, j)) < abs(value)){
-                    value = l(i, j);
-                    row = i;
-                    col = j;
-                }
-            }
-        }
+    std::string& LuDecomposer::getCacheLocation(){
+        static std::string location;
+        return location;
     }
 
-    int LuDecomposer::getLfilled() {
-        int filled = 0;
-        for (int i=0; i < N; ++i){
-            for (int j = 0; j < i; ++j){
-                if (l(i, j) != 0){
-                    ++filled;
-                }
-            }
+    unsigned long long LuDecomposer::getSourceHash() const{
+        /* The sum of the hashes of separate elements doesn't depend on how the matrix is distributed */
+        unsigned long long localHash = 0, hash;
+        for (int index = A.getIstart(); index < A.getIfinish(); ++index){
+            double value = A[index];
+            unsigned long long bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            localHash += mixHash(bits ^ mixHash((unsigned long long)index));
         }
-        return filled;
+        comm.allReduce(&localHash, &hash, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM);
+        return hash;
     }
 
-    int LuDecomposer::getUfilled() {
-        int filled = 0;
-        for (int i=0; i < N; ++i){
-            for (int j = i; j < N; ++j){
-                if (u(i, j) != 0){
-                    ++filled;
-                }
-            }
+    std::string LuDecomposer::getCacheFilename(unsigned long long hash) const{
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx", hash);
+        return getCacheDirectory() + "/lu-" + name + "-" + std::to_string(N) +
+            (precision == MixedPrecision ? "-mixed.bin" : "-double.bin");
+    }
+
+    MPI_Offset LuDecomposer::getCacheDataOffset() const{
+        MPI_Offset offset = sizeof(CacheHeader) + (MPI_Offset)N * sizeof(int);
+        return (offset + 7) / 8 * 8;
+    }
+
+    void LuDecomposer::transferCachedFactors(mpi::File &file, bool write){
+        MPI_Datatype elementType = precision == MixedPrecision ? MPI_FLOAT : MPI_DOUBLE;
+        int sizes[2] = {N, N};
+        int distributions[2] = {MPI_DISTRIBUTE_CYCLIC, MPI_DISTRIBUTE_CYCLIC};
+        int blocks[2] = {blockSize, blockSize};
+        int grid[2] = {distribution.getGridRows(), distribution.getGridColumns()};
+        mpi::ArrayDatatype fileType(elementType, n, r, 2, sizes, distributions, blocks, grid);
+        file.setView(getCacheDataOffset(), elementType, fileType);
+        if (write){
+            file.writeAll(factors, localRows * localColumns, elementType);
+        } else {
+            file.readAll(factors, localRows * localColumns, elementType);
         }
-        return filled;
     }
-#endif
 
-    void LuDecomposer::decompose(){
-        decomposeFirstRow();
-        for (i = 1; i < N; ++i){
-            computeLBestParallel();
-            computeUConsequtive();
-            if (i % interval == 0){
-                logging::progress(i, N);
-            }
-            /*
-            if (i == 300){
-                break;
+    bool LuDecomposer::loadFactors(const std::string &filename, unsigned long long hash){
+        CacheHeader header = {};
+        int valid = 0;
+        if (r == 0){
+            MPI_Offset elementSize = precision == MixedPrecision ? sizeof(float) : sizeof(double);
+            std::ifstream file(filename, std::ios::binary | std::ios::ate);
+            if (file && (MPI_Offset)file.tellg() >= getCacheDataOffset() + (MPI_Offset)N * N * elementSize){
+                file.seekg(0);
+                file.read((char*)&header, sizeof(header));
+                file.read((char*)pivots, (std::streamsize)N * sizeof(int));
+                valid = file && std::strncmp(header.signature, CACHE_SIGNATURE, sizeof(header.signature)) == 0 &&
+                        header.version == CACHE_VERSION && header.precision == (int)precision &&
+                        header.size == N && header.hash == hash;
             }
-             */
         }
-    }
+        comm.broadcast(&valid, 1, MPI_INT, 0);
+        if (!valid){
+            return false;
+        }
+        comm.broadcast(&header.norm, 1, MPI_DOUBLE, 0);
+        comm.broadcast(pivots, N, MPI_INT, 0);
+        normA = header.norm;
 
-    void LuDecomposer::decomposeFirstRow() {
-        double maxDiagonal;
-        int row;
-        i = 0;
-        searchMaxDiagonal(maxDiagonal, row);
-        chooseBest(maxDiagonal, row);
-        initU();
+        mpi::File file(comm, filename, MPI_MODE_RDONLY);
+        transferCachedFactors(file, false);
+        computePermutation();
+        return true;
     }
 
-    void LuDecomposer::searchMaxDiagonal(double& value, int& row){
-        value = 0.0;
-        int load = ceil((double)N/n);
-        int iStart = r * load;
-        int iFinish = iStart + load;
-        if (iFinish > N){
-            iFinish = N;
+    void LuDecomposer::saveFactors(const std::string &filename, unsigned long long hash){
+        /* The file is written under the temporary name, so the other runs never see the incomplete factors */
+        std::string temporary = filename + ".tmp";
+        if (r == 0){
+            std::remove(temporary.c_str());
+        }
+        comm.barrier();
+        int failed = 0, anyFailed;
+        {
+            mpi::File file;
+            try{
+                file = mpi::File(comm, temporary, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+                if (r == 0){
+                    CacheHeader header = {};
+                    std::strncpy(header.signature, CACHE_SIGNATURE, sizeof(header.signature));
+                    header.version = CACHE_VERSION;
+                    header.precision = (int)precision;
+                    header.size = N;
+                    header.hash = hash;
+                    header.norm = normA;
+                    file.writeAt(0, &header, sizeof(header), MPI_BYTE);
+                    file.writeAt(sizeof(header), pivots, N, MPI_INT);
+                }
+            } catch (std::exception&){
+                failed = 1;
+            }
+            /* The factors are written by the collective routine, so either all processes call it or none */
+            comm.allReduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX);
+            if (!anyFailed){
+                try{
+                    transferCachedFactors(file, true);
+                } catch (std::exception&){
+                    failed = 1;
+                }
+                comm.allReduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX);
+            }
         }
-        for (int i = iStart; i < iFinish; ++i){
-            if (abs(a(i,0)) > value){
-                value = a(i, 0);
-                row = i;
+        if (anyFailed){
+            if (r == 0){
+                std::remove(temporary.c_str());
+            }
+            logging::warning("Unable to save the LU factorization into the cache file " + filename);
+        } else if (r == 0){
+            std::rename(temporary.c_str(), filename.c_str());
+        }
+    }
+
+    template<typename T> void LuDecomposer::decomposeFactors(){
+        loadSource<T>();
+        for (int k0 = 0; k0 < N; k0 += blockSize){
+            int kb = std::min(blockSize, N - k0);
+            factorizePanel<T>(k0, kb);
+            applyInterchanges<T>(k0, kb);
+            broadcastPanel<T>(k0, kb);
+            computeUpperPanel<T>(k0, kb);
+            updateTrailingMatrix<T>(k0, kb);
+            if ((k0 + kb) / interval != k0 / interval){
+                logging::progress(k0 + kb, N);
             }
         }
-        checkComputationTime();
+        computePermutation();
     }
 
-    void LuDecomposer::chooseBest(double uBest_local, int pBest_local) {
-        comm.allGather(&uBest_local, 1, MPI_DOUBLE, uBest, 1, MPI_DOUBLE);
-        comm.allGather(&pBest_local, 1, MPI_INT, pBest, 1, MPI_INT);
-        double uBestBest = 0.0;
-        int pBestBest;
-        for (int k=0; k < n; ++k){
-            if (abs(uBest[k]) > uBestBest){
-                uBestBest = uBest[k];
-                pBestBest = pBest[k];
+    template<typename T> void LuDecomposer::loadSource(){
+        std::vector<double> rowSums(localRows + 1, 0.0);
+        for (int li = 0; li < localRows; ++li){
+            int i = distribution.getGlobalRow(li);
+            for (int lj = 0; lj < localColumns; ++lj){
+                double value = a(i, distribution.getGlobalColumn(lj));
+                factor<T>(li, lj) = (T)value;
+                rowSums[li] += fabs(value);
             }
         }
-        P[i] = pBestBest;
-        P[pBestBest] = i;
-        checkTransmissionTime();
-    }
-
-    void LuDecomposer::checkComputationTime(){
-        Application::getInstance().time();
-        computationTime += Application::getInstance().getLocalDifference();
-    }
-
-    void LuDecomposer::checkTransmissionTime(){
-        Application::getInstance().time();
-        transmissionTime += Application::getInstance().getLocalDifference();
-    }
+        checkComputationTime();
 
-    void LuDecomposer::initU(){
-       for (j = i; j < N; ++j){
-            u(i, j) = pa(i, j);
-       }
-       checkComputationTime();
+        /* ||A|| (the maximum absolute row sum) is required for the convergence criterion of the refinement */
+        if (precision == MixedPrecision){
+            std::vector<double> totalSums(localRows + 1);
+            distribution.getRowCommunicator().allReduce(&rowSums[0], &totalSums[0], localRows, MPI_DOUBLE, MPI_SUM);
+            double localNorm = localRows > 0 ? *std::max_element(totalSums.begin(), totalSums.end() - 1) : 0.0;
+            comm.allReduce(&localNorm, &normA, 1, MPI_DOUBLE, MPI_MAX);
+            checkTransmissionTime();
+        }
     }
 
-    void LuDecomposer::computeLBestParallel() {
-        int total_load = N - i;
-        int local_load = total_load / n + (total_load % n != 0);
-        if (local_load == 0){
-            pConsequtive = i;
+    template<typename T> void LuDecomposer::factorizePanel(int k0, int kb){
+        if (gridColumn != distribution.getColumnOwner(k0)){
             return;
         }
-        pStart = i + r * local_load;
-        pFinish = pStart + local_load;
-        if (pFinish > N) pFinish = N;
-        pConsequtive = i + n * local_load;
-        uBestLocal = 0.0;
-        for (p = pStart; p < pFinish; ++p){
-            computeLConsequtive(p);
-            computeUDiagonal(p);
-            if (abs(u(i, i)) > uBestLocal){
-                checkUBestLocal(p);
+        auto& columnCommunicator = distribution.getColumnCommunicator();
+        int lc0 = distribution.getLocalColumnsBefore(k0);
+        std::vector<T> pivotRow(kb);
+        struct { double value; int row; } localBest, best;
+
+        for (int jj = 0; jj < kb; ++jj){
+            int j = k0 + jj;
+            int lj = lc0 + jj;
+
+            /* Partial pivoting: the row with the maximum absolute value in the current column */
+            localBest.value = -1.0;
+            localBest.row = -1;
+            for (int li = distribution.getLocalRowsBefore(j); li < localRows; ++li){
+                double value = fabs(factor<T>(li, lj));
+                if (value > localBest.value){
+                    localBest.value = value;
+                    localBest.row = distribution.getGlobalRow(li);
+                }
+            }
+            checkComputationTime();
+            columnCommunicator.allReduce(&localBest, &best, 1, MPI_DOUBLE_INT, MPI_MAXLOC);
+            pivots[j] = best.row;
+            exchangeRows<T>(j, best.row, lc0, lc0 + kb, lc0 + kb, lc0 + kb);
+
+            int owner = distribution.getRowOwner(j);
+            if (gridRow == owner){
+                T* row = &factor<T>(distribution.getLocalRow(j), lj);
+                std::copy(row, row + kb - jj, pivotRow.begin());
             }
+            columnCommunicator.broadcast(&pivotRow[0], kb - jj, getFactorDatatype<T>(), owner);
+            checkTransmissionTime();
+
+            T pivot = pivotRow[0];
+            for (int li = distribution.getLocalRowsBefore(j + 1); li < localRows; ++li){
+                T* row = &factor<T>(li, lj);
+                T l = row[0] /= pivot;
+                for (int c = 1; c < kb - jj; ++c){
+                    row[c] -= l * pivotRow[c];
+                }
+            }
+            checkComputationTime();
         }
-        checkComputationTime();
-        chooseLBest();
     }
 
-    void LuDecomposer::computeLConsequtive(int p0){
-        for (j = 0; j < i; ++j){
-            l(i, j) = pa(p0, j);
-            for (int k=0; k < j; ++k){
-                l(i, j) -= l(i, k) * u(k, j);
-            }
-            l(i, j) /= u(j, j);
+    template<typename T> void LuDecomposer::exchangeRows(int i1, int i2, int columnStart, int columnFinish,
+            int skipStart, int skipFinish){
+        if (i1 == i2){
+            return;
+        }
+        int owner1 = distribution.getRowOwner(i1);
+        int owner2 = distribution.getRowOwner(i2);
+        if (gridRow != owner1 && gridRow != owner2){
+            return;
         }
-    }
 
-    void LuDecomposer::computeUDiagonal(int p0){
-        u(i, i) = pa(p0, i);
-        for (int k=0; k < i; ++k){
-            u(i, i) -= l(i, k) * u(k, i);
+        if (owner1 == owner2){
+            T* row1 = &factor<T>(distribution.getLocalRow(i1), 0);
+            T* row2 = &factor<T>(distribution.getLocalRow(i2), 0);
+            std::swap_ranges(row1 + columnStart, row1 + skipStart, row2 + columnStart);
+            std::swap_ranges(row1 + skipFinish, row1 + columnFinish, row2 + skipFinish);
+            return;
         }
-    }
 
-    void LuDecomposer::checkUBestLocal(int p0) {
-        for (int k = 0; k < i; ++k){
-            lBestLocal[k] = l(i, k);
+        /* The swap buffer is double for both precisions, the float values are converted exactly */
+        int other = gridRow == owner1 ? owner2 : owner1;
+        T* row = &factor<T>(distribution.getLocalRow(gridRow == owner1 ? i1 : i2), 0);
+        int count = columnFinish - columnStart - (skipFinish - skipStart);
+        swapBuffer.resize(2 * count + 1);
+        double* sendBuffer = &swapBuffer[0];
+        double* receiveBuffer = sendBuffer + count;
+        double* pointer = std::copy(row + columnStart, row + skipStart, sendBuffer);
+        std::copy(row + skipFinish, row + columnFinish, pointer);
+        distribution.getColumnCommunicator().sendrecv(sendBuffer, count, MPI_DOUBLE, other, ROW_EXCHANGE_TAG,
+                receiveBuffer, count, MPI_DOUBLE, other, ROW_EXCHANGE_TAG);
+        std::copy(receiveBuffer, receiveBuffer + (skipStart - columnStart), row + columnStart);
+        std::copy(receiveBuffer + (skipStart - columnStart), receiveBuffer + count, row + skipFinish);
+    }
+
+    template<typename T> void LuDecomposer::applyInterchanges(int k0, int kb){
+        /* All processes need the pivots in order to compute P and to apply the interchanges to their columns */
+        int owner = distribution.getColumnOwner(k0);
+        distribution.getRowCommunicator().broadcast(pivots + k0, kb, MPI_INT, owner);
+        int lc0 = distribution.getLocalColumnsBefore(k0);
+        int lc1 = gridColumn == owner ? lc0 + kb : lc0;
+        for (int j = k0; j < k0 + kb; ++j){
+            exchangeRows<T>(j, pivots[j], 0, localColumns, lc0, lc1);
         }
-        uBestLocal = u(i, i);
-        pBestLocal = p0;
+        checkTransmissionTime();
     }
 
-    void LuDecomposer::chooseLBest(){
-        comm.allGather(lBestLocal, N, MPI_DOUBLE, lBest, N, MPI_DOUBLE);
-        comm.allGather(&uBestLocal, 1, MPI_DOUBLE, uBest, 1, MPI_DOUBLE);
-        comm.allGather(&pBestLocal, 1, MPI_INT, pBest, 1, MPI_INT);
-        double uBestBest = 0.0;
-        int k0;
-        for (int k=0; k < n; ++k){
-            if (abs(uBest[k]) > uBestBest){
-                uBestBest = uBest[k];
-                k0 = k;
-            }
+    template<typename T> void LuDecomposer::broadcastPanel(int k0, int kb){
+        int owner = distribution.getColumnOwner(k0);
+        int lr0 = distribution.getLocalRowsBefore(k0);
+        int rows = localRows - lr0;
+        T* buffer = static_cast<T*>(panel);
+        if (rows == 0){
+            return;
         }
-        int pBestBest = pBest[k0];
-        double* lBestBest = lBest + N * k0;
-        int index = P[pBestBest];
-        P[pBestBest] = P[i];
-        P[i] = index;
-        for (int j = 0; j < i; ++j){
-            l(i, j) = lBestBest[j];
+        if (gridColumn == owner){
+            int lc0 = distribution.getLocalColumnsBefore(k0);
+            for (int li = lr0; li < localRows; ++li){
+                std::copy(&factor<T>(li, lc0), &factor<T>(li, lc0) + kb, buffer + (li - lr0) * kb);
+            }
         }
-        u(i, i) = uBestBest;
+        distribution.getRowCommunicator().broadcast(buffer, rows * kb, getFactorDatatype<T>(), owner);
         checkTransmissionTime();
     }
 
-    void LuDecomposer::computeUConsequtive(){
-        int total_load = N - i - 1;
-        int local_load = total_load / n + (total_load % n != 0);
-        jStart = i + 1 + r * local_load;
-        jFinish = jStart + local_load;
-        if (jFinish > N) jFinish = N;
-        int displ = 0;
-        for (j = jStart; j < jFinish; ++j){
-            uLocal[displ] = pa(i, j);
-            for (int k=0; k < i; ++k){
-                uLocal[displ] -= l(i, k) * u(k, j);
+    template<typename T> void LuDecomposer::computeUpperPanel(int k0, int kb){
+        int owner = distribution.getRowOwner(k0);
+        int lcT = distribution.getLocalColumnsBefore(k0 + kb);
+        int columns = localColumns - lcT;
+        const T* lower = static_cast<T*>(panel);
+        T* upper = static_cast<T*>(upperPanel);
+        if (columns == 0){
+            return;
+        }
+        if (gridRow == owner){
+            /* U12 = L11^-1 * A12. The block row K is stored by the first kb local rows after k0 */
+            int lr0 = distribution.getLocalRowsBefore(k0);
+            for (int rr = 0; rr < kb; ++rr){
+                T* row = &factor<T>(lr0 + rr, lcT);
+                for (int s = 0; s < rr; ++s){
+                    T l = lower[rr * kb + s];
+                    const T* solved = &factor<T>(lr0 + s, lcT);
+                    for (int c = 0; c < columns; ++c){
+                        row[c] -= l * solved[c];
+                    }
+                }
+                /* The negated copy turns the trailing update into C += A * B */
+                T* target = upper + rr * columns;
+                for (int c = 0; c < columns; ++c){
+                    target[c] = -row[c];
+                }
             }
-            ++displ;
+            checkComputationTime();
+        }
+        distribution.getColumnCommunicator().broadcast(upper, kb * columns, getFactorDatatype<T>(), owner);
+        checkTransmissionTime();
+    }
+
+    template<typename T> void LuDecomposer::updateTrailingMatrix(int k0, int kb){
+        int lr0 = distribution.getLocalRowsBefore(k0);
+        int lrT = distribution.getLocalRowsBefore(k0 + kb);
+        int lcT = distribution.getLocalColumnsBefore(k0 + kb);
+        int rows = localRows - lrT;
+        int columns = localColumns - lcT;
+        if (rows > 0 && columns > 0){
+            simd::gemm(rows, columns, kb, static_cast<T*>(panel) + (lrT - lr0) * kb, kb,
+                    static_cast<T*>(upperPanel), columns, &factor<T>(lrT, lcT), localColumns);
         }
         checkComputationTime();
-        transmitU(local_load);
     }
 
-    void LuDecomposer::transmitU(int local_load){
-        comm.allGather(uLocal, local_load, MPI_DOUBLE, uTotal, local_load, MPI_DOUBLE);
-        int displ = 0;
-        for (j = i+1; j < N; ++j){
-            u(i, j) = uTotal[displ];
-            ++displ;
+    void LuDecomposer::computePermutation(){
+        for (int i = 0; i < N; ++i){
+            P[i] = i;
+        }
+        for (int j = 0; j < N; ++j){
+            std::swap(P[j], P[pivots[j]]);
+        }
+        for (int i = 0; i < N; ++i){
+            inverseP[P[i]] = i;
         }
-        checkTransmissionTime();
     }
 
-    ContiguousMatrix LuDecomposer::getLowerTriangle() const{
+    ContiguousMatrix LuDecomposer::getTriangle(bool lower) const{
         ContiguousMatrix Result(comm, N, N, A.getWidthUm(), A.getHeightUm());
-        ContiguousMatrix::Iterator result(Result, 0);
-
-        for (int i=0; i < N; ++i){
-            for (int j=0; j < i; ++j){
-                result.val(i, j) = l(i, j);
-            }
-            result.val(i, i) = 1.0;
-            for (int j = i+1; j < N; ++j){
-                result.val(i, j) = 0.0;
+        std::vector<double> values((std::size_t)localRows * localColumns + 1);
+        for (int li = 0; li < localRows; ++li){
+            int i = distribution.getGlobalRow(li);
+            for (int lj = 0; lj < localColumns; ++lj){
+                int j = distribution.getGlobalColumn(lj);
+                double& value = values[(std::size_t)li * localColumns + lj];
+                if (lower){
+                    value = i > j ? factorValue(li, lj) : (double)(i == j);
+                } else {
+                    value = i <= j ? factorValue(li, lj) : 0.0;
+                }
             }
         }
-
+        storeResult(Result, distribution, &values[0]);
+        Result.synchronize();
         return Result;
     }
 
-    ContiguousMatrix LuDecomposer::getUpperTriangle() const{
-        ContiguousMatrix Result(comm, N, N, A.getWidthUm(), A.getHeightUm());
-        ContiguousMatrix::Iterator result(Result, 0);
-
-        for (int i=0; i < N; ++i){
-            for (int j=0; j < i; ++j) {
-                result.val(i, j) = 0.0;
-            }
-            for (int j=i; j < N; ++j){
-                result.val(i, j) = u(i, j);
-            }
-        }
+    ContiguousMatrix LuDecomposer::getLowerTriangle() const{
+        return getTriangle(true);
+    }
 
-        return Result;
+    ContiguousMatrix LuDecomposer::getUpperTriangle() const{
+        return getTriangle(false);
     }
 
     ContiguousMatrix LuDecomposer::getPermutationMatrix() const {
@@ -431,210 +535,317 @@ namespace data {
         return Result;
     }
 
-    void LuDecomposer::solve(data::ContiguousMatrix &x, const data::ContiguousMatrix &b, int root, double *buf) const {
-        if (comm.getRank() == root){
-            if (b.getHeight() != N || b.getWidth() != 1 || x.getHeight() != N || x.getWidth() != 1){
-                throw matrix_dimensions_mismatch();
-            }
-            bool buffer_not_created = false;
-            if (buf == nullptr){
-                buf = new double[N];
-                buffer_not_created = true;
-            }
-            solve_lowerTriangle(buf, b);
-            solve_upperTriangle(x, buf);
-            if (buffer_not_created){
-                delete [] buf;
-            }
-
-        }
-    }
+    void LuDecomposer::loadRightHandSide(const Matrix *B, const BlockCyclicDistribution &rhs,
+            double *y) const{
+        int M = rhs.getColumns();
+        int columns = rhs.getLocalColumns();
 
-    void LuDecomposer::solve_lowerTriangle(double* buf, const ContiguousMatrix& b) const {
-        ContiguousMatrix::ConstantIterator it(b, 0);
-        for (int i=0; i < N; ++i){
-            buf[i] = it[P[i]];
-            for (int j = i-1; j >=0; --j){
-                buf[i] -= l(i, j) * buf[j];
-            }
-        }
-    }
-
-    void LuDecomposer::solve_upperTriangle(data::ContiguousMatrix &x, const double *buf) const {
-        ContiguousMatrix::Iterator x_it(x, 0);
-        for (int i = N-1; i >= 0; --i){
-            x_it[i] = buf[i];
-            for (int j = i+1; j < N; ++j){
-                x_it[i] -= u(i, j) * x_it[j];
+        /* inverse(...): the right-hand side is the identity matrix, so P*B is known at every process */
+        if (B == nullptr){
+            for (int li = 0; li < localRows; ++li){
+                int i = rhs.getGlobalRow(li);
+                for (int lc = 0; lc < columns; ++lc){
+                    y[(std::size_t)li * columns + lc] = (double)(P[i] == rhs.getGlobalColumn(lc));
+                }
             }
-            x_it[i] /= u(i, i);
+            return;
         }
-    }
 
-    void LuDecomposer::divide(data::ContiguousMatrix &X, const data::ContiguousMatrix &B, double *buffer_local,
-                              double *result_local, double *external_result) {
-        divide_checkMatrices(X, B);
-        divide_init(B);
-        divide_initBuffers(B, buffer_local, result_local, external_result);
-        divide_lowerTriangle(B);
-        divide_upperTriangle();
-        divide_gather(resultLocal, result);
-        divide_setResult(X, result);
-        divide_clearBuffers();
-    }
-
-    void LuDecomposer::inverse(data::ContiguousMatrix &X, double *buffer_local, double *result_local,
-            double *external_result) {
-        inverse_checkMatrix(X);
-        divide_init(X);
-        divide_initBuffers(X, buffer_local, result_local, external_result);
-        inverse_lowerTriangle();
-        divide_upperTriangle();
-        divide_gather(resultLocal, result);
-        divide_setResult(X, result);
-        divide_clearBuffers();
-    }
+        int chunk = (int)ceil((double)N * M / n);
+        int iStart = B->getIstart();
+        int iFinish = B->getIfinish();
+        std::vector<int> sendCounts(n, 0), sendDisplacements(n, 0), receiveCounts(n, 0), receiveDisplacements(n, 0);
 
-    inline void LuDecomposer::divide_checkMatrices(const data::ContiguousMatrix &X, const ContiguousMatrix &B) const {
-        if (X.getHeight() != B.getHeight() || X.getHeight() != A.getHeight()){
-            throw matrix_dimensions_mismatch();
+        /* The rows of the responsibility area are sent in the order of the rows of P*B which is also the order of the
+         * local rows at the receiving process */
+        std::vector<int> rows;
+        if (iStart < iFinish){
+            for (int i0 = iStart / M; i0 <= (iFinish - 1) / M; ++i0){
+                rows.push_back(inverseP[i0]);
+            }
         }
-        if (X.getWidth() != B.getWidth()){
-            throw matrix_dimensions_mismatch();
+        std::sort(rows.begin(), rows.end());
+        for (int i: rows){
+            int offset = P[i] * M;
+            for (int c = std::max(iStart, offset) - offset; c < std::min(iFinish, offset + M) - offset; ++c){
+                ++sendCounts[rhs.getOwner(i, c)];
+            }
         }
-    }
-
-    inline void LuDecomposer::inverse_checkMatrix(const data::ContiguousMatrix &X) const {
-        if (X.getHeight() != A.getHeight() || X.getWidth() != A.getWidth()){
-            throw matrix_dimensions_mismatch();
+        for (int li = 0; li < localRows; ++li){
+            int offset = P[rhs.getGlobalRow(li)] * M;
+            for (int lc = 0; lc < columns; ++lc){
+                ++receiveCounts[(offset + rhs.getGlobalColumn(lc)) / chunk];
+            }
         }
-    }
-
-    inline void LuDecomposer::divide_init(const data::ContiguousMatrix &B) {
-        M = B.getWidth();
-        localJob = M/n + (M%n != 0);
-        totalJob = localJob * n;
-        jStart = r * localJob;
-        jFinish = jStart + localJob;
-        if (jFinish > M) jFinish = M;
-    }
-
-    inline double* LuDecomposer::divide_createBufferLocal(const data::ContiguousMatrix &B, bool initialized) {
-        if (!initialized){
-            divide_init(B);
+        for (int k = 1; k < n; ++k){
+            sendDisplacements[k] = sendDisplacements[k-1] + sendCounts[k-1];
+            receiveDisplacements[k] = receiveDisplacements[k-1] + receiveCounts[k-1];
         }
-        return new double[N*localJob];
-    }
 
-    inline double* LuDecomposer::divide_createResultLocal(const data::ContiguousMatrix &B, bool initialized) {
-        if (!initialized){
-            divide_init(B);
+        std::vector<double> sendBuffer(iFinish - iStart + 1);
+        std::vector<double> receiveBuffer((std::size_t)localRows * columns + 1);
+        std::vector<int> position(sendDisplacements);
+        for (int i: rows){
+            int offset = P[i] * M;
+            for (int c = std::max(iStart, offset) - offset; c < std::min(iFinish, offset + M) - offset; ++c){
+                sendBuffer[position[rhs.getOwner(i, c)]++] = (*B)[offset + c];
+            }
         }
-        return new double[N*localJob];
-    }
+        comm.allToAll(&sendBuffer[0], &sendCounts[0], &sendDisplacements[0], MPI_DOUBLE,
+                &receiveBuffer[0], &receiveCounts[0], &receiveDisplacements[0], MPI_DOUBLE);
 
-    inline double* LuDecomposer::divide_createResult(const data::ContiguousMatrix &B, bool initialized) {
-        if (!initialized){
-            divide_init(B);
+        position = receiveDisplacements;
+        for (int li = 0; li < localRows; ++li){
+            int offset = P[rhs.getGlobalRow(li)] * M;
+            for (int lc = 0; lc < columns; ++lc){
+                int source = (offset + rhs.getGlobalColumn(lc)) / chunk;
+                y[(std::size_t)li * columns + lc] = receiveBuffer[position[source]++];
+            }
         }
-        return new double[N*totalJob];
     }
 
+    void LuDecomposer::storeResult(ContiguousMatrix &X, const BlockCyclicDistribution &source, const double *y) const{
+        int width = source.getColumns();
+        int rows = source.getLocalRows();
+        int columns = source.getLocalColumns();
+        int chunk = (int)ceil((double)X.getWidth() * X.getHeight() / n);
+        std::vector<int> sendCounts(n, 0), sendDisplacements(n, 0), receiveCounts(n, 0), receiveDisplacements(n, 0);
 
-    inline void LuDecomposer::divide_initBuffers(const data::ContiguousMatrix &B, double *buffer_local,
-            double *result_local, double *external_result) {
-        if (buffer_local == nullptr){
-            bufferLocal = divide_createBufferLocal(B, true);
-            bufferLocalInitialized = true;
-        } else {
-            bufferLocal = buffer_local;
-            bufferLocalInitialized = false;
+        /* The local elements are sent in the row-major order that is also the order of the flat indices */
+        for (int li = 0; li < rows; ++li){
+            int i = source.getGlobalRow(li);
+            for (int lj = 0; lj < columns; ++lj){
+                ++sendCounts[(i * width + source.getGlobalColumn(lj)) / chunk];
+            }
         }
-
-        if (result_local == nullptr){
-            resultLocal = divide_createResultLocal(B, true);
-            resultLocalInitialized = true;
-        } else {
-            resultLocal = result_local;
-            resultLocalInitialized = false;
+        for (int index = X.getIstart(); index < X.getIfinish(); ++index){
+            ++receiveCounts[source.getOwner(index / width, index % width)];
         }
-
-        if (external_result == nullptr){
-            result = divide_createResult(B, true);
-            resultInitialized = true;
-        } else {
-            result = external_result;
-            resultInitialized = false;
+        for (int k = 1; k < n; ++k){
+            sendDisplacements[k] = sendDisplacements[k-1] + sendCounts[k-1];
+            receiveDisplacements[k] = receiveDisplacements[k-1] + receiveCounts[k-1];
         }
-    }
 
-    inline void LuDecomposer::divide_clearBuffers() {
-        if (bufferLocalInitialized){
-            delete [] bufferLocal;
-        }
-        if (resultLocalInitialized){
-            delete [] resultLocal;
+        std::vector<double> sendBuffer((std::size_t)rows * columns + 1);
+        std::vector<double> receiveBuffer(X.getIfinish() - X.getIstart() + 1);
+        std::vector<int> position(sendDisplacements);
+        for (int li = 0; li < rows; ++li){
+            int i = source.getGlobalRow(li);
+            for (int lj = 0; lj < columns; ++lj){
+                int destination = (i * width + source.getGlobalColumn(lj)) / chunk;
+                sendBuffer[position[destination]++] = y[(std::size_t)li * columns + lj];
+            }
         }
-        if (resultInitialized){
-            delete [] result;
+        comm.allToAll(&sendBuffer[0], &sendCounts[0], &sendDisplacements[0], MPI_DOUBLE,
+                &receiveBuffer[0], &receiveCounts[0], &receiveDisplacements[0], MPI_DOUBLE);
+
+        position = receiveDisplacements;
+        for (int index = X.getIstart(); index < X.getIfinish(); ++index){
+            X[index] = receiveBuffer[position[source.getOwner(index / width, index % width)]++];
+        }
+        X.touch();
+    }
+
+    MPI_Request LuDecomposer::broadcastSolverPanel(int k0, bool lower, double *buffer) const{
+        int kb = std::min(blockSize, N - k0);
+        int owner = distribution.getColumnOwner(k0);
+        int first = lower ? distribution.getLocalRowsBefore(k0) : 0;
+        int last = lower ? localRows : distribution.getLocalRowsBefore(k0 + kb);
+        if (gridColumn == owner){
+            int lc0 = distribution.getLocalColumnsBefore(k0);
+            for (int li = first; li < last; ++li){
+                double* target = buffer + (li - first) * kb;
+                if (precision == MixedPrecision){
+                    std::copy(&factor<float>(li, lc0), &factor<float>(li, lc0) + kb, target);
+                } else {
+                    std::copy(&factor<double>(li, lc0), &factor<double>(li, lc0) + kb, target);
+                }
+            }
         }
-    }
+        return distribution.getRowCommunicator().ibroadcast(buffer, (last - first) * kb, MPI_DOUBLE, owner);
+    }
+
+    void LuDecomposer::solve_lowerTriangle(const BlockCyclicDistribution &rhs, double *y) const{
+        int columns = rhs.getLocalColumns();
+        std::size_t panelSize = (std::size_t)localRows * blockSize + 1;
+        std::vector<double> panels(2 * panelSize);
+        std::vector<double> solution((std::size_t)blockSize * columns + 1);
+        mpi::Request request;
+
+        request = broadcastSolverPanel(0, true, &panels[0]);
+        for (int k0 = 0, K = 0; k0 < N; k0 += blockSize, ++K){
+            int kb = std::min(blockSize, N - k0);
+            int owner = distribution.getRowOwner(k0);
+            int lr0 = distribution.getLocalRowsBefore(k0);
+            int lrT = distribution.getLocalRowsBefore(k0 + kb);
+            double* current = &panels[(K % 2) * panelSize];
+            request.wait();
+            /* The next block column of L is transmitted while the current one is applied */
+            if (k0 + kb < N){
+                request = broadcastSolverPanel(k0 + kb, true, &panels[((K + 1) % 2) * panelSize]);
+            }
 
-    inline void LuDecomposer::divide_lowerTriangle(const data::ContiguousMatrix &B) {
-        ContiguousMatrix::ConstantIterator b(B, 0);
-        for (int j = jStart, localCol = 0; j < jFinish; ++j, ++localCol){
-            for (int i=0; i < N; ++i){
-                double& value = bufferLocal[i*localJob + localCol];
-                value = b.val(P[i], j);
-                for (int k=0; k < i; ++k){
-                    value -= l(i, k) * bufferLocal[k*localJob + localCol];
+            if (gridRow == owner){
+                for (int rr = 0; rr < kb; ++rr){
+                    double* row = y + (std::size_t)(lr0 + rr) * columns;
+                    for (int s = 0; s < rr; ++s){
+                        double l = current[rr * kb + s];
+                        const double* solved = y + (std::size_t)(lr0 + s) * columns;
+                        for (int c = 0; c < columns; ++c){
+                            row[c] -= l * solved[c];
+                        }
+                    }
+                    for (int c = 0; c < columns; ++c){
+                        solution[rr * columns + c] = -row[c];
+                    }
                 }
             }
+            distribution.getColumnCommunicator().broadcast(&solution[0], kb * columns, MPI_DOUBLE, owner);
+
+            if (lrT < localRows && columns > 0){
+                simd::gemm(localRows - lrT, columns, kb, current + (lrT - lr0) * kb, kb, &solution[0], columns,
+                        y + (std::size_t)lrT * columns, columns);
+            }
         }
     }
 
-    inline void LuDecomposer::inverse_lowerTriangle() {
-        for (int j = jStart, localCol = 0; j < jFinish; ++j, ++localCol){
-            for (int i=0; i < N; ++i){
-                double& value = bufferLocal[i*localJob + localCol];
-                value = (double)(P[i] == j);
-                for (int k = 0; k < i; ++k){
-                    value -= l(i, k) * bufferLocal[k*localJob + localCol];
+    void LuDecomposer::solve_upperTriangle(const BlockCyclicDistribution &rhs, double *y) const{
+        int columns = rhs.getLocalColumns();
+        std::size_t panelSize = (std::size_t)localRows * blockSize + 1;
+        std::vector<double> panels(2 * panelSize);
+        std::vector<double> solution((std::size_t)blockSize * columns + 1);
+        mpi::Request request;
+        int lastBlock = (N - 1) / blockSize * blockSize;
+
+        request = broadcastSolverPanel(lastBlock, false, &panels[0]);
+        for (int k0 = lastBlock, K = 0; k0 >= 0; k0 -= blockSize, ++K){
+            int kb = std::min(blockSize, N - k0);
+            int owner = distribution.getRowOwner(k0);
+            int lr0 = distribution.getLocalRowsBefore(k0);
+            double* current = &panels[(K % 2) * panelSize];
+            request.wait();
+            /* The previous block column of U is transmitted while the current one is applied */
+            if (k0 > 0){
+                request = broadcastSolverPanel(k0 - blockSize, false, &panels[((K + 1) % 2) * panelSize]);
+            }
+
+            if (gridRow == owner){
+                for (int rr = kb - 1; rr >= 0; --rr){
+                    double* row = y + (std::size_t)(lr0 + rr) * columns;
+                    const double* upper = current + (lr0 + rr) * kb;
+                    for (int s = rr + 1; s < kb; ++s){
+                        const double* solved = y + (std::size_t)(lr0 + s) * columns;
+                        for (int c = 0; c < columns; ++c){
+                            row[c] -= upper[s] * solved[c];
+                        }
+                    }
+                    for (int c = 0; c < columns; ++c){
+                        row[c] /= upper[rr];
+                        solution[rr * columns + c] = -row[c];
+                    }
                 }
             }
+            distribution.getColumnCommunicator().broadcast(&solution[0], kb * columns, MPI_DOUBLE, owner);
+
+            if (lr0 > 0 && columns > 0){
+                simd::gemm(lr0, columns, kb, current, kb, &solution[0], columns, y, columns);
+            }
         }
     }
 
-    inline void LuDecomposer::divide_upperTriangle() {
-        for(int j=jStart, localJ = 0; j < jFinish; ++j, ++localJ){
-            for (int i = N-1; i >= 0; --i){
-                double& value = resultLocal[i*localJob + localJ];
-                value = bufferLocal[i*localJob + localJ];
-                for (int k = i+1; k < N; ++k){
-                    value -= u(i, k) * resultLocal[k*localJob + localJ];
-                }
-                value /= u(i, i);
+    bool LuDecomposer::refine(ContiguousMatrix &X, const ContiguousMatrix *B, const BlockCyclicDistribution &rhs,
+            double *y){
+        int M = rhs.getColumns();
+        std::size_t size = (std::size_t)localRows * rhs.getLocalColumns();
+        LocalMatrix R(comm, M, N, X.getWidthUm(), X.getHeightUm());
+        std::vector<double> correction(size + 1);
+        double threshold = normA * std::numeric_limits<double>::epsilon() * sqrt((double)N);
+        double previousResidual = HUGE_VAL;
+
+        for (int iteration = 0; ; ++iteration){
+            /* The residual R = B - A*X is calculated in double precision */
+            storeResult(X, rhs, y);
+            R.distributedDot(A, X);
+            double norms[2] = {0.0, 0.0}, totalNorms[2];
+            for (int index = R.getIstart(); index < R.getIfinish(); ++index){
+                double b = B != nullptr ? (*B)[index] : (double)(index / M == index % M);
+                R[index] = b - R[index];
+                norms[0] = std::max(norms[0], std::isfinite(R[index]) ? fabs(R[index]) : HUGE_VAL);
+            }
+            for (std::size_t e = 0; e < size; ++e){
+                norms[1] = std::max(norms[1], fabs(y[e]));
+            }
+            comm.allReduce(norms, totalNorms, 2, MPI_DOUBLE, MPI_MAX);
+            refinementIterations = iteration;
+            refinementResidual = totalNorms[0];
+            if (!std::isfinite(refinementResidual)){
+                return false;
+            }
+            if (refinementResidual <= totalNorms[1] * threshold){
+                return true;
+            }
+            if (refinementResidual * LU_REFINEMENT_RATIO > previousResidual || iteration == LU_REFINEMENT_ITERATIONS){
+                return false;
+            }
+            previousResidual = refinementResidual;
+
+            /* The correction D: A*D = R is found by means of the float factors */
+            loadRightHandSide(&R, rhs, &correction[0]);
+            solve_lowerTriangle(rhs, &correction[0]);
+            solve_upperTriangle(rhs, &correction[0]);
+            for (std::size_t e = 0; e < size; ++e){
+                y[e] += correction[e];
             }
         }
     }
 
-    inline void LuDecomposer::divide_gather(const double *localBuffer, double *buffer) {
-        for (int i=0; i < N; ++i) {
-            comm.allGather(localBuffer, localJob, MPI_DOUBLE, buffer, localJob, MPI_DOUBLE);
-            localBuffer += localJob;
-            buffer += totalJob;
+    void LuDecomposer::solveDistributed(ContiguousMatrix &X, const ContiguousMatrix *B){
+        BlockCyclicDistribution rhs(comm, N, X.getWidth(), blockSize, distribution.getGridRows());
+        std::vector<double> y((std::size_t)localRows * rhs.getLocalColumns() + 1);
+        loadRightHandSide(B, rhs, &y[0]);
+        solve_lowerTriangle(rhs, &y[0]);
+        solve_upperTriangle(rhs, &y[0]);
+        refinementIterations = 0;
+        refinementResidual = 0.0;
+
+        if (precision == MixedPrecision){
+            if (refine(X, B, rhs, &y[0])){
+                X.synchronize();
+                return;
+            }
+            logging::warning("Iterative refinement of the LU solution has stalled. The matrix will be decomposed "
+                             "in double precision");
+            deleteBuffers();
+            precision = DoublePrecision;
+            allocateBuffers();
+            decompose();
+            loadRightHandSide(B, rhs, &y[0]);
+            solve_lowerTriangle(rhs, &y[0]);
+            solve_upperTriangle(rhs, &y[0]);
+        }
+        storeResult(X, rhs, &y[0]);
+        X.synchronize();
+    }
+
+    void LuDecomposer::solve(data::ContiguousMatrix &x, const data::ContiguousMatrix &b) {
+        if (b.getHeight() != N || b.getWidth() != 1 || x.getHeight() != N || x.getWidth() != 1){
+            throw matrix_dimensions_mismatch();
         }
+        solveDistributed(x, &b);
     }
 
-    inline void LuDecomposer::divide_setResult(data::ContiguousMatrix &X, double *result) {
-        ContiguousMatrix::Iterator x(X, 0);
-        for (int i=0; i < N; ++i){
-            double* px = &(*x);
-            memcpy(px, result, M * sizeof(double));
-            x += M;
-            result += totalJob;
+    void LuDecomposer::divide(data::ContiguousMatrix &X, const data::ContiguousMatrix &B) {
+        if (X.getHeight() != B.getHeight() || X.getHeight() != N || X.getWidth() != B.getWidth()){
+            throw matrix_dimensions_mismatch();
         }
+        solveDistributed(X, &B);
     }
 
+    void LuDecomposer::inverse(data::ContiguousMatrix &X) {
+        if (X.getHeight() != N || X.getWidth() != N){
+            throw matrix_dimensions_mismatch();
+        }
+        solveDistributed(X, nullptr);
+    }
 
-}
\ No newline at end of file
+}
@@ -7,7 +7,11 @@
 #define MPI2_LUDECOMPOSER_H
 
 
+#include <string>
+#include <vector>
 #include "../mpi/Communicator.h"
+#include "../mpi/File.h"
+#include "BlockCyclicDistribution.h"
 #include "ContiguousMatrix.h"
 
 namespace data {
@@ -17,48 +21,73 @@ namespace data {
      *
      * The LU decomposition represents source matrix A as the following matrix production:
      * L*U = P*A
+     *
+     * The factors are stored in the two-dimensional block-cyclic distribution (see data::BlockCyclicDistribution)
+     * with LU_BLOCK_SIZE x LU_BLOCK_SIZE blocks (see compile_options.h), so each process keeps O(N^2/P) elements
+     * of L and U only. The decomposition is blocked and right-looking. For each block column: (1) the process column
+     * containing it factorizes the panel with partial pivoting, (2) the row interchanges are applied to the rest of
+     * the matrix, (3) the panel is broadcast along the process rows while the block row of U is computed and
+     * broadcast along the process columns, (4) the trailing matrix is updated by the matrix multiplication
+     * (see data::simd::gemm). Hence, almost all arithmetic is performed at the matrix multiplication speed and the
+     * number of collectives covering the whole communicator is O(N / LU_BLOCK_SIZE).
+     *
+     * In the mixed precision mode (see Precision) the factors are computed and stored as float numbers, that halves
+     * the memory and the transmission and doubles the SIMD width of the trailing update. solve(...), divide(...) and
+     * inverse(...) recover the double precision solution by the iterative refinement: the residual is calculated in
+     * double precision and the correction is found by means of the float factors. If the refinement doesn't converge
+     * the matrix is decomposed again in double precision and the solution is repeated.
+     *
+     * The factorizations may be kept in the persistent on-disk cache (see setCacheDirectory). Then the repeated
+     * decomposition of the same matrix is replaced by collective reading of the factors.
      */
     class LuDecomposer {
+    public:
+        /**
+         * Precision of the factorization
+         */
+        enum Precision {
+            DoublePrecision,    /* the factors are double numbers */
+            MixedPrecision      /* the factors are float numbers, the solutions are improved by iterative refinement */
+        };
+
     private:
         mpi::Communicator& comm;
         const ContiguousMatrix& A;
         ContiguousMatrix::Iterator _a;
         std::string prompt;
         int interval;
-        double* decomposingData;
-        int* P;
+        int N, n, r;
         double computationTime, transmissionTime;
-        double* lBest;
-        double* uBest;
-        double* uLocal;
-        double* uTotal;
-        int* pBest;
-
-        double* lBestLocal;
-        double uBestLocal;
-        int pBestLocal;
 
-        int pStart;
-        int pFinish;
-        int pConsequtive;
-
-        int jStart, jFinish;
-        int localJob, totalJob;
-        int M;
-        bool bufferLocalInitialized, resultLocalInitialized, resultInitialized;
-        double *bufferLocal, *resultLocal, *result;
-        mpi::VectorDatatype* dtype;
+        BlockCyclicDistribution distribution;
+        int blockSize, localRows, localColumns, gridRow, gridColumn;
+        Precision precision;
+        void* factors;
+        void* panel;
+        void* upperPanel;
+        std::vector<double> swapBuffer;
+        double normA;
+        int refinementIterations;
+        double refinementResidual;
+        int* pivots;
+        int* P;
+        int* inverseP;
 
-        void initializeP();
+        static constexpr int ROW_EXCHANGE_TAG = 1005;
 
-        int N, n, r, i, j, p;
+        template<typename T> T& factor(int li, int lj) const{
+            return static_cast<T*>(factors)[li * localColumns + lj];
+        }
 
-        double& l(int row, int col) const{
-            return decomposingData[row * N + col];
+        double factorValue(int li, int lj) const{
+            return precision == MixedPrecision ? factor<float>(li, lj) : factor<double>(li, lj);
         }
 
-        double& u(int row, int col) const{
-            return decomposingData[row * N + col];
+        double getFactor(int row, int col) const{
+            if (distribution.getOwner(row, col) != r){
+                throw out_of_range_error();
+            }
+            return factorValue(distribution.getLocalRow(row), distribution.getLocalColumn(col));
         }
 
         double a(int row, int col){
@@ -69,60 +98,50 @@ namespace data {
             return _a.val(P[row], col);
         }
 
-
-#if DEBUG==1
-    void getUmax(double& value, int& row, int & col);
-    void getUmin(double& value, int& row, int & col);
-    void getLmax(double& value, int& row, int & col);
-    void getLmin(double& value, int& row, int & col);
-
-    int getLfilled();
-    int getUfilled();
-#endif
-
     /**
      * Routines that perform certain stages of the matrix decomposition
      */
-    void decomposeFirstRow();
-    void searchMaxDiagonal(double& value, int& row);
-    void chooseBest(double uBest_local, int bBest_local);
-    void initU();
+    void allocateBuffers();
+    void deleteBuffers();
+    template<typename T> void decomposeFactors();
+    template<typename T> void loadSource();
+    template<typename T> void factorizePanel(int k0, int kb);
+    template<typename T> void exchangeRows(int i1, int i2, int columnStart, int columnFinish, int skipStart,
+            int skipFinish);
+    template<typename T> void applyInterchanges(int k0, int kb);
+    template<typename T> void broadcastPanel(int k0, int kb);
+    template<typename T> void computeUpperPanel(int k0, int kb);
+    template<typename T> void updateTrailingMatrix(int k0, int kb);
+    void computePermutation();
 
     void checkComputationTime();
     void checkTransmissionTime();
 
-    void computeLBestParallel();
-    void computeLConsequtive(int p0);
-    void computeUConsequtive();
-    void computeUDiagonal(int p0);
-    void checkUBestLocal(int p0);
-    void chooseLBest();
-    void transmitU(int load);
-
     /**
-     * Routines that provide certain steps of the solve(...) method
+     * Routines that provide the factorization cache (see setCacheDirectory(...))
      */
-    void solve_lowerTriangle(double* buf, const ContiguousMatrix& b) const;
-    void solve_upperTriangle(ContiguousMatrix& x, const double* buf) const;
+    static std::string& getCacheLocation();
+    unsigned long long getSourceHash() const;
+    std::string getCacheFilename(unsigned long long hash) const;
+    MPI_Offset getCacheDataOffset() const;
+    void transferCachedFactors(mpi::File& file, bool write);
+    bool loadFactors(const std::string& filename, unsigned long long hash);
+    void saveFactors(const std::string& filename, unsigned long long hash);
 
     /**
-     * Routines for matrix division
+     * Routines that provide certain steps of the solve(...), divide(...) and inverse(...) methods. The right-hand
+     * side y is an N x M matrix distributed in the same way as the factors (see the rhs argument): the local rows of
+     * y correspond to the local rows of L and U, the local part of y is stored by rows
      */
-     inline void divide_checkMatrices(const ContiguousMatrix& X, const ContiguousMatrix& B) const;
-     inline void divide_init(const ContiguousMatrix& B);
-     inline void divide_initBuffers(const ContiguousMatrix& B, double* buffer_local,
-             double* result_local, double* result);
-     inline void divide_clearBuffers();
-     inline void divide_lowerTriangle(const ContiguousMatrix& B);
-     inline void divide_upperTriangle();
-     inline void divide_gather(const double* localBuffer, double* buffer);
-     inline void divide_setResult(ContiguousMatrix& X, double* result);
-
-     /**
-      * Additional routines for matrix inversion
-      */
-      inline void inverse_checkMatrix(const ContiguousMatrix& X) const;
-      inline void inverse_lowerTriangle();
+    void loadRightHandSide(const Matrix* B, const BlockCyclicDistribution& rhs, double* y) const;
+    MPI_Request broadcastSolverPanel(int k0, bool lower, double* buffer) const;
+    void solve_lowerTriangle(const BlockCyclicDistribution& rhs, double* y) const;
+    void solve_upperTriangle(const BlockCyclicDistribution& rhs, double* y) const;
+    bool refine(ContiguousMatrix& X, const ContiguousMatrix* B, const BlockCyclicDistribution& rhs, double* y);
+    void solveDistributed(ContiguousMatrix& X, const ContiguousMatrix* B);
+    void storeResult(ContiguousMatrix& X, const BlockCyclicDistribution& source, const double* y) const;
+
+    ContiguousMatrix getTriangle(bool lower) const;
 
     public:
         /**
@@ -132,8 +151,10 @@ namespace data {
          * so this is your responsibility to achieve this. See data::ContiguousMatrix::synchronize for more details
          * @param userPrompt Give the prompt to the decomposition process each
          * @param userInterval Number of rows after which the progress bar shall be updated
+         * @param userPrecision DoublePrecision or MixedPrecision (see Precision for details)
          */
-        LuDecomposer(ContiguousMatrix& source, const std::string& userPrompt = "", int userInterval = 10);
+        LuDecomposer(ContiguousMatrix& source, const std::string& userPrompt = "", int userInterval = 10,
+                Precision userPrecision = DoublePrecision);
 
         LuDecomposer(const LuDecomposer& other) = delete;
 
@@ -144,15 +165,70 @@ namespace data {
 #endif
 
         /**
-         * Returns the value of the lower triangular matrix. The value is shared among all processes.
+         *
+         * @return distribution of L and U among the processes
+         */
+        [[nodiscard]] const BlockCyclicDistribution& getDistribution() const { return distribution; }
+
+        /**
+         *
+         * @param row the vertical index of the matrix
+         * @param col the horizontal index of the matrix
+         * @return true if L(row, col) and U(row, col) are available at the current process
+         */
+        [[nodiscard]] bool isLocal(int row, int col) const { return distribution.getOwner(row, col) == r; }
+
+        /**
+         *
+         * @return precision of the current factors. MixedPrecision turns to DoublePrecision when the iterative
+         * refinement fails and the matrix is decomposed again
+         */
+        [[nodiscard]] Precision getPrecision() const { return precision; }
+
+        /**
+         *
+         * @return number of the refinement steps made by the last solve(...), divide(...) or inverse(...); 0 in the
+         * double precision mode
+         */
+        [[nodiscard]] int getRefinementIterations() const { return refinementIterations; }
+
+        /**
+         *
+         * @return maximum absolute value of the residual B - A*X at the last refinement step
+         */
+        [[nodiscard]] double getRefinementResidual() const { return refinementResidual; }
+
+        /**
+         * Enables the persistent cache of the factorizations. When the cache is enabled, decompose() calculates the
+         * hash of the source matrix and looks for the file containing L, U and P of the matrix with the same hash,
+         * size and precision. If such file exists the factors are read from it, otherwise the matrix is decomposed
+         * and the factors are written into the cache directory.
+         * The file contains the factors in the global row-major order and is read and written by MPI-IO through the
+         * block-cyclic file view. Hence, the file may be read by any number of processes with any process grid.
+         * The routine shall be called by all processes with the same argument before the decomposer is created.
+         *
+         * @param path an existent directory for the cache files or an empty string to disable the cache (default)
+         */
+        static void setCacheDirectory(const std::string& path) { getCacheLocation() = path; }
+
+        /**
+         *
+         * @return the directory for the persistent factorization cache or an empty string if the cache is disabled
+         */
+        static const std::string& getCacheDirectory() { return getCacheLocation(); }
+
+        /**
+         * Returns the value of the lower triangular matrix. The values below the diagonal are available only at the
+         * process that owns them (see isLocal)
          *
          * @param row the vertical index of the matrix
          * @param col the horizontal index of the matrix
          * @return copy of the item value
+         * @throws out_of_range_error if the item is not stored by the current process
          */
         double L(int row, int col) const{
             if (row > col){
-                return l(row, col);
+                return getFactor(row, col);
             } else if (row == col){
                 return 1.0;
             } else {
@@ -161,17 +237,19 @@ namespace data {
         }
 
         /**
-         * Returns the value of an item of upper triangular matrix. The value is shared among all processes
+         * Returns the value of an item of upper triangular matrix. The values on and above the diagonal are available
+         * only at the process that owns them (see isLocal)
          *
          * @param row the vertical index of the item
          * @param col the horizontal index of the item
          * @return copy of the item value
+         * @throws out_of_range_error if the item is not stored by the current process
          */
         double U(int row, int col) const{
             if (row > col){
                 return 0.0;
             } else {
-                return u(row, col);
+                return getFactor(row, col);
             }
         }
 
@@ -189,7 +267,7 @@ namespace data {
         /**
          *
          * @return L matrix from the LU decomposition
-         * New memory is allocated during execution of this routine
+         * New memory is allocated during execution of this routine. The matrix is synchronized
          * This is a collective routine
          */
         ContiguousMatrix getLowerTriangle() const;
@@ -197,7 +275,7 @@ namespace data {
         /**
          *
          * @return U matrix from the LU decomposition
-         * New memory is allocated during execution of this routine
+         * New memory is allocated during execution of this routine. The matrix is synchronized
          * This is a collective routine
          */
         ContiguousMatrix getUpperTriangle() const;
@@ -217,131 +295,57 @@ namespace data {
         /**
          * Performs decomposition of the source matrix on L and U. This method launches automatically when you create
          * an instance of this class. However, if you changed the source matrix and want to get updated values of L
-         * and U you have to run this method again.
+         * and U you have to run this method again. When the factorization cache is enabled the factors may be read
+         * from the cache file instead (see setCacheDirectory).
+         * This is a collective routine
          */
         void decompose();
 
 
         /**
          * Provides solution of A*x = b equation based on the LU decomposition
-         * The following arguments were given based on consideration that the decomposer was created for NxN matrix
+         * This is a collective routine
+         *
+         * The right-hand side is redistributed in the same way as the factors and the substitution is performed
+         * by all processes, no process keeps the whole right-hand side during the solution. The iterative refinement
+         * is the same as for divide(...)
          *
-         * @param x the 1xN matrix that will be filled by the solution values due to the method execution
-         * @param b the right-hand side (Nx1 matrix)
-         * @param root rank of the root process. Because the job can't be parallelized, it will be run by a single process
-         * only. All other processes within the communicator will do nothing and leave vector x unchanged
-         * @param buf N-sized C array. The array will be used for storage of temporary values. These values will be
-         * non-relevant after the method execution will be finished. If you pass nullptr, the buffer will be created
-         * at the beginning of the method execution and will be destroyed at finish of it
+         * @param x the 1xN matrix that will be filled by the solution values. The matrix will be synchronized
+         * @param b the right-hand side (Nx1 matrix). Only the responsibility area of this matrix is used
          */
-        void solve(ContiguousMatrix& x, const ContiguousMatrix& b, int root = 0, double* buf = nullptr) const;
+        void solve(ContiguousMatrix& x, const ContiguousMatrix& b);
 
         /**
          * Searches for such matrix X as A*X = B where A is the matrix that has already been decomposed,
          * B is a matrix passed through an argument and * is matrix production.
          * This is a collective routine.
-         * Valid results are guaranteed only when the matrix B is synchronized. See ContiguousMatrix::synchronize
-         * for details.
-         * The result matrix X will be synchronized immediately after this method completes its execution
+         * Only the responsibility area of B is used, so B is not required to be synchronized. Both B and X are
+         * redistributed in the same way as the factors, the forward and back substitution for all columns of B are
+         * performed simultaneously and the next block column of L or U is broadcast while the current one is applied.
+         * The result matrix X will be synchronized immediately after this method completes its execution.
+         * In the mixed precision mode the solution is improved by the iterative refinement until the residual
+         * ||B - A*X|| falls below ||X|| * ||A|| * eps * sqrt(N). If the residual doesn't decrease at least
+         * LU_REFINEMENT_RATIO times per step or LU_REFINEMENT_ITERATIONS steps are not enough the matrix is
+         * decomposed in double precision and this mode is used by all subsequent calls. The source matrix shall
+         * be kept unchanged and synchronized.
+         *
+         * Usage:
+         * data::LuDecomposer decomposer(A);
+         * decomposer.divide(X1, B1);
+         * decomposer.divide(X2, B2);
          *
          * @param X see above
          * @param B see above
-         * @param buffer_local 1) if nullptr will be given, the program will allocate the necessary buffer at the
-         * beginning of the program execution and will free this at the end of it. This option gives the best
-         * performance when you apply this method once. 2) you allocate the local buffer separately by calling
-         * divide_createBufferLocal() routine. In this case the program will use the buffer provided by this routine
-         * and the buffer will not be destroyed automatically. This option gives the best performance for multiple
-         * calls of the divide(...) method
-         * @param result_local 1) if nullptr will be given, the program will allocate the necessary buffer at the
-         * beginning of the program execution and will free this at the end of it. This option gives the best
-         * performance when you apply this method once. 2) you allocate the local result buffer separately by calling
-         * divide_createResultLocal() routine. In this case the program will use the buffer provided by this routine
-         * and the buffer will not be destroyed automatically. This option gives the best performance for multiple
-         * calls of the divide(...) method
-         * @param result 1) if nullptr will be given, the program will allocate the necessary buffer at the
-         * beginning of the program execution and will free this at the end of it. This option gives the best
-         * performance when you apply this method once. 2) you allocate the result buffer separately by calling
-         * divide_createResult() routine. In this case the program will use the buffer provided by this routine
-         * and the buffer will not be destroyed automatically. This option gives the best performance for multiple
-         * calls of the divide(...) method
-         *
-         * So, there are two ways to use this method.
-         * Single-call way.
-         * data::LuDedcomposer decomposer(A)
-         * decomposer.divide(X, B)
-         *
-         * Multiple-call way.
-         * data::LuDecomposer decomposer(A)
-         * auto buffer_local = decomposer.divide_createBufferLocal();
-         * auto result_local = decomposer.divide_createResultLocal();
-         * auto result = decomposer.divide_createResult();
-         * decomposer.divide(X1, B1, buffer_local, buffer, result_local, result, dtype);
-         * decomposer.divide(X2, B2, buffer_local, buffer, result_local, result, dtype);
-         * decomposer.divide(X3, B3, buffer_local, buffer, result_local, result, dtype);
-         * ......................................
-         * decomposer.divide(Xn, Bn, buffer_local, buffer, result_local, result, dtype);
-         * delete [] buffer_local;
-         * delete [] result_local;
-         * delete [] result;
          */
-        void divide(ContiguousMatrix& X, const ContiguousMatrix& B, double* buffer_local = nullptr,
-                double* result_local = nullptr, double* result = nullptr);
+        void divide(ContiguousMatrix& X, const ContiguousMatrix& B);
 
         /**
          * Searches for the inverse matrix X = A^-1
+         * This is a collective routine. The result matrix X will be synchronized
          *
          * @param X the inverse results
-         * @param buffer_local 1) if nullptr will be given, the program will allocate the necessary buffer at the
-         * beginning of the program execution and will free this at the end of it. This option gives the best
-         * performance when you apply this method once. 2) you allocate the local buffer separately by calling
-         * divide_createBufferLocal() routine. In this case the program will use the buffer provided by this routine
-         * and the buffer will not be destroyed automatically. This option gives the best performance for multiple
-         * calls of the divide(...) method
-         * @param result_local 1) if nullptr will be given, the program will allocate the necessary buffer at the
-         * beginning of the program execution and will free this at the end of it. This option gives the best
-         * performance when you apply this method once. 2) you allocate the local result buffer separately by calling
-         * divide_createResultLocal() routine. In this case the program will use the buffer provided by this routine
-         * and the buffer will not be destroyed automatically. This option gives the best performance for multiple
-         * calls of the divide(...) method
-         * @param result 1) if nullptr will be given, the program will allocate the necessary buffer at the
-         * beginning of the program execution and will free this at the end of it. This option gives the best
-         * performance when you apply this method once. 2) you allocate the result buffer separately by calling
-         * divide_createResult() routine. In this case the program will use the buffer provided by this routine
-         * and the buffer will not be destroyed automatically. This option gives the best performance for multiple
-         * calls of the divide(...) method
-         */
-        void inverse(ContiguousMatrix& X, double* buffer_local = nullptr, double* result_local = nullptr,
-                double* result = nullptr);
-
-        /**
-         * Creates the local buffer for the division process
-         *
-         * @param B matrix that has the same dimensions as the matrix B in equation A*X = B
-         * @param initialized for service use only. Please, use the default value
-         * @return pointer to the buffer. Please, don't forget to clean the buffer manually after the program execution
-         * will be completed
-         */
-        inline double* divide_createBufferLocal(const ContiguousMatrix& B, bool initialized = false);
-
-        /**
-         * Creates the local result buffer for the division process
-         *
-         * @param B matrix that has the same dimensions as the matrix B in equation A*X = B
-         * @param initialized for service use only. Please, use the default value
-         * @return pointer to the buffer. Please, don't forget to clean the buffer manually after the program execution
-         * will be completed
-         */
-        inline double* divide_createResultLocal(const ContiguousMatrix& B, bool initialized = false);
-
-        /**
-         * Creates the result buffer for the division process
-         *
-         * @param B matrix that has the same dimensions as the matrix B in equation A*X = B
-         * @param initialized for service use only. Please, use the default value
-         * @return pointer to the buffer. Please, don't forget to clean the buffer manually after the program execution
-         * will be completed
          */
-        inline double* divide_createResult(const ContiguousMatrix& B, bool initialized = false);
+        void inverse(ContiguousMatrix& X);
     };
 
 }
@@ -3,20 +3,89 @@
 // (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
 //
 
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include "Matrix.h"
 #include "../Application.h"
 #include "ContiguousMatrix.h"
+#include "MatrixExpression.h"
+#include "MatrixStats.h"
+#include "simd/Kernels.h"
 #include "../log/output.h"
 
+namespace {
+
+    /**
+     * Computes the responsibility area of a given process in the same way as the Matrix constructor
+     */
+    void getResponsibilityArea(int size, int nprocs, int rank, int& start, int& finish){
+        int localSize = (size + nprocs - 1) / nprocs;
+        start = std::min(localSize * rank, size);
+        finish = std::min(start + localSize, size);
+    }
+
+    /**
+     * Maps the element to the unsigned integer in such a way that the greater elements have the greater keys
+     */
+    unsigned long long getOrderKey(double x){
+        unsigned long long bits;
+        memcpy(&bits, &x, sizeof(bits));
+        constexpr unsigned long long sign = 1ULL << 63;
+        return (bits & sign) ? ~bits : bits | sign;
+    }
+
+    /**
+     * The inverse of getOrderKey
+     */
+    double getOrderValue(unsigned long long key){
+        constexpr unsigned long long sign = 1ULL << 63;
+        unsigned long long bits = (key & sign) ? key & ~sign : ~key;
+        double x;
+        memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    /**
+     * Adds the product of the rows of A by the piece of B to the rows of C. The piece contains the elements of B
+     * with the flat indices from start to finish-1, hence it may begin and end in the middle of the row
+     *
+     * @param rows number of rows in A and C
+     * @param depth width of A and height of B
+     * @param width width of B and C
+     */
+    template<typename T> void multiplyByPiece(int rows, int depth, int width, const T* a, const T* piece,
+            int start, int finish, T* c){
+        int k = start / width;
+        int j = start % width;
+        if (j != 0){
+            int columns = std::min(width - j, finish - start);
+            data::simd::gemm(rows, columns, 1, a + k, depth, piece, width, c + j, width);
+            piece += columns;
+            start += columns;
+            ++k;
+        }
+        int fullRows = (finish - start) / width;
+        data::simd::gemm(rows, width, fullRows, a + k, depth, piece, width, c, width);
+        piece += fullRows * width;
+        start += fullRows * width;
+        k += fullRows;
+        if (start < finish){
+            data::simd::gemm(rows, finish - start, 1, a + k, depth, piece, width, c, width);
+        }
+    }
+
+}
+
 namespace data{
 
-    Matrix::Matrix(mpi::Communicator &comm, int w, int h, double w_um, double h_um, double filler): communicator(comm),
-    width(w), height(h), widthUm(w_um), heightUm(h_um)
+    template<typename T> BasicMatrix<T>::BasicMatrix(mpi::Communicator &comm, int w, int h, double w_um, double h_um,
+            double filler): communicator(comm), width(w), height(h), widthUm(w_um), heightUm(h_um)
     {
         size = width * height;
         rank = comm.getRank();
         localSize = ceil((double)size/comm.getProcessorNumber());
-        iStart = localSize * rank;
+        iStart = std::min(localSize * rank, size);
         iFinish = iStart + localSize;
         if (iFinish > size){
             iFinish = size;
@@ -25,7 +94,7 @@ namespace data{
     }
 
 #if DEBUG==1
-    void Matrix::printLocal() const{
+    template<typename T> void BasicMatrix<T>::printLocal() const{
         using namespace std;
 
         for (int i=0; i < height; i++){
@@ -46,200 +115,328 @@ namespace data{
 
 
 
-    void Matrix::fill(double x){
-        for (auto a = begin(); a != end(); ++a){
-            *a = x;
+    template<typename T> void BasicMatrix<T>::checkOperand(const BasicMatrix &A) const{
+        if (A.size != size || A.localSize != localSize){
+            throw matrix_dimensions_mismatch();
         }
     }
 
-    Matrix& Matrix::operator++(){
-        for (auto a = begin(); a != end(); ++a){
-            ++*a;
-        }
+    template<typename T> void BasicMatrix<T>::fill(double x){
+        simd::fill(data, x, localSize);
+    }
+
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator++(){
+        simd::scale(data, data, 1.0, 1.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator--(){
-        for (auto a = begin(); a != end(); ++a){
-            --*a;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator--(){
+        simd::scale(data, data, 1.0, -1.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator+=(const Matrix& other){
-        auto a = begin();
-        auto b = other.cbegin();
-        for (; a != end(); ++a, ++b){
-            *a += *b;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator+=(const BasicMatrix& other){
+        checkOperand(other);
+        simd::linear(data, data, 1.0, other.data, 1.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator-=(const Matrix& other){
-        auto a = begin();
-        auto b = other.cbegin();
-        for (; a != end(); ++a, ++b){
-            *a -= *b;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator-=(const BasicMatrix& other){
+        checkOperand(other);
+        simd::linear(data, data, 1.0, other.data, -1.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator+=(double x){
-        for (auto a = begin(); a != end(); ++a){
-            *a += x;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator+=(double x){
+        simd::scale(data, data, 1.0, x, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator-=(double x){
-        for (auto a = begin(); a != end(); ++a){
-            *a -= x;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator-=(double x){
+        simd::scale(data, data, 1.0, -x, localSize);
         return *this;
     }
 
-    Matrix& Matrix::add(const Matrix& A, const Matrix& B){
-        calculate(A, B, [](ConstantIterator& a, ConstantIterator& b){
-            return *a + *b;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::add(const BasicMatrix& A, const BasicMatrix& B){
+        checkOperand(A);
+        checkOperand(B);
+        simd::linear(data, A.data, 1.0, B.data, 1.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::sub(const Matrix& A, const Matrix& B){
-        calculate(A, B, [](ConstantIterator& a, ConstantIterator& b){
-            return *a - *b;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::add(const BasicMatrix& A, double x, const BasicMatrix& B){
+        checkOperand(A);
+        checkOperand(B);
+        simd::linear(data, A.data, 1.0, B.data, x, localSize);
         return *this;
     }
 
-    Matrix& Matrix::add(const Matrix& A, double x){
-        calculate(A, [&x](ConstantIterator& a){
-            return *a + x;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::sub(const BasicMatrix& A, const BasicMatrix& B){
+        checkOperand(A);
+        checkOperand(B);
+        simd::linear(data, A.data, 1.0, B.data, -1.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::sub(const Matrix& A, double x){
-        calculate(A, [&x](ConstantIterator& a){
-            return *a - x;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::add(const BasicMatrix& A, double x){
+        checkOperand(A);
+        simd::scale(data, A.data, 1.0, x, localSize);
+        return *this;
+    }
+
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::sub(const BasicMatrix& A, double x){
+        checkOperand(A);
+        simd::scale(data, A.data, 1.0, -x, localSize);
         return *this;
     }
 
 
-    Matrix& Matrix::sub(double x, const Matrix& A){
-        calculate(A, [&x](ConstantIterator& a){
-            return x - *a;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::sub(double x, const BasicMatrix& A){
+        checkOperand(A);
+        simd::scale(data, A.data, -1.0, x, localSize);
         return *this;
     }
 
-    Matrix& Matrix::neg(const Matrix& A){
-        calculate(A, [](ConstantIterator& a){
-            return -*a;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::neg(const BasicMatrix& A){
+        checkOperand(A);
+        simd::scale(data, A.data, -1.0, 0.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator*=(const Matrix& other){
-        auto a = begin();
-        auto b = other.cbegin();
-        for (; a != end(); ++a, ++b){
-            *a *= *b;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator*=(const BasicMatrix& other){
+        checkOperand(other);
+        simd::multiply(data, data, other.data, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator/=(const Matrix& other){
-        auto a = begin();
-        auto b = other.cbegin();
-        for (; a != end(); ++a, ++b){
-            *a /= *b;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator/=(const BasicMatrix& other){
+        checkOperand(other);
+        simd::divide(data, data, other.data, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator*=(double x){
-        for (auto a = begin(); a != end(); ++a){
-            *a *= x;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator*=(double x){
+        simd::scale(data, data, x, 0.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::operator/=(double x){
-        for (auto a = begin(); a != end(); ++a){
-            *a /= x;
-        }
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::operator/=(double x){
+        return assign(*this / x);
+    }
+
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::mul(const BasicMatrix& A, const BasicMatrix& B){
+        checkOperand(A);
+        checkOperand(B);
+        simd::multiply(data, A.data, B.data, localSize);
         return *this;
     }
 
-    Matrix& Matrix::mul(const Matrix& A, const Matrix& B){
-        calculate(A, B, [](ConstantIterator& a, ConstantIterator& b){
-            return *a * *b;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::div(const BasicMatrix& A, const BasicMatrix& B){
+        checkOperand(A);
+        checkOperand(B);
+        simd::divide(data, A.data, B.data, localSize);
         return *this;
     }
 
-    Matrix& Matrix::div(const Matrix& A, const Matrix& B){
-        calculate(A, B, [](ConstantIterator& a, ConstantIterator& b){
-            return *a / *b;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::mul(const BasicMatrix& A, double x){
+        checkOperand(A);
+        simd::scale(data, A.data, x, 0.0, localSize);
         return *this;
     }
 
-    Matrix& Matrix::mul(const Matrix& A, double x){
-        calculate(A, [&x](ConstantIterator& a){
-            return *a * x;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::div(const BasicMatrix& A, double x){
+        return assign(A / x);
+    }
+
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::div(double x, const BasicMatrix& A){
+        checkOperand(A);
+        simd::reciprocal(data, x, A.data, localSize);
         return *this;
     }
 
-    Matrix& Matrix::div(const Matrix& A, double x){
-        calculate(A, [&x](ConstantIterator& a){
-            return *a / x;
-        });
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::transpose(const BasicContiguousMatrix<T>& A){
+        if (A.width != height || A.height != width){
+            throw matrix_dimensions_mismatch();
+        }
+        if (localSize > 0){
+            simd::transposeArea(A.bigData, A.width, data, width, iStart, iFinish);
+        }
         return *this;
     }
 
-    Matrix& Matrix::div(double x, const Matrix& A){
-        calculate(A, [&x](ConstantIterator& a){
-            return x / *a;
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::distributedTranspose(const BasicMatrix& A){
+        if (A.width != height || A.height != width){
+            throw matrix_dimensions_mismatch();
+        }
+        int nprocs = communicator.getProcessorNumber();
+        MPI_Datatype datatype = getElementDatatype();
+        int firstRow = 0, lastRow = 0;
+        if (localSize > 0){
+            firstRow = iStart / width;
+            lastRow = (iFinish - 1) / width + 1;
+        }
+
+        /* The rows of the result required by each process are the columns of A */
+        std::vector<int> rowsStart(nprocs, 0), rowsFinish(nprocs, 0);
+        for (int p = 0; p < nprocs; ++p){
+            int start, finish;
+            getResponsibilityArea(size, nprocs, p, start, finish);
+            if (start < finish){
+                rowsStart[p] = start / width;
+                rowsFinish[p] = (finish - 1) / width + 1;
+            }
+        }
+
+        /* Each process sends the parts of its rows of A that belong to the required columns */
+        int aStart, aFinish;
+        getResponsibilityArea(A.size, nprocs, rank, aStart, aFinish);
+        std::vector<int> sendCounts(nprocs, 0), sendDispls(nprocs, 0), recvCounts(nprocs, 0), recvDispls(nprocs, 0);
+        auto forEachSegment = [&](auto f){
+            for (int row = aStart / A.width; row * A.width < aFinish; ++row){
+                for (int p = 0; p < nprocs; ++p){
+                    int start = std::max(row * A.width + rowsStart[p], aStart);
+                    int finish = std::min(row * A.width + rowsFinish[p], aFinish);
+                    if (start < finish){
+                        f(p, start, finish);
+                    }
+                }
+            }
+        };
+        forEachSegment([&](int p, int start, int finish){ sendCounts[p] += finish - start; });
+        for (int p = 1; p < nprocs; ++p){
+            sendDispls[p] = sendDispls[p - 1] + sendCounts[p - 1];
+        }
+        std::vector<T> sendBuffer(sendDispls[nprocs - 1] + sendCounts[nprocs - 1]);
+        std::vector<int> position(sendDispls);
+        forEachSegment([&](int p, int start, int finish){
+            std::copy(A.data + start - aStart, A.data + finish - aStart, sendBuffer.begin() + position[p]);
+            position[p] += finish - start;
         });
+
+        /* The received data form the columns from firstRow to lastRow-1 of A stored row by row */
+        int columns = lastRow - firstRow;
+        int pieceSize = (A.size + nprocs - 1) / nprocs;
+        if (columns > 0){
+            for (int row = 0; row < A.height; ++row){
+                int start = row * A.width + firstRow;
+                int finish = start + columns;
+                while (start < finish){
+                    int q = start / pieceSize;
+                    int segmentFinish = std::min(finish, (q + 1) * pieceSize);
+                    recvCounts[q] += segmentFinish - start;
+                    start = segmentFinish;
+                }
+            }
+        }
+        for (int q = 1; q < nprocs; ++q){
+            recvDispls[q] = recvDispls[q - 1] + recvCounts[q - 1];
+        }
+        std::vector<T> strip(columns * A.height);
+        communicator.allToAll(sendBuffer.data(), sendCounts.data(), sendDispls.data(), datatype,
+                strip.data(), recvCounts.data(), recvDispls.data(), datatype);
+
+        if (localSize > 0){
+            simd::transposeArea(strip.data(), columns, data, width, iStart - firstRow * width,
+                    iFinish - firstRow * width);
+        }
         return *this;
     }
 
-    Matrix& Matrix::transpose(const ContiguousMatrix& A){
-        data::ContiguousMatrix::ConstantIterator a(A, 0);
-        for (auto b = begin(); b != end(); ++b){
-            int i = b.getRow();
-            int j = b.getColumn();
-            *b = a.val(j, i);
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::dot(const BasicContiguousMatrix<T>& A,
+            const BasicContiguousMatrix<T>& B){
+        int depth = A.width;
+        if (A.height != height || B.height != depth || B.width != width){
+            throw matrix_dimensions_mismatch();
+        }
+        if (localSize <= 0){
+            return *this;
         }
+        int firstRow = iStart / width;
+        int lastRow = (iFinish - 1) / width + 1;
+        std::vector<T> rows((lastRow - firstRow) * width, 0);
+        simd::gemm(lastRow - firstRow, width, depth, A.bigData + firstRow * depth, depth, B.bigData, width,
+                rows.data(), width);
+        std::copy(rows.begin() + iStart - firstRow * width, rows.begin() + iFinish - firstRow * width, data);
+        return *this;
     }
 
-    Matrix& Matrix::dot(const ContiguousMatrix& A, const ContiguousMatrix& B){
-        data::ContiguousMatrix::ConstantIterator a(A, 0);
-        data::ContiguousMatrix::ConstantIterator b(B, 0);
-        for (auto c = begin(); c != end(); ++c){
-            int i = c.getRow();
-            int j = c.getColumn();
-            *c = 0.0;
-            for (int k=0; k < A.getWidth(); ++k){
-                *c += a.val(i, k) * b.val(k, j);
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::distributedDot(const BasicMatrix& A, const BasicMatrix& B){
+        int depth = A.width;
+        if (A.height != height || B.height != depth || B.width != width){
+            throw matrix_dimensions_mismatch();
+        }
+        int nprocs = communicator.getProcessorNumber();
+        MPI_Datatype datatype = getElementDatatype();
+        int firstRow = 0, lastRow = 0;
+        if (localSize > 0){
+            firstRow = iStart / width;
+            lastRow = (iFinish - 1) / width + 1;
+        }
+
+        std::vector<int> sendCounts(nprocs), sendDispls(nprocs), recvCounts(nprocs), recvDispls(nprocs);
+        int aStart, aFinish;
+        getResponsibilityArea(A.size, nprocs, rank, aStart, aFinish);
+        for (int p = 0; p < nprocs; ++p){
+            int start, finish, rowsStart = 0, rowsFinish = 0;
+            getResponsibilityArea(size, nprocs, p, start, finish);
+            if (start < finish){
+                rowsStart = start / width * depth;
+                rowsFinish = ((finish - 1) / width + 1) * depth;
             }
+            start = std::max(aStart, rowsStart);
+            finish = std::min(aFinish, rowsFinish);
+            sendCounts[p] = std::max(finish - start, 0);
+            sendDispls[p] = sendCounts[p] > 0 ? start - aStart : 0;
+
+            getResponsibilityArea(A.size, nprocs, p, start, finish);
+            start = std::max(start, firstRow * depth);
+            finish = std::min(finish, lastRow * depth);
+            recvCounts[p] = std::max(finish - start, 0);
+            recvDispls[p] = recvCounts[p] > 0 ? start - firstRow * depth : 0;
+        }
+        std::vector<T> rowsA((lastRow - firstRow) * depth);
+        communicator.allToAll(A.data, sendCounts.data(), sendDispls.data(), datatype,
+                rowsA.data(), recvCounts.data(), recvDispls.data(), datatype);
+
+        int pieceSize = (B.size + nprocs - 1) / nprocs;
+        std::vector<T> pieces[2] = {std::vector<T>(pieceSize), std::vector<T>(pieceSize)};
+        mpi::Request requests[2];
+        auto startBroadcast = [&](int q){
+            int start, finish;
+            getResponsibilityArea(B.size, nprocs, q, start, finish);
+            if (q == rank){
+                std::copy(B.data, B.data + finish - start, pieces[q % 2].begin());
+            }
+            requests[q % 2] = communicator.ibroadcast(pieces[q % 2].data(), finish - start, datatype, q);
+        };
+
+        std::vector<T> rows((lastRow - firstRow) * width, 0);
+        startBroadcast(0);
+        for (int q = 0; q < nprocs; ++q){
+            if (q + 1 < nprocs){
+                startBroadcast(q + 1);
+            }
+            requests[q % 2].wait();
+            int start, finish;
+            getResponsibilityArea(B.size, nprocs, q, start, finish);
+            multiplyByPiece(lastRow - firstRow, depth, width, rowsA.data(), pieces[q % 2].data(), start, finish,
+                    rows.data());
+        }
+
+        if (localSize > 0){
+            std::copy(rows.begin() + iStart - firstRow * width, rows.begin() + iFinish - firstRow * width, data);
         }
         return *this;
     }
 
-    double Matrix::sum() const{
-        double r = 0.0;
-        r = reduce(0.0, MPI_SUM, [](double& result, double x){
-            result += x;
-        });
-        return r;
+    template<typename T> double BasicMatrix<T>::sum() const{
+        double localSum = simd::sum(data, localSize);
+        double globalSum;
+        communicator.allReduce(&localSum, &globalSum, 1, MPI_DOUBLE, MPI_SUM);
+        return globalSum;
     }
 
-    double Matrix::max() const{
+    template<typename T> double BasicMatrix<T>::max() const{
         double m = 0.0;
         bool initialized = false;
         m = reduce(NAN, MPI_MAX, [&initialized](double& result, double x){
@@ -253,42 +450,15 @@ namespace data{
         return m;
     }
 
-    struct MPI_MAX_MIN_LOC_STRUCTURE {
-        double value;
-        int rank;
-    };
-
-    int Matrix::argmax(int &row, int &col, double *value) const {
-        auto a = cbegin();
-        double localValue = *a;
-        int localIndex = a.getIndex();
-        int localRow = a.getRow();
-        int localCol = a.getColumn();
-        double globalValue;
-
-        for (++a; a != cend(); ++a){
-            if (*a > localValue){
-                localValue = *a;
-                localIndex = a.getIndex();
-                localRow = a.getRow();
-                localCol = a.getColumn();
-            }
-        }
-
-        MPI_MAX_MIN_LOC_STRUCTURE local, global;
-        local.value = localValue;
-        local.rank = communicator.getRank();
-        communicator.allReduce(&local, &global, 1, MPI_DOUBLE_INT, MPI_MAXLOC);
-        if (value != nullptr) *value = global.value;
-
-        int indices[3] = {localIndex, localRow, localCol};
-        communicator.broadcast(indices, 3, MPI_INT, global.rank);
-        row = indices[1];
-        col = indices[2];
-        return indices[0];
+    template<typename T> int BasicMatrix<T>::argmax(int &row, int &col, double *value) const {
+        MatrixStats stats(communicator);
+        int maximum = stats.addMax(*this);
+        stats.compute();
+        if (value != nullptr) *value = stats.getValue(maximum);
+        return stats.getLocation(maximum, row, col);
     }
 
-    double Matrix::min() const{
+    template<typename T> double BasicMatrix<T>::min() const{
         double minValue;
         bool initialized = false;
         minValue = reduce(NAN, MPI_MIN, [&initialized](double& result, double x){
@@ -302,39 +472,17 @@ namespace data{
         return minValue;
     }
 
-    int Matrix::argmin(int &row, int &col, double *value) const {
-        ConstantIterator a = cbegin();
-        double localValue = *a;
-        int localIndex = a.getIndex();
-        int localRow = a.getRow();
-        int localCol = a.getColumn();
-
-        for (++a; a != cend(); ++a){
-            if (*a < localValue){
-                localValue = *a;
-                localIndex = a.getIndex();
-                localRow = a.getRow();
-                localCol = a.getColumn();
-            }
-        }
-
-        MPI_MAX_MIN_LOC_STRUCTURE localStructure, globalStructure;
-        localStructure.value = localValue;
-        localStructure.rank = communicator.getRank();
-        communicator.allReduce(&localStructure, &globalStructure, 1, MPI_DOUBLE_INT, MPI_MINLOC);
-        if (value != nullptr) *value = globalStructure.value;
-        int root = globalStructure.rank;
-
-        int indices[3] = {localIndex, localRow, localCol};
-        communicator.broadcast(indices, 3, MPI_INT, root);
-        row = indices[1];
-        col = indices[2];
-        return indices[0];
+    template<typename T> int BasicMatrix<T>::argmin(int &row, int &col, double *value) const {
+        MatrixStats stats(communicator);
+        int minimum = stats.addMin(*this);
+        stats.compute();
+        if (value != nullptr) *value = stats.getValue(minimum);
+        return stats.getLocation(minimum, row, col);
     }
 
 #define SQR(X) ((X)*(X))
 
-    double Matrix::std() const{
+    template<typename T> double BasicMatrix<T>::std() const{
         const int VALUES = 0;
         const int SQUARES = 1;
         double localSum[2] = {0, 0};
@@ -342,42 +490,34 @@ namespace data{
         double deviation;
         int items = height * width;
 
-        for (auto a = cbegin(); a != cend(); ++a){
-            localSum[VALUES] += *a;
-            localSum[SQUARES] += *a * *a;
-        }
+        simd::moments(data, localSize, localSum);
         communicator.allReduce(localSum, globalSum, 2, MPI_DOUBLE, MPI_SUM);
         deviation = sqrt(globalSum[SQUARES]/items - SQR(globalSum[VALUES]/items));
 
         return deviation;
     }
 
-    double Matrix::errorfunc(const data::Matrix &other) const {
+    template<typename T> double BasicMatrix<T>::errorfunc(const BasicMatrix &other) const {
         double localError, globalError;
 
-        localError = 0.0;
-        for (auto a = cbegin(), b = other.cbegin(); a != cend(); ++a, ++b){
-            localError += SQR(*a - *b);
-        }
+        checkOperand(other);
+        localError = simd::squaredDistance(data, other.data, localSize);
         communicator.allReduce(&localError, &globalError, 1, MPI_DOUBLE, MPI_SUM);
 
         return globalError/2.0;
     }
 
-    double Matrix::cov(const data::Matrix &other) const {
+    template<typename T> double BasicMatrix<T>::cov(const BasicMatrix &other) const {
         const int MUTUAL_SUM = 0;
         const int FIRST_SUM = 1;
         const int SECOND_SUM = 2;
         double N = width * height;
-        double local[3] = {0.0, 0.0, 0.0};
+        double local[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
         double global[3];
         double cov;
 
-        for (auto a = cbegin(), b = other.cbegin(); a != cend(); ++a, ++b){
-            local[MUTUAL_SUM] += *a * *b;
-            local[FIRST_SUM] += *a;
-            local[SECOND_SUM] += *b;
-        }
+        checkOperand(other);
+        simd::crossMoments(data, other.data, localSize, local);
         communicator.allReduce(local, global, 3, MPI_DOUBLE, MPI_SUM);
         for (int i=0; i < 3; ++i) global[i] /= N;
         cov = global[MUTUAL_SUM] - global[FIRST_SUM] * global[SECOND_SUM];
@@ -385,7 +525,7 @@ namespace data{
         return cov;
     }
 
-    double Matrix::corr(const data::Matrix& other) const {
+    template<typename T> double BasicMatrix<T>::corr(const BasicMatrix& other) const {
         const int MUTUAL_SUM = 0;
         const int A_SUM = 1;
         const int B_SUM = 2;
@@ -399,13 +539,8 @@ namespace data{
         double varB;
         double corrAB;
 
-        for (auto a = cbegin(), b = other.cbegin(); a != cend(); ++a, ++b){
-            local[MUTUAL_SUM] += *a * *b;
-            local[A_SUM] += *a;
-            local[B_SUM] += *b;
-            local[SQR_A_SUM] += SQR(*a);
-            local[SQR_B_SUM] += SQR(*b);
-        }
+        checkOperand(other);
+        simd::crossMoments(data, other.data, localSize, local);
         communicator.allReduce(local, global, 5, MPI_DOUBLE, MPI_SUM);
         for (int i=0; i < 5; ++i) global[i] /= N;
         covAB = global[MUTUAL_SUM] - global[A_SUM] * global[B_SUM];
@@ -416,17 +551,157 @@ namespace data{
         return corrAB;
     }
 
+    template<typename T> std::vector<int> BasicMatrix<T>::histogram(int bins, double low, double high) const{
+        if (bins <= 0){
+            throw incorrect_order_statistics();
+        }
+        std::vector<int> localCounts(bins, 0), globalCounts(bins);
+        double scale = bins / (high - low);
+        for (int n = 0; n < localSize; ++n){
+            double x = data[n];
+            if (x >= low && x <= high){
+                int k = high > low ? (int)((x - low) * scale) : 0;
+                if (k >= bins) k = bins - 1;
+                ++localCounts[k];
+            }
+        }
+        communicator.allReduce(&localCounts[0], &globalCounts[0], bins, MPI_INT, MPI_SUM);
+        return globalCounts;
+    }
+
+    template<typename T> std::vector<int> BasicMatrix<T>::histogram(int bins) const{
+        /* Maximum and minimum by a single allReduce: min(x) = -max(-x) */
+        double localRange[2] = {-INFINITY, -INFINITY};
+        double globalRange[2];
+        for (int n = 0; n < localSize; ++n){
+            double x = data[n];
+            if (x > localRange[0]) localRange[0] = x;
+            if (-x > localRange[1]) localRange[1] = -x;
+        }
+        communicator.allReduce(localRange, globalRange, 2, MPI_DOUBLE, MPI_MAX);
+        return histogram(bins, -globalRange[1], globalRange[0]);
+    }
+
+    template<typename T> void BasicMatrix<T>::selectOrderStatistics(const long long *positions, double *values,
+            int number) const{
+        constexpr int bits = MATRIX_SELECTION_BITS;
+        constexpr int bins = 1 << bits;
+        static_assert(64 % bits == 0, "MATRIX_SELECTION_BITS shall be a divisor of 64");
+        for (int j = 0; j < number; ++j){
+            if (positions[j] < 0 || positions[j] >= size){
+                throw incorrect_order_statistics();
+            }
+        }
+
+        /* Each step finds the next bits of the key of the required element, starting from the most significant
+         * ones. The candidates are the local keys which more significant bits were found at the previous steps */
+        std::vector<std::vector<unsigned long long>> candidates(number);
+        std::vector<unsigned long long> prefix(number, 0);
+        std::vector<long long> rest(positions, positions + number);
+        std::vector<int> localCounts(number * bins), globalCounts(number * bins);
+        for (int shift = 64 - bits; shift >= 0; shift -= bits){
+            std::fill(localCounts.begin(), localCounts.end(), 0);
+            for (int j = 0; j < number; ++j){
+                int* counts = &localCounts[j * bins];
+                auto& keys = candidates[j];
+                if (shift == 64 - bits){
+                    keys.resize(localSize);
+                    for (int n = 0; n < localSize; ++n){
+                        keys[n] = getOrderKey(data[n]);
+                        ++counts[keys[n] >> shift];
+                    }
+                } else {
+                    std::size_t left = 0;
+                    for (auto key: keys){
+                        if ((key >> (shift + bits)) == prefix[j]){
+                            keys[left++] = key;
+                            ++counts[(key >> shift) & (bins - 1)];
+                        }
+                    }
+                    keys.resize(left);
+                }
+            }
+            communicator.allReduce(&localCounts[0], &globalCounts[0], number * bins, MPI_INT, MPI_SUM);
+            for (int j = 0; j < number; ++j){
+                const int* counts = &globalCounts[j * bins];
+                int digit = 0;
+                while (rest[j] >= counts[digit]){
+                    rest[j] -= counts[digit++];
+                }
+                prefix[j] = (prefix[j] << bits) | digit;
+            }
+        }
+
+        for (int j = 0; j < number; ++j){
+            values[j] = getOrderValue(prefix[j]);
+        }
+    }
+
+    template<typename T> double BasicMatrix<T>::orderStatistic(long long position) const{
+        double value;
+        selectOrderStatistics(&position, &value, 1);
+        return value;
+    }
+
+    template<typename T> double BasicMatrix<T>::percentile(double p) const{
+        if (!(p >= 0.0 && p <= 100.0) || size == 0){
+            throw incorrect_order_statistics();
+        }
+        double position = p / 100.0 * (size - 1);
+        long long positions[2];
+        double values[2];
+        positions[0] = (long long)floor(position);
+        positions[1] = std::min(positions[0] + 1, (long long)size - 1);
+        double fraction = position - positions[0];
+        if (fraction > 0.0){
+            selectOrderStatistics(positions, values, 2);
+            return values[0] + fraction * (values[1] - values[0]);
+        } else {
+            selectOrderStatistics(positions, values, 1);
+            return values[0];
+        }
+    }
 
-    Matrix& Matrix::convolve(const data::ContiguousMatrix &K, const data::ContiguousMatrix &A, bool normalize) {
+    template<typename T> std::vector<typename BasicMatrix<T>::IndexedValue> BasicMatrix<T>::topK(int k) const{
+        if (k <= 0){
+            throw incorrect_order_statistics();
+        }
+        /* Descending order, the empty places (index -1) are always the last */
+        auto greater = [](const IndexedValue& a, const IndexedValue& b){
+            if (a.index < 0) return false;
+            if (b.index < 0) return true;
+            return a.value > b.value || (a.value == b.value && a.index < b.index);
+        };
+
+        std::vector<IndexedValue> local(localSize);
+        for (int n = 0; n < localSize; ++n){
+            local[n] = {(double)data[n], iStart + n};
+        }
+        if (k < localSize){
+            std::nth_element(local.begin(), local.begin() + k, local.end(), greater);
+        }
+        local.resize(k, {-INFINITY, -1});
+
+        std::vector<IndexedValue> all(k * communicator.getProcessorNumber());
+        communicator.allGather(&local[0], k, MPI_DOUBLE_INT, &all[0], k, MPI_DOUBLE_INT);
+        int resultSize = std::min(k, size);
+        std::partial_sort(all.begin(), all.begin() + resultSize, all.end(), greater);
+        all.resize(resultSize);
+        return all;
+    }
+
+
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::convolve(const BasicContiguousMatrix<T> &K,
+            const BasicContiguousMatrix<T> &A, bool normalize) {
         if (A.getWidth() != width || A.getHeight() != height){
             throw matrix_dimensions_mismatch();
         }
 
-        Matrix::Iterator b = begin();
-        Matrix::ConstantIterator a = A.cbegin();
+        Iterator b = begin();
+        ConstantIterator a = A.cbegin();
         int W = (K.getWidth() - 1)/2;
         int H = (K.getHeight() - 1)/2;
-        ContiguousMatrix::ConstantIterator k(K, W, H);
+        typename BasicContiguousMatrix<T>::ConstantIterator k(K, H, W);
 
         for (; b != end(); ++b, ++a){
             *b = 0.0;
@@ -434,9 +709,9 @@ namespace data{
             for (int h = -H; h <= H; ++h){
                 int i_loc = a.getRow() + h;
                 if (i_loc >= 0 && i_loc < A.getHeight()){
-                    for (int w = -W; w < W; ++w){
+                    for (int w = -W; w <= W; ++w){
                         int j_loc = a.getColumn() + w;
-                        if (j_loc >= 0 && j_loc < A.getHeight()){
+                        if (j_loc >= 0 && j_loc < A.getWidth()){
                             *b += k.val(h, w) * a.val(h, w);
                             if (normalize) {
                                 local_sum += k.val(h, w);
@@ -454,7 +729,7 @@ namespace data{
     }
 
 
-    Matrix& Matrix::downsample(const ContiguousMatrix& source){
+    template<typename T> BasicMatrix<T>& BasicMatrix<T>::downsample(const BasicContiguousMatrix<T>& source){
         int sourceHeight = source.getHeight();
         int sourceWidth = source.getWidth();
         double Ny_float = (double)sourceHeight/height;
@@ -468,7 +743,7 @@ namespace data{
         for (auto b = begin(); b != end(); ++b){
             int i0 = b.getRow();
             int j0 = b.getColumn();
-            ContiguousMatrix::ConstantIterator a(source, i0 * Ny, j0 * Nx);
+            typename BasicContiguousMatrix<T>::ConstantIterator a(source, i0 * Ny, j0 * Nx);
             *b = 0;
             for (int i = 0; i < Nx; ++i){
                 for (int j = 0; j < Ny; ++j){
@@ -476,17 +751,25 @@ namespace data{
                 }
             }
         }
+        return *this;
     }
 
+    template class BasicMatrix<double>;
+    template class BasicMatrix<float>;
 
 }
 
-void swap(data::Matrix& A, data::Matrix& B){
+template<typename T> void swap(data::BasicMatrix<T>& A, data::BasicMatrix<T>& B){
     {
         for (auto a = A.begin(), b = B.begin(); a != A.end(); ++a, ++b){
-            double temp = *a;
+            T temp = *a;
             *a = *b;
             *b = temp;
         }
     }
-}
\ No newline at end of file
+    A.touch();
+    B.touch();
+}
+
+template void swap(data::BasicMatrix<double>& A, data::BasicMatrix<double>& B);
+template void swap(data::BasicMatrix<float>& A, data::BasicMatrix<float>& B);
\ No newline at end of file
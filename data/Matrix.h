@@ -7,11 +7,14 @@
 #define MPI2_MATRIX_H
 
 
+#include <vector>
 #include "../mpi/Communicator.h"
+#include "../mpi/Datatype.h"
 #include "../compile_options.h"
+#include "LocalSpan.h"
 
 
-namespace data{ class Matrix; }
+namespace data{ template<typename T> class BasicMatrix; }
 
 /**
           * Exchanges values between the matrices
@@ -19,25 +22,67 @@ namespace data{ class Matrix; }
           * @param A the first matrix
           * @param B the second matrix
           */
-void swap(data::Matrix& A, data::Matrix& B);
+template<typename T> void swap(data::BasicMatrix<T>& A, data::BasicMatrix<T>& B);
 
 namespace data {
 
-    class ContiguousMatrix;
+    /**
+     *
+     * @return a new matrix version, unique among all matrices of the application
+     */
+    inline unsigned long long nextMatrixVersion(){
+        static unsigned long long counter = 0;
+        return ++counter;
+    }
+
+    template<typename T> class BasicContiguousMatrix;
+    template<typename T> class MatrixTerm;
+    template<typename E> class MatrixExpression;
 
 /**
  * A base class for all matrices shared among all processes
- * Minimum total size of each matrix is 8*width*height bytes
+ * Minimum total size of each matrix is sizeof(T)*width*height bytes
  *
  * These matrix are shared. This means that matrix operations were made by certain set of processes
  * in parallel
+ *
+ * The matrix is instantiated for double (data::Matrix, data::LocalMatrix, data::ContiguousMatrix) and for float
+ * (data::MatrixF, data::LocalMatrixF, data::ContiguousMatrixF). The single-precision matrices halve the memory
+ * traffic and the message sizes while all reductions (sum(), std(), corr() etc.) are still accumulated in double.
+ * The matrix arguments of any operation shall have the same element type as the matrix itself while the element-wise
+ * expressions (see MatrixExpression.h) may mix both types.
+ *
+ * @tparam T type of the matrix elements: double or float
  */
-    class Matrix {
+    template<typename T> class BasicMatrix {
     protected:
         int size, localSize, iStart, iFinish, rank, width, height;
         mpi::Communicator &communicator;
         double widthUm, heightUm;
-        double *data;
+        T *data;
+        unsigned long long version = nextMatrixVersion();
+
+        template<typename> friend class MatrixTerm;
+        template<typename> friend class BasicMatrixView;
+        friend class MatrixStats;
+
+        /**
+         * Checks whether the matrix A can be the operand of the element-wise operation applied to the current matrix
+         *
+         * @param A the other matrix
+         * @throws matrix_dimensions_mismatch if the matrix A has another size or another responsibility area
+         */
+        void checkOperand(const BasicMatrix& A) const;
+
+        /**
+         * Finds several order statistics by the distributed radix selection (see orderStatistic). All positions are
+         * processed by the same allReduce calls
+         *
+         * @param positions positions of the elements in the sorted matrix
+         * @param values the array to be filled by the elements
+         * @param number number of positions
+         */
+        void selectOrderStatistics(const long long* positions, double* values, int number) const;
     public:
         /**
          * Initializes the matrix
@@ -49,8 +94,8 @@ namespace data {
          * @param h_um height of the matrix per um
          * @param fillter initial values for the matrix
          */
-        Matrix(mpi::Communicator &comm, int w, int h, double w_um, double h_um, double filler = 0.0);
-        virtual ~Matrix() = default;
+        BasicMatrix(mpi::Communicator &comm, int w, int h, double w_um, double h_um, double filler = 0.0);
+        virtual ~BasicMatrix() = default;
 
         /**
          *
@@ -86,6 +131,11 @@ namespace data {
             return communicator;
         }
 
+        /**
+         *
+         * @return MPI datatype of the matrix elements
+         */
+        static MPI_Datatype getElementDatatype() { return mpi::ScalarType<T>(); }
 
         /**
          *
@@ -127,14 +177,44 @@ namespace data {
          */
         double getResolutionY() const { return heightUm / height; }
 
+        /**
+         * Returns the matrix version. Each matrix gets its own version at construction, the version is changed by
+         * touch(), by the assignment operators and by swap(). Two equal versions always belong to the same matrix,
+         * so the version is enough to decide whether the processor input has been changed since the last update.
+         * Writing the elements (operator[], iterators, spans, fill() etc.) doesn't change the version: the code
+         * that changes the matrix in place shall call touch()
+         *
+         * @return the version
+         */
+        unsigned long long getVersion() const { return version; }
+
+        /**
+         * Marks the matrix as changed: assigns a new version to it
+         */
+        void touch() { version = nextMatrixVersion(); }
+
+        /**
+         * Returns a non-virtual accessor to the responsibility area of the matrix. Prefer it to begin() and end()
+         * in the loops which performance matters (see LocalSpan.h for details)
+         *
+         * @return the span
+         */
+        BasicLocalSpan<T> localSpan() {
+            return BasicLocalSpan<T>(data, iStart, iFinish, width, height, widthUm, heightUm);
+        }
+
+        BasicLocalSpan<const T> localSpan() const {
+            return BasicLocalSpan<const T>(data, iStart, iFinish, width, height, widthUm, heightUm);
+        }
+
         /**
          * Provides an access to the certain element of the matrix
          *
          * @param index index of such an element
          * @return alias for the element value
          */
-        virtual double& operator[](int index) = 0;
-        virtual double operator[](int index) const = 0;
+        virtual T& operator[](int index) = 0;
+        virtual T operator[](int index) const = 0;
 
         /**
          * An alias for operator[]
@@ -142,9 +222,9 @@ namespace data {
          * @param index
          * @return
          */
-        double& getValue(int index) { return operator[](index); }
+        T& getValue(int index) { return operator[](index); }
 
-        double getValue(int index) const{ return operator[](index); }
+        T getValue(int index) const{ return operator[](index); }
 
         /**
          * Returns an item with a certain 2D index
@@ -153,11 +233,11 @@ namespace data {
          * @param j index of the column
          * @return
          */
-        double& getValue(int i, int j){
+        T& getValue(int i, int j){
             return getValue(i * width + j);
         }
 
-        double getValue(int i, int j) const{
+        T getValue(int i, int j) const{
             return getValue(i * width + j);
         }
 
@@ -177,6 +257,31 @@ namespace data {
          */
         virtual void synchronize(int root) = 0;
 
+        /**
+         * Starts the synchronization but doesn't wait for its completion. See synchronize() for details.
+         * The data within the responsibility area shall not be changed until waitSynchronize() is called, while
+         * the data outside the responsibility area remain deprecated until waitSynchronize()
+         * The routine allows to overlap the data transmission with any computations that don't require the data
+         * from other processes
+         *
+         * Not available for local matrices
+         */
+        virtual void startSynchronize() = 0;
+
+        /**
+         * Starts the synchronization to the "root process" but doesn't wait for its completion.
+         * See synchronize(int root) and startSynchronize() for details
+         *
+         * @param root rank of the "root" process
+         */
+        virtual void startSynchronize(int root) = 0;
+
+        /**
+         * Waits until the synchronization started by startSynchronize() completes. After this routine the matrix
+         * is in the same state as after synchronize()
+         */
+        virtual void waitSynchronize() = 0;
+
 
 #if DEBUG==1
         /**
@@ -254,8 +359,9 @@ namespace data {
          */
         class Iterator: public virtual AbstractIterator{
         protected:
-            Matrix* parent;
-            double* pointer;
+            using AbstractIterator::index;
+            BasicMatrix* parent;
+            T* pointer;
         public:
             /**
              * Single-value constructor
@@ -263,7 +369,7 @@ namespace data {
              * @param matrix alias to the matrix which iterator shall be taken into consideration
              * @param index index for the item
              */
-            Iterator(Matrix& matrix, int index): AbstractIterator(index){
+            Iterator(BasicMatrix& matrix, int index): AbstractIterator(index){
                 parent = &matrix;
                 pointer = &parent->data[index];
             }
@@ -315,7 +421,7 @@ namespace data {
                 return pointer != other.pointer;
             }
 
-            double& operator*() const{ return *pointer; }
+            T& operator*() const{ return *pointer; }
 
             Iterator& operator++() {
                 ++index;
@@ -377,7 +483,7 @@ namespace data {
                 return *this;
             }
 
-            double& operator[](int n) const{
+            T& operator[](int n) const{
                 return *(pointer + n);
             }
 
@@ -388,12 +494,12 @@ namespace data {
              * @param j relative index of the column (the iterator points to an item with relative index equal to 0)
              * @return reference to the value
              */
-            double& val(int i, int j){
+            T& val(int i, int j){
                 return *(pointer + parent->width * i + j);
             }
 
             friend void swap(const Iterator& a, const Iterator& b){
-                double x = *a.pointer;
+                T x = *a.pointer;
                 *a.pointer = *b.pointer;
                 *b.pointer = x;
             }
@@ -404,8 +510,9 @@ namespace data {
          */
          class ConstantIterator: public virtual AbstractIterator{
          protected:
-             const Matrix* parent;
-             const double* pointer;
+             using AbstractIterator::index;
+             const BasicMatrix* parent;
+             const T* pointer;
          public:
 
              /**
@@ -414,7 +521,7 @@ namespace data {
               * @param matrix matrix alias to the matrix which iterator shall be taken into consideration
               * @param index index for the item
               */
-             ConstantIterator(const Matrix& matrix, int index): AbstractIterator(index){
+             ConstantIterator(const BasicMatrix& matrix, int index): AbstractIterator(index){
                 parent = &matrix;
                 pointer = &parent->data[index];
              }
@@ -466,7 +573,7 @@ namespace data {
                  return pointer != other.pointer;
              }
 
-             double operator*() const{ return *pointer; }
+             T operator*() const{ return *pointer; }
 
              ConstantIterator& operator++(){
                  ++index;
@@ -528,7 +635,7 @@ namespace data {
                  return *this;
              }
 
-             double operator[](int n) const{
+             T operator[](int n) const{
                  return *(pointer + n);
              }
 
@@ -540,7 +647,7 @@ namespace data {
               * The iterator points to a row and a column which relative indexes are zero
               * @return a copy of the value
               */
-             double val(int i, int j) const{
+             T val(int i, int j) const{
                 return *(pointer + parent->width * i + j);
              }
          };
@@ -550,14 +657,6 @@ namespace data {
          virtual ConstantIterator cbegin() const = 0;
          virtual ConstantIterator cend() const = 0;
 
-         /**
-          * Exchanges values between the matrices
-          *
-          * @param A the first matrix
-          * @param B the second matrix
-          */
-         friend void ::swap(Matrix& A, Matrix& B);
-
          /**
           * Fills all matrix data by a certain value
           *
@@ -584,7 +683,7 @@ namespace data {
           * @param B another matrix
           * @param f instance of the function
           */
-         template<typename F> void calculate(const Matrix& B, F f){
+         template<typename F> void calculate(const BasicMatrix& B, F f){
             auto a = begin();
             auto b = B.cbegin();
             for (;a != end(); ++a, ++b){
@@ -600,7 +699,7 @@ namespace data {
           * @param C the third matrix
           * @param f instance of the functor
           */
-         template<typename F> void calculate(const Matrix& B, const Matrix& C, F f){
+         template<typename F> void calculate(const BasicMatrix& B, const BasicMatrix& C, F f){
             auto a = begin();
             auto b = B.cbegin();
             auto c = C.cbegin();
@@ -717,7 +816,7 @@ namespace data {
           * @param other the other matrix
           * @return the error function itself
           */
-         double errorfunc(const Matrix& other) const;
+         double errorfunc(const BasicMatrix& other) const;
 
          /**
           * Computes covariance between two matrices
@@ -725,7 +824,7 @@ namespace data {
           * @param other the other matrix
           * @return covariance itself
           */
-         double cov(const Matrix& other) const;
+         double cov(const BasicMatrix& other) const;
 
          /**
           * Computes correlation between two matrices
@@ -733,14 +832,118 @@ namespace data {
           * @param other the other matrix
           * @return correlation itself
           */
-         double corr(const Matrix& other) const;
+         double corr(const BasicMatrix& other) const;
 
-         Matrix& operator++();
-         Matrix& operator--();
-         Matrix& operator+=(const Matrix& other);
-         Matrix& operator+=(double x);
-         Matrix& operator-=(const Matrix& other);
-         Matrix& operator-=(double x);
+         /**
+          * Element of the matrix together with its linear index (see topK)
+          */
+         struct IndexedValue{
+             double value;
+             int index;
+         };
+
+         /**
+          * Counts the matrix elements within each of the equal bins between low and high. The elements outside
+          * [low, high] are not counted, the elements equal to high are counted in the last bin.
+          * Each process counts its responsibility area, the counts are merged by a single allReduce of the bins
+          * This is a collective routine
+          *
+          * @param bins number of bins
+          * @param low left border of the first bin
+          * @param high right border of the last bin
+          * @return number of elements within each bin
+          * @throws incorrect_order_statistics if the number of bins is not positive
+          */
+         std::vector<int> histogram(int bins, double low, double high) const;
+
+         /**
+          * Counts the matrix elements within each of the equal bins between min() and max()
+          * This is a collective routine
+          *
+          * @param bins number of bins
+          * @return number of elements within each bin
+          * @throws incorrect_order_statistics if the number of bins is not positive
+          */
+         std::vector<int> histogram(int bins) const;
+
+         /**
+          * Finds the element that would have the given position if all matrix elements were sorted in ascending
+          * order. The matrix is not sorted and not synchronized. The distributed radix selection is used: the
+          * elements are mapped to 64-bit keys preserving their order, and each step finds the next
+          * MATRIX_SELECTION_BITS bits of the required key (see compile_options.h). To do this, each process counts
+          * its candidates by the value of these bits and the counts are merged by a single allReduce. The first step
+          * scans the whole responsibility area, the next steps scan only the local candidates left by the previous
+          * step, so the work is O(localSize) per process and the message size doesn't depend on the matrix size.
+          * The result is exact.
+          * The matrix shall not contain NaN.
+          * This is a collective routine
+          *
+          * @param position the position in the sorted matrix, from 0 to width * height - 1
+          * @return the element itself
+          * @throws incorrect_order_statistics if the position is outside the matrix
+          */
+         double orderStatistic(long long position) const;
+
+         /**
+          * Calculates the percentile with the linear interpolation between the closest elements (the same
+          * definition as numpy.percentile). The percentile is computed by the distributed selection, see
+          * orderStatistic(...)
+          * This is a collective routine
+          *
+          * @param p the percentile, from 0 to 100
+          * @return the percentile value
+          * @throws incorrect_order_statistics if p is outside [0, 100]
+          */
+         double percentile(double p) const;
+
+         /**
+          * Calculates the median
+          * This is a collective routine
+          *
+          * @return the median value
+          */
+         double median() const {
+             return percentile(50.0);
+         }
+
+         /**
+          * Finds k greatest elements of the matrix. Each process selects k greatest elements within its
+          * responsibility area in O(localSize) and all local results are merged by a single allGather of
+          * k elements per process
+          * This is a collective routine
+          *
+          * @param k number of elements to find
+          * @return min(k, width * height) greatest elements in descending order, together with their linear
+          * indices
+          * @throws incorrect_order_statistics if k is not positive
+          */
+         std::vector<IndexedValue> topK(int k) const;
+
+         /**
+          * Evaluates the element-wise expression and puts the results to the responsibility area of the current
+          * matrix. The whole expression is evaluated in a single loop. See data::MatrixExpression for details
+          * (data/MatrixExpression.h shall be included)
+          *
+          * @param expression the expression like k1 * A + k2 * B - C
+          * @return reference to the current matrix
+          * @throws matrix_dimensions_mismatch if some matrix within the expression has another size
+          */
+         template<typename E> BasicMatrix& assign(const MatrixExpression<E>& expression);
+
+         template<typename E> BasicMatrix& operator=(const MatrixExpression<E>& expression){
+             return assign(expression);
+         }
+         template<typename E> BasicMatrix& operator+=(const MatrixExpression<E>& expression);
+         template<typename E> BasicMatrix& operator-=(const MatrixExpression<E>& expression);
+         template<typename E> BasicMatrix& operator*=(const MatrixExpression<E>& expression);
+         template<typename E> BasicMatrix& operator/=(const MatrixExpression<E>& expression);
+
+         BasicMatrix& operator++();
+         BasicMatrix& operator--();
+         BasicMatrix& operator+=(const BasicMatrix& other);
+         BasicMatrix& operator+=(double x);
+         BasicMatrix& operator-=(const BasicMatrix& other);
+         BasicMatrix& operator-=(double x);
 
 
          /**
@@ -750,7 +953,7 @@ namespace data {
           * @param B the second matrix
           * @return reference to the current matrix
           */
-         Matrix& add(const Matrix& A, const Matrix& B);
+         BasicMatrix& add(const BasicMatrix& A, const BasicMatrix& B);
 
          /**
           * Performs A-B. The result will be put to the current matrix
@@ -759,7 +962,17 @@ namespace data {
           * @param B the second matrix
           * @return reference to the current matrix
           */
-         Matrix& sub(const Matrix& A, const Matrix& B);
+         BasicMatrix& sub(const BasicMatrix& A, const BasicMatrix& B);
+
+         /**
+          * Performs A+x*B. The result will be put to the current matrix
+          *
+          * @param A the first matrix
+          * @param x the number
+          * @param B the second matrix
+          * @return reference to the current matrix
+          */
+         BasicMatrix& add(const BasicMatrix& A, double x, const BasicMatrix& B);
 
          /**
           * Performs A+x and puts the result to the current matrix
@@ -768,7 +981,7 @@ namespace data {
           * @param x the number
           * @return reference to this matrix
           */
-         Matrix& add(const Matrix& A, double x);
+         BasicMatrix& add(const BasicMatrix& A, double x);
 
          /**
           * Performs x+A. The result will be put to the current matrix
@@ -777,7 +990,7 @@ namespace data {
           * @param A the matrix
           * @return reference to the result
           */
-         Matrix& add(double x, const Matrix& A) { return add(A, x); }
+         BasicMatrix& add(double x, const BasicMatrix& A) { return add(A, x); }
 
 
          /**
@@ -787,7 +1000,7 @@ namespace data {
           * @param x substracting number
           * @return reference to the result
           */
-         Matrix& sub(const Matrix& A, double x);
+         BasicMatrix& sub(const BasicMatrix& A, double x);
 
          /**
           * Provides x-A operation and puts the result to the current matrix
@@ -796,7 +1009,7 @@ namespace data {
           * @param A the matrix
           * @return reference to the result
           */
-         Matrix& sub(double x, const Matrix& A);
+         BasicMatrix& sub(double x, const BasicMatrix& A);
 
          /**
           * Performs -A and puts the result to the current matrix
@@ -804,7 +1017,7 @@ namespace data {
           * @param A the matrix to negotiate
           * @return reference to the negotiation result
           */
-         Matrix& neg(const Matrix& A);
+         BasicMatrix& neg(const BasicMatrix& A);
 
          /**
           * Provides item-by-item multiplication. The results will be returned to the same matrix.
@@ -812,7 +1025,7 @@ namespace data {
           * @param other the other multiplication term
           * @return reference to the result
           */
-         Matrix& operator*=(const Matrix& other);
+         BasicMatrix& operator*=(const BasicMatrix& other);
 
          /**
           * Multiplies all items in the matrix by the value x
@@ -820,7 +1033,7 @@ namespace data {
           * @param x the value
           * @return reference to the result
           */
-         Matrix& operator*=(double x);
+         BasicMatrix& operator*=(double x);
 
          /**
           * Provides item-by-item division. The results will be returned to the same matrix
@@ -828,7 +1041,7 @@ namespace data {
           * @param other the other multiplication term
           * @return reference to the result
           */
-         Matrix& operator/=(const Matrix& other);
+         BasicMatrix& operator/=(const BasicMatrix& other);
 
          /**
           * Divides all matrix items by the same value x
@@ -836,7 +1049,7 @@ namespace data {
           * @param x the value itself
           * @return reference to the result
           */
-         Matrix& operator/=(double x);
+         BasicMatrix& operator/=(double x);
 
 
          /**
@@ -846,7 +1059,7 @@ namespace data {
           * @param B the second matrix
           * @return reference to the result
           */
-         Matrix& mul(const Matrix& A, const Matrix& B);
+         BasicMatrix& mul(const BasicMatrix& A, const BasicMatrix& B);
 
 
          /**
@@ -856,7 +1069,7 @@ namespace data {
           * @param B The second term
           * @return reference to the result
           */
-         Matrix& div(const Matrix& A, const Matrix& B);
+         BasicMatrix& div(const BasicMatrix& A, const BasicMatrix& B);
 
          /**
           * Multiplies all items on the matrix A by the same number x and put the results to the current matrix
@@ -865,7 +1078,7 @@ namespace data {
           * @param x source number
           * @return reference to the result
           */
-         Matrix& mul(const Matrix& A, double x);
+         BasicMatrix& mul(const BasicMatrix& A, double x);
 
          /**
           * Divides all items on the matrix by the same number x and put the results to the current matrix
@@ -874,7 +1087,7 @@ namespace data {
           * @param x source number
           * @return reference to the result
           */
-         Matrix& div(const Matrix& A, double x);
+         BasicMatrix& div(const BasicMatrix& A, double x);
 
          /**
           * Multiplies all values of the matrix A by the same value x and puts the results to the current matrix
@@ -883,7 +1096,7 @@ namespace data {
           * @param A  source matrix
           * @return reference to the result
           */
-         Matrix& mul(double x, const Matrix& A) { return mul(A, x); }
+         BasicMatrix& mul(double x, const BasicMatrix& A) { return mul(A, x); }
 
          /**
           * Divides the value x by all items for the matrix A and puts the results to the current matrix
@@ -892,33 +1105,67 @@ namespace data {
           * @param A source matrix
           * @return reference to the result
           */
-         Matrix& div(double x, const Matrix& A);
+         BasicMatrix& div(double x, const BasicMatrix& A);
 
         /**
          * transposes matrix A and writes transposition result to the current matrix
+         * The responsibility area is filled by the cache-oblivious transpose kernel (see simd::transpose)
          * Warning: the function will work correctly only when matrix A is contiguous and synchronized
-         * Warning2: if nxm is size of the current matrix, the matrix A shall have size mxn for calculations to be
-         * performed correctly
-         * This is an unsafe method
          *
          * @param A source matrix
          * @return reference to the result
+         * @throws matrix_dimensions_mismatch if nxm is size of the current matrix while A has size other than mxn
          */
-        virtual Matrix& transpose(const ContiguousMatrix& A);
+        virtual BasicMatrix& transpose(const BasicContiguousMatrix<T>& A);
+
+        /**
+         * Transposes matrix A like transpose(...) but uses only the responsibility area of A. Hence, A may be
+         * local or unsynchronized matrix.
+         * Each process sends the parts of its responsibility area required by other processes by means of a single
+         * all-to-all exchange, so each element is transmitted once (the elements of the rows shared by two
+         * processes are transmitted twice). The received column strip of A is transposed by the cache-oblivious
+         * kernel.
+         * Collective routine. A shall be distributed among the same processes as the current matrix and shall
+         * not be the current matrix. Real matrix will not be synchronized after accomplishment of this method
+         *
+         * @param A source matrix
+         * @return reference to the result
+         * @throws matrix_dimensions_mismatch if nxm is size of the current matrix while A has size other than mxn
+         */
+        BasicMatrix& distributedTranspose(const BasicMatrix& A);
 
         /**
          * Products two matrices. In contrast to mul(...) method, it provides true matrix production, onot
          * item-by-item production. Matrix order makes sense.
-         * Warning # 1. Both A and B are contiguous synchronized matrices
+         * The product is calculated by the cache-blocked GEMM (see simd::gemm) for the matrix rows intersecting
+         * the responsibility area.
+         * Warning # 1. Both A and B are contiguous matrices. All elements of B and the rows of A corresponding
+         * to the rows of the responsibility area shall be synchronized
          * Warning # 2. Real matrix will not be synchronized after accomplishment of this method
-         * Warning # 3. Please, be sure that matrix sizes correspond to each other. Otherwise, the results may
-         * be incorrect or the program will fail
          *
          * @param A the first matrix
          * @param B the second matrix
          * @return reference to the result
+         * @throws matrix_dimensions_mismatch if the matrix sizes don't correspond to each other
+         */
+        BasicMatrix& dot(const BasicContiguousMatrix<T>& A, const BasicContiguousMatrix<T>& B);
+
+        /**
+         * Products two matrices like dot(...) but uses only the responsibility areas of A and B. Hence, A and B
+         * may be local or unsynchronized matrices.
+         * The rows of A required by the process are collected by a single all-to-all exchange. Then the
+         * responsibility areas of B are broadcast by their owners one by one (SUMMA over the flat
+         * decomposition): the broadcast of the next area overlaps with multiplication by the current one, and
+         * the process never stores more than two areas of B.
+         * Collective routine. A and B shall be distributed among the same processes as the current matrix.
+         * Real matrix will not be synchronized after accomplishment of this method
+         *
+         * @param A the first matrix
+         * @param B the second matrix
+         * @return reference to the result
+         * @throws matrix_dimensions_mismatch if the matrix sizes don't correspond to each other
          */
-        Matrix& dot(const ContiguousMatrix& A, const ContiguousMatrix& B);
+        BasicMatrix& distributedDot(const BasicMatrix& A, const BasicMatrix& B);
 
         /**
          * Provides spatial convolution of two matrices. The convolution results will be normalized.
@@ -934,7 +1181,8 @@ namespace data {
          * true, the border effect is high, when false the border effect is low
          * @return The convoution results will be put to the current matrix. Its alias will be returned
          */
-        Matrix& convolve(const ContiguousMatrix& K, const ContiguousMatrix& A, bool normalize = true);
+        BasicMatrix& convolve(const BasicContiguousMatrix<T>& K, const BasicContiguousMatrix<T>& A,
+                bool normalize = true);
 
         /**
          * Downsamples rhw source matrix and puts the results to the current matrix.
@@ -943,9 +1191,25 @@ namespace data {
          * @param source the source matrix
          * @return reference to this matrix
          */
-        Matrix& downsample(const ContiguousMatrix& source);
+        BasicMatrix& downsample(const BasicContiguousMatrix<T>& source);
     };
 
+    /**
+     * The double-precision matrix
+     */
+    using Matrix = BasicMatrix<double>;
+
+    /**
+     * The single-precision matrix
+     */
+    using MatrixF = BasicMatrix<float>;
+
+    /**
+     * The contiguous matrices are declared here to be used by pointer without including ContiguousMatrix.h
+     */
+    using ContiguousMatrix = BasicContiguousMatrix<double>;
+    using ContiguousMatrixF = BasicContiguousMatrix<float>;
+
 }
 
 
@@ -0,0 +1,130 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <sys/mman.h>
+#include "MatrixAllocator.h"
+#include "../compile_options.h"
+
+namespace data {
+
+    MatrixAllocator::Statistics MatrixAllocator::statistics;
+    std::size_t MatrixAllocator::poolLimit = MATRIX_POOL_LIMIT;
+    std::map<std::size_t, std::vector<void*>> MatrixAllocator::pool;
+    std::unordered_map<void*, std::size_t> MatrixAllocator::capacities;
+
+    namespace {
+
+        constexpr std::size_t PAGE_SIZE = 4096;
+
+        std::size_t roundUp(std::size_t value, std::size_t factor){
+            return (value + factor - 1) / factor * factor;
+        }
+
+    }
+
+    std::size_t MatrixAllocator::getCapacity(std::size_t bytes) {
+        if (bytes == 0){
+            return MATRIX_ALIGNMENT;
+        } else if (bytes < PAGE_SIZE){
+            return roundUp(bytes, MATRIX_ALIGNMENT);
+        } else if (MATRIX_HUGE_PAGES && bytes >= MATRIX_HUGE_PAGE_SIZE){
+            return roundUp(bytes, MATRIX_HUGE_PAGE_SIZE);
+        } else {
+            return roundUp(bytes, PAGE_SIZE);
+        }
+    }
+
+    void* MatrixAllocator::allocateBytes(std::size_t bytes) {
+        std::size_t capacity = getCapacity(bytes);
+        void* block = nullptr;
+        ++statistics.allocations;
+
+        auto it = pool.find(capacity);
+        if (it != pool.end() && !it->second.empty()){
+            block = it->second.back();
+            it->second.pop_back();
+            statistics.bytesPooled -= capacity;
+            ++statistics.poolHits;
+        } else {
+            bool hugePages = MATRIX_HUGE_PAGES && capacity >= MATRIX_HUGE_PAGE_SIZE;
+            std::size_t alignment = hugePages ? MATRIX_HUGE_PAGE_SIZE : MATRIX_ALIGNMENT;
+            if (posix_memalign(&block, alignment, capacity) != 0){
+                releasePool();
+                if (posix_memalign(&block, alignment, capacity) != 0){
+                    throw std::bad_alloc();
+                }
+            }
+#ifdef MADV_HUGEPAGE
+            if (hugePages && madvise(block, capacity, MADV_HUGEPAGE) == 0){
+                ++statistics.hugePageBlocks;
+            }
+#endif
+            capacities[block] = capacity;
+            ++statistics.systemAllocations;
+        }
+
+        statistics.bytesInUse += capacity;
+        if (statistics.bytesInUse > statistics.peakBytesInUse){
+            statistics.peakBytesInUse = statistics.bytesInUse;
+        }
+        return block;
+    }
+
+    void MatrixAllocator::deallocate(void *block) {
+        if (block == nullptr){
+            return;
+        }
+        std::size_t capacity = capacities.at(block);
+        ++statistics.deallocations;
+        statistics.bytesInUse -= capacity;
+        if (statistics.bytesPooled + capacity <= poolLimit){
+            pool[capacity].push_back(block);
+            statistics.bytesPooled += capacity;
+        } else {
+            capacities.erase(block);
+            free(block);
+        }
+    }
+
+    void MatrixAllocator::releasePool() {
+        for (auto& item: pool){
+            for (void* block: item.second){
+                capacities.erase(block);
+                free(block);
+            }
+        }
+        pool.clear();
+        statistics.bytesPooled = 0;
+    }
+
+    void MatrixAllocator::setPoolLimit(std::size_t bytes) {
+        poolLimit = bytes;
+        /* The largest blocks are released first */
+        for (auto it = pool.rbegin(); it != pool.rend() && statistics.bytesPooled > poolLimit; ++it){
+            while (!it->second.empty() && statistics.bytesPooled > poolLimit){
+                void* block = it->second.back();
+                it->second.pop_back();
+                capacities.erase(block);
+                free(block);
+                statistics.bytesPooled -= it->first;
+            }
+        }
+    }
+
+    std::string MatrixAllocator::getStatisticsString() {
+        std::stringstream ss;
+        ss << "Matrix allocations: " << statistics.allocations << " (" << statistics.poolHits << " from the pool, "
+            << statistics.systemAllocations << " from the system, " << statistics.hugePageBlocks
+            << " on huge pages)\n";
+        ss << "Matrix deallocations: " << statistics.deallocations << "\n";
+        ss << "Matrix memory in use: " << statistics.bytesInUse << " bytes (peak: " << statistics.peakBytesInUse
+            << " bytes), pooled: " << statistics.bytesPooled << " bytes";
+        return ss.str();
+    }
+
+}
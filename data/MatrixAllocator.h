@@ -0,0 +1,122 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_MATRIXALLOCATOR_H
+#define MPI2_MATRIXALLOCATOR_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace data {
+
+    /**
+     * Allocates storage for the matrix elements. All blocks are aligned to MATRIX_ALIGNMENT bytes (see
+     * compile_options.h). Large blocks are advised to be backed by transparent huge pages when MATRIX_HUGE_PAGES is 1.
+     *
+     * Released blocks are not returned to the system but kept in a pool and given to the next request of the
+     * same size. The simulation creates and destroys matrices of a few different sizes only (at each
+     * Processor::finalize() / Processor::initialize(), each trial of the sequence stimulus etc.), so after the first
+     * trial almost all requests are satisfied from the pool without heap fragmentation and page faults.
+     * The pool doesn't grow beyond the pool limit (MATRIX_POOL_LIMIT bytes by default, see setPoolLimit()): the
+     * blocks released when the pool is full are returned to the system.
+     *
+     * The allocator is not thread-safe.
+     *
+     * Example:
+     * double* buffer = data::MatrixAllocator::allocate<double>(n);
+     * ...
+     * data::MatrixAllocator::deallocate(buffer);
+     */
+    class MatrixAllocator {
+    public:
+        /**
+         * Allocation statistics of the process
+         */
+        struct Statistics{
+            unsigned long long allocations = 0;         /* total number of allocate() calls */
+            unsigned long long deallocations = 0;       /* total number of deallocate() calls */
+            unsigned long long poolHits = 0;            /* number of allocations satisfied from the pool */
+            unsigned long long systemAllocations = 0;   /* number of allocations requested from the system */
+            unsigned long long hugePageBlocks = 0;      /* number of system allocations advised to use huge pages */
+            std::size_t bytesInUse = 0;                 /* bytes given to the matrices and not released yet */
+            std::size_t peakBytesInUse = 0;             /* maximum value of bytesInUse */
+            std::size_t bytesPooled = 0;                /* bytes kept in the pool */
+        };
+
+        /**
+         * Allocates the block
+         *
+         * @param bytes the block size
+         * @return pointer to the block aligned to MATRIX_ALIGNMENT bytes
+         * @throws std::bad_alloc if the system has no enough memory
+         */
+        static void* allocateBytes(std::size_t bytes);
+
+        /**
+         * Releases the block to the pool
+         *
+         * @param block pointer returned by allocateBytes() or allocate(), nullptr is ignored
+         */
+        static void deallocate(void* block);
+
+        /**
+         * Allocates uninitialized storage for n elements
+         *
+         * @tparam T element type (double or float)
+         * @param n number of elements
+         * @return pointer to the first element aligned to MATRIX_ALIGNMENT bytes
+         */
+        template<typename T> static T* allocate(std::size_t n){
+            return static_cast<T*>(allocateBytes(n * sizeof(T)));
+        }
+
+        /**
+         * Returns all blocks kept in the pool to the system
+         */
+        static void releasePool();
+
+        /**
+         * Sets the maximum number of bytes kept in the pool. The blocks exceeding the new limit are returned to the
+         * system immediately. The limit is per process: the processes of the same node keep up to
+         * (number of processes per node) * limit bytes idle
+         *
+         * @param bytes the new limit
+         */
+        static void setPoolLimit(std::size_t bytes);
+
+        /**
+         *
+         * @return maximum number of bytes kept in the pool
+         */
+        static std::size_t getPoolLimit() { return poolLimit; }
+
+        /**
+         *
+         * @return allocation statistics of the process
+         */
+        static const Statistics& getStatistics() { return statistics; }
+
+        /**
+         *
+         * @return the statistics in human-readable form
+         */
+        static std::string getStatisticsString();
+
+    private:
+        static Statistics statistics;
+        static std::size_t poolLimit;
+        static std::map<std::size_t, std::vector<void*>> pool;
+        static std::unordered_map<void*, std::size_t> capacities;
+
+        static std::size_t getCapacity(std::size_t bytes);
+    };
+
+}
+
+
+#endif //MPI2_MATRIXALLOCATOR_H
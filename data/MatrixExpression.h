@@ -0,0 +1,244 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_MATRIXEXPRESSION_H
+#define MPI2_MATRIXEXPRESSION_H
+
+#include <type_traits>
+#include <utility>
+#include "Matrix.h"
+#include "exceptions.h"
+
+namespace data {
+
+    /**
+     * Base class for all element-wise matrix expressions. The expression is not evaluated when it is created.
+     * Instead, it is evaluated when it is assigned to the matrix in a single loop over the responsibility area
+     * without any intermediate matrices and without virtual iterators.
+     *
+     * Example:
+     * A = k1 * B + k2 * C - D;     // single pass over A, B, C and D
+     * A += 0.5 * (B - C) / D;      // single pass too
+     *
+     * The expressions are built by the arithmetic operators applied to matrices, numbers and other expressions.
+     * At least one operand of each operator shall be a matrix or an expression. All matrices within the expression
+     * shall have the same size as the target matrix and shall belong to the communicators with the same
+     * number of processes. Only the responsibility area of the target matrix is written. Each element of the target
+     * matrix depends on the same elements of the operands only, so the target matrix may be present in the right-hand
+     * side. The double-precision and single-precision matrices may be mixed: the expression is evaluated in double
+     * and the result is converted to the element type of the target matrix.
+     *
+     * The expression contains pointers to the matrix data. Don't store the expression in the variable when it
+     * refers to the temporary matrix and don't use the expression after synchronization of any matrix within it.
+     * Please, note that -A applied to the matrix A creates a new matrix. Use (-1.0 * A) or (B - A) instead.
+     *
+     * @tparam E the derived class
+     */
+    template<typename E> class MatrixExpression {
+    public:
+        /**
+         *
+         * @return reference to the derived class
+         */
+        const E& self() const { return static_cast<const E&>(*this); }
+    };
+
+    /**
+     * The matrix within the expression. The single-precision elements are converted to double during the evaluation
+     *
+     * @tparam T element type of the matrix
+     */
+    template<typename T> class MatrixTerm: public MatrixExpression<MatrixTerm<T>> {
+    private:
+        const T* data;
+        int size;
+
+    public:
+        explicit MatrixTerm(const BasicMatrix<T>& A): data(A.data), size(A.size) {}
+
+        /**
+         *
+         * @param k index of the element relatively to the beginning of the responsibility area
+         * @return value of the element
+         */
+        double value(int k) const { return data[k]; }
+
+        /**
+         *
+         * @param n total number of the elements in the target matrix
+         * @return true if the expression can be assigned to such a matrix
+         */
+        bool isCompatible(int n) const { return n == size; }
+    };
+
+    /**
+     * The number within the expression
+     */
+    class ScalarTerm: public MatrixExpression<ScalarTerm> {
+    private:
+        double x;
+
+    public:
+        explicit ScalarTerm(double value): x(value) {}
+
+        double value(int) const { return x; }
+        bool isCompatible(int) const { return true; }
+    };
+
+    /**
+     * Result of the binary operation
+     *
+     * @tparam L the left operand
+     * @tparam R the right operand
+     * @tparam Op the operation. The structure shall contain static method double apply(double, double)
+     */
+    template<typename L, typename R, typename Op> class BinaryExpression:
+            public MatrixExpression<BinaryExpression<L, R, Op>> {
+    private:
+        L left;
+        R right;
+
+    public:
+        BinaryExpression(const L& l, const R& r): left(l), right(r) {}
+
+        double value(int k) const { return Op::apply(left.value(k), right.value(k)); }
+        bool isCompatible(int n) const { return left.isCompatible(n) && right.isCompatible(n); }
+    };
+
+    /**
+     * Result of application of an arbitrary function to each element of the expression
+     *
+     * @tparam A the argument
+     * @tparam F some functor like double (*F)(double)
+     */
+    template<typename A, typename F> class UnaryExpression: public MatrixExpression<UnaryExpression<A, F>> {
+    private:
+        A argument;
+        F function;
+
+    public:
+        UnaryExpression(const A& a, F f): argument(a), function(f) {}
+
+        double value(int k) const { return function(argument.value(k)); }
+        bool isCompatible(int n) const { return argument.isCompatible(n); }
+    };
+
+    namespace expression {
+
+        struct Plus{
+            static double apply(double a, double b) { return a + b; }
+        };
+
+        struct Minus{
+            static double apply(double a, double b) { return a - b; }
+        };
+
+        struct Multiplies{
+            static double apply(double a, double b) { return a * b; }
+        };
+
+        struct Divides{
+            static double apply(double a, double b) { return a / b; }
+        };
+
+        struct Negate{
+            double operator()(double a) const { return -a; }
+        };
+
+        template<typename T> MatrixTerm<T> makeTerm(const BasicMatrix<T>& A) { return MatrixTerm<T>(A); }
+        inline ScalarTerm makeTerm(double x) { return ScalarTerm(x); }
+        template<typename E> const E& makeTerm(const MatrixExpression<E>& e) { return e.self(); }
+
+        template<typename T> using Term = std::decay_t<decltype(makeTerm(std::declval<const T&>()))>;
+
+        template<typename T> std::true_type isMatrixTest(const BasicMatrix<T>*);
+        std::false_type isMatrixTest(...);
+
+        template<typename T> constexpr bool isMatrix = decltype(isMatrixTest(std::declval<const T*>()))::value;
+
+        template<typename T> constexpr bool isOperand =
+                isMatrix<T> || std::is_base_of<MatrixExpression<T>, T>::value;
+
+        template<typename L, typename R> constexpr bool areOperands =
+                (isOperand<L> && (isOperand<R> || std::is_arithmetic<R>::value)) ||
+                (std::is_arithmetic<L>::value && isOperand<R>);
+
+        template<typename L, typename R, typename Op> using Result =
+                std::enable_if_t<areOperands<L, R>, BinaryExpression<Term<L>, Term<R>, Op>>;
+
+    }
+
+    template<typename L, typename R> expression::Result<L, R, expression::Plus> operator+(const L& a, const R& b){
+        return {expression::makeTerm(a), expression::makeTerm(b)};
+    }
+
+    template<typename L, typename R> expression::Result<L, R, expression::Minus> operator-(const L& a, const R& b){
+        return {expression::makeTerm(a), expression::makeTerm(b)};
+    }
+
+    template<typename L, typename R> expression::Result<L, R, expression::Multiplies>
+            operator*(const L& a, const R& b){
+        return {expression::makeTerm(a), expression::makeTerm(b)};
+    }
+
+    template<typename L, typename R> expression::Result<L, R, expression::Divides> operator/(const L& a, const R& b){
+        return {expression::makeTerm(a), expression::makeTerm(b)};
+    }
+
+    template<typename E> UnaryExpression<E, expression::Negate> operator-(const MatrixExpression<E>& a){
+        return {a.self(), expression::Negate()};
+    }
+
+    /**
+     * Applies the function to each element of the matrix or expression
+     *
+     * Example:
+     * A = data::apply(B + C, [](double x) { return x > 0 ? x : 0; });
+     *
+     * @param a the matrix or the expression
+     * @param f some functor like double (*f)(double)
+     * @return the expression that will apply the function during the evaluation
+     */
+    template<typename T, typename F> std::enable_if_t<expression::isOperand<T>,
+            UnaryExpression<expression::Term<T>, F>> apply(const T& a, F f){
+        return {expression::makeTerm(a), f};
+    }
+
+    template<typename T> template<typename E>
+    BasicMatrix<T>& BasicMatrix<T>::assign(const MatrixExpression<E>& expression){
+        const E& e = expression.self();
+        if (!e.isCompatible(size)){
+            throw matrix_dimensions_mismatch();
+        }
+        T* target = data;
+        for (int k = 0; k < localSize; ++k){
+            target[k] = static_cast<T>(e.value(k));
+        }
+        return *this;
+    }
+
+    template<typename T> template<typename E>
+    BasicMatrix<T>& BasicMatrix<T>::operator+=(const MatrixExpression<E>& expression){
+        return assign(*this + expression.self());
+    }
+
+    template<typename T> template<typename E>
+    BasicMatrix<T>& BasicMatrix<T>::operator-=(const MatrixExpression<E>& expression){
+        return assign(*this - expression.self());
+    }
+
+    template<typename T> template<typename E>
+    BasicMatrix<T>& BasicMatrix<T>::operator*=(const MatrixExpression<E>& expression){
+        return assign(*this * expression.self());
+    }
+
+    template<typename T> template<typename E>
+    BasicMatrix<T>& BasicMatrix<T>::operator/=(const MatrixExpression<E>& expression){
+        return assign(*this / expression.self());
+    }
+
+}
+
+#endif //MPI2_MATRIXEXPRESSION_H
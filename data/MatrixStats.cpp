@@ -0,0 +1,229 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include "MatrixStats.h"
+#include "exceptions.h"
+#include "simd/Kernels.h"
+
+namespace data {
+
+    MatrixStats::MatrixStats(mpi::Communicator &comm): communicator(comm), slotType(MPI_DOUBLE, 3),
+        reduction(reduceSlots, true) {}
+
+    MatrixStats::~MatrixStats(){
+        if (started){
+            request.wait();
+        }
+    }
+
+    void MatrixStats::reduceSlots(void *in, void *inout, int *len, MPI_Datatype*) {
+        auto* a = (Slot*)in;
+        auto* b = (Slot*)inout;
+        for (int i = 0; i < *len; ++i){
+            switch ((int)b[i].operation){
+                case SumOperation:
+                    b[i].value += a[i].value;
+                    break;
+                case MaxOperation:
+                    if (a[i].value > b[i].value || (a[i].value == b[i].value && a[i].location < b[i].location)){
+                        b[i] = a[i];
+                    }
+                    break;
+                case MinOperation:
+                    if (a[i].value < b[i].value || (a[i].value == b[i].value && a[i].location < b[i].location)){
+                        b[i] = a[i];
+                    }
+                    break;
+            }
+        }
+    }
+
+    int MatrixStats::addItem(Kind kind, const void *A, const void *B, void (*accumulate)(const Item&, Slot*),
+            int width, int size, int slotNumber) {
+        waitCompute();
+        computed = false;
+
+        Item item;
+        item.kind = kind;
+        item.A = A;
+        item.B = B;
+        item.accumulate = accumulate;
+        item.firstSlot = localSlots.size();
+        item.width = width;
+        item.size = size;
+        items.push_back(item);
+
+        Operation operation = SumOperation;
+        if (kind == MaxKind) operation = MaxOperation;
+        if (kind == MinKind) operation = MinOperation;
+        for (int i = 0; i < slotNumber; ++i){
+            localSlots.push_back({(double)operation, 0.0, 0.0});
+        }
+        globalSlots.resize(localSlots.size());
+
+        return items.size() - 1;
+    }
+
+    template<typename T> void MatrixStats::accumulate(const Item &item, Slot* slot) {
+        auto* A = static_cast<const BasicMatrix<T>*>(item.A);
+        auto* B = static_cast<const BasicMatrix<T>*>(item.B);
+        const T* a = A->data;
+        int n = A->localSize;
+        double result[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+        switch (item.kind){
+            case SumKind:
+            case MeanKind:
+                slot[0].value = simd::sum(a, n);
+                break;
+            case StdKind:
+                simd::moments(a, n, result);
+                slot[0].value = result[0];
+                slot[1].value = result[1];
+                break;
+            case ErrorfuncKind:
+                slot[0].value = simd::squaredDistance(a, B->data, n);
+                break;
+            case CovKind:
+            case CorrKind:
+                simd::crossMoments(a, B->data, n, result);
+                for (int i = 0; i < (item.kind == CovKind ? 3 : 5); ++i){
+                    slot[i].value = result[i];
+                }
+                break;
+            case MaxKind:
+            case MinKind: {
+                bool isMax = item.kind == MaxKind;
+                double value = isMax ? -INFINITY : INFINITY;
+                int location = item.size;
+                for (int k = 0; k < n; ++k){
+                    if (location == item.size || (isMax && a[k] > value) || (!isMax && a[k] < value)){
+                        value = a[k];
+                        location = k;
+                    }
+                }
+                slot[0].value = value;
+                slot[0].location = location == item.size ? location : location + A->iStart;
+                break;
+            }
+        }
+    }
+
+    template void MatrixStats::accumulate<double>(const Item& item, Slot* slot);
+    template void MatrixStats::accumulate<float>(const Item& item, Slot* slot);
+
+    template<typename T> void MatrixStats::accumulateView(const Item &item, Slot *slot) {
+        auto* A = static_cast<const BasicMatrixView<T>*>(item.A);
+        bool isMax = item.kind == MaxKind;
+        double sum = 0.0, squares = 0.0;
+        double value = isMax ? -INFINITY : INFINITY;
+        int location = item.size;
+
+        A->forEachLocal([&](T x, int index){
+            sum += x;
+            squares += (double)x * x;
+            if (location == item.size || (isMax && x > value) || (!isMax && x < value)){
+                value = x;
+                location = index;
+            }
+        });
+
+        switch (item.kind){
+            case SumKind:
+            case MeanKind:
+                slot[0].value = sum;
+                break;
+            case StdKind:
+                slot[0].value = sum;
+                slot[1].value = squares;
+                break;
+            case MaxKind:
+            case MinKind:
+                slot[0].value = value;
+                slot[0].location = location;
+                break;
+            default:
+                break;
+        }
+    }
+
+    template void MatrixStats::accumulateView<double>(const Item& item, Slot* slot);
+    template void MatrixStats::accumulateView<float>(const Item& item, Slot* slot);
+
+    void MatrixStats::startCompute() {
+        waitCompute();
+        computed = false;
+        for (auto& item: items){
+            item.accumulate(item, &localSlots[item.firstSlot]);
+        }
+        if (localSlots.empty()){
+            computed = true;
+            return;
+        }
+        request = communicator.iallReduce(localSlots.data(), globalSlots.data(), localSlots.size(), slotType,
+                reduction);
+        started = true;
+    }
+
+    void MatrixStats::waitCompute() {
+        if (started){
+            request.wait();
+            started = false;
+            computed = true;
+        }
+    }
+
+    const MatrixStats::Item &MatrixStats::getItem(int statistic) const {
+        if (!computed){
+            throw statistics_not_computed();
+        }
+        if (statistic < 0 || statistic >= (int)items.size()){
+            throw out_of_range_error();
+        }
+        return items[statistic];
+    }
+
+    double MatrixStats::getValue(int statistic) const {
+        const Item& item = getItem(statistic);
+        const Slot* slot = &globalSlots[item.firstSlot];
+        double N = item.size;
+        double meanA, meanB, varA, varB;
+
+        switch (item.kind){
+            case SumKind:
+                return slot[0].value;
+            case MeanKind:
+                return slot[0].value / N;
+            case StdKind:
+                meanA = slot[0].value / N;
+                return sqrt(slot[1].value / N - meanA * meanA);
+            case ErrorfuncKind:
+                return slot[0].value / 2.0;
+            case CovKind:
+                return slot[0].value / N - slot[1].value / N * slot[2].value / N;
+            case CorrKind:
+                meanA = slot[1].value / N;
+                meanB = slot[2].value / N;
+                varA = slot[3].value / N - meanA * meanA;
+                varB = slot[4].value / N - meanB * meanB;
+                return (slot[0].value / N - meanA * meanB) / sqrt(varA * varB);
+            default:
+                return slot[0].value;
+        }
+    }
+
+    int MatrixStats::getLocation(int statistic, int &row, int &col) const {
+        const Item& item = getItem(statistic);
+        if (item.kind != MaxKind && item.kind != MinKind){
+            throw out_of_range_error();
+        }
+        int index = globalSlots[item.firstSlot].location;
+        row = index / item.width;
+        col = index % item.width;
+        return index;
+    }
+
+}
@@ -0,0 +1,283 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_MATRIXSTATS_H
+#define MPI2_MATRIXSTATS_H
+
+#include <vector>
+#include "Matrix.h"
+#include "MatrixView.h"
+#include "../mpi/Datatype.h"
+#include "../mpi/Operation.h"
+#include "../mpi/Request.h"
+
+namespace data {
+
+    /**
+     * Computes several statistics over several matrices by means of a single collective operation. Each of
+     * Matrix::sum(), Matrix::std(), Matrix::corr() etc. calls its own allReduce while the statistics added to
+     * this object are accumulated locally and completed by one allReduce.
+     *
+     * Example:
+     * data::MatrixStats stats(comm);
+     * int meanA = stats.addMean(A);
+     * int stdA = stats.addStd(A);
+     * int maxB = stats.addMax(B);
+     * int corrAB = stats.addCorr(A, B);
+     * stats.compute();         // single allReduce
+     * double m = stats.getValue(meanA);
+     * int index = stats.getLocation(maxB, row, col);
+     *
+     * The computation may be finished non-blockingly: startCompute() accumulates the local values and starts the
+     * reduction, waitCompute() finishes it. The matrices may be changed or destroyed after startCompute().
+     *
+     * Sum, mean, standard deviation, maximum and minimum may also be added for the matrix views (see
+     * BasicMatrixView). Each process accumulates only the view elements within its responsibility area and the
+     * locations are given in the view coordinates.
+     *
+     * The statistics are accumulated in double for both double-precision and single-precision matrices.
+     * All matrices shall be distributed among the same processes as the communicator. compute(), startCompute()
+     * and waitCompute() are collective routines: all processes shall add the same statistics in the same order.
+     */
+    class MatrixStats {
+    private:
+        enum Kind {SumKind, MeanKind, StdKind, ErrorfuncKind, CovKind, CorrKind, MaxKind, MinKind};
+        enum Operation {SumOperation = 0, MaxOperation = 1, MinOperation = 2};
+
+        /**
+         * Single item of the reduction buffer. All fields are doubles in order to reduce it as a simple
+         * contiguous datatype. The location is the index of the extremum, it is exact up to 2^53
+         */
+        struct Slot{
+            double operation;
+            double value;
+            double location;
+        };
+
+        struct Item{
+            Kind kind;
+            const void* A;
+            const void* B;
+            void (*accumulate)(const Item& item, Slot* slot);
+            int firstSlot;
+            int width;
+            int size;
+        };
+
+        mpi::Communicator& communicator;
+        std::vector<Item> items;
+        std::vector<Slot> localSlots;
+        std::vector<Slot> globalSlots;
+        mpi::ContiguiousDatatype slotType;
+        mpi::ComplexOperation reduction;
+        mpi::Request request;
+        bool started = false;
+        bool computed = false;
+
+        static void reduceSlots(void* in, void* inout, int* len, MPI_Datatype* datatype);
+
+        template<typename T> static void accumulate(const Item& item, Slot* slot);
+        template<typename T> static void accumulateView(const Item& item, Slot* slot);
+
+        int addItem(Kind kind, const void* A, const void* B, void (*accumulate)(const Item&, Slot*),
+                int width, int size, int slotNumber);
+
+        template<typename T> int addItem(Kind kind, const BasicMatrix<T>& A, const BasicMatrix<T>* B,
+                int slotNumber){
+            if (B != nullptr){
+                A.checkOperand(*B);
+            }
+            return addItem(kind, &A, B, accumulate<T>, A.width, A.size, slotNumber);
+        }
+
+        template<typename T> int addItem(Kind kind, const BasicMatrixView<T>& A, int slotNumber){
+            return addItem(kind, &A, nullptr, accumulateView<T>, A.getWidth(), A.getSize(), slotNumber);
+        }
+
+        const Item& getItem(int statistic) const;
+
+    public:
+        /**
+         * Creates an empty set of statistics. This is not a collective routine
+         *
+         * @param comm the communicator where the matrices are distributed
+         */
+        explicit MatrixStats(mpi::Communicator& comm);
+
+        MatrixStats(const MatrixStats& other) = delete;
+        MatrixStats& operator=(const MatrixStats& other) = delete;
+
+        ~MatrixStats();
+
+        /**
+         * Adds the sum of all matrix elements
+         *
+         * @param A the matrix
+         * @return the statistic identifier that shall be passed to getValue()
+         */
+        template<typename T> int addSum(const BasicMatrix<T>& A) { return addItem<T>(SumKind, A, nullptr, 1); }
+
+        /**
+         * Adds the mean value of all matrix elements
+         *
+         * @param A the matrix
+         * @return the statistic identifier
+         */
+        template<typename T> int addMean(const BasicMatrix<T>& A) { return addItem<T>(MeanKind, A, nullptr, 1); }
+
+        /**
+         * Adds the standard deviation, see Matrix::std() for details
+         *
+         * @param A the matrix
+         * @return the statistic identifier
+         */
+        template<typename T> int addStd(const BasicMatrix<T>& A) { return addItem<T>(StdKind, A, nullptr, 2); }
+
+        /**
+         * Adds the error function, see Matrix::errorfunc() for details
+         *
+         * @param A the first matrix
+         * @param B the second matrix
+         * @return the statistic identifier
+         * @throws matrix_dimensions_mismatch if two matrices have different sizes
+         */
+        template<typename T> int addErrorfunc(const BasicMatrix<T>& A, const BasicMatrix<T>& B){
+            return addItem<T>(ErrorfuncKind, A, &B, 1);
+        }
+
+        /**
+         * Adds the covariance, see Matrix::cov() for details
+         *
+         * @param A the first matrix
+         * @param B the second matrix
+         * @return the statistic identifier
+         * @throws matrix_dimensions_mismatch if two matrices have different sizes
+         */
+        template<typename T> int addCov(const BasicMatrix<T>& A, const BasicMatrix<T>& B){
+            return addItem<T>(CovKind, A, &B, 3);
+        }
+
+        /**
+         * Adds the correlation coefficient, see Matrix::corr() for details
+         *
+         * @param A the first matrix
+         * @param B the second matrix
+         * @return the statistic identifier
+         * @throws matrix_dimensions_mismatch if two matrices have different sizes
+         */
+        template<typename T> int addCorr(const BasicMatrix<T>& A, const BasicMatrix<T>& B){
+            return addItem<T>(CorrKind, A, &B, 5);
+        }
+
+        /**
+         * Adds the maximum value. Its location can be revealed by getLocation()
+         *
+         * @param A the matrix
+         * @return the statistic identifier
+         */
+        template<typename T> int addMax(const BasicMatrix<T>& A) { return addItem<T>(MaxKind, A, nullptr, 1); }
+
+        /**
+         * Adds the minimum value. Its location can be revealed by getLocation()
+         *
+         * @param A the matrix
+         * @return the statistic identifier
+         */
+        template<typename T> int addMin(const BasicMatrix<T>& A) { return addItem<T>(MinKind, A, nullptr, 1); }
+
+        /**
+         * Adds the sum of all view elements. The view shall not be destroyed before startCompute()
+         *
+         * @param A the view of the matrix distributed among the communicator processes
+         * @return the statistic identifier
+         */
+        template<typename T> int addSum(const BasicMatrixView<T>& A) { return addItem<T>(SumKind, A, 1); }
+
+        /**
+         * Adds the mean value of all view elements
+         *
+         * @param A the view
+         * @return the statistic identifier
+         */
+        template<typename T> int addMean(const BasicMatrixView<T>& A) { return addItem<T>(MeanKind, A, 1); }
+
+        /**
+         * Adds the standard deviation of the view elements
+         *
+         * @param A the view
+         * @return the statistic identifier
+         */
+        template<typename T> int addStd(const BasicMatrixView<T>& A) { return addItem<T>(StdKind, A, 2); }
+
+        /**
+         * Adds the maximum value of the view elements. getLocation() returns the view row and column
+         *
+         * @param A the view
+         * @return the statistic identifier
+         */
+        template<typename T> int addMax(const BasicMatrixView<T>& A) { return addItem<T>(MaxKind, A, 1); }
+
+        /**
+         * Adds the minimum value of the view elements. getLocation() returns the view row and column
+         *
+         * @param A the view
+         * @return the statistic identifier
+         */
+        template<typename T> int addMin(const BasicMatrixView<T>& A) { return addItem<T>(MinKind, A, 1); }
+
+        /**
+         *
+         * @return total number of statistics added
+         */
+        [[nodiscard]] int getStatisticNumber() const { return items.size(); }
+
+        /**
+         * Computes all statistics. This is a collective routine
+         */
+        void compute() { startCompute(); waitCompute(); }
+
+        /**
+         * Accumulates all statistics for the responsibility area of the current process and starts the reduction.
+         * The function returns immediately. This is a collective routine
+         */
+        void startCompute();
+
+        /**
+         * Waits until the reduction started by startCompute() will be finished. Does nothing when the
+         * reduction has not been started
+         */
+        void waitCompute();
+
+        /**
+         *
+         * @return true if all statistics have been computed
+         */
+        [[nodiscard]] bool isComputed() const { return computed; }
+
+        /**
+         *
+         * @param statistic the statistic identifier returned by one of add... methods
+         * @return value of the statistic
+         * @throws statistics_not_computed if the computation has not been finished yet
+         */
+        [[nodiscard]] double getValue(int statistic) const;
+
+        /**
+         * Reveals the location of the maximum or minimum value. When the extremum is reached at several elements
+         * the element with the least index is taken
+         *
+         * @param statistic the identifier returned by addMax() or addMin()
+         * @param row row of the extremum
+         * @param col column of the extremum
+         * @return index of the extremum
+         * @throws statistics_not_computed if the computation has not been finished yet
+         */
+        int getLocation(int statistic, int& row, int& col) const;
+    };
+
+}
+
+
+#endif //MPI2_MATRIXSTATS_H
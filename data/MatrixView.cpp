@@ -0,0 +1,164 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <vector>
+#include <algorithm>
+#include "MatrixView.h"
+#include "MatrixStats.h"
+#include "exceptions.h"
+
+namespace data {
+
+    template<typename T> BasicMatrixView<T>::BasicMatrixView(BasicMatrix<T> &matrix, int top, int left, int h, int w,
+            int rs, int cs): parent(matrix), top(top), left(left), height(h), width(w), rowStride(rs),
+            columnStride(cs) {
+        if (h <= 0 || w <= 0 || rs <= 0 || cs <= 0 || top < 0 || left < 0 ||
+                top + (h - 1) * rs >= matrix.getHeight() || left + (w - 1) * cs >= matrix.getWidth()){
+            throw view_out_of_range();
+        }
+
+        firstLocalRow = lastLocalRow = 0;
+        if (parent.iFinish > parent.iStart){
+            int firstParentRow = parent.iStart / parent.width;
+            int lastParentRow = (parent.iFinish - 1) / parent.width;
+            firstLocalRow = firstParentRow <= top ? 0 : (firstParentRow - top + rowStride - 1) / rowStride;
+            lastLocalRow = lastParentRow < top ? 0 : std::min((lastParentRow - top) / rowStride + 1, height);
+            if (firstLocalRow > lastLocalRow){
+                firstLocalRow = lastLocalRow;
+            }
+        }
+    }
+
+    template<typename T> void BasicMatrixView<T>::getLocalColumns(int i, int &first, int &last) const {
+        int base = getParentIndex(i, 0);
+        int start = parent.iStart - base;
+        int finish = parent.iFinish - base;
+        first = start <= 0 ? 0 : (start + columnStride - 1) / columnStride;
+        last = finish <= 0 ? 0 : std::min((finish + columnStride - 1) / columnStride, width);
+    }
+
+    template<typename T> int BasicMatrixView<T>::getLocalSize() const {
+        int localSize = 0;
+        for (int i = firstLocalRow; i < lastLocalRow; ++i){
+            int first, last;
+            getLocalColumns(i, first, last);
+            localSize += std::max(last - first, 0);
+        }
+        return localSize;
+    }
+
+    template<typename T> void BasicMatrixView<T>::copyTo(BasicMatrix<T> &target) {
+        if (target.height != height || target.width != width){
+            throw matrix_dimensions_mismatch();
+        }
+        mpi::Communicator& comm = parent.communicator;
+        int nprocs = comm.getProcessorNumber();
+        int rank = parent.rank;
+        int sourcePiece = (parent.size + nprocs - 1) / nprocs;
+        int targetPiece = (target.size + nprocs - 1) / nprocs;
+        MPI_Datatype datatype = BasicMatrix<T>::getElementDatatype();
+
+        /* Both sides enumerate the elements in the same order: by rows of the view */
+        std::vector<int> sendCounts(nprocs, 0), recvCounts(nprocs, 0);
+        for (auto it = begin(); it != end(); ++it){
+            ++sendCounts[it.getIndex() / targetPiece];
+        }
+        for (int t = target.iStart; t < target.iFinish; ++t){
+            ++recvCounts[getParentIndex(t / width, t % width) / sourcePiece];
+        }
+        std::vector<int> sendDispls(nprocs, 0), recvDispls(nprocs, 0);
+        for (int q = 1; q < nprocs; ++q){
+            sendDispls[q] = sendDispls[q - 1] + sendCounts[q - 1];
+            recvDispls[q] = recvDispls[q - 1] + recvCounts[q - 1];
+        }
+        std::vector<T> sendBuffer(sendDispls[nprocs - 1] + sendCounts[nprocs - 1]);
+        std::vector<T> recvBuffer(recvDispls[nprocs - 1] + recvCounts[nprocs - 1]);
+        if (sendBuffer.empty() && recvBuffer.empty()){
+            return;
+        }
+
+        mpi::Requests requests(2 * nprocs);
+        for (int q = 0; q < nprocs; ++q){
+            if (q != rank && recvCounts[q] > 0){
+                requests = comm.irecv(recvBuffer.data() + recvDispls[q], recvCounts[q], datatype, q,
+                        VIEW_EXCHANGE_TAG);
+            }
+        }
+        std::vector<int> position(sendDispls);
+        for (auto it = begin(); it != end(); ++it){
+            sendBuffer[position[it.getIndex() / targetPiece]++] = *it;
+        }
+        for (int q = 0; q < nprocs; ++q){
+            if (q != rank && sendCounts[q] > 0){
+                requests = comm.isend(sendBuffer.data() + sendDispls[q], sendCounts[q], datatype, q,
+                        VIEW_EXCHANGE_TAG);
+            }
+        }
+        std::copy(sendBuffer.begin() + sendDispls[rank], sendBuffer.begin() + sendDispls[rank] + sendCounts[rank],
+                recvBuffer.begin() + recvDispls[rank]);
+        requests.waitAll();
+
+        position = recvDispls;
+        for (int t = target.iStart; t < target.iFinish; ++t){
+            int q = getParentIndex(t / width, t % width) / sourcePiece;
+            target.data[t - target.iStart] = recvBuffer[position[q]++];
+        }
+    }
+
+    template<typename T> double BasicMatrixView<T>::sum() const {
+        MatrixStats stats(parent.communicator);
+        int total = stats.addSum(*this);
+        stats.compute();
+        return stats.getValue(total);
+    }
+
+    template<typename T> double BasicMatrixView<T>::mean() const {
+        MatrixStats stats(parent.communicator);
+        int average = stats.addMean(*this);
+        stats.compute();
+        return stats.getValue(average);
+    }
+
+    template<typename T> double BasicMatrixView<T>::std() const {
+        MatrixStats stats(parent.communicator);
+        int deviation = stats.addStd(*this);
+        stats.compute();
+        return stats.getValue(deviation);
+    }
+
+    template<typename T> double BasicMatrixView<T>::max() const {
+        int row, col;
+        double value;
+        argmax(row, col, &value);
+        return value;
+    }
+
+    template<typename T> double BasicMatrixView<T>::min() const {
+        int row, col;
+        double value;
+        argmin(row, col, &value);
+        return value;
+    }
+
+    template<typename T> int BasicMatrixView<T>::argmax(int &row, int &col, double *value) const {
+        MatrixStats stats(parent.communicator);
+        int maximum = stats.addMax(*this);
+        stats.compute();
+        if (value != nullptr) *value = stats.getValue(maximum);
+        return stats.getLocation(maximum, row, col);
+    }
+
+    template<typename T> int BasicMatrixView<T>::argmin(int &row, int &col, double *value) const {
+        MatrixStats stats(parent.communicator);
+        int minimum = stats.addMin(*this);
+        stats.compute();
+        if (value != nullptr) *value = stats.getValue(minimum);
+        return stats.getLocation(minimum, row, col);
+    }
+
+    template class BasicMatrixView<double>;
+    template class BasicMatrixView<float>;
+
+}
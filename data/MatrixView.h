@@ -0,0 +1,291 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_MATRIXVIEW_H
+#define MPI2_MATRIXVIEW_H
+
+#include "Matrix.h"
+
+namespace data {
+
+    /**
+     * A non-owning rectangular region of the matrix. The view contains getHeight() x getWidth() elements, the element
+     * (i, j) of the view is the element (getTop() + i * getRowStride(), getLeft() + j * getColumnStride()) of the
+     * matrix. The strides allow to take every n-th row or column without copying.
+     *
+     * The view doesn't copy any data: all changes in the matrix are visible through the view and vice versa. The
+     * view shall not outlive the matrix.
+     *
+     * The iterators run only through the view elements that belong to the responsibility area of the matrix. The
+     * processes which responsibility areas don't intersect the view (see isOwner()) have empty iteration range.
+     *
+     * Example:
+     * data::MatrixView roi(A, 10, 20, 64, 64);        // 64 x 64 pixels starting from row 10 and column 20
+     * for (auto it = roi.begin(); it != roi.end(); ++it){
+     *     *it *= 2;                                    // only the pixels owned by the process are touched
+     * }
+     * roi.copyTo(B);                                   // B is any 64 x 64 matrix
+     *
+     * @tparam T element type: double (data::MatrixView) or float (data::MatrixViewF)
+     */
+    template<typename T> class BasicMatrixView {
+    private:
+        friend class MatrixStats;
+        BasicMatrix<T>& parent;
+        int top, left, height, width, rowStride, columnStride;
+        int firstLocalRow, lastLocalRow;
+
+        static constexpr int VIEW_EXCHANGE_TAG = 1003;
+
+        [[nodiscard]] int getParentIndex(int i, int j) const{
+            return (top + i * rowStride) * parent.width + left + j * columnStride;
+        }
+
+        /**
+         * Finds the view columns of a given row that belong to the responsibility area of the matrix
+         *
+         * @param i the view row
+         * @param first the first local column
+         * @param last the column next to the last local one. first >= last when the row has no local elements
+         */
+        void getLocalColumns(int i, int& first, int& last) const;
+
+        /**
+         * Calls f(value, index) for each view element that belongs to the responsibility area of the matrix
+         *
+         * @param f the function to call, index is the flat index of the element within the view
+         */
+        template<typename F> void forEachLocal(F f) const{
+            for (int i = firstLocalRow; i < lastLocalRow; ++i){
+                int first, last;
+                getLocalColumns(i, first, last);
+                for (int j = first; j < last; ++j){
+                    f(parent.data[getParentIndex(i, j) - parent.iStart], i * width + j);
+                }
+            }
+        }
+
+    public:
+        /**
+         * Creates the view. This is not a collective routine
+         *
+         * @param matrix the matrix
+         * @param top the matrix row corresponding to the first row of the view
+         * @param left the matrix column corresponding to the first column of the view
+         * @param h the view height
+         * @param w the view width
+         * @param rs the row stride
+         * @param cs the column stride
+         * @throws view_out_of_range if the view is empty or doesn't fit into the matrix
+         */
+        BasicMatrixView(BasicMatrix<T>& matrix, int top, int left, int h, int w, int rs = 1, int cs = 1);
+
+        /**
+         * Creates the view of a given size placed at the center of the matrix
+         *
+         * @param matrix the matrix
+         * @param h the view height
+         * @param w the view width
+         * @return the view
+         * @throws view_out_of_range if the view is larger than the matrix
+         */
+        static BasicMatrixView centered(BasicMatrix<T>& matrix, int h, int w){
+            return BasicMatrixView(matrix, (matrix.getHeight() - h) / 2, (matrix.getWidth() - w) / 2, h, w);
+        }
+
+        BasicMatrix<T>& getMatrix() { return parent; }
+        [[nodiscard]] int getTop() const { return top; }
+        [[nodiscard]] int getLeft() const { return left; }
+        [[nodiscard]] int getHeight() const { return height; }
+        [[nodiscard]] int getWidth() const { return width; }
+        [[nodiscard]] int getRowStride() const { return rowStride; }
+        [[nodiscard]] int getColumnStride() const { return columnStride; }
+
+        /**
+         *
+         * @return total number of the view elements
+         */
+        [[nodiscard]] int getSize() const { return height * width; }
+
+        /**
+         *
+         * @return number of the view elements that belong to the responsibility area of the matrix
+         */
+        [[nodiscard]] int getLocalSize() const;
+
+        /**
+         *
+         * @return true if the responsibility area of the matrix intersects the view
+         */
+        [[nodiscard]] bool isOwner() const { return getLocalSize() > 0; }
+
+        /**
+         *
+         * @param i the view row
+         * @param j the view column
+         * @return true if the element belongs to the responsibility area of the matrix
+         */
+        [[nodiscard]] bool isLocal(int i, int j) const{
+            int index = getParentIndex(i, j);
+            return index >= parent.iStart && index < parent.iFinish;
+        }
+
+        /**
+         * Provides an access to the element of the view. The access rules are the same as for operator[] of the
+         * matrix: local matrices provide access to their responsibility area only, while contiguous matrices
+         * return deprecated values outside the responsibility area until synchronized
+         *
+         * @param i the view row
+         * @param j the view column
+         * @return reference to the element
+         */
+        T& operator()(int i, int j) { return parent[getParentIndex(i, j)]; }
+        T operator()(int i, int j) const { return static_cast<const BasicMatrix<T>&>(parent)[getParentIndex(i, j)]; }
+
+        /**
+         * Iterates through the view elements within the responsibility area of the matrix, row by row
+         */
+        class Iterator{
+        private:
+            BasicMatrixView* view;
+            int row, column, lastColumn;
+
+            void findRow(){
+                for (; row < view->lastLocalRow; ++row){
+                    view->getLocalColumns(row, column, lastColumn);
+                    if (column < lastColumn){
+                        return;
+                    }
+                }
+                column = lastColumn = 0;
+            }
+
+        public:
+            Iterator(BasicMatrixView* v, int i): view(v), row(i), column(0), lastColumn(0){
+                findRow();
+            }
+
+            T& operator*() { return view->parent.data[view->getParentIndex(row, column) - view->parent.iStart]; }
+
+            Iterator& operator++(){
+                if (++column >= lastColumn){
+                    ++row;
+                    findRow();
+                }
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const { return row == other.row && column == other.column; }
+            bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+            /**
+             *
+             * @return the view row
+             */
+            [[nodiscard]] int getRow() const { return row; }
+
+            /**
+             *
+             * @return the view column
+             */
+            [[nodiscard]] int getColumn() const { return column; }
+
+            /**
+             *
+             * @return the flat index of the element within the view
+             */
+            [[nodiscard]] int getIndex() const { return row * view->width + column; }
+        };
+
+        Iterator begin() { return Iterator(this, firstLocalRow); }
+        Iterator end() { return Iterator(this, lastLocalRow); }
+
+        /**
+         * Copies the view to the matrix of the same size. Only the processes owning some view elements send the
+         * data, and only to the processes which responsibility areas of the target need them: the routine uses
+         * point-to-point messages between such pairs of processes instead of collective operations. The elements that
+         * are owned by the same process in both matrices are copied during the data transmission.
+         * The routine shall be called by all processes of the matrix communicator, the processes that neither own
+         * the view elements nor the target elements return immediately. Neither the view nor the target need to be
+         * synchronized. The target will not be synchronized after the routine
+         *
+         * @param target the target matrix, shall be distributed among the same processes as the viewed matrix
+         * @throws matrix_dimensions_mismatch if the target size differs from the view size
+         */
+        void copyTo(BasicMatrix<T>& target);
+
+        /**
+         * Calculates sum of all view elements. Each process accumulates only the view elements within its
+         * responsibility area, the processes that don't own the view contribute nothing. All reductions of the view
+         * are finished by a single allReduce over the matrix communicator (see MatrixStats), so they shall be called
+         * by all processes of the matrix communicator.
+         * This is a collective routine
+         *
+         * @return sum of all view elements
+         */
+        [[nodiscard]] double sum() const;
+
+        /**
+         * Calculates the mean value of the view elements
+         * This is a collective routine
+         *
+         * @return the mean value
+         */
+        [[nodiscard]] double mean() const;
+
+        /**
+         * Calculates the standard deviation of the view elements
+         * This is a collective routine
+         *
+         * @return the standard deviation
+         */
+        [[nodiscard]] double std() const;
+
+        /**
+         * Calculates the maximum value of the view elements
+         * This is a collective routine
+         *
+         * @return the maximum value
+         */
+        [[nodiscard]] double max() const;
+
+        /**
+         * Calculates the minimum value of the view elements
+         * This is a collective routine
+         *
+         * @return the minimum value
+         */
+        [[nodiscard]] double min() const;
+
+        /**
+         * Calculates the location of the maximum value
+         * This is a collective routine
+         *
+         * @param row the view row where the value is maximum
+         * @param col the view column where the value is maximum
+         * @param value pointer to the value which will be filled by the maximum value or nullptr if don't do it
+         * @return flat index of the maximum value within the view
+         */
+        int argmax(int& row, int& col, double* value = nullptr) const;
+
+        /**
+         * Calculates the location of the minimum value
+         * This is a collective routine
+         *
+         * @param row the view row where the value is minimum
+         * @param col the view column where the value is minimum
+         * @param value pointer to the value which will be filled by the minimum value or nullptr if don't do it
+         * @return flat index of the minimum value within the view
+         */
+        int argmin(int& row, int& col, double* value = nullptr) const;
+    };
+
+    using MatrixView = BasicMatrixView<double>;
+    using MatrixViewF = BasicMatrixView<float>;
+
+}
+
+
+#endif //MPI2_MATRIXVIEW_H
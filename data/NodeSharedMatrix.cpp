@@ -0,0 +1,234 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "NodeSharedMatrix.h"
+#include "simd/Kernels.h"
+
+namespace data {
+
+    NodeSharedMatrix::NodeSharedMatrix(mpi::Communicator &comm, int width, int height, double widthUm,
+                                       double heightUm, double filler):
+                                       ContiguousMatrix(comm, width, height, widthUm, heightUm, filler, false),
+                                       nodeCommunicator(comm.splitShared(comm.getRank())),
+                                       leaderCommunicator(MPI_COMM_NULL){
+        initializeNodes();
+        createBuffers();
+        if (isNodeLeader()){
+            for (int i=0; i < size; i++){
+                bigData[i] = filler;
+            }
+        }
+        synchronizeNode();
+    }
+
+    NodeSharedMatrix::NodeSharedMatrix(const NodeSharedMatrix &other):
+        ContiguousMatrix(other.communicator, other.width, other.height, other.widthUm, other.heightUm, 0.0, false),
+        nodeCommunicator(other.communicator.splitShared(other.rank)),
+        leaderCommunicator(MPI_COMM_NULL){
+        initializeNodes();
+        createBuffers();
+        memcpy(data, other.data, localSize * sizeof(double));
+    }
+
+    NodeSharedMatrix::~NodeSharedMatrix(){
+        if (exchangeRequests != nullptr){
+            try{
+                exchangeRequests->waitAll();
+            } catch (std::exception& e){
+                std::cerr << e.what() << std::endl;
+            }
+            delete exchangeRequests;
+            exchangeRequests = nullptr;
+        }
+        try{
+            deleteBuffers();
+        } catch (std::exception& e){
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+    void NodeSharedMatrix::initializeNodes(){
+        nodeRank = nodeCommunicator.getRank();
+        leaderCommunicator = communicator.split(isNodeLeader() ? 0 : MPI_UNDEFINED, rank);
+        if (isNodeLeader()){
+            nodeIndex = leaderCommunicator.getRank();
+        }
+        nodeCommunicator.broadcast(&nodeIndex, 1, MPI_INT, 0);
+        nodeOfRank.resize(communicator.getProcessorNumber());
+        communicator.allGather(&nodeIndex, 1, MPI_INT, &nodeOfRank[0], 1, MPI_INT);
+    }
+
+    void NodeSharedMatrix::createBuffers(){
+        int nprocs = communicator.getProcessorNumber();
+        allocatorSize = ceil((double)size/nprocs);
+        MPI_Aint windowSize = isNodeLeader() ? (MPI_Aint)allocatorSize * nprocs * sizeof(double) : 0;
+        double* localBase;
+        int errcode;
+        if ((errcode = MPI_Win_allocate_shared(windowSize, sizeof(double), MPI_INFO_NULL, *nodeCommunicator,
+                &localBase, &window)) != MPI_SUCCESS){
+            mpi::throw_exception(errcode);
+        }
+        MPI_Aint sharedSize;
+        int displacementUnit;
+        if ((errcode = MPI_Win_shared_query(window, 0, &sharedSize, &displacementUnit, &bigData)) != MPI_SUCCESS){
+            mpi::throw_exception(errcode);
+        }
+        if ((errcode = MPI_Win_lock_all(MPI_MODE_NOCHECK, window)) != MPI_SUCCESS){
+            mpi::throw_exception(errcode);
+        }
+        synchronizationBuffer = nullptr;
+        sharedBuffers = true;
+        data = bigData + iStart;
+    }
+
+    void NodeSharedMatrix::deleteBuffers(){
+        if (window != MPI_WIN_NULL){
+            int errcode;
+            if ((errcode = MPI_Win_unlock_all(window)) != MPI_SUCCESS){
+                mpi::throw_exception(errcode);
+            }
+            if ((errcode = MPI_Win_free(&window)) != MPI_SUCCESS){
+                mpi::throw_exception(errcode);
+            }
+            window = MPI_WIN_NULL;
+            bigData = nullptr;
+            data = nullptr;
+        }
+    }
+
+    void NodeSharedMatrix::synchronizeNode(){
+        int errcode;
+        if ((errcode = MPI_Win_sync(window)) != MPI_SUCCESS){
+            mpi::throw_exception(errcode);
+        }
+        nodeCommunicator.barrier();
+        if ((errcode = MPI_Win_sync(window)) != MPI_SUCCESS){
+            mpi::throw_exception(errcode);
+        }
+    }
+
+    void NodeSharedMatrix::getTransferAreas(int sourceNode, int destinationNode, int halo,
+                                            std::vector<std::pair<int, int>> &areas) const{
+        int nprocs = nodeOfRank.size();
+
+        /* Rows required by the destination node */
+        std::vector<std::pair<int, int>> required;
+        if (halo < 0){
+            required.emplace_back(0, size);
+        } else {
+            for (int r = 0; r < nprocs; ++r){
+                if (nodeOfRank[r] != destinationNode) continue;
+                int start, finish;
+                getHaloArea(r, halo, start, finish);
+                if (start < finish){
+                    required.emplace_back(start, finish);
+                }
+            }
+            std::sort(required.begin(), required.end());
+        }
+
+        /* Responsibility areas of the source node intersected with the required rows */
+        areas.clear();
+        for (int s = 0; s < nprocs; ++s){
+            if (nodeOfRank[s] != sourceNode) continue;
+            int processStart = s * allocatorSize;
+            int processFinish = std::min(processStart + allocatorSize, size);
+            for (auto& area: required){
+                int start = std::max(area.first, processStart);
+                int finish = std::min(area.second, processFinish);
+                if (start >= finish) continue;
+                if (!areas.empty() && start <= areas.back().second){
+                    areas.back().second = std::max(areas.back().second, finish);
+                } else {
+                    areas.emplace_back(start, finish);
+                }
+            }
+        }
+    }
+
+    void NodeSharedMatrix::startNodeExchange(int halo, int targetNode){
+        if (exchangeStarted){
+            finishNodeExchange();
+        }
+        exchangeStarted = true;
+        synchronizeNode();
+        if (!isNodeLeader()){
+            return;
+        }
+
+        int nodes = leaderCommunicator.getProcessorNumber();
+        std::vector<std::vector<std::pair<int, int>>> receiveAreas(nodes), sendAreas(nodes);
+        int requestNumber = 0;
+        for (int node = 0; node < nodes; ++node){
+            if (node == nodeIndex) continue;
+            if (targetNode == -1 || targetNode == nodeIndex){
+                getTransferAreas(node, nodeIndex, halo, receiveAreas[node]);
+                requestNumber += receiveAreas[node].size();
+            }
+            if (targetNode == -1 || targetNode == node){
+                getTransferAreas(nodeIndex, node, halo, sendAreas[node]);
+                requestNumber += sendAreas[node].size();
+            }
+        }
+
+        exchangeRequests = new mpi::Requests(requestNumber + 1);
+        for (int node = 0; node < nodes; ++node){
+            for (auto& area: receiveAreas[node]){
+                *exchangeRequests = leaderCommunicator.irecv(bigData + area.first, area.second - area.first,
+                        MPI_DOUBLE, node, NODE_EXCHANGE_TAG);
+            }
+            for (auto& area: sendAreas[node]){
+                *exchangeRequests = leaderCommunicator.isend(bigData + area.first, area.second - area.first,
+                        MPI_DOUBLE, node, NODE_EXCHANGE_TAG);
+            }
+        }
+    }
+
+    void NodeSharedMatrix::finishNodeExchange(){
+        if (exchangeRequests != nullptr){
+            exchangeRequests->waitAll();
+            delete exchangeRequests;
+            exchangeRequests = nullptr;
+        }
+        if (exchangeStarted){
+            synchronizeNode();
+            exchangeStarted = false;
+        }
+    }
+
+    void NodeSharedMatrix::startSynchronize(int root){
+        startNodeExchange(-1, nodeOfRank[root]);
+    }
+
+    void NodeSharedMatrix::startSynchronize(){
+        startNodeExchange(-1, -1);
+    }
+
+    void NodeSharedMatrix::waitSynchronize(){
+        finishNodeExchange();
+    }
+
+    void NodeSharedMatrix::startHaloExchange(int halo){
+        startNodeExchange(halo, -1);
+    }
+
+    void NodeSharedMatrix::finishHaloExchange(){
+        finishNodeExchange();
+    }
+
+    NodeSharedMatrix& NodeSharedMatrix::transpose(){
+        if (width != height){
+            throw matrix_dimensions_mismatch();
+        }
+        std::vector<double> area(std::max(localSize, 0));
+        if (localSize > 0){
+            simd::transposeArea(bigData, width, area.data(), width, iStart, iFinish);
+        }
+        synchronizeNode();
+        std::copy(area.begin(), area.end(), data);
+        return *this;
+    }
+
+}
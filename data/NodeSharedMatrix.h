@@ -0,0 +1,159 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_NODESHAREDMATRIX_H
+#define MPI2_NODESHAREDMATRIX_H
+
+#include <vector>
+#include <algorithm>
+#include "ContiguousMatrix.h"
+
+namespace data {
+
+    /**
+     * The contiguous matrix which data are stored in the memory shared by all processes within the same node.
+     * Unlike ContiguousMatrix that allocates two full copies of the matrix for each process, the node-shared
+     * matrix allocates a single copy of the matrix per node. Each process writes its responsibility area directly
+     * into the shared copy, so the processes within the same node always see the recent version of each other's
+     * responsibility areas after the node-local barrier. The data between the nodes are exchanged by the node
+     * leaders only (i.e., processes with rank 0 within the node).
+     *
+     * The object can be used everywhere where ContiguousMatrix is used. Iterators are not invalidated by
+     * synchronize() because the data are not moved between the buffers.
+     *
+     * All processes within the same node access the same memory. Hence, the data outside the responsibility area
+     * shall never be written until the matrix is synchronized (however, the ContiguousMatrix restricts this too).
+     */
+    class NodeSharedMatrix: public ContiguousMatrix {
+    private:
+        mpi::Communicator nodeCommunicator;
+        mpi::Communicator leaderCommunicator;
+        int nodeRank;
+        int nodeIndex;
+        std::vector<int> nodeOfRank;
+
+        MPI_Win window = MPI_WIN_NULL;
+        mpi::Requests* exchangeRequests = nullptr;
+        bool exchangeStarted = false;
+
+        static constexpr int NODE_EXCHANGE_TAG = 1003;
+
+        void initializeNodes();
+        void synchronizeNode();
+        void getTransferAreas(int sourceNode, int destinationNode, int halo,
+                std::vector<std::pair<int, int>>& areas) const;
+        void startNodeExchange(int halo, int targetNode);
+        void finishNodeExchange();
+
+    protected:
+        void createBuffers() override;
+        void deleteBuffers() override;
+
+    public:
+        /**
+         * Initializes the matrix
+         * Collective routine
+         *
+         * @param comm communicator responsible for the matrix operations
+         * @param width matrix width in pixels
+         * @param height matrix height in pixels
+         * @param widthUm matrix width in um or any other units
+         * @param heightUm matrix height in um or any other units
+         * @param filler default value for all data within the matrix
+         */
+        NodeSharedMatrix(mpi::Communicator& comm, int width, int height, double widthUm, double heightUm,
+                double filler = 0.0);
+
+        /**
+         * Creates the node-shared copy of the matrix. Only the responsibility area is copied
+         * Collective routine
+         *
+         * @param other the source matrix
+         */
+        NodeSharedMatrix(const NodeSharedMatrix& other);
+
+        ~NodeSharedMatrix() override;
+
+        NodeSharedMatrix& operator=(const NodeSharedMatrix& other){
+            ContiguousMatrix::operator=(other);
+            return *this;
+        }
+
+        using ContiguousMatrix::operator=;
+
+        /**
+         * Starts the synchronization. The node leaders start to exchange the responsibility areas of their nodes
+         * while the rest of processes return immediately after the node-local barrier. Unlike
+         * ContiguousMatrix::waitSynchronize(), the synchronization doesn't make the iterators incorrect
+         * Collective routine
+         */
+        void startSynchronize() override;
+
+        /**
+         * Starts the synchronization. After waitSynchronize() all processes within the node containing the root
+         * process have the last version of the data everywhere within the matrix
+         * Collective routine
+         *
+         * @param root rank of the root process in the communicator used for the matrix creation
+         */
+        void startSynchronize(int root) override;
+
+        /**
+         * Waits until the synchronization completes
+         * Collective routine
+         */
+        void waitSynchronize() override;
+
+        /**
+         * Starts the halo exchange. See ContiguousMatrix::startHaloExchange for details. Only the node leaders
+         * take part in the data transmission while the rest of processes wait for the node-local barrier
+         * Collective routine
+         *
+         * @param halo number of rows above and below the responsibility area that shall be updated
+         */
+        void startHaloExchange(int halo) override;
+
+        /**
+         * Waits until the halo exchange completes
+         * Collective routine
+         */
+        void finishHaloExchange() override;
+
+        using ContiguousMatrix::transpose;
+
+        /**
+         * Transposes the matrix and writes the result to itself. See ContiguousMatrix::transpose() for details.
+         * Since the buffer is shared by all processes within the node, each process transposes its responsibility
+         * area into a temporary buffer and writes it back after the node-local barrier
+         * Collective routine
+         *
+         * @return reference to the result
+         * @throws matrix_dimensions_mismatch if the matrix is not square
+         */
+        NodeSharedMatrix& transpose() override;
+
+        /**
+         *
+         * @return the communicator containing all processes within the same node
+         */
+        mpi::Communicator& getNodeCommunicator() { return nodeCommunicator; }
+
+        /**
+         *
+         * @return number of nodes the matrix is distributed among
+         */
+        int getNodeNumber() { return *std::max_element(nodeOfRank.begin(), nodeOfRank.end()) + 1; }
+
+        /**
+         *
+         * @return true if the process is the node leader
+         */
+        [[nodiscard]] bool isNodeLeader() const { return nodeRank == 0; }
+    };
+
+}
+
+
+#endif //MPI2_NODESHAREDMATRIX_H
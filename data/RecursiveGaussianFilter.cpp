@@ -0,0 +1,200 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include <algorithm>
+#include <complex>
+#include "RecursiveGaussianFilter.h"
+
+namespace data {
+
+    template<typename T>
+    RecursiveGaussianFilter::RecursiveGaussianFilter(double sigmaX, double sigmaY, const BasicMatrix<T> &target){
+        width = target.getWidth();
+        height = target.getHeight();
+        iStart = target.getIstart();
+        iFinish = target.getIfinish();
+        horizontal = getCoefficients(sigmaX);
+        vertical = getCoefficients(sigmaY);
+
+        if (iFinish > iStart) {
+            firstRow = iStart / width;
+            lastRow = (iFinish - 1) / width;
+        } else {
+            firstRow = 0;
+            lastRow = -1;
+        }
+        stripStart = std::max(firstRow - vertical.margin, 0);
+        stripFinish = std::min(lastRow + vertical.margin + 1, height);
+        int stripRows = std::max(stripFinish - stripStart, 0);
+        stripBuffer.assign((stripRows + 8) * width, 0.0);
+        causalBuffer.assign((stripRows + 4) * width, 0.0);
+        anticausalBuffer.assign((stripRows + 4) * width, 0.0);
+        line.resize(std::max(width, height));
+        lineInput.assign(std::max(width, height) + 8, 0.0);
+
+        /* The normalization weights are the results of the filtering of the matrix filled by ones */
+        horizontalWeights.assign(width, 1.0);
+        filterLine(horizontal, &horizontalWeights[0], width);
+        verticalWeights.assign(height, 1.0);
+        filterLine(vertical, &verticalWeights[0], height);
+    }
+
+    RecursiveGaussianFilter::Coefficients RecursiveGaussianFilter::getCoefficients(double sigma){
+        typedef std::complex<double> Complex;
+
+        if (!(sigma > 0.0)){
+            throw incorrect_gaussian_sigma();
+        }
+
+        /* The causal part of the impulse response is a sum of four exponents: h[n] = sum(alpha[k] * pole[k]^n).
+         * The values below are the Deriche approximation of exp(-x^2/2) */
+        const double a0 = 1.680, a1 = 3.735, b0 = 1.783, w0 = 0.6318;
+        const double c0 = -0.6803, c1 = -0.2598, b1 = 1.723, w1 = 1.997;
+        Complex pole[4] = {exp(Complex(-b0, w0) / sigma), exp(Complex(-b0, -w0) / sigma),
+                           exp(Complex(-b1, w1) / sigma), exp(Complex(-b1, -w1) / sigma)};
+        Complex alpha[4] = {Complex(a0, -a1) / 2.0, Complex(a0, a1) / 2.0,
+                            Complex(c0, -c1) / 2.0, Complex(c0, c1) / 2.0};
+
+        /* The transfer function of the causal part is numerator(z^-1) / denominator(z^-1) where
+         * denominator = product(1 - pole[k] * z^-1) and numerator = sum(alpha[k] * product(1 - pole[j] * z^-1, j!=k)) */
+        Complex denominator[5] = {1.0, 0.0, 0.0, 0.0, 0.0};
+        for (int k = 0; k < 4; ++k){
+            for (int m = k + 1; m > 0; --m){
+                denominator[m] -= pole[k] * denominator[m-1];
+            }
+        }
+        Complex numerator[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int k = 0; k < 4; ++k){
+            Complex product[4] = {alpha[k], 0.0, 0.0, 0.0};
+            for (int j = 0, order = 0; j < 4; ++j){
+                if (j == k) continue;
+                ++order;
+                for (int m = order; m > 0; --m){
+                    product[m] -= pole[j] * product[m-1];
+                }
+            }
+            for (int m = 0; m < 4; ++m){
+                numerator[m] += product[m];
+            }
+        }
+
+        /* The anticausal part is the same except h[0] that shall be taken into account only once */
+        Complex h0 = alpha[0] + alpha[1] + alpha[2] + alpha[3];
+        Coefficients c;
+        for (int m = 0; m < 5; ++m){
+            c.denominator[m] = denominator[m].real();
+            Complex anticausal = (m < 4 ? numerator[m] : 0.0) - h0 * denominator[m];
+            c.anticausal[m] = anticausal.real();
+        }
+        for (int m = 0; m < 4; ++m){
+            c.causal[m] = numerator[m].real();
+        }
+        c.anticausal[0] = 0.0;
+        c.margin = (int)ceil(HALO_SIGMAS * sigma);
+        return c;
+    }
+
+    void RecursiveGaussianFilter::filterLine(const Coefficients &c, double *x, int n){
+        /* lineInput contains four zeros before and after the data */
+        double* input = &lineInput[4];
+        std::copy(x, x + n, input);
+        std::fill(input + n, input + n + 4, 0.0);
+        const double* d = c.denominator;
+
+        double y1 = 0.0, y2 = 0.0, y3 = 0.0, y4 = 0.0;
+        for (int k = 0; k < n; ++k){
+            double y = c.causal[0] * input[k] + c.causal[1] * input[k-1] + c.causal[2] * input[k-2] +
+                    c.causal[3] * input[k-3] - d[1] * y1 - d[2] * y2 - d[3] * y3 - d[4] * y4;
+            line[k] = y;
+            y4 = y3;
+            y3 = y2;
+            y2 = y1;
+            y1 = y;
+        }
+
+        y1 = y2 = y3 = y4 = 0.0;
+        for (int k = n - 1; k >= 0; --k){
+            double y = c.anticausal[1] * input[k+1] + c.anticausal[2] * input[k+2] +
+                    c.anticausal[3] * input[k+3] + c.anticausal[4] * input[k+4] -
+                    d[1] * y1 - d[2] * y2 - d[3] * y3 - d[4] * y4;
+            x[k] = line[k] + y;
+            y4 = y3;
+            y3 = y2;
+            y2 = y1;
+            y1 = y;
+        }
+    }
+
+    void RecursiveGaussianFilter::filterColumns(const Coefficients &c, double *x, int rows){
+        /* All columns are filtered simultaneously, row by row, to keep the memory access sequential.
+         * x contains four zero rows before and after the data. The first four rows of causalBuffer and the last
+         * four rows of anticausalBuffer are always zero */
+        const double* d = c.denominator;
+
+        double* causal = &causalBuffer[4 * width];
+        for (int r = 0; r < rows; ++r){
+            double* y = causal + r * width;
+            const double* in = x + r * width;
+            for (int j = 0; j < width; ++j){
+                y[j] = c.causal[0] * in[j] + c.causal[1] * in[j - width] + c.causal[2] * in[j - 2*width] +
+                        c.causal[3] * in[j - 3*width] - d[1] * y[j - width] - d[2] * y[j - 2*width] -
+                        d[3] * y[j - 3*width] - d[4] * y[j - 4*width];
+            }
+        }
+
+        double* anticausal = &anticausalBuffer[0];
+        for (int r = rows - 1; r >= 0; --r){
+            double* y = anticausal + r * width;
+            const double* in = x + r * width;
+            for (int j = 0; j < width; ++j){
+                y[j] = c.anticausal[1] * in[j + width] + c.anticausal[2] * in[j + 2*width] +
+                        c.anticausal[3] * in[j + 3*width] + c.anticausal[4] * in[j + 4*width] -
+                        d[1] * y[j + width] - d[2] * y[j + 2*width] - d[3] * y[j + 3*width] - d[4] * y[j + 4*width];
+            }
+        }
+
+        for (int n = 0; n < rows * width; ++n){
+            x[n] = causal[n] + anticausal[n];
+        }
+    }
+
+    template<typename T>
+    void RecursiveGaussianFilter::filter(BasicMatrix<T> &output, const BasicContiguousMatrix<T> &A){
+        if (output.getWidth() != width || output.getHeight() != height ||
+            A.getWidth() != width || A.getHeight() != height ||
+            output.getIstart() != iStart || output.getIfinish() != iFinish){
+            throw matrix_dimensions_mismatch();
+        }
+        if (iFinish <= iStart){
+            return;
+        }
+
+        int stripRows = stripFinish - stripStart;
+        double* strip = &stripBuffer[4 * width];
+        typename BasicContiguousMatrix<T>::ConstantIterator a(A, stripStart, 0);
+        for (int r = 0; r < stripRows; ++r){
+            double* row = strip + r * width;
+            for (int j = 0; j < width; ++j){
+                row[j] = a.val(r, j);
+            }
+            filterLine(horizontal, row, width);
+        }
+        filterColumns(vertical, strip, stripRows);
+
+        int index = iStart;
+        for (auto b = output.begin(); b != output.end(); ++b, ++index){
+            int i = index / width;
+            int j = index % width;
+            *b = strip[(i - stripStart) * width + j] / (horizontalWeights[j] * verticalWeights[i]);
+        }
+    }
+
+    template RecursiveGaussianFilter::RecursiveGaussianFilter(double, double, const Matrix&);
+    template RecursiveGaussianFilter::RecursiveGaussianFilter(double, double, const MatrixF&);
+    template void RecursiveGaussianFilter::filter(Matrix&, const ContiguousMatrix&);
+    template void RecursiveGaussianFilter::filter(MatrixF&, const ContiguousMatrixF&);
+
+}
@@ -0,0 +1,94 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_RECURSIVEGAUSSIANFILTER_H
+#define MPI2_RECURSIVEGAUSSIANFILTER_H
+
+#include <vector>
+#include "ContiguousMatrix.h"
+
+namespace data {
+
+    /**
+     * Provides the normalized convolution with the gaussian kernel exp(-x^2/(2*sigmaX^2) - y^2/(2*sigmaY^2)) by
+     * means of the fourth-order Deriche recursive filter (R. Deriche, Recursively implementing the Gaussian and its
+     * derivatives, INRIA Research Report 1893, 1993). The number of operations per pixel doesn't depend on the
+     * kernel size. Deviation of the filter impulse response from the gaussian is less than 0.001 of its maximum.
+     *
+     * The result approximates Matrix::convolve with normalize = true: the values outside the matrix are treated
+     * as zeros and each output pixel is divided by the sum of the kernel part that overlaps the matrix.
+     *
+     * Each process filters only the rows that are closer than HALO_SIGMAS * sigmaY to its responsibility area.
+     * This is not a collective routine; the source matrix shall be synchronized within these rows.
+     */
+    class RecursiveGaussianFilter {
+    private:
+
+        /**
+         * Coefficients of the recursive filter along one direction. The filter output is y[n] = y+[n] + y-[n] where
+         * y+[n] = sum(causal[m] * x[n-m], m=0..3) - sum(denominator[m] * y+[n-m], m=1..4)
+         * y-[n] = sum(anticausal[m] * x[n+m], m=1..4) - sum(denominator[m] * y-[n+m], m=1..4)
+         */
+        struct Coefficients{
+            double causal[4];
+            double anticausal[5];
+            double denominator[5];
+            int margin;
+        };
+
+        int width, height, iStart, iFinish;
+        int firstRow, lastRow, stripStart, stripFinish;
+        Coefficients horizontal, vertical;
+        std::vector<double> horizontalWeights, verticalWeights;
+        std::vector<double> stripBuffer, causalBuffer, anticausalBuffer, line, lineInput;
+
+        static Coefficients getCoefficients(double sigma);
+        void filterLine(const Coefficients& c, double* x, int n);
+        void filterColumns(const Coefficients& c, double* x, int rows);
+
+    public:
+        /**
+         * Rows that are further than HALO_SIGMAS * sigma from the responsibility area are ignored
+         */
+        static constexpr double HALO_SIGMAS = 5.0;
+
+        /**
+         * Prepares the filter
+         *
+         * @param sigmaX standard deviation of the gaussian along the rows, in pixels
+         * @param sigmaY standard deviation of the gaussian along the columns, in pixels
+         * @param target any matrix which dimensions and responsibility area are the same as for the filtering
+         * results
+         * @throws incorrect_gaussian_sigma if any of the standard deviations is not positive
+         */
+        template<typename T> RecursiveGaussianFilter(double sigmaX, double sigmaY, const BasicMatrix<T>& target);
+
+        RecursiveGaussianFilter(const RecursiveGaussianFilter& other) = delete;
+        RecursiveGaussianFilter& operator=(const RecursiveGaussianFilter& other) = delete;
+
+        /**
+         * Provides the filtering. This is not a collective routine
+         * The filtering is always provided in double precision while the matrices may be either double (T = double)
+         * or single (T = float) precision
+         *
+         * @param output the matrix where the results will be put. Dimensions of the matrix and its responsibility
+         * area shall be the same as for the target matrix passed to the constructor
+         * @param A the source matrix. The matrix shall be synchronized at least within getHaloRows() rows from
+         * the responsibility area
+         */
+        template<typename T> void filter(BasicMatrix<T>& output, const BasicContiguousMatrix<T>& A);
+
+        /**
+         *
+         * @return number of rows above and below the responsibility area which values are required for the
+         * filtering (see ContiguousMatrix::synchronizeHalo)
+         */
+        [[nodiscard]] int getHaloRows() const { return vertical.margin; }
+    };
+
+}
+
+
+#endif //MPI2_RECURSIVEGAUSSIANFILTER_H
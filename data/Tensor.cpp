@@ -0,0 +1,279 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <algorithm>
+#include <cmath>
+#include "Tensor.h"
+#include "MatrixAllocator.h"
+
+namespace data {
+
+    Tensor::Channel::Channel(Tensor &tensor, int c):
+        ContiguousMatrix(tensor.communicator, tensor.width, tensor.height, tensor.widthUm, tensor.heightUm, 0.0,
+                false), parent(tensor), index(c){
+        sharedBuffers = true;
+        createBuffers();
+    }
+
+    Tensor::Channel::~Channel(){
+        try{
+            waitSynchronize();
+        } catch (std::exception& e){
+            std::cerr << e.what() << std::endl;
+        }
+        deleteBuffers();
+    }
+
+    void Tensor::Channel::createBuffers(){
+        if (width != parent.width || height != parent.height){
+            throw matrix_dimensions_mismatch();
+        }
+        allocatorSize = parent.allocatorSize;
+        bigData = parent.bigData + index * parent.channelStride;
+        synchronizationBuffer = nullptr;
+        data = bigData + iStart;
+    }
+
+    void Tensor::Channel::deleteBuffers(){
+        /* The memory belongs to the tensor */
+        bigData = nullptr;
+        synchronizationBuffer = nullptr;
+        data = nullptr;
+    }
+
+    Tensor::Channel& Tensor::Channel::operator=(const ContiguousMatrix &other){
+        if (other.getWidth() != width || other.getHeight() != height){
+            throw matrix_dimensions_mismatch();
+        }
+        ContiguousMatrix::operator=(other);
+        return *this;
+    }
+
+    void Tensor::Channel::startSynchronize(){
+        if (synchronizationStarted){
+            waitSynchronize();
+        }
+        /* The responsibility area is already in place, so the data are gathered directly into the channel */
+        MPI_Datatype datatype = Matrix::getElementDatatype();
+        synchronizationRequest = communicator.iallGather(MPI_IN_PLACE, 0, datatype, bigData, allocatorSize,
+                datatype);
+        synchronizationRoot = -1;
+        synchronizationStarted = true;
+    }
+
+    void Tensor::Channel::startSynchronize(int root){
+        if (synchronizationStarted){
+            waitSynchronize();
+        }
+        MPI_Datatype datatype = Matrix::getElementDatatype();
+        if (rank == root){
+            synchronizationRequest = communicator.igather(MPI_IN_PLACE, 0, datatype, bigData, allocatorSize,
+                    datatype, root);
+        } else {
+            synchronizationRequest = communicator.igather(bigData + rank * allocatorSize, allocatorSize, datatype,
+                    nullptr, 0, datatype, root);
+        }
+        synchronizationRoot = root;
+        synchronizationStarted = true;
+    }
+
+    void Tensor::Channel::waitSynchronize(){
+        if (!synchronizationStarted){
+            return;
+        }
+        synchronizationRequest.wait();
+        synchronizationStarted = false;
+    }
+
+    Tensor::Tensor(mpi::Communicator &comm, int c, int w, int h, double w_um, double h_um, double filler):
+        communicator(comm), channels(c), width(w), height(h), widthUm(w_um), heightUm(h_um){
+        int nprocs = communicator.getProcessorNumber();
+        size = width * height;
+        rank = communicator.getRank();
+        allocatorSize = ceil((double)size / nprocs);
+        channelStride = allocatorSize * nprocs;
+        iStart = std::min(allocatorSize * rank, size);
+        iFinish = std::min(iStart + allocatorSize, size);
+        localSize = iFinish - iStart;
+
+        bigData = MatrixAllocator::allocate<double>((std::size_t)channels * channelStride);
+        std::fill(bigData, bigData + (std::size_t)channels * channelStride, filler);
+
+        /* Responsibility areas of the process in all channels, the next process areas follow immediately */
+        localAreaType = new mpi::VectorDatatype(MPI_DOUBLE, allocatorSize, channelStride, channels);
+        synchronizationType = new mpi::ResizedDatatype(*localAreaType, 0, allocatorSize * sizeof(double));
+
+        channelMatrices.reserve(channels);
+        for (int index = 0; index < channels; ++index){
+            channelMatrices.push_back(new Channel(*this, index));
+        }
+    }
+
+    Tensor::~Tensor(){
+        try{
+            waitSynchronize();
+            finishHaloExchange();
+        } catch (std::exception& e){
+            std::cerr << e.what() << std::endl;
+        }
+        for (auto* channel: channelMatrices){
+            delete channel;
+        }
+        delete synchronizationType;
+        delete localAreaType;
+        MatrixAllocator::deallocate(bigData);
+    }
+
+    void Tensor::checkOperand(const Tensor &other) const{
+        if (other.channels != channels || other.width != width || other.height != height ||
+            other.iStart != iStart || other.iFinish != iFinish){
+            throw matrix_dimensions_mismatch();
+        }
+    }
+
+    void Tensor::touch(){
+        for (auto* channel: channelMatrices){
+            channel->touch();
+        }
+    }
+
+    void Tensor::fill(double value){
+        for (int c = 0; c < channels; ++c){
+            std::fill(localData(c), localData(c) + localSize, value);
+        }
+        touch();
+    }
+
+    Tensor& Tensor::operator+=(const Tensor &other){
+        calculate(*this, other, [](double a, double b) { return a + b; });
+        return *this;
+    }
+
+    Tensor& Tensor::operator-=(const Tensor &other){
+        calculate(*this, other, [](double a, double b) { return a - b; });
+        return *this;
+    }
+
+    Tensor& Tensor::operator*=(const Tensor &other){
+        calculate(*this, other, [](double a, double b) { return a * b; });
+        return *this;
+    }
+
+    Tensor& Tensor::operator+=(double value){
+        apply([value](double x) { return x + value; });
+        return *this;
+    }
+
+    Tensor& Tensor::operator*=(double value){
+        apply([value](double x) { return x * value; });
+        return *this;
+    }
+
+    Tensor& Tensor::operator*=(const ContiguousMatrix &mask){
+        if (mask.getWidth() != width || mask.getHeight() != height ||
+            mask.getIstart() != iStart || mask.getIfinish() != iFinish){
+            throw matrix_dimensions_mismatch();
+        }
+        const double* m = mask.localSpan().begin();
+        for (int c = 0; c < channels; ++c){
+            double* x = localData(c);
+            for (int n = 0; n < localSize; ++n){
+                x[n] *= m[n];
+            }
+        }
+        touch();
+        return *this;
+    }
+
+    void Tensor::startSynchronize(){
+        if (synchronizationStarted){
+            waitSynchronize();
+        }
+        synchronizationRequest = communicator.iallGather(MPI_IN_PLACE, 0, *synchronizationType, bigData, 1,
+                *synchronizationType);
+        synchronizationStarted = true;
+    }
+
+    void Tensor::waitSynchronize(){
+        if (!synchronizationStarted){
+            return;
+        }
+        synchronizationRequest.wait();
+        synchronizationStarted = false;
+    }
+
+    void Tensor::startHaloExchange(int halo){
+        int nprocs = communicator.getProcessorNumber();
+        if (haloRequests != nullptr){
+            finishHaloExchange();
+        }
+        haloRequests = new mpi::Requests(2 * nprocs);
+        if (channels == 0){
+            return;
+        }
+
+        /* The halo areas are the same for all channels, see ContiguousMatrix::startHaloExchange */
+        Channel& first = *channelMatrices[0];
+        int haloStart, haloFinish;
+        first.getHaloArea(rank, halo, haloStart, haloFinish);
+        for (int r = 0; r < nprocs; ++r){
+            if (r == rank) continue;
+            int processStart = r * allocatorSize;
+            int processFinish = std::min(processStart + allocatorSize, size);
+
+            int recvStart = std::max(haloStart, processStart);
+            int recvFinish = std::min(haloFinish, processFinish);
+            if (recvStart < recvFinish){
+                auto* type = new mpi::VectorDatatype(MPI_DOUBLE, recvFinish - recvStart, channelStride, channels);
+                haloTypes.push_back(type);
+                *haloRequests = communicator.irecv(bigData + recvStart, 1, *type, r, HALO_EXCHANGE_TAG);
+            }
+
+            int neighborStart, neighborFinish;
+            first.getHaloArea(r, halo, neighborStart, neighborFinish);
+            int sendStart = std::max(neighborStart, iStart);
+            int sendFinish = std::min(neighborFinish, iFinish);
+            if (sendStart < sendFinish){
+                auto* type = new mpi::VectorDatatype(MPI_DOUBLE, sendFinish - sendStart, channelStride, channels);
+                haloTypes.push_back(type);
+                *haloRequests = communicator.isend(bigData + sendStart, 1, *type, r, HALO_EXCHANGE_TAG);
+            }
+        }
+    }
+
+    void Tensor::finishHaloExchange(){
+        if (haloRequests != nullptr){
+            haloRequests->waitAll();
+            delete haloRequests;
+            haloRequests = nullptr;
+        }
+        for (auto* type: haloTypes){
+            delete type;
+        }
+        haloTypes.clear();
+    }
+
+    void Tensor::convolve(Convolver &convolver, Tensor &output){
+        checkOperand(output);
+        if (&output == this){
+            throw matrix_dimensions_mismatch();
+        }
+        if (channels == 0){
+            return;
+        }
+
+        /* The convolver keeps the intermediate results between convolveInterior() and convolveBoundary(), so
+         * only the first channel can be overlapped with the exchange. */
+        startHaloExchange(convolver.getHaloRows());
+        convolver.convolveInterior(output[0], (*this)[0]);
+        finishHaloExchange();
+        convolver.convolveBoundary(output[0], (*this)[0]);
+        for (int c = 1; c < channels; ++c){
+            convolver.convolve(output[c], (*this)[c]);
+        }
+        output.touch();
+    }
+
+}
@@ -0,0 +1,342 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_TENSOR_H
+#define MPI2_TENSOR_H
+
+#include <vector>
+#include "ContiguousMatrix.h"
+#include "Convolver.h"
+#include "../mpi/Datatype.h"
+#include "../mpi/Request.h"
+
+namespace data {
+
+    /**
+     * A stack of several matrices of the same size (channels x height x width): several stimuli or several
+     * trials processed by the same pipeline. Each channel is partitioned among the processes exactly like
+     * ContiguousMatrix, so the process is responsible for the same elements in all channels.
+     *
+     * All channels are stored in a single buffer, one full channel after another. The tensor operations process
+     * all channels at once: element-wise operations run a single loop over the local elements of all channels,
+     * synchronize() sends the responsibility areas of all channels by a single collective call and
+     * startHaloExchange() sends a single message to each neighbor. Hence, the processing of N channels requires
+     * as many messages as the processing of a single matrix.
+     *
+     * Each channel is available as ContiguousMatrix (see operator[]) that shares the memory with the tensor and
+     * can be passed everywhere where the ContiguousMatrix is required. Unlike ContiguousMatrix, the channel
+     * synchronization doesn't move the data between the buffers, so the iterators are not invalidated by
+     * synchronize(). The channel can't be resized: assignment of the matrix with different size throws
+     * matrix_dimensions_mismatch.
+     *
+     * Usage:
+     * data::Tensor stimuli(comm, 8, width, height, widthUm, heightUm), responses(comm, 8, width, height, ...);
+     * data::Convolver convolver(K, stimuli[0]);
+     * stimuli.apply([](double x) { return x * x; });
+     * stimuli.convolve(convolver, responses);
+     * responses.synchronize();
+     */
+    class Tensor {
+    public:
+        /**
+         * A single channel of the tensor
+         */
+        class Channel: public ContiguousMatrix {
+        private:
+            Tensor& parent;
+            int index;
+
+            friend class Tensor;
+
+        protected:
+            void createBuffers() override;
+            void deleteBuffers() override;
+
+        public:
+            /**
+             * Creates the channel. Use Tensor::operator[] to access the channel
+             *
+             * @param tensor the tensor that contains the channel
+             * @param c index of the channel
+             */
+            Channel(Tensor& tensor, int c);
+
+            Channel(const Channel& other) = delete;
+
+            ~Channel() override;
+
+            using ContiguousMatrix::operator=;
+
+            /**
+             * Copies the responsibility area of the other matrix into the channel
+             *
+             * @param other matrix of the channel size
+             * @return reference to the channel
+             * @throws matrix_dimensions_mismatch if the other matrix has another size
+             */
+            Channel& operator=(const ContiguousMatrix& other);
+
+            Channel& operator=(ContiguousMatrix&& other){
+                return *this = static_cast<const ContiguousMatrix&>(other);
+            }
+
+            Channel& operator=(const Channel& other){
+                return *this = static_cast<const ContiguousMatrix&>(other);
+            }
+
+            /**
+             *
+             * @return the tensor that contains the channel
+             */
+            Tensor& getTensor() { return parent; }
+
+            /**
+             *
+             * @return index of the channel within the tensor
+             */
+            [[nodiscard]] int getIndex() const { return index; }
+
+            /**
+             * Starts synchronization of the channel only. Use Tensor::startSynchronize() to synchronize all
+             * channels at once
+             * Collective routine
+             */
+            void startSynchronize() override;
+
+            /**
+             * Starts synchronization of the channel only at the root process
+             * Collective routine
+             *
+             * @param root rank of the root process
+             */
+            void startSynchronize(int root) override;
+
+            /**
+             * Waits until the synchronization of the channel is completed
+             */
+            void waitSynchronize() override;
+        };
+
+    private:
+        mpi::Communicator& communicator;
+        int channels, width, height;
+        double widthUm, heightUm;
+        int size, localSize, iStart, iFinish, rank;
+        int allocatorSize, channelStride;
+        double* bigData;
+        std::vector<Channel*> channelMatrices;
+
+        mpi::VectorDatatype* localAreaType;
+        mpi::ResizedDatatype* synchronizationType;
+        mpi::Request synchronizationRequest;
+        bool synchronizationStarted = false;
+
+        mpi::Requests* haloRequests = nullptr;
+        std::vector<mpi::VectorDatatype*> haloTypes;
+        static constexpr int HALO_EXCHANGE_TAG = 1004;
+
+        void checkOperand(const Tensor& other) const;
+
+        /**
+         *
+         * @param c channel index
+         * @return pointer to the first element of the responsibility area of the channel c
+         */
+        double* localData(int c) { return bigData + c * channelStride + iStart; }
+        [[nodiscard]] const double* localData(int c) const { return bigData + c * channelStride + iStart; }
+
+    public:
+        /**
+         * Creates new tensor. This is not a collective routine
+         *
+         * @param comm communicator responsible for the tensor operations
+         * @param c number of channels
+         * @param w width of each channel in pixels
+         * @param h height of each channel in pixels
+         * @param w_um width of each channel in um
+         * @param h_um height of each channel in um
+         * @param filler initial value for all elements
+         */
+        Tensor(mpi::Communicator& comm, int c, int w, int h, double w_um, double h_um, double filler = 0.0);
+
+        Tensor(const Tensor& other) = delete;
+        Tensor& operator=(const Tensor& other) = delete;
+
+        ~Tensor();
+
+        [[nodiscard]] mpi::Communicator& getCommunicator() const { return communicator; }
+        [[nodiscard]] int getChannels() const { return channels; }
+        [[nodiscard]] int getWidth() const { return width; }
+        [[nodiscard]] int getHeight() const { return height; }
+        [[nodiscard]] double getWidthUm() const { return widthUm; }
+        [[nodiscard]] double getHeightUm() const { return heightUm; }
+        [[nodiscard]] int getIstart() const { return iStart; }
+        [[nodiscard]] int getIfinish() const { return iFinish; }
+
+        /**
+         *
+         * @param c channel index
+         * @return the channel as a matrix
+         * @throws out_of_range_error if there is no such channel
+         */
+        Channel& operator[](int c){
+            if (c >= 0 && c < channels){
+                return *channelMatrices[c];
+            } else {
+                throw out_of_range_error();
+            }
+        }
+
+        const Channel& operator[](int c) const{
+            if (c >= 0 && c < channels){
+                return *channelMatrices[c];
+            } else {
+                throw out_of_range_error();
+            }
+        }
+
+        /**
+         * Changes the versions of all channels (see BasicMatrix::touch()). The tensor operations call this method
+         * themselves
+         */
+        void touch();
+
+        /**
+         * Sets all local elements of all channels to the same value
+         *
+         * @param value the value
+         */
+        void fill(double value);
+
+        /**
+         * Applies the function to each local element of all channels: x = f(x)
+         *
+         * @param f the function that takes the element value and returns its new value
+         */
+        template<typename F> void apply(F f){
+            for (int c = 0; c < channels; ++c){
+                double* x = localData(c);
+                for (int n = 0; n < localSize; ++n){
+                    x[n] = f(x[n]);
+                }
+            }
+            touch();
+        }
+
+        /**
+         * Sets each local element of all channels to f(a), where a is the corresponding element of A
+         *
+         * @param A the tensor of the same size and the same number of channels
+         * @param f the function
+         * @throws matrix_dimensions_mismatch if the tensors have different sizes
+         */
+        template<typename F> void calculate(const Tensor& A, F f){
+            checkOperand(A);
+            for (int c = 0; c < channels; ++c){
+                double* x = localData(c);
+                const double* a = A.localData(c);
+                for (int n = 0; n < localSize; ++n){
+                    x[n] = f(a[n]);
+                }
+            }
+            touch();
+        }
+
+        /**
+         * Sets each local element of all channels to f(a, b), where a and b are the corresponding elements of
+         * A and B
+         *
+         * @param A the first tensor of the same size and the same number of channels
+         * @param B the second tensor of the same size and the same number of channels
+         * @param f the function
+         * @throws matrix_dimensions_mismatch if the tensors have different sizes
+         */
+        template<typename F> void calculate(const Tensor& A, const Tensor& B, F f){
+            checkOperand(A);
+            checkOperand(B);
+            for (int c = 0; c < channels; ++c){
+                double* x = localData(c);
+                const double* a = A.localData(c);
+                const double* b = B.localData(c);
+                for (int n = 0; n < localSize; ++n){
+                    x[n] = f(a[n], b[n]);
+                }
+            }
+            touch();
+        }
+
+        Tensor& operator+=(const Tensor& other);
+        Tensor& operator-=(const Tensor& other);
+        Tensor& operator*=(const Tensor& other);
+        Tensor& operator+=(double value);
+        Tensor& operator*=(double value);
+
+        /**
+         * Multiplies each channel by the same matrix element-wise (e.g., by the spatial mask)
+         *
+         * @param mask the matrix with the same size and the same responsibility area as the channels
+         * @return reference to this tensor
+         * @throws matrix_dimensions_mismatch if the matrix has another size
+         */
+        Tensor& operator*=(const ContiguousMatrix& mask);
+
+        /**
+         * Starts the synchronization of all channels by a single collective call
+         * Collective routine
+         */
+        void startSynchronize();
+
+        /**
+         * Waits until the synchronization started by startSynchronize() is completed
+         */
+        void waitSynchronize();
+
+        /**
+         * Synchronizes all channels: after the synchronization each process has the recent values of all elements
+         * in all channels
+         * Collective routine
+         */
+        void synchronize(){
+            startSynchronize();
+            waitSynchronize();
+        }
+
+        /**
+         * Starts the exchange of the halo rows of all channels (see ContiguousMatrix::startHaloExchange). Each
+         * neighbor receives a single message for all channels
+         * Collective routine
+         *
+         * @param halo number of rows above and below the responsibility area
+         */
+        void startHaloExchange(int halo);
+
+        /**
+         * Waits until the halo exchange is completed
+         */
+        void finishHaloExchange();
+
+        void synchronizeHalo(int halo){
+            startHaloExchange(halo);
+            finishHaloExchange();
+        }
+
+        /**
+         * Convolves each channel with the kernel of the convolver: output[c] = convolver.convolve(this[c]).
+         * The halo rows of all channels are exchanged by a single batched exchange overlapped with the
+         * computations, so the tensor doesn't need to be synchronized before the convolution. The responsibility
+         * area of the output is computed only.
+         * Collective routine
+         *
+         * @param convolver the convolver created for the matrices of the channel size
+         * @param output the tensor with the same size and the same number of channels, not the same as this tensor
+         * @throws matrix_dimensions_mismatch if the tensors have different sizes
+         */
+        void convolve(Convolver& convolver, Tensor& output);
+    };
+
+}
+
+
+#endif //MPI2_TENSOR_H
@@ -0,0 +1,152 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <algorithm>
+#include "TiledMatrix.h"
+
+namespace data {
+
+    TiledMatrix::TiledMatrix(BlockDecomposition &d, double w_um, double h_um, int h):
+        decomposition(d), widthUm(w_um), heightUm(h_um), halo(h){
+
+        auto& tile = decomposition.getLocalTile();
+        tileWidth = tile.getWidth();
+        tileHeight = tile.getHeight();
+        stride = tileWidth + 2 * halo;
+        tileData.assign((tileHeight + 2 * halo) * stride, 0.0);
+
+        neighbors = decomposition.getNeighbors(halo);
+        for (auto& neighbor: neighbors){
+            haloTypes.push_back(new mpi::VectorDatatype(MPI_DOUBLE, neighbor.columns, stride, neighbor.rows));
+        }
+    }
+
+    TiledMatrix::~TiledMatrix(){
+        if (haloRequests != nullptr){
+            try{
+                haloRequests->waitAll();
+            } catch (std::exception& e){
+                std::cerr << e.what() << std::endl;
+            }
+            delete haloRequests;
+        }
+        for (auto* type: haloTypes){
+            delete type;
+        }
+    }
+
+    void TiledMatrix::startHaloExchange(){
+        if (haloRequests != nullptr){
+            finishHaloExchange();
+        }
+        haloRequests = new mpi::Requests(2 * neighbors.size() + 1);
+        auto& comm = decomposition.getCommunicator();
+
+        for (std::size_t n = 0; n < neighbors.size(); ++n){
+            auto& neighbor = neighbors[n];
+            /* The neighbor sends us the data with the tag corresponding to its opposite direction */
+            int sendTag = HALO_EXCHANGE_TAG + 3 * (neighbor.rowShift + 1) + neighbor.columnShift + 1;
+            int receiveTag = HALO_EXCHANGE_TAG + 3 * (1 - neighbor.rowShift) + 1 - neighbor.columnShift;
+            *haloRequests = comm.irecv(&(*this)(neighbor.receiveRow, neighbor.receiveColumn), 1,
+                    *haloTypes[n], neighbor.rank, receiveTag);
+            *haloRequests = comm.isend(&(*this)(neighbor.sendRow, neighbor.sendColumn), 1,
+                    *haloTypes[n], neighbor.rank, sendTag);
+        }
+    }
+
+    void TiledMatrix::finishHaloExchange(){
+        if (haloRequests != nullptr){
+            haloRequests->waitAll();
+            delete haloRequests;
+            haloRequests = nullptr;
+        }
+    }
+
+    void TiledMatrix::copyFrom(const ContiguousMatrix &source){
+        if (source.getWidth() != getWidth() || source.getHeight() != getHeight()){
+            throw matrix_dimensions_mismatch();
+        }
+        ContiguousMatrix::ConstantIterator a(source, getRowStart(), getColumnStart());
+        for (int i = 0; i < tileHeight; ++i){
+            for (int j = 0; j < tileWidth; ++j){
+                (*this)(i, j) = a.val(i, j);
+            }
+        }
+    }
+
+    void TiledMatrix::copyTo(ContiguousMatrix &target){
+        if (target.getWidth() != getWidth() || target.getHeight() != getHeight()){
+            throw matrix_dimensions_mismatch();
+        }
+        auto& comm = decomposition.getCommunicator();
+        int nprocs = comm.getProcessorNumber();
+
+        std::vector<int> counts(nprocs), displacements(nprocs);
+        std::vector<BlockDecomposition::Tile> tiles(nprocs);
+        int total = 0;
+        for (int r = 0; r < nprocs; ++r){
+            tiles[r] = decomposition.getTile(r);
+            counts[r] = tiles[r].getWidth() * tiles[r].getHeight();
+            displacements[r] = total;
+            total += counts[r];
+        }
+
+        std::vector<double> packed(tileWidth * tileHeight);
+        for (int i = 0; i < tileHeight; ++i){
+            std::copy(&(*this)(i, 0), &(*this)(i, 0) + tileWidth, &packed[i * tileWidth]);
+        }
+        std::vector<double> all(total);
+        comm.allGather(&packed[0], tileWidth * tileHeight, MPI_DOUBLE, &all[0], &counts[0], &displacements[0],
+                MPI_DOUBLE);
+
+        ContiguousMatrix::Iterator t(target, 0);
+        for (int r = 0; r < nprocs; ++r){
+            auto& tile = tiles[r];
+            const double* source = &all[displacements[r]];
+            for (int i = tile.rowStart; i < tile.rowFinish; ++i){
+                for (int j = tile.columnStart; j < tile.columnFinish; ++j){
+                    t.val(i, j) = *(source++);
+                }
+            }
+        }
+    }
+
+    TiledMatrix& TiledMatrix::convolve(const ContiguousMatrix &K, const TiledMatrix &A, bool normalize){
+        int W = (K.getWidth() - 1)/2;
+        int H = (K.getHeight() - 1)/2;
+        if (A.getWidth() != getWidth() || A.getHeight() != getHeight() || &A.decomposition != &decomposition){
+            throw matrix_dimensions_mismatch();
+        }
+        if (A.halo < H || A.halo < W){
+            throw halo_too_large();
+        }
+
+        ContiguousMatrix::ConstantIterator k(K, H, W);
+        int rowStart = getRowStart();
+        int columnStart = getColumnStart();
+        int height = getHeight();
+        int width = getWidth();
+        for (int i = 0; i < tileHeight; ++i){
+            int hmin = std::max(-H, -(rowStart + i));
+            int hmax = std::min(H, height - 1 - rowStart - i);
+            for (int j = 0; j < tileWidth; ++j){
+                int wmin = std::max(-W, -(columnStart + j));
+                int wmax = std::min(W, width - 1 - columnStart - j);
+                double sum = 0.0;
+                double localSum = 0.0;
+                for (int h = hmin; h <= hmax; ++h){
+                    for (int w = wmin; w <= wmax; ++w){
+                        sum += k.val(h, w) * A(i + h, j + w);
+                        localSum += k.val(h, w);
+                    }
+                }
+                (*this)(i, j) = normalize ? sum / localSum : sum;
+            }
+        }
+
+        return *this;
+    }
+
+}
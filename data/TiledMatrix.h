@@ -0,0 +1,159 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_TILEDMATRIX_H
+#define MPI2_TILEDMATRIX_H
+
+#include <vector>
+#include "BlockDecomposition.h"
+#include "ContiguousMatrix.h"
+#include "../mpi/Datatype.h"
+#include "../mpi/Request.h"
+
+namespace data {
+
+    /**
+     * A matrix distributed among the processes by means of the two-dimensional block decomposition (see
+     * data::BlockDecomposition). Each process stores only its tile surrounded by the halo of a given width.
+     * All indices used by the tiled matrix are given relatively to the top left corner of the local tile.
+     * The halo values are indexed from -getHalo() to -1 and from the tile size to the tile size + getHalo() - 1
+     *
+     * The halo values are up to date only after the halo exchange (see synchronizeHalo). The values outside the
+     * matrix are always zero.
+     */
+    class TiledMatrix {
+    private:
+        BlockDecomposition& decomposition;
+        double widthUm, heightUm;
+        int halo;
+        int tileWidth, tileHeight, stride;
+        std::vector<double> tileData;
+
+        std::vector<BlockDecomposition::Neighbor> neighbors;
+        std::vector<mpi::VectorDatatype*> haloTypes;
+        mpi::Requests* haloRequests = nullptr;
+        static constexpr int HALO_EXCHANGE_TAG = 1002;
+
+    public:
+        /**
+         * Creates new tiled matrix filled by zeros. This is not a collective routine
+         *
+         * @param d the decomposition. The decomposition shall not be destroyed before the matrix
+         * @param w_um matrix width in um
+         * @param h_um matrix height in um
+         * @param h the halo width in pixels
+         * @throws halo_too_large if the halo is wider than some tile
+         */
+        TiledMatrix(BlockDecomposition& d, double w_um, double h_um, int h = 0);
+
+        TiledMatrix(const TiledMatrix& other) = delete;
+        TiledMatrix& operator=(const TiledMatrix& other) = delete;
+
+        ~TiledMatrix();
+
+        /**
+         *
+         * @return the decomposition of the matrix
+         */
+        BlockDecomposition& getDecomposition() { return decomposition; }
+
+        [[nodiscard]] int getWidth() const { return decomposition.getWidth(); }
+        [[nodiscard]] int getHeight() const { return decomposition.getHeight(); }
+        [[nodiscard]] double getWidthUm() const { return widthUm; }
+        [[nodiscard]] double getHeightUm() const { return heightUm; }
+
+        /**
+         *
+         * @return the halo width in pixels
+         */
+        [[nodiscard]] int getHalo() const { return halo; }
+
+        /**
+         *
+         * @return width of the local tile without halo
+         */
+        [[nodiscard]] int getTileWidth() const { return tileWidth; }
+
+        /**
+         *
+         * @return height of the local tile without halo
+         */
+        [[nodiscard]] int getTileHeight() const { return tileHeight; }
+
+        /**
+         *
+         * @return the matrix row corresponding to the first row of the local tile
+         */
+        [[nodiscard]] int getRowStart() const { return decomposition.getLocalTile().rowStart; }
+
+        /**
+         *
+         * @return the matrix column corresponding to the first column of the local tile
+         */
+        [[nodiscard]] int getColumnStart() const { return decomposition.getLocalTile().columnStart; }
+
+        /**
+         * Access to the element of the local tile or its halo (no checking)
+         *
+         * @param i row relatively to the top of the tile
+         * @param j column relatively to the left border of the tile
+         * @return reference to the element
+         */
+        double& operator()(int i, int j) { return tileData[(i + halo) * stride + j + halo]; }
+        double operator()(int i, int j) const { return tileData[(i + halo) * stride + j + halo]; }
+
+        /**
+         * Starts the halo exchange with all neighbor tiles. The tile values shall not be changed and the halo
+         * values shall not be read until finishHaloExchange() is called
+         * Collective routine
+         */
+        void startHaloExchange();
+
+        /**
+         * Waits until the halo exchange is completed
+         */
+        void finishHaloExchange();
+
+        /**
+         * Updates all halo values by the values from the neighbor tiles
+         * Collective routine
+         */
+        void synchronizeHalo(){
+            startHaloExchange();
+            finishHaloExchange();
+        }
+
+        /**
+         * Copies the local tile from the contiguous matrix. This is not a collective routine
+         *
+         * @param source the source matrix. The matrix shall be synchronized and shall have the same size
+         */
+        void copyFrom(const ContiguousMatrix& source);
+
+        /**
+         * Collects all tiles into the contiguous matrix. After the routine the matrix is synchronized.
+         * Collective routine
+         *
+         * @param target the target matrix. The matrix shall have the same size
+         */
+        void copyTo(ContiguousMatrix& target);
+
+        /**
+         * Convolves the kernel with another tiled matrix. See Matrix::convolve for details
+         * This is not a collective routine
+         *
+         * @param K the kernel. The kernel shall be synchronized
+         * @param A the source matrix. The matrix shall have the same decomposition, its halo shall not be less than
+         * the kernel half-size and shall be synchronized
+         * @param normalize true if the result shall be normalized. See Matrix::convolve for details
+         * @return reference to this matrix
+         */
+        TiledMatrix& convolve(const ContiguousMatrix& K, const TiledMatrix& A, bool normalize = true);
+    };
+
+}
+
+
+#endif //MPI2_TILEDMATRIX_H
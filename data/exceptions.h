@@ -52,6 +52,93 @@ namespace data{
         }
     };
 
+    class statistics_not_computed: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The statistics have not been computed yet or the computation has not been finished";
+        }
+    };
+
+    class incorrect_fft_size: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "Size of the fast Fourier transform shall be a positive power of two";
+        }
+    };
+
+    class non_separable_kernel: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "Separable convolution was requested for the kernel that is not separable";
+        }
+    };
+
+    class incorrect_gaussian_sigma: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "Standard deviation of the recursive gaussian filter shall be positive";
+        }
+    };
+
+    class incorrect_decomposition_topology: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "Block decomposition requires the two-dimensional cartesian communicator which grid is not larger than the matrix";
+        }
+    };
+
+    class halo_too_large: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The halo is wider than the tile of the neighbor process";
+        }
+    };
+
+    class view_out_of_range: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The matrix view shall have positive size and strides and shall lie within the matrix";
+        }
+    };
+
+    class incorrect_order_statistics: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The number of bins and the number of elements shall be positive, the percentile shall be "
+                   "within [0, 100]";
+        }
+    };
+
+    class operator_not_assembled: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The preconditioner requires the local block of the linear operator but the operator can't "
+                   "assemble it";
+        }
+    };
+
+    class singular_preconditioner: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "Zero pivot was found during the construction of the preconditioner";
+        }
+    };
+
+    class solver_breakdown: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The iterative solver broke down: the next iteration requires division by zero";
+        }
+    };
+
+    class solver_not_converged: public simulation_exception{
+    public:
+        const char* what() const noexcept override{
+            return "The iterative solver has not reached the required tolerance within the maximum number of "
+                   "iterations";
+        }
+    };
+
     class incorrect_data_format: public std::exception{
     public:
         const char* what() const noexcept override{
@@ -0,0 +1,70 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include "Fft.h"
+#include "../exceptions.h"
+
+namespace data::fft{
+
+    Fft::Fft(int size): n(size), bitReversal(size), twiddles(size/2){
+        if (n <= 0 || (n & (n - 1)) != 0){
+            throw incorrect_fft_size();
+        }
+
+        int logn = 0;
+        while ((1 << logn) < n) ++logn;
+        for (int i=0; i < n; ++i){
+            int r = 0;
+            for (int b = 0; b < logn; ++b){
+                if (i & (1 << b)) r |= 1 << (logn - 1 - b);
+            }
+            bitReversal[i] = r;
+        }
+
+        for (int k=0; k < n/2; ++k){
+            double phi = -2.0 * M_PI * k / n;
+            twiddles[k] = Complex(cos(phi), sin(phi));
+        }
+    }
+
+    int Fft::getOptimalSize(int n){
+        int size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    void Fft::transform(Complex* x, bool inverse) const{
+        for (int i=0; i < n; ++i){
+            int j = bitReversal[i];
+            if (i < j){
+                std::swap(x[i], x[j]);
+            }
+        }
+
+        for (int len = 2; len <= n; len <<= 1){
+            int half = len / 2;
+            int step = n / len;
+            for (int start = 0; start < n; start += len){
+                for (int k = 0; k < half; ++k){
+                    Complex w = twiddles[k * step];
+                    if (inverse) w = std::conj(w);
+                    Complex u = x[start + k];
+                    Complex v = x[start + k + half] * w;
+                    x[start + k] = u + v;
+                    x[start + k + half] = u - v;
+                }
+            }
+        }
+
+        if (inverse){
+            double factor = 1.0 / n;
+            for (int i=0; i < n; ++i){
+                x[i] *= factor;
+            }
+        }
+    }
+
+}
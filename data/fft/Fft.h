@@ -0,0 +1,79 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_FFT_H
+#define MPI2_FFT_H
+
+#include <complex>
+#include <vector>
+
+namespace data::fft {
+
+    /**
+     * A self-contained radix-2 fast Fourier transform engine.
+     *
+     * The engine is created once for a certain transform size and may be used many times. All twiddle factors
+     * and the bit reversal permutation are computed by the constructor, so forward() and inverse() do not
+     * allocate any memory and do not call any trigonometric functions.
+     *
+     * Usage:
+     * data::fft::Fft fft(data::fft::Fft::getOptimalSize(n));
+     * fft.forward(x);  // x is an array of fft.getSize() complex values
+     * ...
+     * fft.inverse(x);  // the same array is transformed back, 1/n normalization is included
+     */
+    class Fft {
+    public:
+        typedef std::complex<double> Complex;
+
+    private:
+        int n;
+        std::vector<int> bitReversal;
+        std::vector<Complex> twiddles;
+
+        void transform(Complex* x, bool inverse) const;
+
+    public:
+        /**
+         * Creates the FFT engine
+         *
+         * @param size transform size. Shall be a power of two
+         * @throws data::incorrect_fft_size if the size is not a power of two
+         */
+        explicit Fft(int size);
+
+        /**
+         *
+         * @return the transform size
+         */
+        [[nodiscard]] int getSize() const { return n; }
+
+        /**
+         * Provides the forward transform in place
+         *
+         * @param x array containing getSize() complex items
+         */
+        void forward(Complex* x) const { transform(x, false); }
+
+        /**
+         * Provides the inverse transform in place. The result is divided by getSize()
+         *
+         * @param x array containing getSize() complex items
+         */
+        void inverse(Complex* x) const { transform(x, true); }
+
+        /**
+         * Returns the minimum transform size which is not less than a given number
+         *
+         * @param n minimum number of samples
+         * @return the nearest power of two
+         */
+        static int getOptimalSize(int n);
+    };
+
+}
+
+
+#endif //MPI2_FFT_H
@@ -0,0 +1,136 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <vector>
+#include <algorithm>
+#include "Kernels.h"
+
+namespace {
+
+    /*
+     * Block sizes. The packed block of a (BLOCK_ROWS x BLOCK_DEPTH) shall fit into L2 cache, the packed block of b
+     * (BLOCK_DEPTH x BLOCK_COLUMNS) shall fit into L3 cache while a single panel of b (BLOCK_DEPTH x tile columns)
+     * remains in L1 cache during the loop over the tiles of a
+     */
+    constexpr int BLOCK_ROWS = 128;
+    constexpr int BLOCK_DEPTH = 256;
+    constexpr int BLOCK_COLUMNS = 1024;
+
+    constexpr int FLOAT_TILE_ROWS = 4;
+    constexpr int FLOAT_TILE_COLUMNS = 8;
+
+    void floatTile(int k, const float* a, const float* b, float* c, int ldc){
+        float tile[FLOAT_TILE_ROWS][FLOAT_TILE_COLUMNS] = {};
+        for (int p = 0; p < k; ++p){
+            for (int i = 0; i < FLOAT_TILE_ROWS; ++i){
+                for (int j = 0; j < FLOAT_TILE_COLUMNS; ++j){
+                    tile[i][j] += a[i] * b[j];
+                }
+            }
+            a += FLOAT_TILE_ROWS;
+            b += FLOAT_TILE_COLUMNS;
+        }
+        for (int i = 0; i < FLOAT_TILE_ROWS; ++i){
+            for (int j = 0; j < FLOAT_TILE_COLUMNS; ++j){
+                c[i * ldc + j] += tile[i][j];
+            }
+        }
+    }
+
+    /**
+     * Packs rows x depth block of a into panels of tileRows rows. Within the panel the elements are stored
+     * column by column. The last panel is padded by zeros
+     */
+    template<typename T> void packA(const T* a, int lda, int rows, int depth, int tileRows, T* packed){
+        for (int i0 = 0; i0 < rows; i0 += tileRows){
+            int panelRows = std::min(tileRows, rows - i0);
+            for (int p = 0; p < depth; ++p){
+                for (int i = 0; i < panelRows; ++i){
+                    *(packed++) = a[(i0 + i) * lda + p];
+                }
+                for (int i = panelRows; i < tileRows; ++i){
+                    *(packed++) = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * Packs depth x columns block of b into panels of tileColumns columns. Within the panel the elements are
+     * stored row by row. The last panel is padded by zeros
+     */
+    template<typename T> void packB(const T* b, int ldb, int depth, int columns, int tileColumns, T* packed){
+        for (int j0 = 0; j0 < columns; j0 += tileColumns){
+            int panelColumns = std::min(tileColumns, columns - j0);
+            for (int p = 0; p < depth; ++p){
+                const T* row = b + p * ldb + j0;
+                for (int j = 0; j < panelColumns; ++j){
+                    *(packed++) = row[j];
+                }
+                for (int j = panelColumns; j < tileColumns; ++j){
+                    *(packed++) = 0;
+                }
+            }
+        }
+    }
+
+    template<typename T> void blockedGemm(int m, int n, int k, const T* a, int lda, const T* b, int ldb,
+            T* c, int ldc, int tileRows, int tileColumns, void (*tile)(int, const T*, const T*, T*, int)){
+        if (m <= 0 || n <= 0 || k <= 0){
+            return;
+        }
+        int blockRows = BLOCK_ROWS / tileRows * tileRows;
+        int blockColumns = BLOCK_COLUMNS / tileColumns * tileColumns;
+        std::vector<T> packedA(blockRows * BLOCK_DEPTH);
+        std::vector<T> packedB(blockColumns * BLOCK_DEPTH);
+        std::vector<T> edge(tileRows * tileColumns);
+
+        for (int j0 = 0; j0 < n; j0 += blockColumns){
+            int columns = std::min(blockColumns, n - j0);
+            for (int p0 = 0; p0 < k; p0 += BLOCK_DEPTH){
+                int depth = std::min(BLOCK_DEPTH, k - p0);
+                packB(b + p0 * ldb + j0, ldb, depth, columns, tileColumns, packedB.data());
+                for (int i0 = 0; i0 < m; i0 += blockRows){
+                    int rows = std::min(blockRows, m - i0);
+                    packA(a + i0 * lda + p0, lda, rows, depth, tileRows, packedA.data());
+                    for (int j = 0; j < columns; j += tileColumns){
+                        const T* panelB = packedB.data() + j * depth;
+                        for (int i = 0; i < rows; i += tileRows){
+                            const T* panelA = packedA.data() + i * depth;
+                            T* target = c + (i0 + i) * ldc + j0 + j;
+                            int tileHeight = std::min(tileRows, rows - i);
+                            int tileWidth = std::min(tileColumns, columns - j);
+                            if (tileHeight == tileRows && tileWidth == tileColumns){
+                                tile(depth, panelA, panelB, target, ldc);
+                            } else {
+                                std::fill(edge.begin(), edge.end(), 0);
+                                tile(depth, panelA, panelB, edge.data(), tileColumns);
+                                for (int ii = 0; ii < tileHeight; ++ii){
+                                    for (int jj = 0; jj < tileWidth; ++jj){
+                                        target[ii * ldc + jj] += edge[ii * tileColumns + jj];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+namespace data::simd {
+
+    void gemm(int m, int n, int k, const double* a, int lda, const double* b, int ldb, double* c, int ldc){
+        const KernelTable& kernels = getKernels();
+        blockedGemm(m, n, k, a, lda, b, ldb, c, ldc, kernels.gemmRows, kernels.gemmColumns, kernels.gemmTile);
+    }
+
+    void gemm(int m, int n, int k, const float* a, int lda, const float* b, int ldb, float* c, int ldc){
+        blockedGemm(m, n, k, a, lda, b, ldb, c, ldc, FLOAT_TILE_ROWS, FLOAT_TILE_COLUMNS, floatTile);
+    }
+
+}
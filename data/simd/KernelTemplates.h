@@ -0,0 +1,235 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_KERNELTEMPLATES_H
+#define MPI2_KERNELTEMPLATES_H
+
+#include "Kernels.h"
+
+/**
+ * Generic implementation of all kernels. The header shall be included only by the translation units that compile
+ * the kernels for a certain instruction set. Each of these units defines the vector type V in the anonymous
+ * namespace and calls makeKernelTable<V>(). The vector type shall contain:
+ *
+ * using Type = ...;                            // the vector register type
+ * static constexpr int width = ...;            // number of doubles in the register
+ * static Type load(const double* p);           // unaligned load
+ * static void store(double* p, Type x);        // unaligned store
+ * static Type set(double x);                   // broadcast
+ * static Type add(Type x, Type y);
+ * static Type sub(Type x, Type y);
+ * static Type mul(Type x, Type y);
+ * static Type div(Type x, Type y);
+ * static double total(Type x);                 // sum of all register elements
+ *
+ * The reductions keep several independent accumulators per sum (four in sum, two in moments and squaredDistance,
+ * one for each of the five sums in crossMoments), so their results may differ from the sequential summation in
+ * the last digits.
+ *
+ * The GEMM microkernel keeps 4 x (2 * width) tile of the result in eight registers during the whole loop over k.
+ */
+namespace data::simd::implementation {
+
+    template<typename V> void fill(double* out, double value, int n){
+        auto x = V::set(value);
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            V::store(out + k, x);
+        }
+        for (; k < n; ++k){
+            out[k] = value;
+        }
+    }
+
+    template<typename V> void scale(double* out, const double* a, double alpha, double gamma, int n){
+        auto va = V::set(alpha);
+        auto vg = V::set(gamma);
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            V::store(out + k, V::add(V::mul(V::load(a + k), va), vg));
+        }
+        for (; k < n; ++k){
+            out[k] = alpha * a[k] + gamma;
+        }
+    }
+
+    template<typename V> void linear(double* out, const double* a, double alpha, const double* b, double beta,
+            int n){
+        auto va = V::set(alpha);
+        auto vb = V::set(beta);
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            V::store(out + k, V::add(V::mul(V::load(a + k), va), V::mul(V::load(b + k), vb)));
+        }
+        for (; k < n; ++k){
+            out[k] = alpha * a[k] + beta * b[k];
+        }
+    }
+
+    template<typename V> void multiply(double* out, const double* a, const double* b, int n){
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            V::store(out + k, V::mul(V::load(a + k), V::load(b + k)));
+        }
+        for (; k < n; ++k){
+            out[k] = a[k] * b[k];
+        }
+    }
+
+    template<typename V> void divide(double* out, const double* a, const double* b, int n){
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            V::store(out + k, V::div(V::load(a + k), V::load(b + k)));
+        }
+        for (; k < n; ++k){
+            out[k] = a[k] / b[k];
+        }
+    }
+
+    template<typename V> void reciprocal(double* out, double x, const double* a, int n){
+        auto vx = V::set(x);
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            V::store(out + k, V::div(vx, V::load(a + k)));
+        }
+        for (; k < n; ++k){
+            out[k] = x / a[k];
+        }
+    }
+
+    template<typename V> double sum(const double* a, int n){
+        auto s0 = V::set(0.0), s1 = V::set(0.0), s2 = V::set(0.0), s3 = V::set(0.0);
+        int k = 0;
+        for (; k + 4 * V::width <= n; k += 4 * V::width){
+            s0 = V::add(s0, V::load(a + k));
+            s1 = V::add(s1, V::load(a + k + V::width));
+            s2 = V::add(s2, V::load(a + k + 2 * V::width));
+            s3 = V::add(s3, V::load(a + k + 3 * V::width));
+        }
+        for (; k + V::width <= n; k += V::width){
+            s0 = V::add(s0, V::load(a + k));
+        }
+        double result = V::total(V::add(V::add(s0, s1), V::add(s2, s3)));
+        for (; k < n; ++k){
+            result += a[k];
+        }
+        return result;
+    }
+
+    template<typename V> void moments(const double* a, int n, double result[2]){
+        auto s0 = V::set(0.0), s1 = V::set(0.0), q0 = V::set(0.0), q1 = V::set(0.0);
+        int k = 0;
+        for (; k + 2 * V::width <= n; k += 2 * V::width){
+            auto x0 = V::load(a + k);
+            auto x1 = V::load(a + k + V::width);
+            s0 = V::add(s0, x0);
+            s1 = V::add(s1, x1);
+            q0 = V::add(q0, V::mul(x0, x0));
+            q1 = V::add(q1, V::mul(x1, x1));
+        }
+        for (; k + V::width <= n; k += V::width){
+            auto x = V::load(a + k);
+            s0 = V::add(s0, x);
+            q0 = V::add(q0, V::mul(x, x));
+        }
+        result[0] = V::total(V::add(s0, s1));
+        result[1] = V::total(V::add(q0, q1));
+        for (; k < n; ++k){
+            result[0] += a[k];
+            result[1] += a[k] * a[k];
+        }
+    }
+
+    template<typename V> double squaredDistance(const double* a, const double* b, int n){
+        auto s0 = V::set(0.0), s1 = V::set(0.0);
+        int k = 0;
+        for (; k + 2 * V::width <= n; k += 2 * V::width){
+            auto d0 = V::sub(V::load(a + k), V::load(b + k));
+            auto d1 = V::sub(V::load(a + k + V::width), V::load(b + k + V::width));
+            s0 = V::add(s0, V::mul(d0, d0));
+            s1 = V::add(s1, V::mul(d1, d1));
+        }
+        for (; k + V::width <= n; k += V::width){
+            auto d = V::sub(V::load(a + k), V::load(b + k));
+            s0 = V::add(s0, V::mul(d, d));
+        }
+        double result = V::total(V::add(s0, s1));
+        for (; k < n; ++k){
+            result += (a[k] - b[k]) * (a[k] - b[k]);
+        }
+        return result;
+    }
+
+    template<typename V> void crossMoments(const double* a, const double* b, int n, double result[5]){
+        auto ab = V::set(0.0), sa = V::set(0.0), sb = V::set(0.0), aa = V::set(0.0), bb = V::set(0.0);
+        int k = 0;
+        for (; k + V::width <= n; k += V::width){
+            auto x = V::load(a + k);
+            auto y = V::load(b + k);
+            ab = V::add(ab, V::mul(x, y));
+            sa = V::add(sa, x);
+            sb = V::add(sb, y);
+            aa = V::add(aa, V::mul(x, x));
+            bb = V::add(bb, V::mul(y, y));
+        }
+        result[0] = V::total(ab);
+        result[1] = V::total(sa);
+        result[2] = V::total(sb);
+        result[3] = V::total(aa);
+        result[4] = V::total(bb);
+        for (; k < n; ++k){
+            result[0] += a[k] * b[k];
+            result[1] += a[k];
+            result[2] += b[k];
+            result[3] += a[k] * a[k];
+            result[4] += b[k] * b[k];
+        }
+    }
+
+    template<typename V> void gemmTile(int k, const double* a, const double* b, double* c, int ldc){
+        auto c00 = V::set(0.0), c01 = V::set(0.0), c10 = V::set(0.0), c11 = V::set(0.0);
+        auto c20 = V::set(0.0), c21 = V::set(0.0), c30 = V::set(0.0), c31 = V::set(0.0);
+        for (int p = 0; p < k; ++p){
+            auto b0 = V::load(b);
+            auto b1 = V::load(b + V::width);
+            auto x = V::set(a[0]);
+            c00 = V::add(c00, V::mul(x, b0));
+            c01 = V::add(c01, V::mul(x, b1));
+            x = V::set(a[1]);
+            c10 = V::add(c10, V::mul(x, b0));
+            c11 = V::add(c11, V::mul(x, b1));
+            x = V::set(a[2]);
+            c20 = V::add(c20, V::mul(x, b0));
+            c21 = V::add(c21, V::mul(x, b1));
+            x = V::set(a[3]);
+            c30 = V::add(c30, V::mul(x, b0));
+            c31 = V::add(c31, V::mul(x, b1));
+            a += 4;
+            b += 2 * V::width;
+        }
+        V::store(c, V::add(V::load(c), c00));
+        V::store(c + V::width, V::add(V::load(c + V::width), c01));
+        c += ldc;
+        V::store(c, V::add(V::load(c), c10));
+        V::store(c + V::width, V::add(V::load(c + V::width), c11));
+        c += ldc;
+        V::store(c, V::add(V::load(c), c20));
+        V::store(c + V::width, V::add(V::load(c + V::width), c21));
+        c += ldc;
+        V::store(c, V::add(V::load(c), c30));
+        V::store(c + V::width, V::add(V::load(c + V::width), c31));
+    }
+
+    template<typename V> KernelTable makeKernelTable(){
+        return {
+            fill<V>, scale<V>, linear<V>, multiply<V>, divide<V>, reciprocal<V>,
+            sum<V>, moments<V>, squaredDistance<V>, crossMoments<V>,
+            4, 2 * V::width, gemmTile<V>
+        };
+    }
+
+}
+
+#endif //MPI2_KERNELTEMPLATES_H
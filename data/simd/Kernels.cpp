@@ -0,0 +1,105 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "KernelTemplates.h"
+
+namespace {
+
+    struct ScalarVector{
+        using Type = double;
+        static constexpr int width = 1;
+        static Type load(const double* p) { return *p; }
+        static void store(double* p, Type x) { *p = x; }
+        static Type set(double x) { return x; }
+        static Type add(Type x, Type y) { return x + y; }
+        static Type sub(Type x, Type y) { return x - y; }
+        static Type mul(Type x, Type y) { return x * y; }
+        static Type div(Type x, Type y) { return x / y; }
+        static double total(Type x) { return x; }
+    };
+
+}
+
+namespace data::simd {
+
+    namespace implementation {
+        const KernelTable* getSse2Kernels();
+        const KernelTable* getAvx2Kernels();
+        const KernelTable* getAvx512Kernels();
+    }
+
+    static const KernelTable* getTable(Isa isa){
+        static const KernelTable scalarTable = implementation::makeKernelTable<ScalarVector>();
+        switch (isa){
+            case Avx512Isa:
+#if defined(__x86_64__) || defined(__i386__)
+                if (!__builtin_cpu_supports("avx512f")) return nullptr;
+#endif
+                return implementation::getAvx512Kernels();
+            case Avx2Isa:
+#if defined(__x86_64__) || defined(__i386__)
+                if (!__builtin_cpu_supports("avx2")) return nullptr;
+#endif
+                return implementation::getAvx2Kernels();
+            case Sse2Isa:
+#if defined(__x86_64__) || defined(__i386__)
+                if (!__builtin_cpu_supports("sse2")) return nullptr;
+#endif
+                return implementation::getSse2Kernels();
+            default:
+                return &scalarTable;
+        }
+    }
+
+    static Isa currentIsa = ScalarIsa;
+    static const KernelTable* currentTable = nullptr;
+
+    static void selectBestIsa(){
+        for (int isa = Avx512Isa; isa >= ScalarIsa; --isa){
+            const KernelTable* table = getTable((Isa)isa);
+            if (table != nullptr){
+                currentIsa = (Isa)isa;
+                currentTable = table;
+                return;
+            }
+        }
+    }
+
+    const KernelTable& getKernels(){
+        if (currentTable == nullptr){
+            selectBestIsa();
+        }
+        return *currentTable;
+    }
+
+    Isa getIsa(){
+        getKernels();
+        return currentIsa;
+    }
+
+    bool setIsa(Isa isa){
+        const KernelTable* table = getTable(isa);
+        if (table == nullptr){
+            return false;
+        }
+        currentIsa = isa;
+        currentTable = table;
+        return true;
+    }
+
+    bool isSupported(Isa isa){
+        return getTable(isa) != nullptr;
+    }
+
+    const char* getIsaName(Isa isa){
+        switch (isa){
+            case Sse2Isa: return "SSE2";
+            case Avx2Isa: return "AVX2";
+            case Avx512Isa: return "AVX-512";
+            default: return "scalar";
+        }
+    }
+
+}
@@ -0,0 +1,282 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_KERNELS_H
+#define MPI2_KERNELS_H
+
+namespace data::simd {
+
+    /**
+     * Instruction set used by the kernels. The instruction set is selected at the first kernel call as the best
+     * instruction set supported by the CPU. Each instruction set processes 1, 2, 4 or 8 doubles per instruction
+     */
+    enum Isa {ScalarIsa = 0, Sse2Isa = 1, Avx2Isa = 2, Avx512Isa = 3};
+
+    /**
+     * Table of all kernels compiled for a certain instruction set. See the routines below for description
+     * of each kernel
+     */
+    struct KernelTable{
+        void (*fill)(double* out, double value, int n);
+        void (*scale)(double* out, const double* a, double alpha, double gamma, int n);
+        void (*linear)(double* out, const double* a, double alpha, const double* b, double beta, int n);
+        void (*multiply)(double* out, const double* a, const double* b, int n);
+        void (*divide)(double* out, const double* a, const double* b, int n);
+        void (*reciprocal)(double* out, double x, const double* a, int n);
+        double (*sum)(const double* a, int n);
+        void (*moments)(const double* a, int n, double result[2]);
+        double (*squaredDistance)(const double* a, const double* b, int n);
+        void (*crossMoments)(const double* a, const double* b, int n, double result[5]);
+
+        /**
+         * The GEMM microkernel: c[i*ldc + j] += sum of a[p*gemmRows + i] * b[p*gemmColumns + j] over p from 0 to k-1
+         * for the gemmRows x gemmColumns tile of c. a and b are the panels packed by gemm()
+         */
+        int gemmRows;
+        int gemmColumns;
+        void (*gemmTile)(int k, const double* a, const double* b, double* c, int ldc);
+    };
+
+    /**
+     *
+     * @return the instruction set currently used by the kernels
+     */
+    Isa getIsa();
+
+    /**
+     * Changes the instruction set used by the kernels. This is useful for benchmarking and testing only
+     *
+     * @param isa the desired instruction set
+     * @return false if the instruction set is not supported by the CPU or was not compiled. In this case the
+     * instruction set will not be changed
+     */
+    bool setIsa(Isa isa);
+
+    /**
+     *
+     * @param isa the instruction set
+     * @return true if the instruction set is supported by both CPU and the application build
+     */
+    bool isSupported(Isa isa);
+
+    /**
+     *
+     * @param isa the instruction set
+     * @return human-readable name of the instruction set
+     */
+    const char* getIsaName(Isa isa);
+
+    /**
+     *
+     * @return the kernel table for the current instruction set
+     */
+    const KernelTable& getKernels();
+
+    /**
+     * out[k] = value
+     */
+    inline void fill(double* out, double value, int n) { getKernels().fill(out, value, n); }
+
+    /**
+     * out[k] = alpha * a[k] + gamma. out and a may be the same array
+     */
+    inline void scale(double* out, const double* a, double alpha, double gamma, int n){
+        getKernels().scale(out, a, alpha, gamma, n);
+    }
+
+    /**
+     * out[k] = alpha * a[k] + beta * b[k]. out may be the same array as a or b
+     */
+    inline void linear(double* out, const double* a, double alpha, const double* b, double beta, int n){
+        getKernels().linear(out, a, alpha, b, beta, n);
+    }
+
+    /**
+     * out[k] = a[k] * b[k]
+     */
+    inline void multiply(double* out, const double* a, const double* b, int n){
+        getKernels().multiply(out, a, b, n);
+    }
+
+    /**
+     * out[k] = a[k] / b[k]
+     */
+    inline void divide(double* out, const double* a, const double* b, int n){
+        getKernels().divide(out, a, b, n);
+    }
+
+    /**
+     * out[k] = x / a[k]
+     */
+    inline void reciprocal(double* out, double x, const double* a, int n){
+        getKernels().reciprocal(out, x, a, n);
+    }
+
+    /**
+     *
+     * @return sum of a[k]
+     */
+    inline double sum(const double* a, int n) { return getKernels().sum(a, n); }
+
+    /**
+     * result[0] = sum of a[k], result[1] = sum of a[k]^2
+     */
+    inline void moments(const double* a, int n, double result[2]) { getKernels().moments(a, n, result); }
+
+    /**
+     *
+     * @return sum of (a[k] - b[k])^2
+     */
+    inline double squaredDistance(const double* a, const double* b, int n){
+        return getKernels().squaredDistance(a, b, n);
+    }
+
+    /**
+     * result[0] = sum of a[k]*b[k], result[1] = sum of a[k], result[2] = sum of b[k],
+     * result[3] = sum of a[k]^2, result[4] = sum of b[k]^2
+     */
+    inline void crossMoments(const double* a, const double* b, int n, double result[5]){
+        getKernels().crossMoments(a, b, n, result);
+    }
+
+    /**
+     * c += a * b where a is m x k matrix, b is k x n matrix and c is m x n matrix. All matrices are stored by rows,
+     * lda, ldb and ldc are distances between the beginnings of two neighbor rows. The product is cache-blocked:
+     * the blocks of a and b are packed into contiguous panels that fit into L2 and L3 caches and the panels are
+     * multiplied by the register-tiled microkernel of the current instruction set. c shall not overlap a or b
+     */
+    void gemm(int m, int n, int k, const double* a, int lda, const double* b, int ldb, double* c, int ldc);
+
+    /**
+     * The same as above for single-precision matrices. The microkernel is vectorized by the compiler
+     */
+    void gemm(int m, int n, int k, const float* a, int lda, const float* b, int ldb, float* c, int ldc);
+
+    /**
+     * c[i*ldc + j] = a[j*lda + i] for i < rows and j < columns. The routine is cache-oblivious: it halves the larger
+     * dimension until the block fits into L1 cache, so both the reads and the writes use every loaded cache line
+     * irrespectively of the cache size. c shall not overlap a
+     */
+    template<typename T> void transpose(const T* a, int lda, T* c, int ldc, int rows, int columns){
+        constexpr int blockSize = 32;
+        if (rows <= blockSize && columns <= blockSize){
+            for (int i = 0; i < rows; ++i){
+                for (int j = 0; j < columns; ++j){
+                    c[i * ldc + j] = a[j * lda + i];
+                }
+            }
+        } else if (rows >= columns){
+            int half = rows / 2;
+            transpose(a, lda, c, ldc, half, columns);
+            transpose(a + half, lda, c + half * ldc, ldc, rows - half, columns);
+        } else {
+            int half = columns / 2;
+            transpose(a, lda, c, ldc, rows, half);
+            transpose(a + half * lda, lda, c + half, ldc, rows, columns - half);
+        }
+    }
+
+    /**
+     * Writes the elements of the transposed matrix with flat indices from start to finish-1 to c[0], c[1], ...
+     * The area may begin and end in the middle of the row
+     *
+     * @param a the source matrix
+     * @param lda width of the source matrix
+     * @param c the output array of finish-start elements
+     * @param width width of the transposed matrix, i.e., height of the source matrix
+     */
+    template<typename T> void transposeArea(const T* a, int lda, T* c, int width, int start, int finish){
+        int i = start / width;
+        int j = start % width;
+        if (j != 0){
+            for (; j < width && start < finish; ++j, ++start){
+                *(c++) = a[j * lda + i];
+            }
+            ++i;
+        }
+        int rows = (finish - start) / width;
+        transpose(a + i, lda, c, width, rows, width);
+        c += rows * width;
+        start += rows * width;
+        i += rows;
+        for (j = 0; start < finish; ++j, ++start){
+            *(c++) = a[j * lda + i];
+        }
+    }
+
+    /*
+     * The same routines for other element types (e.g., for single-precision matrices). They are plain loops
+     * vectorized by the compiler; the reductions are accumulated in double. The overloads above are always preferred
+     * for double arrays
+     */
+
+    template<typename T> void fill(T* out, double value, int n){
+        auto x = static_cast<T>(value);
+        for (int k = 0; k < n; ++k) out[k] = x;
+    }
+
+    template<typename T> void scale(T* out, const T* a, double alpha, double gamma, int n){
+        auto alphaT = static_cast<T>(alpha), gammaT = static_cast<T>(gamma);
+        for (int k = 0; k < n; ++k) out[k] = alphaT * a[k] + gammaT;
+    }
+
+    template<typename T> void linear(T* out, const T* a, double alpha, const T* b, double beta, int n){
+        auto alphaT = static_cast<T>(alpha), betaT = static_cast<T>(beta);
+        for (int k = 0; k < n; ++k) out[k] = alphaT * a[k] + betaT * b[k];
+    }
+
+    template<typename T> void multiply(T* out, const T* a, const T* b, int n){
+        for (int k = 0; k < n; ++k) out[k] = a[k] * b[k];
+    }
+
+    template<typename T> void divide(T* out, const T* a, const T* b, int n){
+        for (int k = 0; k < n; ++k) out[k] = a[k] / b[k];
+    }
+
+    template<typename T> void reciprocal(T* out, double x, const T* a, int n){
+        auto xT = static_cast<T>(x);
+        for (int k = 0; k < n; ++k) out[k] = xT / a[k];
+    }
+
+    template<typename T> double sum(const T* a, int n){
+        double result = 0.0;
+        for (int k = 0; k < n; ++k) result += a[k];
+        return result;
+    }
+
+    template<typename T> void moments(const T* a, int n, double result[2]){
+        result[0] = result[1] = 0.0;
+        for (int k = 0; k < n; ++k){
+            double x = a[k];
+            result[0] += x;
+            result[1] += x * x;
+        }
+    }
+
+    template<typename T> double squaredDistance(const T* a, const T* b, int n){
+        double result = 0.0;
+        for (int k = 0; k < n; ++k){
+            double d = (double)a[k] - (double)b[k];
+            result += d * d;
+        }
+        return result;
+    }
+
+    template<typename T> void crossMoments(const T* a, const T* b, int n, double result[5]){
+        for (int i = 0; i < 5; ++i) result[i] = 0.0;
+        for (int k = 0; k < n; ++k){
+            double x = a[k], y = b[k];
+            result[0] += x * y;
+            result[1] += x;
+            result[2] += y;
+            result[3] += x * x;
+            result[4] += y * y;
+        }
+    }
+
+}
+
+
+#endif //MPI2_KERNELS_H
@@ -0,0 +1,50 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "KernelTemplates.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx2Vector{
+        using Type = __m256d;
+        static constexpr int width = 4;
+        static Type load(const double* p) { return _mm256_loadu_pd(p); }
+        static void store(double* p, Type x) { _mm256_storeu_pd(p, x); }
+        static Type set(double x) { return _mm256_set1_pd(x); }
+        static Type add(Type x, Type y) { return _mm256_add_pd(x, y); }
+        static Type sub(Type x, Type y) { return _mm256_sub_pd(x, y); }
+        static Type mul(Type x, Type y) { return _mm256_mul_pd(x, y); }
+        static Type div(Type x, Type y) { return _mm256_div_pd(x, y); }
+        static double total(Type x){
+            __m128d y = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(y, _mm_unpackhi_pd(y, y)));
+        }
+    };
+
+}
+
+namespace data::simd::implementation {
+
+    const KernelTable* getAvx2Kernels(){
+        static const KernelTable table = makeKernelTable<Avx2Vector>();
+        return &table;
+    }
+
+}
+
+#else
+
+namespace data::simd::implementation {
+
+    const KernelTable* getAvx2Kernels(){
+        return nullptr;
+    }
+
+}
+
+#endif
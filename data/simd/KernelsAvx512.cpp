@@ -0,0 +1,47 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "KernelTemplates.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx512Vector{
+        using Type = __m512d;
+        static constexpr int width = 8;
+        static Type load(const double* p) { return _mm512_loadu_pd(p); }
+        static void store(double* p, Type x) { _mm512_storeu_pd(p, x); }
+        static Type set(double x) { return _mm512_set1_pd(x); }
+        static Type add(Type x, Type y) { return _mm512_add_pd(x, y); }
+        static Type sub(Type x, Type y) { return _mm512_sub_pd(x, y); }
+        static Type mul(Type x, Type y) { return _mm512_mul_pd(x, y); }
+        static Type div(Type x, Type y) { return _mm512_div_pd(x, y); }
+        static double total(Type x) { return _mm512_reduce_add_pd(x); }
+    };
+
+}
+
+namespace data::simd::implementation {
+
+    const KernelTable* getAvx512Kernels(){
+        static const KernelTable table = makeKernelTable<Avx512Vector>();
+        return &table;
+    }
+
+}
+
+#else
+
+namespace data::simd::implementation {
+
+    const KernelTable* getAvx512Kernels(){
+        return nullptr;
+    }
+
+}
+
+#endif
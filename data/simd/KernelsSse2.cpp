@@ -0,0 +1,47 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "KernelTemplates.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+namespace {
+
+    struct Sse2Vector{
+        using Type = __m128d;
+        static constexpr int width = 2;
+        static Type load(const double* p) { return _mm_loadu_pd(p); }
+        static void store(double* p, Type x) { _mm_storeu_pd(p, x); }
+        static Type set(double x) { return _mm_set1_pd(x); }
+        static Type add(Type x, Type y) { return _mm_add_pd(x, y); }
+        static Type sub(Type x, Type y) { return _mm_sub_pd(x, y); }
+        static Type mul(Type x, Type y) { return _mm_mul_pd(x, y); }
+        static Type div(Type x, Type y) { return _mm_div_pd(x, y); }
+        static double total(Type x) { return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x))); }
+    };
+
+}
+
+namespace data::simd::implementation {
+
+    const KernelTable* getSse2Kernels(){
+        static const KernelTable table = makeKernelTable<Sse2Vector>();
+        return &table;
+    }
+
+}
+
+#else
+
+namespace data::simd::implementation {
+
+    const KernelTable* getSse2Kernels(){
+        return nullptr;
+    }
+
+}
+
+#endif
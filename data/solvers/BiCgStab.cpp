@@ -0,0 +1,77 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include "BiCgStab.h"
+#include "../LocalMatrix.h"
+
+namespace data::solvers {
+
+    bool BiCgStab::iterate(ContiguousMatrix &x, const Matrix &b) {
+        int w = x.getWidth(), h = x.getHeight();
+        double wu = x.getWidthUm(), hu = x.getHeightUm();
+        LocalMatrix r(*comm, w, h, wu, hu), r0(*comm, w, h, wu, hu), p(*comm, w, h, wu, hu);
+        LocalMatrix v(*comm, w, h, wu, hu), s(*comm, w, h, wu, hu), t(*comm, w, h, wu, hu);
+        ContiguousMatrix pHat(*comm, w, h, wu, hu), sHat(*comm, w, h, wu, hu);
+        const Matrix* stepFirst[] = {&t, &t, &s};
+        const Matrix* stepSecond[] = {&s, &t, &s};
+        const Matrix* residualFirst[] = {&r, &r0};
+        const Matrix* residualSecond[] = {&r, &r};
+        double step[3], products[2];
+        double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+        computeResidual(r, b, x);
+        copy(r0, r);
+        innerProducts(2, residualFirst, residualSecond, products);
+        if (checkResidual(sqrt(products[0]))){
+            return true;
+        }
+
+        while (iterations < maxIterations){
+            ++iterations;
+            double rhoNext = products[1];
+            if (rhoNext == 0.0 || !std::isfinite(rhoNext)){
+                throw solver_breakdown();
+            }
+            double beta = (rhoNext / rho) * (alpha / omega);
+            rho = rhoNext;
+            p.add(p, -omega, v);
+            p.add(r, beta, p);
+            precondition(pHat, p);
+            A.apply(v, pHat);
+            double r0v = innerProduct(r0, v);
+            if (r0v == 0.0 || !std::isfinite(r0v)){
+                throw solver_breakdown();
+            }
+            alpha = rho / r0v;
+            s.add(r, -alpha, v);
+
+            precondition(sHat, s);
+            A.apply(t, sHat);
+            innerProducts(3, stepFirst, stepSecond, step);
+            if (checkResidual(sqrt(step[2]))){
+                x.add(x, alpha, pHat);
+                return true;
+            }
+            if (step[1] == 0.0){
+                throw solver_breakdown();
+            }
+            omega = step[0] / step[1];
+            x.add(x, alpha, pHat);
+            x.add(x, omega, sHat);
+            r.add(s, -omega, t);
+
+            innerProducts(2, residualFirst, residualSecond, products);
+            if (checkResidual(sqrt(products[0]))){
+                return true;
+            }
+            if (omega == 0.0){
+                throw solver_breakdown();
+            }
+        }
+        return false;
+    }
+
+}
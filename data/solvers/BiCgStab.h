@@ -0,0 +1,33 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_BICGSTAB_H
+#define MPI2_BICGSTAB_H
+
+#include "KrylovSolver.h"
+
+namespace data::solvers {
+
+    /**
+     * The stabilized biconjugate gradient method (BiCGSTAB) with the right preconditioning. The method is suitable
+     * for the non-symmetric operators (e.g., the normalized convolution). Each iteration applies the operator and
+     * the preconditioner twice and makes three allReduce calls: the first one for (r0, v), the second one for (t, s),
+     * (t, t) and (s, s), the third one for (r, r) and (r0, r)
+     */
+    class BiCgStab: public KrylovSolver {
+    protected:
+        bool iterate(ContiguousMatrix& x, const Matrix& b) override;
+
+    public:
+        /**
+         * Creates the solver. See KrylovSolver::KrylovSolver for details
+         */
+        explicit BiCgStab(LinearOperator& op, const Preconditioner* preconditioner = nullptr, double tol = 1e-8,
+                int iterationNumber = 1000): KrylovSolver(op, preconditioner, tol, iterationNumber) {};
+    };
+
+}
+
+#endif //MPI2_BICGSTAB_H
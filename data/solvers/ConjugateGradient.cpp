@@ -0,0 +1,52 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include "ConjugateGradient.h"
+#include "../LocalMatrix.h"
+
+namespace data::solvers {
+
+    bool ConjugateGradient::iterate(ContiguousMatrix &x, const Matrix &b) {
+        int w = x.getWidth(), h = x.getHeight();
+        double wu = x.getWidthUm(), hu = x.getHeightUm();
+        LocalMatrix r(*comm, w, h, wu, hu), z(*comm, w, h, wu, hu), q(*comm, w, h, wu, hu);
+        ContiguousMatrix p(*comm, w, h, wu, hu);
+        const Matrix* first[] = {&r, &r};
+        const Matrix* second[] = {&z, &r};
+        double products[2];
+
+        computeResidual(r, b, x);
+        precondition(z, r);
+        innerProducts(2, first, second, products);
+        if (checkResidual(sqrt(products[1]))){
+            return true;
+        }
+        double rz = products[0];
+        copy(p, z);
+
+        while (iterations < maxIterations){
+            ++iterations;
+            A.apply(q, p);
+            double pq = innerProduct(p, q);
+            if (pq == 0.0 || !std::isfinite(pq)){
+                throw solver_breakdown();
+            }
+            double alpha = rz / pq;
+            x.add(x, alpha, p);
+            r.add(r, -alpha, q);
+            precondition(z, r);
+            innerProducts(2, first, second, products);
+            if (checkResidual(sqrt(products[1]))){
+                return true;
+            }
+            double beta = products[0] / rz;
+            rz = products[0];
+            p.add(z, beta, p);
+        }
+        return false;
+    }
+
+}
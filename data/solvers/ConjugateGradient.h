@@ -0,0 +1,33 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_CONJUGATEGRADIENT_H
+#define MPI2_CONJUGATEGRADIENT_H
+
+#include "KrylovSolver.h"
+
+namespace data::solvers {
+
+    /**
+     * The preconditioned conjugate gradient method. The operator and the preconditioner shall be symmetric and
+     * positive definite. Each iteration applies the operator once and makes two allReduce calls: the first one for
+     * (p, A p), the second one for (r, z) and (r, r)
+     */
+    class ConjugateGradient: public KrylovSolver {
+    protected:
+        bool iterate(ContiguousMatrix& x, const Matrix& b) override;
+
+    public:
+        /**
+         * Creates the solver. See KrylovSolver::KrylovSolver for details
+         */
+        explicit ConjugateGradient(LinearOperator& op, const Preconditioner* preconditioner = nullptr,
+                double tol = 1e-8, int iterationNumber = 1000):
+                KrylovSolver(op, preconditioner, tol, iterationNumber) {};
+    };
+
+}
+
+#endif //MPI2_CONJUGATEGRADIENT_H
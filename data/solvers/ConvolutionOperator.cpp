@@ -0,0 +1,72 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <algorithm>
+#include "ConvolutionOperator.h"
+#include "../simd/Kernels.h"
+
+namespace data::solvers {
+
+    ConvolutionOperator::ConvolutionOperator(const ContiguousMatrix &K, const Matrix &target, double a, double b,
+            bool norm): kernel(K), convolver(K, target, norm), alpha(a), beta(b), normalize(norm),
+            width(target.getWidth()), height(target.getHeight()),
+            iStart(target.getIstart()), iFinish(target.getIfinish()) {}
+
+    void ConvolutionOperator::apply(Matrix &y, ContiguousMatrix &x) {
+        if (x.getWidth() != width || x.getHeight() != height || y.getWidth() != width || y.getHeight() != height){
+            throw matrix_dimensions_mismatch();
+        }
+        x.startHaloExchange(convolver.getHaloRows());
+        convolver.convolveInterior(y, x);
+        x.finishHaloExchange();
+        convolver.convolveBoundary(y, x);
+
+        auto source = x.localSpan();
+        auto result = y.localSpan();
+        simd::linear(result.begin(), source.begin(), alpha, result.begin(), beta, result.getSize());
+    }
+
+    void ConvolutionOperator::getLocalBlock(LocalBlock &block) const {
+        int W = (kernel.getWidth() - 1) / 2;
+        int H = (kernel.getHeight() - 1) / 2;
+
+        block.rowStart.assign(1, 0);
+        block.columns.clear();
+        block.values.clear();
+        for (int p = iStart; p < iFinish; ++p){
+            int i = p / width, j = p % width;
+            int hMin = std::max(-H, -i), hMax = std::min(H, height - 1 - i);
+            int wMin = std::max(-W, -j), wMax = std::min(W, width - 1 - j);
+
+            /* The normalization weight is the sum of the kernel over the pixels overlapped with the field */
+            double weight = 1.0;
+            if (normalize){
+                weight = 0.0;
+                for (int h = hMin; h <= hMax; ++h){
+                    for (int w = wMin; w <= wMax; ++w){
+                        weight += kernel[(H + h) * kernel.getWidth() + W + w];
+                    }
+                }
+            }
+
+            /* The neighbors are visited in the ascending order of their indices */
+            for (int h = hMin; h <= hMax; ++h){
+                for (int w = wMin; w <= wMax; ++w){
+                    int q = p + h * width + w;
+                    double value = beta * kernel[(H + h) * kernel.getWidth() + W + w] / weight;
+                    if (q == p){
+                        value += alpha;
+                    }
+                    if (q >= iStart && q < iFinish && (value != 0.0 || q == p)){
+                        block.columns.push_back(q - iStart);
+                        block.values.push_back(value);
+                    }
+                }
+            }
+            block.rowStart.push_back((int)block.columns.size());
+        }
+    }
+
+}
@@ -0,0 +1,66 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_CONVOLUTIONOPERATOR_H
+#define MPI2_CONVOLUTIONOPERATOR_H
+
+#include "LinearOperator.h"
+#include "../Convolver.h"
+
+namespace data::solvers {
+
+    /**
+     * The matrix-free operator y = alpha * x + beta * (K * x) where K * x is the spatial convolution of the field x
+     * with the kernel K (the same convolution as given by Matrix::convolve). The vectors are the fields of the same
+     * size as the target matrix given to the constructor.
+     *
+     * The convolution is performed by data::Convolver while the halo rows of x are transmitted, so each application
+     * transmits the halo only. Any spatial kernel of the GLM model may act as the operator:
+     * data::solvers::ConvolutionOperator op(spatialKernel.getKernel(), spatialKernel.getOutput(), 1.0, -w);
+     * Then the steady state x = b + w * (K * x) is found by solving op x = b
+     */
+    class ConvolutionOperator: public LinearOperator {
+    private:
+        const ContiguousMatrix& kernel;
+        Convolver convolver;
+        double alpha, beta;
+        bool normalize;
+        int width, height, iStart, iFinish;
+
+    public:
+        /**
+         * Creates the operator
+         *
+         * @param K the convolution kernel. The kernel shall be synchronized and shall not be destroyed before
+         * the operator
+         * @param target any matrix which dimensions and responsibility area are the same as for the vectors
+         * @param a the coefficient alpha
+         * @param b the coefficient beta
+         * @param norm true if the convolution results shall be normalized. See Matrix::convolve for details
+         */
+        ConvolutionOperator(const ContiguousMatrix& K, const Matrix& target, double a, double b, bool norm = true);
+
+        /**
+         * Applies the operator. See LinearOperator::apply for details
+         * This is a collective routine
+         *
+         * @param y the matrix where the result will be written
+         * @param x the source vector. Only the halo rows of the vector will be synchronized (see
+         * ContiguousMatrix::startHaloExchange)
+         */
+        void apply(Matrix& y, ContiguousMatrix& x) override;
+
+        /**
+         * Assembles the local block from the kernel values. Each local row contains at most
+         * K.getWidth() * K.getHeight() entries
+         *
+         * @param block the structure to fill
+         */
+        void getLocalBlock(LocalBlock& block) const override;
+    };
+
+}
+
+#endif //MPI2_CONVOLUTIONOPERATOR_H
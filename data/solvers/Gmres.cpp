@@ -0,0 +1,111 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include <algorithm>
+#include "Gmres.h"
+#include "../LocalMatrix.h"
+
+namespace data::solvers {
+
+    bool Gmres::iterate(ContiguousMatrix &x, const Matrix &b) {
+        int w = x.getWidth(), h = x.getHeight();
+        double wu = x.getWidthUm(), hu = x.getHeightUm();
+        std::vector<LocalMatrix> V;
+        V.reserve(restart + 1);
+        for (int i = 0; i <= restart; ++i){
+            V.emplace_back(*comm, w, h, wu, hu);
+        }
+        LocalMatrix u(*comm, w, h, wu, hu);
+        ContiguousMatrix z(*comm, w, h, wu, hu);
+        std::vector<const Matrix*> first(restart + 1), second(restart + 1, &u);
+        std::vector<double> R((std::size_t)restart * restart), column(restart + 1), correction(restart + 1);
+        std::vector<double> cs(restart), sn(restart), g(restart + 1), y(restart);
+
+        while (true){
+            computeResidual(V[0], b, x);
+            double beta = sqrt(innerProduct(V[0], V[0]));
+            if (checkResidual(beta)){
+                return true;
+            }
+            if (iterations >= maxIterations){
+                return false;
+            }
+            V[0] *= 1.0 / beta;
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = beta;
+
+            bool converged = false;
+            int j = 0;
+            while (j < restart && iterations < maxIterations && !converged){
+                ++iterations;
+                precondition(z, V[j]);
+                A.apply(u, z);
+
+                /* The classical Gram-Schmidt process, the second pass computes the norm as well */
+                for (int i = 0; i <= j; ++i){
+                    first[i] = &V[i];
+                }
+                innerProducts(j + 1, first.data(), second.data(), column.data());
+                for (int i = 0; i <= j; ++i){
+                    u.add(u, -column[i], V[i]);
+                }
+                first[j + 1] = &u;
+                innerProducts(j + 2, first.data(), second.data(), correction.data());
+                double norm = correction[j + 1];
+                for (int i = 0; i <= j; ++i){
+                    u.add(u, -correction[i], V[i]);
+                    column[i] += correction[i];
+                    norm -= correction[i] * correction[i];
+                }
+                norm = sqrt(std::max(norm, 0.0));
+
+                /* The Givens rotations transform the Hessenberg matrix into the upper triangular one */
+                for (int i = 0; i < j; ++i){
+                    double value = cs[i] * column[i] + sn[i] * column[i + 1];
+                    column[i + 1] = -sn[i] * column[i] + cs[i] * column[i + 1];
+                    column[i] = value;
+                }
+                double diagonal = hypot(column[j], norm);
+                if (diagonal == 0.0 || !std::isfinite(diagonal)){
+                    throw solver_breakdown();
+                }
+                cs[j] = column[j] / diagonal;
+                sn[j] = norm / diagonal;
+                column[j] = diagonal;
+                g[j + 1] = -sn[j] * g[j];
+                g[j] *= cs[j];
+                for (int i = 0; i <= j; ++i){
+                    R[(std::size_t)i * restart + j] = column[i];
+                }
+
+                converged = checkResidual(std::abs(g[j + 1])) || norm == 0.0;
+                if (!converged){
+                    V[j + 1].mul(u, 1.0 / norm);
+                }
+                ++j;
+            }
+
+            /* x = x + M^{-1} V y where R y = g */
+            for (int i = j - 1; i >= 0; --i){
+                double value = g[i];
+                for (int k = i + 1; k < j; ++k){
+                    value -= R[(std::size_t)i * restart + k] * y[k];
+                }
+                y[i] = value / R[(std::size_t)i * restart + i];
+            }
+            u.mul(V[0], y[0]);
+            for (int i = 1; i < j; ++i){
+                u.add(u, y[i], V[i]);
+            }
+            precondition(z, u);
+            x.add(x, 1.0, z);
+            if (converged){
+                return true;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,48 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_GMRES_H
+#define MPI2_GMRES_H
+
+#include "KrylovSolver.h"
+#include "../../compile_options.h"
+
+namespace data::solvers {
+
+    /**
+     * The restarted generalized minimal residual method GMRES(m) with the right preconditioning, so the residual
+     * minimized by the method is the true residual b - A x. The basis is orthogonalized by the classical Gram-Schmidt
+     * process repeated twice: each pass computes all the inner products by a single allReduce (the second pass
+     * gives the norm of the new basis vector as well), so each iteration makes two allReduce calls regardless of
+     * the basis size. The residual norm is given by the Givens rotations of the Hessenberg matrix and requires no
+     * extra reductions
+     */
+    class Gmres: public KrylovSolver {
+    private:
+        int restart;
+
+    protected:
+        bool iterate(ContiguousMatrix& x, const Matrix& b) override;
+
+    public:
+        /**
+         * Creates the solver. See KrylovSolver::KrylovSolver for details
+         *
+         * @param m number of iterations between restarts
+         */
+        explicit Gmres(LinearOperator& op, const Preconditioner* preconditioner = nullptr, double tol = 1e-8,
+                int iterationNumber = 1000, int m = SOLVER_GMRES_RESTART):
+                KrylovSolver(op, preconditioner, tol, iterationNumber), restart(m) {};
+
+        /**
+         *
+         * @return number of iterations between restarts
+         */
+        [[nodiscard]] int getRestart() const { return restart; }
+    };
+
+}
+
+#endif //MPI2_GMRES_H
@@ -0,0 +1,90 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include "IluPreconditioner.h"
+
+namespace data::solvers {
+
+    IluPreconditioner::IluPreconditioner(const LinearOperator &A, double dropTolerance) {
+        LocalBlock block;
+        A.getLocalBlock(block);
+        int rows = (int)block.rowStart.size() - 1;
+
+        /* Builds the pattern of the factors and finds the diagonal entries */
+        factors.rowStart.assign(1, 0);
+        diagonal.assign(rows, -1);
+        for (int r = 0; r < rows; ++r){
+            double threshold = 0.0;
+            for (int k = block.rowStart[r]; k < block.rowStart[r+1]; ++k){
+                if (block.columns[k] == r){
+                    threshold = dropTolerance * std::abs(block.values[k]);
+                }
+            }
+            for (int k = block.rowStart[r]; k < block.rowStart[r+1]; ++k){
+                if (block.columns[k] == r){
+                    diagonal[r] = (int)factors.columns.size();
+                } else if (std::abs(block.values[k]) < threshold){
+                    continue;
+                }
+                factors.columns.push_back(block.columns[k]);
+                factors.values.push_back(block.values[k]);
+            }
+            factors.rowStart.push_back((int)factors.columns.size());
+            if (diagonal[r] == -1){
+                throw singular_preconditioner();
+            }
+        }
+
+        /* ILU(0), the IKJ variant: the row r is eliminated by the rows above it within its own pattern */
+        std::vector<int> position(rows, -1);
+        for (int r = 0; r < rows; ++r){
+            for (int k = factors.rowStart[r]; k < factors.rowStart[r+1]; ++k){
+                position[factors.columns[k]] = k;
+            }
+            for (int k = factors.rowStart[r]; k < diagonal[r]; ++k){
+                int c = factors.columns[k];
+                double l = factors.values[k] /= factors.values[diagonal[c]];
+                for (int m = diagonal[c] + 1; m < factors.rowStart[c+1]; ++m){
+                    int target = position[factors.columns[m]];
+                    if (target >= 0){
+                        factors.values[target] -= l * factors.values[m];
+                    }
+                }
+            }
+            for (int k = factors.rowStart[r]; k < factors.rowStart[r+1]; ++k){
+                position[factors.columns[k]] = -1;
+            }
+            if (factors.values[diagonal[r]] == 0.0 || !std::isfinite(factors.values[diagonal[r]])){
+                throw singular_preconditioner();
+            }
+        }
+    }
+
+    void IluPreconditioner::apply(Matrix &z, const Matrix &r) const {
+        auto source = r.localSpan();
+        auto result = z.localSpan();
+        int rows = (int)diagonal.size();
+        if (source.getSize() != rows || result.getSize() != rows){
+            throw matrix_dimensions_mismatch();
+        }
+
+        for (int i = 0; i < rows; ++i){
+            double value = source[i];
+            for (int k = factors.rowStart[i]; k < diagonal[i]; ++k){
+                value -= factors.values[k] * result[factors.columns[k]];
+            }
+            result[i] = value;
+        }
+        for (int i = rows - 1; i >= 0; --i){
+            double value = result[i];
+            for (int k = diagonal[i] + 1; k < factors.rowStart[i+1]; ++k){
+                value -= factors.values[k] * result[factors.columns[k]];
+            }
+            result[i] = value / factors.values[diagonal[i]];
+        }
+    }
+
+}
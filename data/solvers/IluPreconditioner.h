@@ -0,0 +1,53 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_ILUPRECONDITIONER_H
+#define MPI2_ILUPRECONDITIONER_H
+
+#include <vector>
+#include "Preconditioner.h"
+
+namespace data::solvers {
+
+    /**
+     * The block Jacobi preconditioner with the incomplete LU factorization of each block: each process computes
+     * ILU(0) of the local block of the operator (see LinearOperator::getLocalBlock), i.e., L and U have the same
+     * non-zero pattern as the block. The couplings between the responsibility areas of different processes are
+     * ignored, so the preconditioner requires no communication.
+     *
+     * The factorization takes O(n * m^2) operations where m is the number of entries per row. For the wide kernels
+     * most of the entries are small; the entries which absolute value is less than dropTolerance times the diagonal
+     * value may be excluded from the pattern
+     */
+    class IluPreconditioner: public Preconditioner {
+    private:
+        LocalBlock factors;
+        std::vector<int> diagonal;
+
+    public:
+        /**
+         * Creates the preconditioner
+         * This is not a collective routine
+         *
+         * @param A the operator. The operator shall provide its local block (see LinearOperator::getLocalBlock)
+         * @param dropTolerance the off-diagonal entries less than dropTolerance times the diagonal entry of the same
+         * row will be excluded from the factors
+         * @throws operator_not_assembled if the operator can't provide the local block
+         * @throws singular_preconditioner if zero pivot was found
+         */
+        explicit IluPreconditioner(const LinearOperator& A, double dropTolerance = 0.0);
+
+        /**
+         * Applies the preconditioner: solves L U z = r by the forward and the backward substitution
+         *
+         * @param z the result
+         * @param r the source vector
+         */
+        void apply(Matrix& z, const Matrix& r) const override;
+    };
+
+}
+
+#endif //MPI2_ILUPRECONDITIONER_H
@@ -0,0 +1,39 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "JacobiPreconditioner.h"
+#include "../simd/Kernels.h"
+
+namespace data::solvers {
+
+    JacobiPreconditioner::JacobiPreconditioner(const LinearOperator &A) {
+        LocalBlock block;
+        A.getLocalBlock(block);
+        int rows = (int)block.rowStart.size() - 1;
+        inverseDiagonal.resize(rows);
+        for (int r = 0; r < rows; ++r){
+            double diagonal = 0.0;
+            for (int k = block.rowStart[r]; k < block.rowStart[r+1]; ++k){
+                if (block.columns[k] == r){
+                    diagonal = block.values[k];
+                }
+            }
+            if (diagonal == 0.0){
+                throw singular_preconditioner();
+            }
+            inverseDiagonal[r] = 1.0 / diagonal;
+        }
+    }
+
+    void JacobiPreconditioner::apply(Matrix &z, const Matrix &r) const {
+        auto source = r.localSpan();
+        auto result = z.localSpan();
+        if (source.getSize() != (int)inverseDiagonal.size() || result.getSize() != source.getSize()){
+            throw matrix_dimensions_mismatch();
+        }
+        simd::multiply(result.begin(), source.begin(), inverseDiagonal.data(), result.getSize());
+    }
+
+}
@@ -0,0 +1,43 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_JACOBIPRECONDITIONER_H
+#define MPI2_JACOBIPRECONDITIONER_H
+
+#include <vector>
+#include "Preconditioner.h"
+
+namespace data::solvers {
+
+    /**
+     * The Jacobi preconditioner: M is the diagonal of the operator
+     */
+    class JacobiPreconditioner: public Preconditioner {
+    private:
+        std::vector<double> inverseDiagonal;
+
+    public:
+        /**
+         * Creates the preconditioner
+         * This is not a collective routine
+         *
+         * @param A the operator. The operator shall provide its local block (see LinearOperator::getLocalBlock)
+         * @throws operator_not_assembled if the operator can't provide the local block
+         * @throws singular_preconditioner if the operator has zero diagonal element
+         */
+        explicit JacobiPreconditioner(const LinearOperator& A);
+
+        /**
+         * Applies the preconditioner. See Preconditioner::apply for details
+         *
+         * @param z the result
+         * @param r the source vector
+         */
+        void apply(Matrix& z, const Matrix& r) const override;
+    };
+
+}
+
+#endif //MPI2_JACOBIPRECONDITIONER_H
@@ -0,0 +1,71 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include <algorithm>
+#include "KrylovSolver.h"
+
+namespace data::solvers {
+
+    void KrylovSolver::innerProducts(int number, const Matrix *const *first, const Matrix *const *second,
+            double *result) const {
+        std::vector<double> local(number, 0.0);
+        for (int n = 0; n < number; ++n){
+            auto x = first[n]->localSpan();
+            auto y = second[n]->localSpan();
+            double sum = 0.0;
+            for (int k = 0; k < x.getSize(); ++k){
+                sum += x[k] * y[k];
+            }
+            local[n] = sum;
+        }
+        comm->allReduce(local.data(), result, number, MPI_DOUBLE, MPI_SUM);
+    }
+
+    double KrylovSolver::innerProduct(const Matrix &x, const Matrix &y) const {
+        const Matrix* first = &x;
+        const Matrix* second = &y;
+        double result;
+        innerProducts(1, &first, &second, &result);
+        return result;
+    }
+
+    void KrylovSolver::precondition(Matrix &z, const Matrix &r) const {
+        if (M == nullptr){
+            copy(z, r);
+        } else {
+            M->apply(z, r);
+        }
+    }
+
+    void KrylovSolver::copy(Matrix &y, const Matrix &x) {
+        auto source = x.localSpan();
+        std::copy(source.begin(), source.end(), y.localSpan().begin());
+    }
+
+    void KrylovSolver::computeResidual(Matrix &r, const Matrix &b, ContiguousMatrix &x) {
+        A.apply(r, x);
+        r.sub(b, r);
+    }
+
+    void KrylovSolver::solve(ContiguousMatrix &x, const Matrix &b) {
+        if (x.getWidth() != b.getWidth() || x.getHeight() != b.getHeight() || x.getIstart() != b.getIstart() ||
+                x.getIfinish() != b.getIfinish()){
+            throw matrix_dimensions_mismatch();
+        }
+        comm = &x.getCommunicator();
+        iterations = 0;
+        residual = 0.0;
+        normB = sqrt(innerProduct(b, b));
+        if (normB == 0.0){
+            x.fill(0.0);
+            return;
+        }
+        if (!iterate(x, b)){
+            throw solver_not_converged();
+        }
+    }
+
+}
@@ -0,0 +1,185 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_KRYLOVSOLVER_H
+#define MPI2_KRYLOVSOLVER_H
+
+#include "LinearOperator.h"
+#include "Preconditioner.h"
+
+namespace data::solvers {
+
+    /**
+     * Base class for the distributed Krylov solvers of the linear system A x = b (see ConjugateGradient, BiCgStab
+     * and Gmres). In contrast to data::LuDecomposer the solvers never form the operator: each iteration applies
+     * the operator once or twice and computes several inner products, so the work per iteration is O(N) for
+     * the sparse and matrix-free operators.
+     *
+     * All vectors are distributed in the usual way and the solvers work on their responsibility areas only. The
+     * inner products required at the same step of the method are merged into a single allReduce, hence the
+     * number of the global reductions per iteration doesn't depend on the number of the inner products.
+     *
+     * The iterations stop when ||b - A x|| <= tolerance * ||b||.
+     *
+     * Usage:
+     * data::solvers::ConvolutionOperator op(K, b, 1.0, -0.5);
+     * data::solvers::IluPreconditioner ilu(op);
+     * data::solvers::BiCgStab solver(op, &ilu, 1e-10);
+     * solver.solve(x, b);
+     */
+    class KrylovSolver {
+    protected:
+        LinearOperator& A;
+        const Preconditioner* M;
+        double tolerance;
+        int maxIterations;
+        mpi::Communicator* comm = nullptr;
+        int iterations = 0;
+        double residual = 0.0;
+        double normB = 0.0;
+
+        /**
+         * Computes several inner products by a single allReduce
+         * This is a collective routine
+         *
+         * @param number number of the inner products
+         * @param first the first operands of the products
+         * @param second the second operands of the products
+         * @param result the array where the products will be written
+         */
+        void innerProducts(int number, const Matrix* const* first, const Matrix* const* second, double* result) const;
+
+        /**
+         * Computes the single inner product
+         * This is a collective routine
+         *
+         * @param x the first vector
+         * @param y the second vector
+         * @return the product (x, y)
+         */
+        double innerProduct(const Matrix& x, const Matrix& y) const;
+
+        /**
+         * Applies the preconditioner or copies r into z if the solver has no preconditioner
+         *
+         * @param z the result
+         * @param r the source vector
+         */
+        void precondition(Matrix& z, const Matrix& r) const;
+
+        /**
+         * Copies the responsibility area of one vector to another one
+         *
+         * @param y the destination vector
+         * @param x the source vector
+         */
+        static void copy(Matrix& y, const Matrix& x);
+
+        /**
+         * Computes the residual r = b - A x
+         * This is a collective routine
+         *
+         * @param r the residual
+         * @param b the right-hand side
+         * @param x the solution
+         */
+        void computeResidual(Matrix& r, const Matrix& b, ContiguousMatrix& x);
+
+        /**
+         * Stores the residual norm and checks the stopping criterion
+         *
+         * @param norm the residual norm ||b - A x||
+         * @return true if the required residual has been reached
+         */
+        bool checkResidual(double norm){
+            residual = norm / normB;
+            return residual <= tolerance;
+        }
+
+        /**
+         * Runs the iterations. x contains the initial guess, ||b|| is positive and is stored in normB. The method
+         * shall increase the iterations counter and call checkResidual(...) each iteration
+         * This is a collective routine
+         *
+         * @param x the initial guess on input, the solution on output
+         * @param b the right-hand side
+         * @return true if the required residual has been reached
+         */
+        virtual bool iterate(ContiguousMatrix& x, const Matrix& b) = 0;
+
+    public:
+        /**
+         * Creates the solver
+         *
+         * @param op the linear operator. The operator shall not be destroyed before the solver
+         * @param preconditioner the preconditioner or nullptr if the preconditioning is not required
+         * @param tol the relative residual required
+         * @param iterationNumber maximum number of iterations
+         */
+        explicit KrylovSolver(LinearOperator& op, const Preconditioner* preconditioner = nullptr, double tol = 1e-8,
+                int iterationNumber = 1000): A(op), M(preconditioner), tolerance(tol),
+                maxIterations(iterationNumber) {};
+
+        KrylovSolver(const KrylovSolver& other) = delete;
+        KrylovSolver& operator=(const KrylovSolver& other) = delete;
+
+        virtual ~KrylovSolver() = default;
+
+        /**
+         * Solves the equation A x = b
+         * This is a collective routine
+         *
+         * @param x the initial guess on input, the solution on output. Only the responsibility area of the solution
+         * is up to date
+         * @param b the right-hand side. Only the responsibility area is used
+         * @throws matrix_dimensions_mismatch if x and b have different size or responsibility areas
+         * @throws solver_not_converged if the tolerance was not reached within the maximum number of iterations.
+         * x contains the last approximation in this case
+         * @throws solver_breakdown if the method can't continue the iterations
+         */
+        void solve(ContiguousMatrix& x, const Matrix& b);
+
+        /**
+         *
+         * @return number of iterations made by the last call of solve(...)
+         */
+        [[nodiscard]] int getIterations() const { return iterations; }
+
+        /**
+         *
+         * @return the relative residual ||b - A x|| / ||b|| estimated by the method at the last iteration
+         */
+        [[nodiscard]] double getResidual() const { return residual; }
+
+        /**
+         *
+         * @return the relative residual required
+         */
+        [[nodiscard]] double getTolerance() const { return tolerance; }
+
+        /**
+         * Sets the relative residual required
+         *
+         * @param value the new value
+         */
+        void setTolerance(double value) { tolerance = value; }
+
+        /**
+         *
+         * @return maximum number of iterations
+         */
+        [[nodiscard]] int getMaxIterations() const { return maxIterations; }
+
+        /**
+         * Sets maximum number of iterations
+         *
+         * @param value the new value
+         */
+        void setMaxIterations(int value) { maxIterations = value; }
+    };
+
+}
+
+#endif //MPI2_KRYLOVSOLVER_H
@@ -0,0 +1,69 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_LINEAROPERATOR_H
+#define MPI2_LINEAROPERATOR_H
+
+#include <vector>
+#include "../Matrix.h"
+#include "../ContiguousMatrix.h"
+#include "../exceptions.h"
+
+namespace data::solvers {
+
+    /**
+     * Rows of the linear operator that belong to the responsibility area of the process restricted to the columns
+     * within the same responsibility area (the diagonal block of the operator). The block is stored in the compressed
+     * sparse row format: the entries of the local row r are columns[k] and values[k] for
+     * rowStart[r] <= k < rowStart[r+1]. Both row and column indices are local, i.e., the local index 0 corresponds
+     * to getIstart() of the vectors. The columns within each row are sorted in ascending order and the diagonal
+     * entry is always present
+     */
+    struct LocalBlock {
+        std::vector<int> rowStart;
+        std::vector<int> columns;
+        std::vector<double> values;
+    };
+
+    /**
+     * Base class for all linear operators y = A x used by the Krylov solvers (see KrylovSolver).
+     *
+     * The operator is matrix-free: the solvers know nothing about the operator except how to apply it to a vector.
+     * The vectors are the matrices distributed in the usual way (see data::Matrix): all of them have the same size
+     * and the same responsibility area, so the operator may act on the two-dimensional fields directly (see
+     * ConvolutionOperator) as well as on the N x 1 columns (see MatrixOperator).
+     *
+     * The preconditioners (see Preconditioner) require the local block of the operator. The operators that can't
+     * assemble their local block don't override getLocalBlock() and can be used without the preconditioner only
+     */
+    class LinearOperator {
+    public:
+        virtual ~LinearOperator() = default;
+
+        /**
+         * Applies the operator: y = A x
+         * This is a collective routine
+         *
+         * @param y the matrix where the result will be written. Only its responsibility area is filled
+         * @param x the source vector. Only the responsibility area of x is required to be up to date; the operator
+         * synchronizes the rest of the vector itself (see ContiguousMatrix::synchronize and
+         * ContiguousMatrix::synchronizeHalo)
+         * @throws matrix_dimensions_mismatch if the vectors have size not suitable for the operator
+         */
+        virtual void apply(Matrix& y, ContiguousMatrix& x) = 0;
+
+        /**
+         * Assembles the diagonal block of the operator corresponding to the responsibility area of the process.
+         * This is not a collective routine
+         *
+         * @param block the structure to fill
+         * @throws operator_not_assembled if the operator doesn't support the assembly
+         */
+        virtual void getLocalBlock(LocalBlock&) const { throw operator_not_assembled(); }
+    };
+
+}
+
+#endif //MPI2_LINEAROPERATOR_H
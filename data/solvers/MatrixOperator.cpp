@@ -0,0 +1,46 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cmath>
+#include <algorithm>
+#include "MatrixOperator.h"
+
+namespace data::solvers {
+
+    MatrixOperator::MatrixOperator(ContiguousMatrix &A): matrix(A), N(A.getHeight()) {
+        if (A.getWidth() != A.getHeight()){
+            throw square_matrix_required();
+        }
+        /* The responsibility area of the N x 1 vectors, see Matrix::Matrix */
+        int localSize = (int)ceil((double)N / A.getCommunicator().getProcessorNumber());
+        firstRow = std::min(localSize * A.getRank(), N);
+        lastRow = std::min(firstRow + localSize, N);
+    }
+
+    void MatrixOperator::apply(Matrix &y, ContiguousMatrix &x) {
+        if (x.getHeight() != N || x.getWidth() != 1 || y.getHeight() != N || y.getWidth() != 1){
+            throw matrix_dimensions_mismatch();
+        }
+        x.synchronize();
+        y.dot(matrix, x);
+    }
+
+    void MatrixOperator::getLocalBlock(LocalBlock &block) const {
+        block.rowStart.assign(1, 0);
+        block.columns.clear();
+        block.values.clear();
+        for (int i = firstRow; i < lastRow; ++i){
+            for (int j = firstRow; j < lastRow; ++j){
+                double value = matrix[i * N + j];
+                if (value != 0.0 || i == j){
+                    block.columns.push_back(j - firstRow);
+                    block.values.push_back(value);
+                }
+            }
+            block.rowStart.push_back((int)block.columns.size());
+        }
+    }
+
+}
@@ -0,0 +1,64 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_MATRIXOPERATOR_H
+#define MPI2_MATRIXOPERATOR_H
+
+#include "LinearOperator.h"
+
+namespace data::solvers {
+
+    /**
+     * The linear operator given by the explicit N x N matrix. The operator acts on the N x 1 vectors (the same
+     * vectors as used by LuDecomposer::solve). The product is computed by Matrix::dot, so each application
+     * transmits the whole vector x but never transmits the matrix
+     *
+     * Usage:
+     * data::solvers::MatrixOperator op(A); // A shall be synchronized
+     * data::solvers::ConjugateGradient solver(op);
+     * solver.solve(x, b);
+     */
+    class MatrixOperator: public LinearOperator {
+    private:
+        const ContiguousMatrix& matrix;
+        int N;
+        int firstRow, lastRow;
+
+    public:
+        /**
+         * Creates the operator
+         *
+         * @param A the operator matrix. The rows of A corresponding to the responsibility area of the vectors shall
+         * be synchronized. The matrix shall not be destroyed before the operator
+         * @throws square_matrix_required if the matrix is not square
+         */
+        explicit MatrixOperator(ContiguousMatrix& A);
+
+        /**
+         *
+         * @return size of the vectors the operator acts on
+         */
+        [[nodiscard]] int getSize() const { return N; }
+
+        /**
+         * Applies the operator: y = A x. See LinearOperator::apply for details
+         * This is a collective routine
+         *
+         * @param y the N x 1 matrix where the result will be written
+         * @param x the N x 1 source vector. The vector will be synchronized by the routine
+         */
+        void apply(Matrix& y, ContiguousMatrix& x) override;
+
+        /**
+         * Assembles the local block from the non-zero elements of the matrix
+         *
+         * @param block the structure to fill
+         */
+        void getLocalBlock(LocalBlock& block) const override;
+    };
+
+}
+
+#endif //MPI2_MATRIXOPERATOR_H
@@ -0,0 +1,36 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_PRECONDITIONER_H
+#define MPI2_PRECONDITIONER_H
+
+#include "LinearOperator.h"
+
+namespace data::solvers {
+
+    /**
+     * Base class for all preconditioners z = M^{-1} r used by the Krylov solvers.
+     *
+     * All preconditioners are block-diagonal: the process applies the preconditioner to its responsibility area
+     * using the local block of the operator only (see LinearOperator::getLocalBlock), so the application requires
+     * no communication
+     */
+    class Preconditioner {
+    public:
+        virtual ~Preconditioner() = default;
+
+        /**
+         * Applies the preconditioner: z = M^{-1} r
+         * This is not a collective routine
+         *
+         * @param z the matrix where the result will be written. Only its responsibility area is filled
+         * @param r the source vector. Only its responsibility area is used
+         */
+        virtual void apply(Matrix& z, const Matrix& r) const = 0;
+    };
+
+}
+
+#endif //MPI2_PRECONDITIONER_H
@@ -6,6 +6,7 @@
 #include "../log/output.h"
 #include "../data/stream/BinStream.h"
 #include "../analyzers/AnalysisBuilder.h"
+#include "../data/MatrixAllocator.h"
 
 namespace job{
 
@@ -35,7 +36,7 @@ namespace job{
         auto N = (unsigned long long)(stimulus.getRecordLength() / integration_step);
         logging::progress(0, N, "Single-run simulation");
         for (; time < stimulus.getRecordLength(); ++timestamp, time = integration_step*timestamp){
-            stimulus.update(time);
+            stimulus.refresh(time);
             method.update(state, timestamp);
             updateAnalyzers(time);
             logging::progress(timestamp, N);
@@ -49,6 +50,7 @@ namespace job{
         double total_time = finish_time - start_time;
         logging::enter();
         logging::debug("Elapsed time: " + std::to_string(total_time));
+        logging::debug(data::MatrixAllocator::getStatisticsString());
         logging::exit();
         logging::progress(0, 1, "Finalizing the state");
         state.finalize();
@@ -346,6 +346,11 @@ let spatial_kernel_list = {
         type: "processor",
         mechanism: "glm:spatial_kernel.gaussian",
         radius: 0.3*d
+    },
+    recursive_gaussian: {
+        type: "processor",
+        mechanism: "glm:spatial_kernel.recursive_gaussian",
+        radius: 0.3*d
     }
 };
 
@@ -369,6 +374,7 @@ let lgn_on = {
     type: "layer",
     mechanism: "abstract:glm",
     stimulus_acceptable: true,
+    precision: "double",
     saturation: saturation_list.no,
     excitation: {
         temporal_kernel: Object.assign(lgn_on_properties.excitatory_temporal_kernel, {
@@ -21,12 +21,19 @@ namespace net{
                 logging::info("The layer is not stimulus acceptable");
             }
         }
+        setPrecision(equ::Processor::loadPrecision(source, equ::Processor::DoublePrecision));
+        if (getDeepFlag() && getPrecision() == equ::Processor::SinglePrecision){
+            logging::info("The layer state is stored in single precision");
+        }
         loadLayerParameters(source);
     }
 
     void Layer::broadcastParameterList() {
         logging::progress(0, 1, "Broadcasting '" + getFullName() + "'");
         Application::getInstance().broadcastBoolean(stimulus_acceptable, 0);
+        int precision_value = precision;
+        Application::getInstance().broadcastInteger(precision_value, 0);
+        precision = (equ::Processor::Precision)precision_value;
         broadcastLayerParameters();
     }
 
@@ -28,6 +28,7 @@ namespace net {
 
     private:
         bool stimulus_acceptable = false;
+        equ::Processor::Precision precision = equ::Processor::DoublePrecision;
         mpi::Communicator* comm = nullptr;
         Status status;
         method::Method* method = nullptr;
@@ -47,7 +48,7 @@ namespace net {
         virtual std::string getLayerDescription() = 0;
 
         /**
-         * Loads all layer parameters except: type, mechanism, stimulus_acceptable
+         * Loads all layer parameters except: type, mechanism, stimulus_acceptable, precision
          *
          * @param source parameter source (a cover for v8::Object)
          */
@@ -95,6 +96,20 @@ namespace net {
          */
         void setStimulusAcceptable(bool value) { stimulus_acceptable = value; }
 
+        /**
+         *
+         * @return default storage precision of the layer processors (see equ::Processor::Precision)
+         */
+        [[nodiscard]] equ::Processor::Precision getPrecision() const { return precision; }
+
+        /**
+         * Sets the default storage precision of the layer processors. The precision of a certain processor may be
+         * overridden by the 'precision' property of this processor
+         *
+         * @param value the storage precision
+         */
+        void setPrecision(equ::Processor::Precision value) { precision = value; }
+
         /**
          *
          * @return the layer communicator. This communicator will be applied to all layer processor and all layer
@@ -45,44 +45,55 @@ namespace equ{
     void DogFilter::initialize() {
         auto* exc = getExcitatoryKernel();
         auto* inh = getInhibitoryKernel();
-        int width = exc->getOutput().getWidth();
-        int height = exc->getOutput().getHeight();
-        double widthUm = exc->getOutput().getWidthUm();
-        double heightUm = exc->getOutput().getHeightUm();
-
-        if (width != inh->getOutput().getWidth()){
-            throw input_dimensions_mismatch();
-        }
-
-        if (height != inh->getOutput().getHeight()){
-            throw input_dimensions_mismatch();
-        }
-
-        if (widthUm != inh->getOutput().getWidthUm()){
-            throw input_dimensions_mismatch();
-        }
-
-        if (heightUm != inh->getOutput().getHeightUm()){
-            throw input_dimensions_mismatch();
-        }
+        int width = 0, height = 0;
+        double widthUm = 0.0, heightUm = 0.0;
+
+        exc->visitOutput([&](auto& excitatoryOutput) {
+            width = excitatoryOutput.getWidth();
+            height = excitatoryOutput.getHeight();
+            widthUm = excitatoryOutput.getWidthUm();
+            heightUm = excitatoryOutput.getHeightUm();
+        });
+
+        inh->visitOutput([&](auto& inhibitoryOutput) {
+            if (width != inhibitoryOutput.getWidth()){
+                throw input_dimensions_mismatch();
+            }
+
+            if (height != inhibitoryOutput.getHeight()){
+                throw input_dimensions_mismatch();
+            }
+
+            if (widthUm != inhibitoryOutput.getWidthUm()){
+                throw input_dimensions_mismatch();
+            }
+
+            if (heightUm != inhibitoryOutput.getHeightUm()){
+                throw input_dimensions_mismatch();
+            }
+        });
 
         output = new data::LocalMatrix(getCommunicator(), width, height, widthUm, heightUm);
     }
 
     void DogFilter::update(double time) {
-        auto r = output->begin();
-        auto r_end = output->end();
-        auto e = excitation->getOutput().cbegin();
-        auto i = inhibition->getOutput().cbegin();
+        auto r = output->localSpan();
         double r0 = getDarkRate();
         double k_e = getExcitatoryWeight();
         double k_i = getInhibitoryWeight();
         double T = getThreshold();
 
-        for (; r != r_end; ++r, ++e, ++i){
-            *r = r0 + k_e * *e + k_i * *i;
-            if (*r < T) *r = 0.0;
-        }
+        /* The spatial kernels may have single precision output while the DOG output is always double */
+        excitation->visitOutput([&](auto& excitatoryOutput) {
+            inhibition->visitOutput([&](auto& inhibitoryOutput) {
+                auto e = excitatoryOutput.localSpan();
+                auto i = inhibitoryOutput.localSpan();
+                for (int n = 0; n < r.getSize(); ++n){
+                    double value = r0 + k_e * e[n] + k_i * i[n];
+                    r[n] = value < T ? 0.0 : value;
+                }
+            });
+        });
     }
 
     void DogFilter::finalizeProcessor(bool destruct) noexcept {
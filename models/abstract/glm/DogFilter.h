@@ -10,6 +10,10 @@
 
 namespace equ {
 
+    /**
+     * The DOG filter produces output of the whole GLM layer that is read by the analyzers, hence its output is always
+     * double precision. The input spatial kernels may have any precision
+     */
     class DogFilter: public Equation {
     private:
         SpatialKernel *excitation = nullptr, *inhibition = nullptr;
@@ -19,6 +23,7 @@ namespace equ {
     protected:
         [[nodiscard]] std::string getProcessorName() override { return "equ::DogFilter"; }
         bool isOutputContiguous() override { return false; };
+        bool isInputDriven() override { return true; }
         void loadParameterList(const param::Object& source) override;
         void broadcastParameterList() override;
         void setParameter(const std::string& name, const void* pvalue) override;
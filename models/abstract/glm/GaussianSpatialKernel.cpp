@@ -28,9 +28,11 @@ namespace equ{
     }
 
     void GaussianSpatialKernel::initializeSpatialKernel() {
-        auto& input = getTemporalKernel()->getOutput();
-        double resX = input.getWidthUm() / (input.getWidth() - 1);
-        double resY = input.getHeightUm() / (input.getHeight() - 1);
+        double resX, resY;
+        getTemporalKernel()->visitOutput([&](auto& input) {
+            resX = input.getWidthUm() / (input.getWidth() - 1);
+            resY = input.getHeightUm() / (input.getHeight() - 1);
+        });
         double r = getRadius();
         double size = 4 * r;
         double kernelWidthUm = size;
@@ -40,10 +42,24 @@ namespace equ{
         kernel = new data::ContiguousMatrix(getCommunicator(), kernelWidth, kernelHeight,
                 kernelWidthUm, kernelHeightUm, 20.0);
 
-        for (auto kpix = kernel->begin(); kpix != kernel->end(); ++kpix){
-            double x = kpix.getColumnUm();
-            double y = kpix.getRowUm();
-            *kpix = exp(-(x*x)/(r*r) - (y*y)/(r*r));
+        auto kpix = kernel->localSpan();
+        for (int i = kpix.getFirstRow(); i < kpix.getLastRow(); ++i){
+            double y = kpix.getRowUm(i);
+            for (int j = kpix.getFirstColumn(i); j < kpix.getLastColumn(i); ++j){
+                double x = kpix.getColumnUm(j);
+                kpix(i, j) = exp(-(x*x)/(r*r) - (y*y)/(r*r));
+            }
+        }
+
+        horizontalFactor.resize(kernelWidth);
+        for (int j = 0; j < kernelWidth; ++j){
+            double x = (j - kernelWidth/2) * kernelWidthUm / (kernelWidth - 1);
+            horizontalFactor[j] = exp(-(x*x)/(r*r));
+        }
+        verticalFactor.resize(kernelHeight);
+        for (int i = 0; i < kernelHeight; ++i){
+            double y = (kernelHeight/2 - i) * kernelHeightUm / (kernelHeight - 1);
+            verticalFactor[i] = exp(-(y*y)/(r*r));
         }
     }
 }
\ No newline at end of file
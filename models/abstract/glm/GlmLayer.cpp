@@ -54,6 +54,7 @@ namespace net{
             if (saturation == nullptr){
                 throw IncorrectSaturationProperty();
             }
+            saturation->setPrecision(equ::Processor::loadPrecision(saturation_parameters, getPrecision()));
             saturation->loadParameters(saturation_parameters);
 
             logging::info("Excitatory kernel parameters");
@@ -68,6 +69,8 @@ namespace net{
                 throw IncorrectExcitatoryTemporalKernel();
             }
             excitatory_temporal_kernel->setStimulusSaturation(saturation);
+            excitatory_temporal_kernel->setPrecision(equ::Processor::loadPrecision(
+                    excitatory_temporal_kernel_parameters, getPrecision()));
             excitatory_temporal_kernel->loadParameters(excitatory_temporal_kernel_parameters);
 
             auto excitatory_spatial_kernel_parameters = excitation_parameters.getObjectField("spatial_kernel");
@@ -79,6 +82,8 @@ namespace net{
                 throw IncorrectExcitatorySpatialKernel();
             }
             excitatory_spatial_kernel->setTemporalKernel(excitatory_temporal_kernel);
+            excitatory_spatial_kernel->setPrecision(equ::Processor::loadPrecision(
+                    excitatory_spatial_kernel_parameters, getPrecision()));
             excitatory_spatial_kernel->loadParameters(excitatory_spatial_kernel_parameters);
 
             logging::info("Inhibitory kernel parameters");
@@ -92,6 +97,8 @@ namespace net{
                 throw IncorrectInhibitoryTemporalKernel();
             }
             inhibitory_temporal_kernel->setStimulusSaturation(saturation);
+            inhibitory_temporal_kernel->setPrecision(equ::Processor::loadPrecision(
+                    inhibitory_temporal_kernel_parameters, getPrecision()));
             inhibitory_temporal_kernel->loadParameters(inhibitory_temporal_kernel_parameters);
 
             auto inhibitory_spatial_kernel_parameters = inhibitory_parameters.getObjectField("spatial_kernel");
@@ -103,6 +110,8 @@ namespace net{
                 throw IncorrectInhibitorySpatialKernel();
             }
             inhibitory_spatial_kernel->setTemporalKernel(inhibitory_temporal_kernel);
+            inhibitory_spatial_kernel->setPrecision(equ::Processor::loadPrecision(
+                    inhibitory_spatial_kernel_parameters, getPrecision()));
             inhibitory_spatial_kernel->loadParameters(inhibitory_spatial_kernel_parameters);
 
             auto dog_filter_parameters = source.getObjectField("dog_filter");
@@ -160,6 +169,13 @@ namespace net{
                 dog_filter->setSpatialKernels(excitatory_spatial_kernel, inhibitory_spatial_kernel);
             }
 
+            /* The DOG filter output is the layer output, it is always double precision */
+            saturation->broadcastPrecision();
+            excitatory_temporal_kernel->broadcastPrecision();
+            excitatory_spatial_kernel->broadcastPrecision();
+            inhibitory_temporal_kernel->broadcastPrecision();
+            inhibitory_spatial_kernel->broadcastPrecision();
+
             saturation->broadcastParameters();
             excitatory_temporal_kernel->broadcastParameters();
             excitatory_spatial_kernel->broadcastParameters();
@@ -46,30 +46,48 @@ namespace equ{
     }
 
     void OdeTemporalKernel::update(double time) {
-        auto m_early = getOutput(EQUATION_m, 0).begin();
-        auto m_early_final = getOutput(EQUATION_m, 0).end();
-        auto m_late = getOutput(EQUATION_m_LATE, 0).begin();
+        if (getPrecision() == SinglePrecision){
+            updateState<float>();
+        } else {
+            updateState<double>();
+        }
+    }
 
-        for (; m_early != m_early_final; ++m_early, ++m_late){
-            *m_early -= getK() * *m_late;
+    template<typename T> void OdeTemporalKernel::updateState() {
+        auto m_early = getOutput<T>(EQUATION_m, 0).localSpan();
+        auto m_late = getOutput<T>(EQUATION_m_LATE, 0).localSpan();
+        double k = getK();
+
+        for (int n = 0; n < m_early.getSize(); ++n){
+            m_early[n] -= k * m_late[n];
         }
     }
 
     void OdeTemporalKernel::initializeSingleOde() {
-        getOutput(EQUATION_U, 0).fill(getInitialStimulusValue());
-        getOutput(EQUATION_m, 0).fill(getInitialStimulusValue());
-        getOutput(EQUATION_U_LATE, 0).fill(getInitialStimulusValue());
-        getOutput(EQUATION_m_LATE, 0).fill(getInitialStimulusValue());
+        for (int equation: {EQUATION_U, EQUATION_m, EQUATION_U_LATE, EQUATION_m_LATE}){
+            if (getPrecision() == SinglePrecision){
+                getOutput<float>(equation, 0).fill(getInitialStimulusValue());
+            } else {
+                getOutput(equation, 0).fill(getInitialStimulusValue());
+            }
+        }
     }
 
     void OdeTemporalKernel::calculateDerivative(int derivativeIndex, int equationIndex, double t,
                                                 Ode::BufferType equationBuffer) {
+        if (getPrecision() == SinglePrecision){
+            calculateStateDerivative<float>(derivativeIndex, equationIndex, equationBuffer);
+        } else {
+            calculateStateDerivative<double>(derivativeIndex, equationIndex, equationBuffer);
+        }
+    }
+
+    template<typename T> void OdeTemporalKernel::calculateStateDerivative(int derivativeIndex, int equationIndex,
+            Ode::BufferType equationBuffer) {
         double tau = getSolutionParameters().getTimeConstant();
         double tau_late = lateTimeConstantH;
 
         auto dU_dt = SINGLE_ODE_DERIVATIVE(EQUATION_U);
-        auto dU_dt_final = SINGLE_ODE_DERIVATIVE_LAST_PIXEL(EQUATION_U);
-        auto I = getStimulusSaturation()->getOutput().begin();
         auto U = SINGLE_ODE_OUTPUT(EQUATION_U);
         auto dm_dt = SINGLE_ODE_DERIVATIVE(EQUATION_m);
         auto m = SINGLE_ODE_OUTPUT(EQUATION_m);
@@ -79,12 +97,15 @@ namespace equ{
         auto dm_dt_late = SINGLE_ODE_DERIVATIVE(EQUATION_m_LATE);
         auto m_late = SINGLE_ODE_OUTPUT(EQUATION_m_LATE);
 
-        for (; dU_dt != dU_dt_final; ++dU_dt, ++I, ++U, ++dm_dt, ++m, ++dU_dt_late, ++U_late, ++dm_dt_late, ++m_late){
-            *dU_dt = (*I - *U)/tau;
-            *dm_dt = (*U - *m)/tau;
-            *dU_dt_late = (*I - *U_late)/tau_late;
-            *dm_dt_late = (*U_late - *m_late)/tau_late;
-        }
-
+        /* The saturation output may have the other precision than the temporal kernel state */
+        getStimulusSaturation()->visitOutput([&](auto& saturation) {
+            auto I = saturation.localSpan();
+            for (int n = 0; n < dU_dt.getSize(); ++n){
+                dU_dt[n] = (I[n] - U[n])/tau;
+                dm_dt[n] = (U[n] - m[n])/tau;
+                dU_dt_late[n] = (I[n] - U_late[n])/tau_late;
+                dm_dt_late[n] = (U_late[n] - m_late[n])/tau_late;
+            }
+        });
     }
 }
\ No newline at end of file
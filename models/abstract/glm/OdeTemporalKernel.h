@@ -29,6 +29,10 @@ namespace equ {
         static constexpr int EQUATION_U_LATE = 2;
         static constexpr int EQUATION_m_LATE = 3;
 
+        template<typename T> void updateState();
+        template<typename T> void calculateStateDerivative(int derivativeIndex, int equationIndex,
+                BufferType equationBuffer);
+
     protected:
         std::string getProcessorName() override { return "equ::OdeTemporalKernel"; }
         void loadParameterList(const param::Object& source) override;
@@ -38,6 +42,7 @@ namespace equ {
         void finalizeSingleOde(bool destruct = false) override {};
 
         int getMainEquation() { return 1; }
+        bool isSinglePrecisionSupported() override { return true; }
 
     public:
         OdeTemporalKernel(mpi::Communicator& comm, Ode::SolutionParameters parameters):
@@ -66,19 +71,19 @@ namespace equ {
         void update(double time) override;
 
         int getGridX() override {
-            return getStimulusSaturation()->getOutput().getWidth();
+            return getStimulusSaturation()->visitOutput([](auto& input) { return input.getWidth(); });
         }
 
         int getGridY() override {
-            return getStimulusSaturation()->getOutput().getHeight();
+            return getStimulusSaturation()->visitOutput([](auto& input) { return input.getHeight(); });
         }
 
         double getSizeX() override{
-            return getStimulusSaturation()->getOutput().getWidthUm();
+            return getStimulusSaturation()->visitOutput([](auto& input) { return input.getWidthUm(); });
         }
 
         double getSizeY() override {
-            return getStimulusSaturation()->getOutput().getHeightUm();
+            return getStimulusSaturation()->visitOutput([](auto& input) { return input.getHeightUm(); });
         }
 
         void calculateDerivative(int derivativeIndex, int equationIndex,
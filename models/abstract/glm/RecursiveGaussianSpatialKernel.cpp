@@ -0,0 +1,39 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "RecursiveGaussianSpatialKernel.h"
+#include "../../../log/output.h"
+
+namespace equ{
+
+    void RecursiveGaussianSpatialKernel::loadParameterList(const param::Object &source) {
+        logging::info("Spatial kernel parameters");
+        logging::info("Spatial kernel type: recursive gaussian");
+        setRadius(source.getFloatField("radius"));
+        logging::info("Spatial kernel radius: " + std::to_string(getRadius()));
+    }
+
+    void RecursiveGaussianSpatialKernel::initializeSpatialKernel() {
+        double sigma = getRadius() / sqrt(2.0);
+        visitBuffers([&](auto& out, auto&) {
+            double resX = out.getWidthUm() / (out.getWidth() - 1);
+            double resY = out.getHeightUm() / (out.getHeight() - 1);
+            filter = new data::RecursiveGaussianFilter(sigma / resX, sigma / resY, out);
+        });
+    }
+
+    void RecursiveGaussianSpatialKernel::applySpatialKernel() {
+        visitBuffers([this](auto& out, auto& buf) {
+            buf.synchronizeHalo(filter->getHaloRows());
+            filter->filter(out, buf);
+        });
+    }
+
+    void RecursiveGaussianSpatialKernel::finalizeProcessor(bool destruct) noexcept {
+        delete filter;
+        filter = nullptr;
+        SpatialKernel::finalizeProcessor(destruct);
+    }
+}
@@ -0,0 +1,42 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#ifndef MPI2_RECURSIVEGAUSSIANSPATIALKERNEL_H
+#define MPI2_RECURSIVEGAUSSIANSPATIALKERNEL_H
+
+#include "GaussianSpatialKernel.h"
+#include "../../../data/RecursiveGaussianFilter.h"
+
+namespace equ {
+
+    /**
+     * The same gaussian spatial kernel as GaussianSpatialKernel but applied by means of the recursive filter.
+     * The computation time doesn't depend on the kernel radius, so this kernel is preferred for large radii.
+     * The kernel is not truncated, hence the results are slightly different from GaussianSpatialKernel
+     */
+    class RecursiveGaussianSpatialKernel: public GaussianSpatialKernel {
+    private:
+        data::RecursiveGaussianFilter* filter = nullptr;
+
+    protected:
+        [[nodiscard]] std::string getProcessorName() override { return "equ::RecursiveGaussianSpatialKernel"; }
+        void loadParameterList(const param::Object& source) override;
+        void initializeSpatialKernel() override;
+        void applySpatialKernel() override;
+        void finalizeProcessor(bool destruct = false) noexcept override;
+
+    public:
+        explicit RecursiveGaussianSpatialKernel(mpi::Communicator& comm):
+            GaussianSpatialKernel(comm), Processor(comm) {};
+
+        ~RecursiveGaussianSpatialKernel() override{
+            finalizeProcessor(true);
+        }
+    };
+
+}
+
+
+#endif //MPI2_RECURSIVEGAUSSIANSPATIALKERNEL_H
@@ -4,6 +4,7 @@
 
 #include "SpatialKernel.h"
 #include "GaussianSpatialKernel.h"
+#include "RecursiveGaussianSpatialKernel.h"
 #include "../../../log/output.h"
 #include "../../../data/LocalMatrix.h"
 
@@ -14,6 +15,8 @@ namespace equ{
 
         if (mechanism == "gaussian"){
             kernel = new GaussianSpatialKernel(comm);
+        } else if (mechanism == "recursive_gaussian"){
+            kernel = new RecursiveGaussianSpatialKernel(comm);
         } else {
             throw param::UnknownMechanism("glm:spatial_kernel." + mechanism);
         }
@@ -26,30 +29,63 @@ namespace equ{
         if (input_processor == nullptr){
             throw incorrect_temporal_kernel();
         }
-        auto& input = input_processor->getOutput();
-        output = new data::LocalMatrix(getCommunicator(), input.getWidth(), input.getHeight(),
-                input.getWidthUm(), input.getHeightUm());
-        buffer = new data::ContiguousMatrix(getCommunicator(), input.getWidth(), input.getHeight(),
-                input.getWidthUm(), input.getHeightUm());
+        input_processor->visitOutput([this](auto& input) {
+            if (getPrecision() == SinglePrecision){
+                singleOutput = new data::LocalMatrixF(getCommunicator(), input.getWidth(), input.getHeight(),
+                        input.getWidthUm(), input.getHeightUm());
+                singleBuffer = new data::ContiguousMatrixF(getCommunicator(), input.getWidth(), input.getHeight(),
+                        input.getWidthUm(), input.getHeightUm());
+            } else {
+                output = new data::LocalMatrix(getCommunicator(), input.getWidth(), input.getHeight(),
+                        input.getWidthUm(), input.getHeightUm());
+                buffer = new data::ContiguousMatrix(getCommunicator(), input.getWidth(), input.getHeight(),
+                        input.getWidthUm(), input.getHeightUm());
+            }
+        });
         initializeSpatialKernel();
-        kernel->synchronize();
+        if (kernel != nullptr) {
+            kernel->synchronize();
+            visitBuffers([this](auto& out, auto&) {
+                if (horizontalFactor.empty()) {
+                    convolver = new data::Convolver(*kernel, out);
+                } else {
+                    convolver = new data::Convolver(*kernel, horizontalFactor, verticalFactor, out);
+                }
+            });
+        }
     }
 
     void SpatialKernel::update(double time) {
-        auto input = getTemporalKernel()->getOutput().cbegin();
-        auto buf = buffer->begin();
-        for (; buf != buffer->end(); ++buf, ++input){
-            *buf = *input;
-        }
-        buffer->synchronize();
-        output->convolve(*kernel, *buffer, true);
+        /* The temporal kernel may have the other precision than the spatial kernel */
+        getTemporalKernel()->visitOutput([this](auto& temporalKernelOutput) {
+            visitBuffers([&](auto&, auto& buf) {
+                auto input = temporalKernelOutput.localSpan();
+                std::copy(input.begin(), input.end(), buf.localSpan().begin());
+            });
+        });
+        applySpatialKernel();
+    }
+
+    void SpatialKernel::applySpatialKernel() {
+        visitBuffers([this](auto& out, auto& buf) {
+            buf.startHaloExchange(convolver->getHaloRows());
+            convolver->convolveInterior(out, buf);
+            buf.finishHaloExchange();
+            convolver->convolveBoundary(out, buf);
+        });
     }
 
     void SpatialKernel::finalizeProcessor(bool destruct) noexcept {
+        delete convolver;
+        convolver = nullptr;
         delete buffer;
         buffer = nullptr;
+        delete singleBuffer;
+        singleBuffer = nullptr;
         delete kernel;
         kernel = nullptr;
+        horizontalFactor.clear();
+        verticalFactor.clear();
     }
 
     void SpatialKernel::setTemporalKernel(TemporalKernel *temporalKernel) {
@@ -7,6 +7,7 @@
 
 #include "../../../processors/Equation.h"
 #include "../../../data/ContiguousMatrix.h"
+#include "../../../data/Convolver.h"
 #include "TemporalKernel.h"
 
 namespace equ {
@@ -14,20 +15,56 @@ namespace equ {
     class SpatialKernel: public Equation {
     private:
         data::ContiguousMatrix* buffer = nullptr;
+        data::ContiguousMatrixF* singleBuffer = nullptr;
+        data::Convolver* convolver = nullptr;
 
     protected:
         bool isOutputContiguous() override { return false; };
+        bool isInputDriven() override { return true; }
+        bool isSinglePrecisionSupported() override { return true; }
         void finalizeProcessor(bool destruct = false) noexcept override;
 
+        /**
+         * Calls f(output, buffer) for the output matrix and the buffer of the processor precision: both are double
+         * or both are float (see getPrecision())
+         *
+         * @param f the function to call, usually a generic lambda
+         */
+        template<typename F> void visitBuffers(F f){
+            if (getPrecision() == SinglePrecision){
+                f(*singleOutput, *singleBuffer);
+            } else {
+                f(*output, *buffer);
+            }
+        }
+
         /**
          * Creates the new matrix pointer by the kernel protected pointer (before call of this function
          * the value of kernel is always nullptr, then, fills it by the kernel values.
          * Doesn't synchronizes the kernel.
+         * The kernels that don't require the kernel matrix (see applySpatialKernel) may leave the pointer nullptr
          * This is not a collective routine.
          */
         virtual void initializeSpatialKernel() = 0;
         data::ContiguousMatrix* kernel = nullptr;
 
+        /**
+         * Applies the spatial kernel to the buffer and writes the results to the output.
+         * Only the responsibility area of the buffer is up to date when the method is called; the method shall
+         * synchronize the buffer itself (see ContiguousMatrix::synchronizeHalo).
+         * By default the kernel matrix is convolved with the buffer while the halo rows are transmitted
+         * This is a collective routine
+         */
+        virtual void applySpatialKernel();
+
+        /**
+         * Separable kernel representation: kernel(i, j) = verticalFactor[i] * horizontalFactor[j].
+         * initializeSpatialKernel() may fill these vectors when the kernel is known to be separable. Otherwise,
+         * the vectors shall be left empty and the separability will be checked from the kernel values.
+         * The convolution by separable kernels is provided by two one-dimensional passes.
+         */
+        std::vector<double> horizontalFactor, verticalFactor;
+
     public:
         explicit SpatialKernel(mpi::Communicator& comm): Equation(comm), Processor(comm) {};
 
@@ -81,6 +118,8 @@ namespace equ {
 
         data::ContiguousMatrix& getBuffer() { return *buffer; }
 
+        data::ContiguousMatrixF& getSingleBuffer() { return *singleBuffer; }
+
         data::ContiguousMatrix& getKernel() { return *kernel; }
     };
 
@@ -62,19 +62,31 @@ namespace equ{
             throw wrong_input();
         }
 
-        output = new data::LocalMatrix(getCommunicator(), stimulus.getGridX(), stimulus.getGridY(),
-                stimulus.getSizeX(), stimulus.getSizeY(), 0.0);
+        if (getPrecision() == SinglePrecision){
+            singleOutput = new data::LocalMatrixF(getCommunicator(), stimulus.getGridX(), stimulus.getGridY(),
+                    stimulus.getSizeX(), stimulus.getSizeY(), 0.0);
+        } else {
+            output = new data::LocalMatrix(getCommunicator(), stimulus.getGridX(), stimulus.getGridY(),
+                    stimulus.getSizeX(), stimulus.getSizeY(), 0.0);
+        }
     }
 
     void StimulusSaturation::update(double time) {
-        auto pix = getOutput().begin();
         auto* input = *inputProcessorBegin();
-        auto pix0 = input->getOutput().cbegin();
+        double darkCurrent = getDarkCurrent();
+        double amplification = getStimulusAmplitifacation();
 
-        for (; pix != getOutput().end(); ++pix, ++pix0){
-            double unsaturated = getDarkCurrent() + getStimulusAmplitifacation() * *pix0;
-            *pix = getSaturationOutput(unsaturated);
-        }
+        /* The stimulus and the saturation may have different precisions */
+        visitOutputMatrix([&](auto& saturation) {
+            input->visitOutput([&](auto& stimulus) {
+                auto pix = saturation.localSpan();
+                auto pix0 = stimulus.localSpan();
+                for (int n = 0; n < pix.getSize(); ++n){
+                    double unsaturated = darkCurrent + amplification * pix0[n];
+                    pix[n] = getSaturationOutput(unsaturated);
+                }
+            });
+        });
     }
 
     void StimulusSaturation::finalizeProcessor(bool destruct) noexcept {
@@ -23,6 +23,8 @@ namespace equ {
         double maxCurrent = 0.0;
 
         bool isOutputContiguous() override { return false; }
+        bool isInputDriven() override { return true; }
+        bool isSinglePrecisionSupported() override { return true; }
 
         /**
          * Loads all saturation parameters except 'type' and 'mechanism'
@@ -86,6 +86,22 @@ namespace mpi {
             }
         }
 
+        /**
+         * Returns the rank of the process with given coordinates
+         *
+         * @param coords - coordinates of the process. The array shall contain as many elements as the number of
+         * dimensions in this communicator
+         * @return rank of the process
+         */
+        int getRankByCoordinates(const int coords[]) const{
+            int rank;
+            int errcode;
+            if ((errcode = MPI_Cart_rank(comm, coords, &rank)) != MPI_SUCCESS){
+                throw_exception(errcode);
+            }
+            return rank;
+        }
+
         /**
          * Returns the coordinates of the process that called this routine as std::vector<int> instance
          *
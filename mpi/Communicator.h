@@ -1389,6 +1389,24 @@ namespace mpi {
             return Communicator(newcomm);
         }
 
+        /**
+         * Creates new communicators each of which contains processes that can create the shared memory
+         * (i.e., processes belonging to the same node)
+         *
+         * @param key the desired rank of the process in the new communicator
+         * @return the created communicator
+         */
+        Communicator splitShared(int key) const{
+            if (comm == MPI_COMM_NULL) throw communicator_error();
+            int errcode;
+            MPI_Comm newcomm;
+            if ((errcode = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &newcomm))
+                != MPI_SUCCESS){
+                throw_exception(errcode);
+            }
+            return Communicator(newcomm);
+        }
+
         /**
          * Makes a new communicator that has cartesian topology
          *
@@ -18,16 +18,79 @@ namespace equ{
         }
         delete output;
         output = nullptr;
+        delete singleOutput;
+        singleOutput = nullptr;
+        inputVersions.clear();
+    }
+
+    void Processor::setPrecision(Precision value) {
+        if (value == SinglePrecision && !isSinglePrecisionSupported()){
+            throw unsupported_precision();
+        }
+        precision = value;
+    }
+
+    Processor::Precision Processor::loadPrecision(const param::Object &source, Precision defaultValue) {
+        if (source.getFieldType("precision") == param::Object::UndefinedType){
+            return defaultValue;
+        }
+        std::string value = source.getStringField("precision");
+        if (value == "double") {
+            return DoublePrecision;
+        } else if (value == "single") {
+            return SinglePrecision;
+        } else {
+            throw incorrect_precision();
+        }
+    }
+
+    void Processor::broadcastPrecision() {
+        int value = precision;
+        Application::getInstance().broadcastInteger(value, 0);
+        setPrecision((Precision)value);
+    }
+
+    bool Processor::isInputChanged() {
+        if (inputVersions.empty() || inputVersions.size() != inputProcessors.size()){
+            return true;
+        }
+        auto version = inputVersions.begin();
+        for (auto input: inputProcessors){
+            if (input != nullptr && input->getOutputVersion() != *version){
+                return true;
+            }
+            ++version;
+        }
+        return false;
+    }
+
+    bool Processor::refresh(double time) {
+        if (isInputDriven() && !isInputChanged()){
+            return false;
+        }
+        update(time);
+        if (isOutputUpdated()){
+            visitOutput([](auto& matrix) { matrix.touch(); });
+        }
+        if (isInputDriven()){
+            inputVersions.clear();
+            for (auto input: inputProcessors){
+                inputVersions.push_back(input != nullptr ? input->getOutputVersion() : 0);
+            }
+        }
+        return true;
     }
 
     void Processor::addInputProcessor(Processor *pother) {
         inputProcessors.push_back(pother);
         pother->outputProcessor = this;
+        inputVersions.clear();
     }
 
     void Processor::removeInputProcessor(Processor *pother){
         inputProcessors.remove(pother);
         pother->outputProcessor = nullptr;
+        inputVersions.clear();
     }
 
     void Processor::printAllProcessors(int level, int root) {
@@ -6,6 +6,8 @@
 #define MPI2_PROCESSOR_H
 
 #include <list>
+#include <vector>
+#include <utility>
 
 #include "../param/Loadable.h"
 #include "../mpi/Communicator.h"
@@ -19,6 +21,16 @@ namespace equ {
      * A base class for all equations engaged into the system
      */
     class Processor: public param::Loadable {
+    public:
+        /**
+         * Storage precision of the output matrix and the processor state
+         *
+         * DoublePrecision - all matrices are data::Matrix, data::LocalMatrix etc. This is the default
+         * SinglePrecision - all matrices are data::MatrixF, data::LocalMatrixF etc. This halves the memory traffic
+         * and the message sizes. The output shall be read by getSingleOutput() or visitOutput(...)
+         */
+        enum Precision {DoublePrecision, SinglePrecision};
+
     private:
         mpi::Communicator& comm;
         Processor* outputProcessor = nullptr;
@@ -26,11 +38,40 @@ namespace equ {
         static int idCounter;
         int id;
         unsigned int flags;
+        std::vector<unsigned long long> inputVersions;
+        Precision precision = DoublePrecision;
 
     protected:
         const char* getObjectType() const noexcept override { return "processor"; }
         data::Matrix* output = nullptr;
 
+        /**
+         * The output matrix of the single precision processor. Only one of output and singleOutput is allocated
+         * by initialize(), depending on getPrecision()
+         */
+        data::MatrixF* singleOutput = nullptr;
+
+        /**
+         *
+         * @return true if the processor is able to allocate its output and state in single precision.
+         * false by default
+         */
+        virtual bool isSinglePrecisionSupported() { return false; }
+
+        /**
+         * Calls f(*output) for the double precision processor and f(*singleOutput) for the single precision one.
+         * Use a generic lambda to write the output matrix allocated by initialize()
+         *
+         * @param f the function to call
+         */
+        template<typename F> void visitOutputMatrix(F f){
+            if (precision == SinglePrecision){
+                f(*singleOutput);
+            } else {
+                f(*output);
+            }
+        }
+
         /**
          *
          * @return true if the output matrix is contiguous
@@ -54,6 +95,24 @@ namespace equ {
          */
         virtual std::string getProcessorName() = 0;
 
+        /**
+         * Input-driven processors are the processors which output depends on the outputs of their input processors
+         * only, not on time or any other state. refresh() skips update() of such processors when no input has been
+         * changed since the previous refresh()
+         *
+         * @return true if the processor is input-driven, false by default
+         */
+        virtual bool isInputDriven() { return false; }
+
+        /**
+         * Called by refresh() after each update()
+         *
+         * @return true if update() has changed the contents of the output matrix and the output version shall be
+         * changed. Return false if update() at most selects another matrix returned by getOutput(): the matrices
+         * have different versions anyway
+         */
+        virtual bool isOutputUpdated() { return true; }
+
     public:
         explicit Processor(mpi::Communicator& c): comm(c), flags(0) {
             id = idCounter++;
@@ -110,21 +169,136 @@ namespace equ {
          */
         virtual void update(double time) = 0;
 
+        /**
+         *
+         * @return version of the output matrix (see data::Matrix::getVersion())
+         */
+        unsigned long long getOutputVersion() {
+            return visitOutput([](auto& matrix) { return matrix.getVersion(); });
+        }
+
+        /**
+         *
+         * @return true if the output version of any input processor has been changed since the last refresh()
+         */
+        bool isInputChanged();
+
+        /**
+         * Calls update() unless the processor is input-driven and its inputs have not been changed since the
+         * previous refresh(). Changes the output version if the output has been updated. Use this method instead
+         * of update() to avoid recomputing the processors which inputs are the same. The decision is the same
+         * on all processes of the communicator since the matrix versions are changed in the same order on all of
+         * them
+         *
+         * @param time current timestamp in milliseconds
+         * @return true if update() was called, false if it was skipped
+         */
+        bool refresh(double time);
+
         /**
          * Returns the matrix where output from the processor at current timestamp is placed.
          * WARNING. Please, remember that different output matrices may have different pointers/references
          * at different timestamps, so, call this function each time after update() call and before the usage
-         * of the output results
+         * of the output results. The single precision processors have no double output, use visitOutput() to
+         * read the output of any processor
          *
          * @return output results from the processor
+         * @throws precision_mismatch for the single precision processor
          */
         virtual data::Matrix& getOutput(){
+            if (precision != DoublePrecision){
+                throw precision_mismatch();
+            }
             if (output == nullptr){
                 throw uninitialized_processor();
             }
             return *output;
         }
 
+        /**
+         * The same as getOutput() but for the single precision processors
+         *
+         * @return output results from the processor
+         */
+        virtual data::MatrixF& getSingleOutput(){
+            if (precision != SinglePrecision){
+                throw precision_mismatch();
+            }
+            if (singleOutput == nullptr){
+                throw uninitialized_processor();
+            }
+            return *singleOutput;
+        }
+
+        /**
+         * Calls f(getOutput()) for the double precision processor and f(getSingleOutput()) for the single
+         * precision one. Use a generic lambda to read the output of the processor which precision is not known:
+         * input->visitOutput([&](auto& in){ auto pix0 = in.localSpan(); ... });
+         *
+         * @param f the function to call
+         * @return the value returned by f
+         */
+        template<typename F> auto visitOutput(F f) -> decltype(f(std::declval<data::Matrix&>())){
+            if (precision == SinglePrecision){
+                return f(getSingleOutput());
+            } else {
+                return f(getOutput());
+            }
+        }
+
+        /**
+         *
+         * @return storage precision of the output and the processor state
+         */
+        [[nodiscard]] Precision getPrecision() const { return precision; }
+
+        /**
+         * Sets the storage precision. The precision is applied by the next initialize() or reset(), hence
+         * the method shall be called before the processor initialization
+         *
+         * @param value the storage precision
+         * @throws unsupported_precision if the processor doesn't support such a precision
+         */
+        void setPrecision(Precision value);
+
+        /**
+         * Reads the optional 'precision' property of the JS object which value is either "double" or "single"
+         *
+         * @param source the JS object
+         * @param defaultValue the value to return when the property is absent
+         * @return the storage precision
+         * @throws incorrect_precision if the property has another value
+         */
+        static Precision loadPrecision(const param::Object& source, Precision defaultValue);
+
+        /**
+         * Copies the storage precision from the process with rank 0 to all other processes
+         * This is a collective routine relatively to the application communicator
+         */
+        void broadcastPrecision();
+
+        class precision_mismatch: public simulation_exception{
+        public:
+            [[nodiscard]] const char* what() const noexcept override{
+                return "Trying to access the processor output in precision other than the storage precision of "
+                       "the processor";
+            }
+        };
+
+        class unsupported_precision: public simulation_exception{
+        public:
+            [[nodiscard]] const char* what() const noexcept override{
+                return "The processor doesn't support single precision storage";
+            }
+        };
+
+        class incorrect_precision: public simulation_exception{
+        public:
+            [[nodiscard]] const char* what() const noexcept override{
+                return "The 'precision' property shall be either 'double' or 'single'";
+            }
+        };
+
         /**
          *
          * @return name and status of the processor
@@ -132,7 +306,7 @@ namespace equ {
         std::string getName(){
             std::stringstream ss;
             ss << getProcessorName();
-            if (output != nullptr){
+            if (output != nullptr || singleOutput != nullptr){
                 ss << "  [ INITIALIZED ]";
             }
             ss << " # " << id;
@@ -9,25 +9,37 @@ namespace equ{
 
     void SingleOde::initialize(){
         if (initialized) return;
+        if (getPrecision() == SinglePrecision){
+            initializeBuffers<float>();
+        } else {
+            initializeBuffers<double>();
+        }
+        initializeSingleOde();
+        if (getPrecision() == SinglePrecision){
+            singleOutput = singleBuffers[PublicBuffer]->at(getMainEquation()).der->at(0);
+        } else {
+            output = buffers[PublicBuffer]->at(getMainEquation()).der->at(0);
+        }
+        currentOutput = 0;
+        initialized = true;
+    }
+
+    template<typename T> void SingleOde::initializeBuffers() {
         SolutionParameters par = getSolutionParameters();
         for (int btype = 0; btype < 1 + par.isDoubleBuffer(); ++btype){
-            Buffer* buffer = new Buffer(par.getEquationNumber());
+            auto* buffer = new BasicBuffer<T>(par.getEquationNumber());
             for (int i=0; i < par.getEquationNumber(); ++i){
-                buffer->at(i).out = initializeLine(par.getEquationOrder() + 1);
-                buffer->at(i).der = initializeLine(par.getDerivativeOrder());
+                buffer->at(i).out = initializeLine<T>(par.getEquationOrder() + 1);
+                buffer->at(i).der = initializeLine<T>(par.getDerivativeOrder());
             }
-            buffers[btype] = buffer;
+            getStateBuffers<T>()[btype] = buffer;
         }
-        initializeSingleOde();
-        output = buffers[PublicBuffer]->at(getMainEquation()).der->at(0);
-        currentOutput = 0;
-        initialized = true;
     }
 
-    SingleOde::Line* SingleOde::initializeLine(int matrixNumber) {
-        Line* line = new Line(matrixNumber);
+    template<typename T> SingleOde::BasicLine<T>* SingleOde::initializeLine(int matrixNumber) {
+        auto* line = new BasicLine<T>(matrixNumber);
         for (size_t i=0; i < line->size(); ++i){
-            line->at(i) = new data::LocalMatrix(getCommunicator(),
+            line->at(i) = new data::BasicLocalMatrix<T>(getCommunicator(),
                     getGridX(), getGridY(), getSizeX(), getSizeY());
         }
         return line;
@@ -36,21 +48,30 @@ namespace equ{
     void SingleOde::finalizeProcessor(bool destruct) noexcept {
         if (!initialized) return;
         output = nullptr;
+        singleOutput = nullptr;
         currentOutput = -1;
+        finalizeBuffers<double>();
+        finalizeBuffers<float>();
+        if (!destruct) finalizeSingleOde(false);
+        initialized = false;
+    }
+
+    template<typename T> void SingleOde::finalizeBuffers() {
         SolutionParameters par = getSolutionParameters();
-        for (int btype = 0; btype < 1 + par.isDoubleBuffer(); ++btype){
-            Buffer* buffer = buffers[btype];
+        auto** stateBuffers = getStateBuffers<T>();
+        for (int btype = 0; btype < 2; ++btype){
+            auto* buffer = stateBuffers[btype];
+            if (buffer == nullptr) continue;
             for (int i=0; i < par.getEquationNumber(); ++i){
                 finalizeLine(buffer->at(i).out);
                 finalizeLine(buffer->at(i).der);
             }
-            delete buffers[btype];
+            delete buffer;
+            stateBuffers[btype] = nullptr;
         }
-        if (!destruct) finalizeSingleOde(false);
-        initialized = false;
     }
 
-    void SingleOde::finalizeLine(equ::SingleOde::Line *line) {
+    template<typename T> void SingleOde::finalizeLine(BasicLine<T> *line) {
         for (size_t i = 0; i < line->size(); ++i){
             delete line->at(i);
         }
@@ -59,35 +80,55 @@ namespace equ{
 
     void SingleOde::increment(int outputNumber, int inputNumber, int derivativeNumber, double incrementStep,
                               Ode::BufferType inputBuffer, Ode::BufferType equationBuffer) {
+        if (getPrecision() == SinglePrecision){
+            incrementState<float>(outputNumber, inputNumber, derivativeNumber, incrementStep, inputBuffer,
+                    equationBuffer);
+        } else {
+            incrementState<double>(outputNumber, inputNumber, derivativeNumber, incrementStep, inputBuffer,
+                    equationBuffer);
+        }
+    }
+
+    template<typename T> void SingleOde::incrementState(int outputNumber, int inputNumber, int derivativeNumber,
+            double incrementStep, Ode::BufferType inputBuffer, Ode::BufferType equationBuffer) {
+        auto** stateBuffers = getStateBuffers<T>();
         for (int i=0; i < getSolutionParameters().getEquationNumber(); ++i){
-            data::LocalMatrix& out = *buffers[PublicBuffer]->at(i).out->at(outputNumber);
-            data::LocalMatrix& in = *buffers[inputBuffer]->at(i).out->at(inputNumber);
-            data::LocalMatrix& der = *buffers[equationBuffer]->at(i).der->at(derivativeNumber);
-            auto out_it = out.begin();
-            auto in_it = in.cbegin();
-            auto der_it = der.cbegin();
-            for (; out_it != out.end(); out_it++, in_it++, der_it++){
-                *out_it = *in_it + incrementStep * *der_it;
-            }
+            auto& out = *stateBuffers[PublicBuffer]->at(i).out->at(outputNumber);
+            auto& in = *stateBuffers[inputBuffer]->at(i).out->at(inputNumber);
+            auto& der = *stateBuffers[equationBuffer]->at(i).der->at(derivativeNumber);
+            out.add(in, incrementStep, der);
+            out.touch();
         }
     }
 
     void SingleOde::swap(int outputIndex1, int outputIndex2) {
         for (int i=0; i < getSolutionParameters().getEquationNumber(); ++i){
-            std::swap(buffers[PublicBuffer]->at(i).out->at(outputIndex1),
-                    buffers[PublicBuffer]->at(i).out->at(outputIndex2));
+            if (getPrecision() == SinglePrecision){
+                std::swap(singleBuffers[PublicBuffer]->at(i).out->at(outputIndex1),
+                        singleBuffers[PublicBuffer]->at(i).out->at(outputIndex2));
+            } else {
+                std::swap(buffers[PublicBuffer]->at(i).out->at(outputIndex1),
+                        buffers[PublicBuffer]->at(i).out->at(outputIndex2));
+            }
         }
     }
 
     void SingleOde::copy(int dest, int source) {
+        if (getPrecision() == SinglePrecision){
+            copyState<float>(dest, source);
+        } else {
+            copyState<double>(dest, source);
+        }
+    }
+
+    template<typename T> void SingleOde::copyState(int dest, int source) {
+        auto** stateBuffers = getStateBuffers<T>();
         for (int i=0; i < getSolutionParameters().getEquationNumber();  ++i){
-            data::LocalMatrix& mdest = *buffers[PublicBuffer]->at(i).out->at(dest);
-            data::LocalMatrix& msource = *buffers[PublicBuffer]->at(i).out->at(source);
-            auto idest = mdest.begin();
-            auto isource = msource.cbegin();
-            for (; idest != mdest.end(); ++idest, ++isource){
-                *idest = *isource;
-            }
+            auto& mdest = *stateBuffers[PublicBuffer]->at(i).out->at(dest);
+            auto& msource = *stateBuffers[PublicBuffer]->at(i).out->at(source);
+            auto source = msource.localSpan();
+            std::copy(source.begin(), source.end(), mdest.localSpan().begin());
+            mdest.touch();
         }
     }
 
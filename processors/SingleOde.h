@@ -5,15 +5,16 @@
 #ifndef MPI2_SINGLEODE_H
 #define MPI2_SINGLEODE_H
 
+#include <type_traits>
 #include "Ode.h"
 #include "Processor.h"
 #include "../data/LocalMatrix.h"
 
-/* These macros will help to implement OdeTemporalKernel::calculateDerivative methods */
-#define SINGLE_ODE_DERIVATIVE(n)    getDerivative(n, derivativeIndex).begin()
-#define SINGLE_ODE_OUTPUT(n)        getOutput(n, equationIndex, equationBuffer).begin()
-#define SINGLE_ODE_DERIVATIVE_LAST_PIXEL(n) getDerivative(n, derivativeIndex).end()
-#define SINGLE_ODE_OUTPUT_LAST_PIXEL(n)     getOutput(n, equationIndex, equationBuffer).end()
+/* These macros will help to implement OdeTemporalKernel::calculateDerivative methods. They return local spans of
+ * the matrices (see data/LocalSpan.h); all derivative and output matrices have the same local indices.
+ * T is the element type of the state: double or float depending on getPrecision() */
+#define SINGLE_ODE_DERIVATIVE(n)    getDerivative<T>(n, derivativeIndex).localSpan()
+#define SINGLE_ODE_OUTPUT(n)        getOutput<T>(n, equationIndex, equationBuffer).localSpan()
 
 namespace equ {
 
@@ -79,14 +80,22 @@ namespace equ {
 
         virtual void update(double time) = 0;
 
-        typedef std::vector<data::LocalMatrix*> Line;
+        template<typename T> using BasicLine = std::vector<data::BasicLocalMatrix<T>*>;
 
-        typedef struct{
-            Line* out;
-            Line* der;
-        } Cell;
+        template<typename T> struct BasicCell{
+            BasicLine<T>* out;
+            BasicLine<T>* der;
+        };
 
-        typedef std::vector<Cell> Buffer;
+        template<typename T> using BasicBuffer = std::vector<BasicCell<T>>;
+
+        typedef BasicLine<double> Line;
+        typedef BasicCell<double> Cell;
+        typedef BasicBuffer<double> Buffer;
+
+        typedef BasicLine<float> LineF;
+        typedef BasicCell<float> CellF;
+        typedef BasicBuffer<float> BufferF;
 
         /**
          * Constructs the single ODE.
@@ -137,40 +146,77 @@ namespace equ {
          * @return the output
          */
         data::Matrix& getOutput() override{
-            return *buffers[PublicBuffer]->at(getMainEquation()).out->at(currentOutput);
+            if (getPrecision() != DoublePrecision){
+                throw precision_mismatch();
+            }
+            return getOutput(getMainEquation(), currentOutput);
+        }
+
+        /**
+         * The same as getOutput() for the processors with single precision state
+         *
+         * @return the output
+         */
+        data::MatrixF& getSingleOutput() override{
+            if (getPrecision() != SinglePrecision){
+                throw precision_mismatch();
+            }
+            return getOutput<float>(getMainEquation(), currentOutput);
         }
 
         /**
          * Returns output of the particular number for a partucular equation
          *
+         * @tparam T float for the single precision state, double otherwise
          * @param equationNumber
          * @param outputNumber
          * @return
          */
-        data::LocalMatrix& getOutput(int equationNumber, int outputNumber, BufferType type = PublicBuffer){
-            return *buffers[type]->at(equationNumber).out->at(outputNumber);
+        template<typename T = double>
+        data::BasicLocalMatrix<T>& getOutput(int equationNumber, int outputNumber, BufferType type = PublicBuffer){
+            return *getStateBuffers<T>()[type]->at(equationNumber).out->at(outputNumber);
         }
 
         /**
          * Returns the derivative matrix
          *
+         * @tparam T float for the single precision state, double otherwise
          * @param equationNumber number of equation which derivative matrix shall be returned
          * @param matrixNumber index of the derivative matrix
          * @return
          */
-        data::LocalMatrix& getDerivative(int equationNumber, int matrixNumber){
-            return *buffers[PublicBuffer]->at(equationNumber).der->at(matrixNumber);
+        template<typename T = double> data::BasicLocalMatrix<T>& getDerivative(int equationNumber, int matrixNumber){
+            return *getStateBuffers<T>()[PublicBuffer]->at(equationNumber).der->at(matrixNumber);
         }
 
     protected:
-        Buffer* buffers[2];
+        Buffer* buffers[2] = {nullptr, nullptr};
+        BufferF* singleBuffers[2] = {nullptr, nullptr};
+
+        /**
+         *
+         * @tparam T element type of the state
+         * @return buffers for double precision state, singleBuffers for single precision state
+         */
+        template<typename T> BasicBuffer<T>** getStateBuffers(){
+            if constexpr (std::is_same<T, float>::value){
+                return singleBuffers;
+            } else {
+                return buffers;
+            }
+        }
 
     private:
         bool initialized = false;
         int currentOutput = -1;
 
-        Line* initializeLine(int matrixNumber);
-        void finalizeLine(Line*);
+        template<typename T> BasicLine<T>* initializeLine(int matrixNumber);
+        template<typename T> void finalizeLine(BasicLine<T>* line);
+        template<typename T> void initializeBuffers();
+        template<typename T> void finalizeBuffers();
+        template<typename T> void incrementState(int outputNumber, int inputNumber, int derivativeNumber,
+                double incrementStep, BufferType inputBuffer, BufferType equationBuffer);
+        template<typename T> void copyState(int dest, int source);
     };
 
 }
@@ -15,7 +15,7 @@ namespace equ{
             auto* equ = dynamic_cast<Equation*>(*it);
             if (equ != nullptr){
                 if (equ->getFlag(Processor::IsInDerivative)){
-                    equ->update(real_t);
+                    equ->refresh(real_t);
                 }
             }
             auto* diff = dynamic_cast<SingleOde*>(*it);
@@ -75,13 +75,13 @@ namespace equ{
             auto equ = dynamic_cast<Equation*>(*it);
             if (equ != nullptr){
                 if (equ->getFlag(Processor::IsInUpdate)){
-                    equ->update(time);
+                    equ->refresh(time);
                 }
             }
             auto ode = dynamic_cast<SingleOde*>(*it);
             if (ode != nullptr){
-                ode->update(time);
                 ode->setCurrentOutput(0);
+                ode->refresh(time);
             }
         }
     }
@@ -40,24 +40,29 @@ namespace stim{
     }
 
     void BoundedStimulus::update(double time) {
-        output->fill(1.0);
+        visitOutputMatrix([&](auto& result){
+            result.fill(1.0);
 
-        for (auto pstimulus = inputProcessorBegin(); pstimulus != inputProcessorEnd(); ++pstimulus){
-            auto* stimulus = dynamic_cast<Stimulus*>(*pstimulus);
-            stimulus->update(time);
-            double L0 = stimulus->getLuminance();
-            auto pix = output->begin();
-            auto pix0 = stimulus->getOutput().begin();
-            for (; pix != output->end(); ++pix, ++pix0){
-                *pix *= *pix0 - L0;
+            for (auto pstimulus = inputProcessorBegin(); pstimulus != inputProcessorEnd(); ++pstimulus){
+                auto* stimulus = dynamic_cast<Stimulus*>(*pstimulus);
+                stimulus->refresh(time);
+                double L0 = stimulus->getLuminance();
+                stimulus->visitOutput([&](auto& input){
+                    auto pix = result.localSpan();
+                    auto pix0 = input.localSpan();
+                    for (int n = 0; n < pix.getSize(); ++n){
+                        pix[n] *= pix0[n] - L0;
+                    }
+                });
             }
-        }
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            *pix += getLuminance();
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-        }
+            double L = getLuminance();
+            for (auto& pix: result.localSpan()){
+                pix += L;
+                if (pix < 0.0) pix = 0.0;
+                if (pix > 1.0) pix = 1.0;
+            }
+        });
     }
 
     void BoundedStimulus::finalizeComplexStimulus(bool destruct) {
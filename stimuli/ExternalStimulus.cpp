@@ -41,17 +41,20 @@ namespace stim{
         double Lmin = getLuminance() - 0.5 * getContrast();
         double C = getContrast();
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double val;
-            if (get_stimulus_value(x, y, t, &val)){
-                throw get_stimulus_value_error();
+        visitOutputMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            const double* X = getCoordinateGrid().getX();
+            const double* Y = getCoordinateGrid().getY();
+            for (int n = 0; n < pixels.getSize(); ++n){
+                double val;
+                if (get_stimulus_value(X[n], Y[n], t, &val)){
+                    throw get_stimulus_value_error();
+                }
+                if (val < 0.0) val = 0.0;
+                if (val > 1.0) val = 1.0;
+                pixels[n] = Lmin + C * val;
             }
-            if (val < 0.0) val = 0.0;
-            if (val > 1.0) val = 1.0;
-            *pix = Lmin + C * val;
-        }
+        });
     }
 
     void ExternalStimulus::finalizeExtraBuffer(bool destruct) {
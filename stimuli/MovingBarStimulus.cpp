@@ -49,16 +49,18 @@ namespace stim{
         double l_max = 0.5 * getLength();
         double w_max = 0.5 * getWidth();
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double l = (x-x0) * ctheta + (y-y0) * stheta;
-            double w = (x-x0) * stheta - (y-y0) * ctheta;
-            if (std::abs(l) < l_max && std::abs(w) < w_max){
-                *pix = Lmax;
-            } else {
-                *pix = Lmin;
+        double l0 = x0 * ctheta + y0 * stheta;
+        double w0 = x0 * stheta - y0 * ctheta;
+
+        visitOutputMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            const double* L = getCoordinateGrid().getLongitudinal(theta);
+            const double* W = getCoordinateGrid().getTransverse(theta);
+            for (int n = 0; n < pixels.getSize(); ++n){
+                double l = L[n] - l0;
+                double w = W[n] - w0;
+                pixels[n] = std::abs(l) < l_max && std::abs(w) < w_max ? Lmax : Lmin;
             }
-        }
+        });
     }
 }
\ No newline at end of file
@@ -49,16 +49,14 @@ namespace stim{
         double Lmax = Lmin + getContrast();
         if (Lmax > 1.0) Lmax = 1.0;
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double r2 = (x-x0) * (x-x0) + (y-y0) * (y-y0);
-
-            if (r2 <= R2){
-                *pix = Lmax;
-            } else {
-                *pix = Lmin;
+        visitOutputMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            const double* X = getCoordinateGrid().getX();
+            const double* Y = getCoordinateGrid().getY();
+            for (int n = 0; n < pixels.getSize(); ++n){
+                double r2 = (X[n]-x0) * (X[n]-x0) + (Y[n]-y0) * (Y[n]-y0);
+                pixels[n] = r2 <= R2 ? Lmax : Lmin;
             }
-        }
+        });
     }
 }
@@ -10,20 +10,23 @@ namespace stim{
         double L0 = getLuminance();
         double A = 0.5 * getContrast();
         double theta = getOrientation();
-        double ctheta = cos(theta);
-        double stheta = sin(theta);
         double s = getSpatialFrequency();
         double f = getTemporalFrequency();
         double t = relativeTime * 0.001; // relativeTime is in ms, t shall be in s because f is in Hz
         double phi0 = getSpatialPhase();
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double w = x * stheta - y * ctheta;
-            *pix = L0 + A * cos(2*M_PI*s*w + 2*M_PI*f*t + phi0);
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-        }
+        double k = 2*M_PI*s;
+        double phase = 2*M_PI*f*t + phi0;
+
+        visitOutputMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            const double* W = getCoordinateGrid().getTransverse(theta);
+            for (int n = 0; n < pixels.getSize(); ++n){
+                double pix = L0 + A * cos(k*W[n] + phase);
+                if (pix < 0.0) pix = 0.0;
+                if (pix > 1.0) pix = 1.0;
+                pixels[n] = pix;
+            }
+        });
     }
 }
\ No newline at end of file
@@ -9,26 +9,22 @@ namespace stim {
 
     void MovingRectangularGrating::updateMovingStimulus(double t) {
         double theta = getOrientation();
-        double stheta = sin(theta);
-        double ctheta = cos(theta);
         double s = getSpatialFrequency();
         double phase0 = getSpatialPhase() / (2 * M_PI) + 0.001 * getTemporalFrequency() * t - 0.25;
         double Lmax = getLuminance() + 0.5 * getContrast();
         double Lmin = getLuminance() - 0.5 * getContrast();
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double w = x * stheta  - y * ctheta;
-            double phase = s * w + phase0;
-            phase -= floor(phase);
-            if (phase <= 0.5){
-                *pix = Lmax;
-            } else {
-                *pix = Lmin;
+        if (Lmax > 1.0) Lmax = 1.0;
+        if (Lmin < 0.0) Lmin = 0.0;
+
+        visitOutputMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            const double* W = getCoordinateGrid().getTransverse(theta);
+            for (int n = 0; n < pixels.getSize(); ++n){
+                double phase = s * W[n] + phase0;
+                phase -= floor(phase);
+                pixels[n] = phase <= 0.5 ? Lmax : Lmin;
             }
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-        }
+        });
     }
 }
\ No newline at end of file
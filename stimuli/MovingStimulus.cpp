@@ -35,16 +35,22 @@ namespace stim {
 
     void MovingStimulus::initializeStimulus() {
         showStimulus = false;
-        meanLuminance = new data::LocalMatrix(getCommunicator(), getGridX(), getGridY(),
-                getSizeX(), getSizeY(), getLuminance());
-        output = new data::LocalMatrix(getCommunicator(), getGridX(), getGridY(),
-                getSizeX(), getSizeY(), 0.0);
+        if (getPrecision() == SinglePrecision){
+            singleMeanLuminance = new data::LocalMatrixF(getCommunicator(), getGridX(), getGridY(),
+                    getSizeX(), getSizeY(), getLuminance());
+        } else {
+            meanLuminance = new data::LocalMatrix(getCommunicator(), getGridX(), getGridY(),
+                    getSizeX(), getSizeY(), getLuminance());
+        }
+        visitOutputMatrix([](auto& matrix) { matrix.fill(0.0); });
         initializeExtraBuffer();
     }
 
     void MovingStimulus::finalizeProcessor(bool destruct) noexcept {
         delete meanLuminance;
         meanLuminance = nullptr;
+        delete singleMeanLuminance;
+        singleMeanLuminance = nullptr;
         if (!destruct){
             finalizeExtraBuffer(false);
         }
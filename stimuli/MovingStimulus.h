@@ -14,10 +14,14 @@ namespace stim {
     class MovingStimulus: public Stimulus, public StepStimulusParameters {
     protected:
         data::LocalMatrix* meanLuminance = nullptr;
+        data::LocalMatrixF* singleMeanLuminance = nullptr;
         bool showStimulus = false;
 
         void initializeStimulus() override;
         void finalizeProcessor(bool destruct = false) noexcept override;
+
+        /* the mean luminance matrix presented outside the stimulus epoch is never changed */
+        bool isOutputUpdated() override { return showStimulus; }
         void loadStimulusParameters(const param::Object& source) override;
         void broadcastStimulusParameters() override;
         void setStimulusParameter(const std::string& name, const void* pvalue) override;
@@ -105,12 +109,30 @@ namespace stim {
          * @return the stimulus output
          */
         data::Matrix& getOutput() override{
+            if (getPrecision() != DoublePrecision){
+                throw precision_mismatch();
+            }
             if (showStimulus){
                 return *output;
             } else {
                 return *meanLuminance;
             }
         }
+
+        /**
+         *
+         * @return the stimulus output for the single precision stimulus
+         */
+        data::MatrixF& getSingleOutput() override{
+            if (getPrecision() != SinglePrecision){
+                throw precision_mismatch();
+            }
+            if (showStimulus){
+                return *singleOutput;
+            } else {
+                return *singleMeanLuminance;
+            }
+        }
     };
 
 }
@@ -129,12 +129,16 @@ namespace stim{
         logging::exit();
          */
 
-        pstimulus->update(timeFromTrialStart);
-        auto pix = output->begin();
-        auto pix0 = pstimulus->getOutput().begin();
-        for (; pix != output->end(); ++pix, ++pix0){
-            *pix = *pix0;
-        }
+        pstimulus->refresh(timeFromTrialStart);
+        visitOutputMatrix([&](auto& result){
+            pstimulus->visitOutput([&](auto& input){
+                auto pix = result.begin();
+                auto pix0 = input.begin();
+                for (; pix != result.end(); ++pix, ++pix0){
+                    *pix = *pix0;
+                }
+            });
+        });
 
         frameNumber++;
     }
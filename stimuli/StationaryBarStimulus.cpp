@@ -35,19 +35,25 @@ namespace stim {
         double L = getLuminance();
         double Lmax = L + getContrast();
 
-        for (auto pix = stimulusMatrix->begin(); pix != stimulusMatrix->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double l = (x-x0) * ctheta + (y-y0) * stheta;
-            double w = (x-x0) * stheta - (y-y0) * ctheta;
-            if (std::abs(l) <= l_max && std::abs(w) <= w_max){
-                *pix = Lmax;
-            } else {
-                *pix = L;
+        visitStimulusMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            for (int i = pixels.getFirstRow(); i < pixels.getLastRow(); ++i){
+                double y = pixels.getRowUm(i);
+                for (int j = pixels.getFirstColumn(i); j < pixels.getLastColumn(i); ++j){
+                    double x = pixels.getColumnUm(j);
+                    auto& pix = pixels(i, j);
+                    double l = (x-x0) * ctheta + (y-y0) * stheta;
+                    double w = (x-x0) * stheta - (y-y0) * ctheta;
+                    if (std::abs(l) <= l_max && std::abs(w) <= w_max){
+                        pix = Lmax;
+                    } else {
+                        pix = L;
+                    }
+                    if (pix < 0.0) pix = 0.0;
+                    if (pix > 1.0) pix = 1.0;
+                }
             }
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-        }
+        });
     }
 
 }
\ No newline at end of file
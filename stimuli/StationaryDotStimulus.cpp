@@ -33,17 +33,23 @@ namespace stim {
         double L = getLuminance();
         double Lmax = L + getContrast();
 
-        for (auto pix = stimulusMatrix->begin(); pix != stimulusMatrix->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double r2 = (x-x0) * (x-x0) + (y-y0) * (y-y0);
-            if (r2 <= R2) {
-                *pix = Lmax;
-            } else {
-                *pix = L;
+        visitStimulusMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            for (int i = pixels.getFirstRow(); i < pixels.getLastRow(); ++i){
+                double y = pixels.getRowUm(i);
+                for (int j = pixels.getFirstColumn(i); j < pixels.getLastColumn(i); ++j){
+                    double x = pixels.getColumnUm(j);
+                    auto& pix = pixels(i, j);
+                    double r2 = (x-x0) * (x-x0) + (y-y0) * (y-y0);
+                    if (r2 <= R2) {
+                        pix = Lmax;
+                    } else {
+                        pix = L;
+                    }
+                    if (pix < 0.0) pix = 0.0;
+                    if (pix > 1.0) pix = 1.0;
+                }
             }
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-        }
+        });
     }
 }
\ No newline at end of file
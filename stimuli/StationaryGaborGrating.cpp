@@ -14,15 +14,21 @@ namespace stim{
         double L = getLuminance();
         double C = 0.5 * getContrast();
 
-        for (auto pix = stimulusMatrix->begin(); pix != stimulusMatrix->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            // double l = x * ctheta + y * stheta;
-            double w = x * stheta - y * ctheta;
-            *pix = C * cos(2 * M_PI * sf * w + phi0) + L;
-            if (*pix<0) *pix = 0;
-            if (*pix>1) *pix = 1;
-        }
+        visitStimulusMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            for (int i = pixels.getFirstRow(); i < pixels.getLastRow(); ++i){
+                double y = pixels.getRowUm(i);
+                for (int j = pixels.getFirstColumn(i); j < pixels.getLastColumn(i); ++j){
+                    double x = pixels.getColumnUm(j);
+                    auto& pix = pixels(i, j);
+                    // double l = x * ctheta + y * stheta;
+                    double w = x * stheta - y * ctheta;
+                    pix = C * cos(2 * M_PI * sf * w + phi0) + L;
+                    if (pix<0) pix = 0;
+                    if (pix>1) pix = 1;
+                }
+            }
+        });
     }
 
 }
\ No newline at end of file
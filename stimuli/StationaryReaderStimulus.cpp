@@ -31,7 +31,7 @@ namespace stim{
         } catch (std::exception& e){
             throw reading_failed();
         }
-        if (source->getWidth() != stimulusMatrix->getWidth() || source->getHeight() != stimulusMatrix->getHeight()){
+        if (source->getWidth() != getGridX() || source->getHeight() != getGridY()){
             delete source;
             throw reader_dimensions_mismatch();
         }
@@ -43,11 +43,13 @@ namespace stim{
         double alpha = (max_new - min_new)/(max_old-min_old);
         double beta = min_new - alpha * min_old;
 
-        auto pix_new = stimulusMatrix->begin();
-        auto pix_old = source->cbegin();
-        for (; pix_new != stimulusMatrix->end(); ++pix_new, ++pix_old){
-            *pix_new = alpha * *pix_old + beta;
-        }
+        visitStimulusMatrix([&](auto& stimulus){
+            auto pix_new = stimulus.begin();
+            auto pix_old = source->cbegin();
+            for (; pix_new != stimulus.end(); ++pix_new, ++pix_old){
+                *pix_new = alpha * *pix_old + beta;
+            }
+        });
 
         delete source;
     }
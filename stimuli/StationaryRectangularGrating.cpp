@@ -17,20 +17,26 @@ namespace stim{
         double Lmax = L + 0.5 * C;
         double Lmin = L - 0.5 * C;
 
-        for (auto pix = stimulusMatrix->begin(); pix != stimulusMatrix->end(); ++pix){
-            double x = pix.getColumnUm();
-            double y = pix.getRowUm();
-            double w = x * stheta - y * ctheta;
-            double phase = sf * w + phi0 + 0.25;
-            phase -= floor(phase);
-            if (phase <= 0.5){
-                *pix = Lmax;
-            } else {
-                *pix = Lmin;
+        visitStimulusMatrix([&](auto& stimulus){
+            auto pixels = stimulus.localSpan();
+            for (int i = pixels.getFirstRow(); i < pixels.getLastRow(); ++i){
+                double y = pixels.getRowUm(i);
+                for (int j = pixels.getFirstColumn(i); j < pixels.getLastColumn(i); ++j){
+                    double x = pixels.getColumnUm(j);
+                    auto& pix = pixels(i, j);
+                    double w = x * stheta - y * ctheta;
+                    double phase = sf * w + phi0 + 0.25;
+                    phase -= floor(phase);
+                    if (phase <= 0.5){
+                        pix = Lmax;
+                    } else {
+                        pix = Lmin;
+                    }
+                    if (pix < 0.0) pix = 0.0;
+                    if (pix > 1.0) pix = 1.0;
+                }
             }
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-        }
+        });
     }
 
 }
\ No newline at end of file
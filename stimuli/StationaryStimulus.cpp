@@ -32,21 +32,31 @@ namespace stim{
     }
 
     void StationaryStimulus::initializeStimulus() {
-        stimulusMatrix = new data::LocalMatrix(getCommunicator(), getGridX(),
-                getGridY(), getSizeX(), getSizeY());
+        if (getPrecision() == SinglePrecision){
+            singleStimulusMatrix = new data::LocalMatrixF(getCommunicator(), getGridX(),
+                    getGridY(), getSizeX(), getSizeY());
+        } else {
+            stimulusMatrix = new data::LocalMatrix(getCommunicator(), getGridX(),
+                    getGridY(), getSizeX(), getSizeY());
+        }
         time = 0.0;
-        output->fill(getLuminance());
+        visitOutputMatrix([this](auto& background) { background.fill(getLuminance()); });
         fillStimulusMatrix();
     }
 
     void StationaryStimulus::finalizeProcessor(bool destruct) noexcept{
         delete stimulusMatrix;
         stimulusMatrix = nullptr;
+        delete singleStimulusMatrix;
+        singleStimulusMatrix = nullptr;
     }
 
     data::Matrix& StationaryStimulus::getOutput(){
         data::Matrix* result;
 
+        if (getPrecision() != DoublePrecision){
+            throw precision_mismatch();
+        }
         if (output == nullptr || stimulusMatrix == nullptr){
             throw uninitialized_processor();
         }
@@ -59,6 +69,24 @@ namespace stim{
         return *result;
     }
 
+    data::MatrixF& StationaryStimulus::getSingleOutput(){
+        data::MatrixF* result;
+
+        if (getPrecision() != SinglePrecision){
+            throw precision_mismatch();
+        }
+        if (singleOutput == nullptr || singleStimulusMatrix == nullptr){
+            throw uninitialized_processor();
+        }
+        if (time >= getStimulusStart() && time < getStimulusFinish()){
+            result = singleStimulusMatrix;
+        } else {
+            result = singleOutput;
+        }
+
+        return *result;
+    }
+
     StationaryStimulus* StationaryStimulus::createStationaryStimulus(mpi::Communicator &comm,
                                                                      const std::string &mechanism) {
         StationaryStimulus* stimulus;
@@ -25,6 +25,24 @@ namespace stim {
 
     protected:
         data::LocalMatrix* stimulusMatrix = nullptr;
+        data::LocalMatrixF* singleStimulusMatrix = nullptr;
+
+        /**
+         * Calls f(*stimulusMatrix) for the double precision stimulus and f(*singleStimulusMatrix) for the single
+         * precision one. Use a generic lambda to fill the stimulus matrix
+         *
+         * @param f the function to call
+         */
+        template<typename F> void visitStimulusMatrix(F f){
+            if (getPrecision() == SinglePrecision){
+                f(*singleStimulusMatrix);
+            } else {
+                f(*stimulusMatrix);
+            }
+        }
+
+        /* update() only selects between the background and the stimulus matrix, their contents are not changed */
+        bool isOutputUpdated() override { return false; }
 
         void loadStimulusParameters(const param::Object& source) override;
         void broadcastStimulusParameters() override;
@@ -85,6 +103,8 @@ namespace stim {
 
         [[nodiscard]] data::Matrix& getOutput() override;
 
+        [[nodiscard]] data::MatrixF& getSingleOutput() override;
+
         /**
          * Runs at each iteration
          *
@@ -28,6 +28,10 @@ namespace stim{
         ss << "Luminance: " << getLuminance() << endl;
         setContrast(source.getFloatField("contrast"));
         ss << "Contrast: " << getContrast();
+        setPrecision(loadPrecision(source, getPrecision()));
+        if (getPrecision() == SinglePrecision){
+            ss << "\nThe stimulus is stored in single precision";
+        }
 
         logging::info(ss.str());
         loadStimulusParameters(source);
@@ -41,6 +45,7 @@ namespace stim{
         app.broadcastDouble(sizeY, 0);
         app.broadcastDouble(luminance, 0);
         app.broadcastDouble(contrast, 0);
+        broadcastPrecision();
         broadcastStimulusParameters();
     }
 
@@ -63,8 +68,14 @@ namespace stim{
     }
 
     void Stimulus::initialize(){
-        output = new data::LocalMatrix(getCommunicator(), getGridX(), getGridY(),
-                getSizeX(), getSizeY());
+        if (getPrecision() == SinglePrecision){
+            singleOutput = new data::LocalMatrixF(getCommunicator(), getGridX(), getGridY(),
+                    getSizeX(), getSizeY());
+        } else {
+            output = new data::LocalMatrix(getCommunicator(), getGridX(), getGridY(),
+                    getSizeX(), getSizeY());
+        }
+        visitOutputMatrix([this](auto& matrix) { coordinateGrid = data::CoordinateGrid::getGrid(matrix); });
         initializeStimulus();
     }
 
@@ -6,6 +6,7 @@
 #define MPI2_STIMULUS_H
 
 #include "../processors/Processor.h"
+#include "../data/CoordinateGrid.h"
 
 namespace stim {
 
@@ -16,6 +17,7 @@ namespace stim {
     private:
         int gridX = 0, gridY = 0;
         double sizeX = 0.0, sizeY = 0.0, luminance = 0.0, contrast = 0.0;
+        std::shared_ptr<data::CoordinateGrid> coordinateGrid;
 
     protected:
         void loadParameterList(const param::Object& source) override;
@@ -23,7 +25,7 @@ namespace stim {
 
         /**
          * Reads all other stimulus parameters except 'type', 'mechanism', 'grid_x', 'grid_y',
-         * 'size_x', 'size_y', 'luminance', 'contrast'
+         * 'size_x', 'size_y', 'luminance', 'contrast', 'precision'
          *
          * @param source an object that contains the JS object
          */
@@ -31,7 +33,7 @@ namespace stim {
 
         /**
          * Broadcasts all other stimulus parameters except type', 'mechanism', 'grid_x', 'grid_y',
-         * 'size_x', 'size_y', 'luminance', 'contrast'
+         * 'size_x', 'size_y', 'luminance', 'contrast', 'precision'
          */
         virtual void broadcastStimulusParameters()=0;
 
@@ -45,12 +47,21 @@ namespace stim {
         virtual void setStimulusParameter(const std::string& name, const void* pvalue)=0;
 
         bool isOutputContiguous() override { return false; }
+        bool isSinglePrecisionSupported() override { return true; }
 
         /**
          * Performs all initialization routines for the stimulus except creating output matrix
          */
         virtual void initializeStimulus() = 0;
 
+        /**
+         * Returns coordinates of the local pixels of the stimulus shared among all stimuli of the same geometry.
+         * Use it in the rendering loops instead of the coordinates computed for each pixel
+         *
+         * @return the coordinate grid, available after initialization
+         */
+        data::CoordinateGrid& getCoordinateGrid() { return *coordinateGrid; }
+
     public:
         explicit Stimulus(mpi::Communicator& comm): Processor(comm) {};
 
@@ -28,6 +28,9 @@ namespace stim {
         void initializeExtraBuffer() override;
         void finalizeExtraBuffer(bool destruct = false) override;
 
+        /* The stream is read by data::stream::BinStream that works with double matrices only */
+        bool isSinglePrecisionSupported() override { return false; }
+
     public:
         class stream_opening_failed: public simulation_exception{
         private:
@@ -54,26 +54,30 @@ namespace stim{
         auto pstimulus = inputProcessorBegin();
         double Lmin = getLuminance() - 0.5 * getContrast();
         double C = getContrast();
-        output->fill(0.0);
+        visitOutputMatrix([&](auto& result){
+            result.fill(0.0);
 
-        for (; pstimulus != inputProcessorEnd(); ++pweight, ++pstimulus){
-            double weight = *pweight;
-            auto* stimulus = dynamic_cast<Stimulus*>(*pstimulus);
-            if (time < stimulus->getRecordLength()){
-                stimulus->update(time);
-                auto pix = output->begin();
-                auto pix0 = stimulus->getOutput().cbegin();
-                for (; pix != output->end(); ++pix, ++pix0){
-                    *pix += weight * *pix0;
+            for (; pstimulus != inputProcessorEnd(); ++pweight, ++pstimulus){
+                double weight = *pweight;
+                auto* stimulus = dynamic_cast<Stimulus*>(*pstimulus);
+                if (time < stimulus->getRecordLength()){
+                    stimulus->refresh(time);
+                    stimulus->visitOutput([&](auto& input){
+                        auto pix = result.localSpan();
+                        auto pix0 = input.localSpan();
+                        for (int n = 0; n < pix.getSize(); ++n){
+                            pix[n] += weight * pix0[n];
+                        }
+                    });
                 }
             }
-        }
 
-        for (auto pix = output->begin(); pix != output->end(); ++pix){
-            if (*pix < 0.0) *pix = 0.0;
-            if (*pix > 1.0) *pix = 1.0;
-            *pix = Lmin + C * *pix;
-        }
+            for (auto& pix: result.localSpan()){
+                if (pix < 0.0) pix = 0.0;
+                if (pix > 1.0) pix = 1.0;
+                pix = Lmin + C * pix;
+            }
+        });
     }
 
     void WeightedStimulus::finalizeComplexStimulus(bool) {}
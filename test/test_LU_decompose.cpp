@@ -75,13 +75,15 @@ void test_main(){
     decomposer.printDebugInformation();
 
     logging::progress(0, 1, "Checking decomnposed information");
+    data::ContiguousMatrix L = decomposer.getLowerTriangle();
+    data::ContiguousMatrix U = decomposer.getUpperTriangle();
+    data::ContiguousMatrix LU(comm, n, n, 1.0, 1.0);
+    LU.dot(L, U);
+    LU.synchronize();
     for (int i=0; i < n; ++i){
         for (int j = 0; j < n; ++j){
             double PA_real = decomposer.PA(i, j);
-            double PA_decomposed = 0.0;
-            for (int k = 0; k < n; ++k){
-                PA_decomposed += decomposer.L(i, k) * decomposer.U(k, j);
-            }
+            double PA_decomposed = LU.getValue(i, j);
             if (abs(PA_real - PA_decomposed) > 1e-8) {
                 logging::enter();
                 if (comm.getRank() == 0) {
@@ -95,7 +97,5 @@ void test_main(){
         }
     }
 
-
-
     logging::progress(1, 1);
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/Convolver.h"
+#include "../data/TiledMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    logging::progress(0, 1, "Creating the decomposition");
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 53, height = 47, kernelSize = 9;
+    int dims[2];
+    data::BlockDecomposition::getOptimalGrid(comm.getProcessorNumber(), dims);
+    bool periods[] = {false, false};
+    mpi::CartesianCommunicator cart = comm.createCartesianTopology(2, dims, periods, false);
+    data::BlockDecomposition decomposition(cart, width, height);
+
+    auto& tile = decomposition.getLocalTile();
+    logging::enter();
+    logging::debug("Process grid: " + std::to_string(dims[0]) + " x " + std::to_string(dims[1]));
+    logging::debug("Local tile: rows " + std::to_string(tile.rowStart) + " - " + std::to_string(tile.rowFinish) +
+        ", columns " + std::to_string(tile.columnStart) + " - " + std::to_string(tile.columnFinish));
+    for (auto& neighbor: decomposition.getNeighbors(kernelSize / 2)){
+        logging::debug("Neighbor " + std::to_string(neighbor.rank) + " at (" + std::to_string(neighbor.rowShift) +
+            ", " + std::to_string(neighbor.columnShift) + "): " + std::to_string(neighbor.rows) + " x " +
+            std::to_string(neighbor.columns) + " halo pixels");
+    }
+    logging::exit();
+
+    logging::progress(0, 1, "Matrix initialization");
+    data::ContiguousMatrix A(comm, width, height, width, height);
+    data::ContiguousMatrix K(comm, kernelSize, kernelSize, kernelSize, kernelSize);
+    for (auto a = A.begin(); a != A.end(); ++a){
+        *a = sin(0.3 * a.getColumn() + 0.7 * a.getRow());
+    }
+    for (auto k = K.begin(); k != K.end(); ++k){
+        double x = k.getColumnUm();
+        double y = k.getRowUm();
+        *k = exp(-(x*x + y*y)/9.0);
+    }
+    A.synchronize();
+    K.synchronize();
+
+    logging::progress(0, 1, "Convolution on tiles");
+    data::LocalMatrix expected(comm, width, height, width, height);
+    data::Convolver(K, expected, true, data::Convolver::DirectMethod).convolve(expected, A);
+    data::TiledMatrix source(decomposition, width, height, kernelSize / 2);
+    data::TiledMatrix result(decomposition, width, height);
+    source.copyFrom(A);
+    source.synchronizeHalo();
+    result.convolve(K, source);
+    data::ContiguousMatrix actual(comm, width, height, width, height);
+    result.copyTo(actual);
+
+    double error = 0.0;
+    auto a = actual.cbegin();
+    for (auto e = expected.cbegin(); e != expected.cend(); ++e, ++a){
+        error = std::max(error, fabs(*a - *e));
+    }
+    double totalError;
+    comm.allReduce(&error, &totalError, 1, MPI_DOUBLE, MPI_MAX);
+
+    logging::enter();
+    logging::debug("Maximum difference from the convolution of the contiguous matrix: " +
+        std::to_string(totalError));
+    logging::exit();
+}
@@ -0,0 +1,37 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/CoordinateGrid.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    data::LocalMatrix A(comm, 37, 23, 10.0, 8.0);
+    data::LocalMatrix B(comm, 37, 23, 10.0, 8.0);
+    const double theta = 0.3;
+
+    logging::progress(0, 1, "Comparison of the grid coordinates with the iterator coordinates");
+    auto grid = data::CoordinateGrid::getGrid(A);
+    const double* L = grid->getLongitudinal(theta);
+    const double* W = grid->getTransverse(theta);
+    double error = 0.0;
+    int n = 0;
+    for (auto a = A.begin(); a != A.end(); ++a, ++n){
+        double x = a.getColumnUm(), y = a.getRowUm();
+        error = max(error, fabs(grid->getX()[n] - x));
+        error = max(error, fabs(grid->getY()[n] - y));
+        error = max(error, fabs(L[n] - x * cos(theta) - y * sin(theta)));
+        error = max(error, fabs(W[n] - x * sin(theta) + y * cos(theta)));
+    }
+
+    logging::enter();
+    logging::debug("Maximum error: " + std::to_string(error));
+    logging::debug(std::string("The grid is shared: ") + (grid == data::CoordinateGrid::getGrid(B) ? "yes" : "no"));
+    logging::exit();
+    logging::progress(1, 1);
+}
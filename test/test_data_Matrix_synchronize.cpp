@@ -36,6 +36,11 @@ void test_matrix(data::Matrix& matrix){
         print_matrix(matrix, "Matrix after syncrhonization process for rank = 3");
         matrix.synchronize();
         print_matrix(matrix, "Matrix after synchronization process for all ranks");
+        fill_matrix(matrix);
+        matrix.startSynchronize();
+        print_matrix(matrix, "Matrix during the split-phase synchronization");
+        matrix.waitSynchronize();
+        print_matrix(matrix, "Matrix after the split-phase synchronization");
     } catch (simulation_exception& e){
         logging::error(e);
     }
@@ -0,0 +1,66 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/Convolver.h"
+
+void test_main(){
+    using namespace std;
+
+    logging::progress(0, 1, "Matrix initialization");
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 100, height = 80;
+    const double radius = 8.0;
+    data::ContiguousMatrix A(comm, width, height, width, height);
+    data::ContiguousMatrix K(comm, 4 * (int)radius + 1, 4 * (int)radius + 1, 4 * radius + 1, 4 * radius + 1);
+
+    for (auto a = A.begin(); a != A.end(); ++a){
+        *a = sin(0.3 * a.getColumn()) * cos(0.2 * a.getRow()) + (a.getRow() > height/2 ? 1.0 : 0.0);
+    }
+    for (auto k = K.begin(); k != K.end(); ++k){
+        double x = k.getColumnUm();
+        double y = k.getRowUm();
+        *k = exp(-(x*x + y*y)/(radius * radius));
+    }
+    A.synchronize();
+    K.synchronize();
+
+    for (int normalize = 0; normalize <= 1; ++normalize){
+        logging::progress(0, 1, normalize ? "Normalized convolution" : "Non-normalized convolution");
+        data::LocalMatrix direct(comm, width, height, width, height);
+        data::LocalMatrix fourier(comm, width, height, width, height);
+        data::LocalMatrix separable(comm, width, height, width, height);
+        data::Convolver directConvolver(K, direct, normalize, data::Convolver::DirectMethod);
+        data::Convolver fourierConvolver(K, fourier, normalize, data::Convolver::FourierMethod);
+        data::Convolver separableConvolver(K, separable, normalize, data::Convolver::SeparableMethod);
+        data::Convolver autoConvolver(K, fourier, normalize);
+
+        directConvolver.convolve(direct, A);
+        fourierConvolver.convolve(fourier, A);
+        separableConvolver.convolve(separable, A);
+
+        double error[2] = {0.0, 0.0};
+        auto f = fourier.cbegin();
+        auto s = separable.cbegin();
+        for (auto d = direct.cbegin(); d != direct.cend(); ++d, ++f, ++s){
+            error[0] = std::max(error[0], fabs(*d - *f));
+            error[1] = std::max(error[1], fabs(*d - *s));
+        }
+        double totalError[2];
+        comm.allReduce(error, totalError, 2, MPI_DOUBLE, MPI_MAX);
+
+        logging::enter();
+        logging::debug("Maximum difference between direct and FFT convolution: " + std::to_string(totalError[0]));
+        logging::debug("Maximum difference between direct and separable convolution: " +
+            std::to_string(totalError[1]));
+        logging::debug(std::string("Automatically chosen method: ") +
+            (autoConvolver.getMethod() == data::Convolver::FourierMethod ? "FFT" :
+            autoConvolver.getMethod() == data::Convolver::SeparableMethod ? "separable" : "direct"));
+        logging::exit();
+    }
+}
@@ -0,0 +1,50 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/MatrixExpression.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 37, height = 23;
+    data::LocalMatrix A(comm, width, height, width, height);
+    data::ContiguousMatrix B(comm, width, height, width, height);
+    data::LocalMatrixF Af(comm, width, height, width, height);
+    data::ContiguousMatrixF Bf(comm, width, height, width, height);
+    auto fa = [](auto& a){ return sin(a.getRow() * width + a.getColumn()); };
+    auto fb = [](auto& b){ return cos(b.getRow() - b.getColumn()) + 2.0; };
+    A.fill(fa);
+    Af.fill(fa);
+    B.fill(fb);
+    Bf.fill(fb);
+
+    logging::progress(0, 3, "Statistics of the single-precision matrices");
+    double statError = fabs(A.sum() - Af.sum()) + fabs(A.std() - Af.std()) + fabs(A.corr(B) - Af.corr(Bf)) +
+            fabs(A.max() - Af.max()) + fabs(A.errorfunc(B) - Af.errorfunc(Bf));
+
+    logging::progress(1, 3, "Synchronization of the single-precision matrices");
+    B.synchronize();
+    Bf.synchronize();
+    double syncError = 0.0;
+    for (int i = 0; i < B.getSize(); ++i){
+        syncError += fabs(B[i] - Bf[i]);
+    }
+
+    logging::progress(2, 3, "Mixed-precision expressions");
+    Af = 2.0 * Af + Bf * A;
+    A = 2.0 * A + B * A;
+    double expressionError = fabs(A.sum() - Af.sum());
+
+    logging::enter();
+    logging::debug("Difference in statistics: " + std::to_string(statError));
+    logging::debug("Difference after synchronization: " + std::to_string(syncError));
+    logging::debug("Difference in expression results: " + std::to_string(expressionError));
+    logging::exit();
+    logging::progress(3, 3);
+}
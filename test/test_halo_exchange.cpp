@@ -0,0 +1,59 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/Convolver.h"
+
+void test_main(){
+    using namespace std;
+
+    logging::progress(0, 1, "Matrix initialization");
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 53, height = 47, kernelSize = 15;
+    data::ContiguousMatrix A(comm, width, height, width, height);
+    data::ContiguousMatrix B(comm, width, height, width, height);
+    data::ContiguousMatrix K(comm, kernelSize, kernelSize, kernelSize, kernelSize);
+
+    for (auto a = A.begin(), b = B.begin(); a != A.end(); ++a, ++b){
+        *a = *b = sin(0.3 * a.getColumn() + 0.7 * a.getRow());
+    }
+    for (auto k = K.begin(); k != K.end(); ++k){
+        double x = k.getColumnUm();
+        double y = k.getRowUm();
+        *k = exp(-(x*x + y*y)/9.0);
+    }
+    K.synchronize();
+
+    logging::progress(0, 1, "Convolution after full synchronization");
+    data::LocalMatrix expected(comm, width, height, width, height);
+    A.synchronize();
+    data::Convolver(K, expected, true, data::Convolver::DirectMethod).convolve(expected, A);
+
+    for (auto method: {data::Convolver::DirectMethod, data::Convolver::SeparableMethod,
+                       data::Convolver::FourierMethod}){
+        logging::progress(0, 1, "Convolution overlapped with the halo exchange, method " + std::to_string(method));
+        data::LocalMatrix actual(comm, width, height, width, height);
+        data::Convolver convolver(K, actual, true, method);
+        B.startHaloExchange(convolver.getHaloRows());
+        convolver.convolveInterior(actual, B);
+        B.finishHaloExchange();
+        convolver.convolveBoundary(actual, B);
+
+        double error = 0.0;
+        auto e = expected.cbegin();
+        for (auto a = actual.cbegin(); a != actual.cend(); ++a, ++e){
+            error = std::max(error, fabs(*a - *e));
+        }
+        double totalError;
+        comm.allReduce(&error, &totalError, 1, MPI_DOUBLE, MPI_MAX);
+
+        logging::enter();
+        logging::debug("Maximum difference from the fully synchronized convolution: " + std::to_string(totalError));
+        logging::exit();
+    }
+}
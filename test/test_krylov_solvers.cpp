@@ -0,0 +1,100 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/LocalMatrix.h"
+#include "../data/solvers/MatrixOperator.h"
+#include "../data/solvers/ConvolutionOperator.h"
+#include "../data/solvers/JacobiPreconditioner.h"
+#include "../data/solvers/IluPreconditioner.h"
+#include "../data/solvers/ConjugateGradient.h"
+#include "../data/solvers/BiCgStab.h"
+#include "../data/solvers/Gmres.h"
+
+template<typename S> void check_solver(const std::string& name, data::solvers::LinearOperator& op,
+        const data::solvers::Preconditioner* M, data::ContiguousMatrix& x, const data::Matrix& b){
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    x.fill(0.0);
+    S solver(op, M, 1e-10);
+    solver.solve(x, b);
+
+    data::LocalMatrix r(comm, b.getWidth(), b.getHeight(), 1.0, 1.0);
+    data::LocalMatrix zero(comm, b.getWidth(), b.getHeight(), 1.0, 1.0);
+    op.apply(r, x);
+    double error = sqrt(r.errorfunc(b) / b.errorfunc(zero));
+    logging::enter();
+    logging::debug(name + ": " + std::to_string(solver.getIterations()) + " iterations, relative residual " +
+        std::to_string(error));
+    logging::exit();
+    if (error > 1e-9){
+        throw std::runtime_error(name + " solution check failed");
+    }
+}
+
+void test_main(){
+    using namespace std;
+    using namespace data::solvers;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int n = 300;
+    data::ContiguousMatrix S(comm, n, n, 1.0, 1.0);
+    data::ContiguousMatrix U(comm, n, n, 1.0, 1.0);
+    data::ContiguousMatrix x(comm, 1, n, 1.0, 1.0);
+    data::LocalMatrix b(comm, 1, n, 1.0, 1.0);
+
+    logging::progress(0, 3, "Krylov solvers for the explicit matrices");
+    for (int i = 0; i < n; ++i){
+        for (int j = 0; j < n; ++j){
+            int d = abs(i - j);
+            S[i * n + j] = i == j ? 2.5 + 0.01 * i : (d <= 3 ? -0.3 / d : 0.0);
+            U[i * n + j] = i == j ? 3.0 + sin(i) : (d <= 2 ? 0.4 * cos(i + 2.0 * j) : 0.0);
+        }
+    }
+    for (int i = b.getIstart(); i < b.getIfinish(); ++i){
+        b[i] = cos(0.37 * i) + 0.1;
+    }
+    MatrixOperator symmetric(S), nonsymmetric(U);
+    JacobiPreconditioner jacobi(symmetric);
+    IluPreconditioner ilu(nonsymmetric);
+    check_solver<ConjugateGradient>("CG", symmetric, nullptr, x, b);
+    check_solver<ConjugateGradient>("CG + Jacobi", symmetric, &jacobi, x, b);
+    check_solver<BiCgStab>("BiCGSTAB + ILU", nonsymmetric, &ilu, x, b);
+    check_solver<Gmres>("GMRES", nonsymmetric, nullptr, x, b);
+    check_solver<Gmres>("GMRES + ILU", nonsymmetric, &ilu, x, b);
+
+    logging::progress(1, 3, "Krylov solvers for the convolution operator");
+    const int width = 45, height = 31;
+    data::ContiguousMatrix K(comm, 9, 7, 1.0, 1.0);
+    for (int i = 0; i < K.getSize(); ++i){
+        int r = i / 9 - 3, c = i % 9 - 4;
+        K[i] = exp(-(r * r + c * c) / 6.0);
+    }
+    data::LocalMatrix f(comm, width, height, 1.0, 1.0);
+    data::ContiguousMatrix g(comm, width, height, 1.0, 1.0);
+    for (int i = f.getIstart(); i < f.getIfinish(); ++i){
+        f[i] = sin(0.1 * i) + (i * 7 % 13) / 13.0;
+    }
+    ConvolutionOperator convolution(K, f, 1.0, -0.9);
+    IluPreconditioner convolutionIlu(convolution);
+    check_solver<BiCgStab>("BiCGSTAB for convolution", convolution, nullptr, g, f);
+    check_solver<BiCgStab>("BiCGSTAB + ILU for convolution", convolution, &convolutionIlu, g, f);
+    check_solver<Gmres>("GMRES + ILU for convolution", convolution, &convolutionIlu, g, f);
+
+    logging::progress(2, 3, "Comparison with Matrix::convolve");
+    g.synchronize();
+    data::ContiguousMatrix convolved(comm, width, height, 1.0, 1.0);
+    convolved.convolve(K, g);
+    data::LocalMatrix steadyState(comm, width, height, 1.0, 1.0);
+    steadyState.add(g, -0.9, convolved);
+    double error = sqrt(steadyState.errorfunc(f) / f.errorfunc(data::LocalMatrix(comm, width, height, 1.0, 1.0)));
+    logging::enter();
+    logging::debug("Relative residual given by Matrix::convolve: " + std::to_string(error));
+    logging::exit();
+    if (error > 1e-9){
+        throw std::runtime_error("Convolution operator check failed");
+    }
+    logging::progress(3, 3);
+}
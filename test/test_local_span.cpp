@@ -0,0 +1,43 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 37, height = 23;
+    data::LocalMatrix A(comm, width, height, 100.0, 80.0);
+    data::LocalMatrix B(comm, width, height, 100.0, 80.0);
+
+    logging::progress(0, 2, "Filling the matrix through the iterators and through the span");
+    A.fill([](data::Matrix::Iterator& a){ return 1000.0 * a.getRow() + a.getColumn() + a.getColumnUm() * a.getRowUm(); });
+    auto span = B.localSpan();
+    int localElements = 0;
+    for (int i = span.getFirstRow(); i < span.getLastRow(); ++i){
+        double y = span.getRowUm(i);
+        for (int j = span.getFirstColumn(i); j < span.getLastColumn(i); ++j){
+            span(i, j) = 1000.0 * i + j + span.getColumnUm(j) * y;
+            ++localElements;
+        }
+    }
+
+    logging::progress(1, 2, "Element-wise comparison");
+    const data::LocalMatrix& constA = A;
+    auto a = constA.localSpan();
+    double error = 0.0;
+    for (int n = 0; n < span.getSize(); ++n){
+        error = max(error, fabs(a[n] - span[n]));
+    }
+
+    logging::enter();
+    logging::debug("Local elements visited: " + std::to_string(localElements) + " of " +
+        std::to_string(span.getSize()));
+    logging::debug("Maximum error: " + std::to_string(error));
+    logging::exit();
+    logging::progress(2, 2);
+}
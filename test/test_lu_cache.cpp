@@ -0,0 +1,107 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <dirent.h>
+#include <unistd.h>
+#include "../Application.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/LuDecomposer.h"
+
+/**
+ * Returns the full names of all files in the folder
+ */
+std::vector<std::string> list_cache_folder(const std::string& folder){
+    std::vector<std::string> files;
+    DIR* dir = opendir(folder.c_str());
+    if (dir == nullptr){
+        return files;
+    }
+    for (dirent* info = readdir(dir); info != nullptr; info = readdir(dir)){
+        std::string name = info->d_name;
+        if (name != "." && name != ".."){
+            files.push_back(folder + "/" + name);
+        }
+    }
+    closedir(dir);
+    return files;
+}
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int n = 150;
+    data::ContiguousMatrix A(comm, n, n, 1.0, 1.0);
+    for (int i = 0; i < n * n; ++i){
+        A[i] = sin(1.3 * i * (i % 11 + 1)) + (i / n == i % n ? 3.0 : 0.0);
+    }
+
+    /* The cache is placed into the fresh folder, so the factors can't be taken from the previous runs */
+    char folder[64] = "/tmp/vis-brain-lu-cache-XXXXXX";
+    int status = 1;
+    if (comm.getRank() == 0 && mkdtemp(folder) == nullptr){
+        status = 0;
+    }
+    comm.broadcast(&status, 1, MPI_INT, 0);
+    if (!status){
+        throw std::runtime_error("LU cache test failed: unable to create the temporary folder");
+    }
+    comm.broadcast(folder, sizeof(folder), MPI_CHAR, 0);
+    data::LuDecomposer::setCacheDirectory(folder);
+
+    logging::progress(0, 3, "LU decomposition with the empty cache");
+    data::LuDecomposer first(A);
+    data::ContiguousMatrix U1 = first.getUpperTriangle();
+
+    logging::progress(1, 3, "Corruption of the cache file");
+    /* U(0, 0) is the first factor stored at the end of the file. The changed value shall appear in the next
+     * decomposition if this is read from the cache */
+    std::string filename;
+    if (comm.getRank() == 0){
+        auto files = list_cache_folder(folder);
+        status = files.size() == 1;
+        if (status){
+            filename = files[0];
+            std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekg(0, std::ios::end);
+            std::streamoff offset = (std::streamoff)file.tellg() - (std::streamoff)n * n * sizeof(double);
+            double value;
+            file.seekg(offset);
+            file.read((char*)&value, sizeof(value));
+            value += 1.0;
+            file.seekp(offset);
+            file.write((const char*)&value, sizeof(value));
+            status = offset > 0 && (bool)file;
+        }
+    }
+    comm.broadcast(&status, 1, MPI_INT, 0);
+    if (!status){
+        throw std::runtime_error("LU cache test failed: the cache file was not created");
+    }
+
+    logging::progress(2, 3, "LU decomposition from the cache");
+    data::LuDecomposer second(A);
+    data::ContiguousMatrix U2 = second.getUpperTriangle();
+    data::LuDecomposer::setCacheDirectory("");
+    if (comm.getRank() == 0){
+        std::remove(filename.c_str());
+        rmdir(folder);
+    }
+
+    double difference = abs(U2[0] - U1[0] - 1.0);
+    for (int i = 1; i < n * n; ++i){
+        difference = max(difference, abs(U1[i] - U2[i]));
+    }
+    logging::enter();
+    logging::debug("Difference between the computed and the cached factors: " + std::to_string(difference));
+    logging::exit();
+    if (difference > 1e-12){
+        throw std::runtime_error("LU cache test failed: the factors were not read from the cache");
+    }
+    logging::progress(3, 3);
+}
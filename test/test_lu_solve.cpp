@@ -0,0 +1,78 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/LuDecomposer.h"
+#include "../compile_options.h"
+
+/**
+ * Returns max |A*X - B| where B is the identity matrix when it is omitted
+ */
+double lu_residual(const data::ContiguousMatrix& A, const data::ContiguousMatrix& X,
+        const data::ContiguousMatrix* B = nullptr){
+    int n = A.getHeight(), m = X.getWidth();
+    double error = 0.0;
+    for (int i = 0; i < n; ++i){
+        for (int c = 0; c < m; ++c){
+            double control = B == nullptr ? (i == c ? -1.0 : 0.0) : -B->getValue(i, c);
+            for (int k = 0; k < n; ++k){
+                control += A.getValue(i, k) * X.getValue(k, c);
+            }
+            error = std::max(error, std::abs(control));
+        }
+    }
+    return error;
+}
+
+void check_residual(const std::string& name, double error){
+    logging::enter();
+    logging::debug(name + ": maximum residual " + std::to_string(error));
+    logging::exit();
+    if (error > 1e-9){
+        throw std::runtime_error(name + " check failed");
+    }
+}
+
+/*
+ * The test shall be run on 4 or 6 processes at least to make the process grid two-dimensional
+ */
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int n = 3 * LU_BLOCK_SIZE + 11;
+    data::ContiguousMatrix A(comm, n, n, 1.0, 1.0);
+    for (int i = 0; i < n * n; ++i){
+        A[i] = sin(1.3 * i * (i % 11 + 1)) + (i / n == i % n ? 3.0 : 0.0);
+    }
+    data::LuDecomposer decomposer(A);
+
+    logging::progress(0, 3, "Solution of A*x = b");
+    data::ContiguousMatrix b(comm, 1, n, 1.0, 1.0);
+    data::ContiguousMatrix x(comm, 1, n, 1.0, 1.0);
+    for (int i = 0; i < n; ++i){
+        b[i] = cos(0.7 * i);
+    }
+    decomposer.solve(x, b);
+    check_residual("A*x = b", lu_residual(A, x, &b));
+
+    logging::progress(1, 3, "Matrix division");
+    for (int m: {3, LU_BLOCK_SIZE + 6}){
+        data::ContiguousMatrix B(comm, m, n, 1.0, 1.0);
+        data::ContiguousMatrix X(comm, m, n, 1.0, 1.0);
+        for (int i = 0; i < n * m; ++i){
+            B[i] = cos(0.7 * i) + 0.01 * (i % m);
+        }
+        decomposer.divide(X, B);
+        check_residual("A*X = B for " + std::to_string(m) + " columns", lu_residual(A, X, &B));
+    }
+
+    logging::progress(2, 3, "Matrix inversion");
+    data::ContiguousMatrix Ainv(comm, n, n, 1.0, 1.0);
+    decomposer.inverse(Ainv);
+    check_residual("A*A^-1 = I", lu_residual(A, Ainv));
+    logging::progress(3, 3);
+}
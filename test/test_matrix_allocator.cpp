@@ -0,0 +1,88 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <cstdint>
+#include "../Application.h"
+#include "../data/MatrixAllocator.h"
+#include "../compile_options.h"
+
+void check_allocator(bool condition, const std::string& message){
+    if (!condition){
+        throw std::runtime_error("Matrix allocator test failed: " + message);
+    }
+}
+
+void test_main(){
+    using namespace std;
+    using data::MatrixAllocator;
+
+    const auto& statistics = MatrixAllocator::getStatistics();
+    std::size_t oldLimit = MatrixAllocator::getPoolLimit();
+    MatrixAllocator::setPoolLimit(MATRIX_POOL_LIMIT);
+
+    logging::progress(0, 4, "Alignment of the matrix buffers");
+    for (std::size_t bytes: {(std::size_t)1, (std::size_t)100, (std::size_t)5000,
+            (std::size_t)(MATRIX_HUGE_PAGE_SIZE + 8)}){
+        void* block = MatrixAllocator::allocateBytes(bytes);
+        check_allocator((std::uintptr_t)block % MATRIX_ALIGNMENT == 0,
+                "the block of " + std::to_string(bytes) + " bytes is not aligned");
+        MatrixAllocator::deallocate(block);
+    }
+
+    logging::progress(1, 4, "Reuse of the released buffers");
+    auto* first = MatrixAllocator::allocate<double>(1000);
+    auto hits = statistics.poolHits;
+    auto systemAllocations = statistics.systemAllocations;
+    MatrixAllocator::deallocate(first);
+    auto* second = MatrixAllocator::allocate<double>(1000);
+    check_allocator(second == first, "the released block of the same size was not reused");
+    check_allocator(statistics.poolHits == hits + 1, "the pool hit was not counted");
+    check_allocator(statistics.systemAllocations == systemAllocations, "the system allocation was counted");
+    MatrixAllocator::deallocate(second);
+
+    logging::progress(2, 4, "Allocation statistics");
+    /* Five rounds of creation and destruction of the buffers of four different sizes */
+    const std::size_t sizes[] = {777, 12345, 54321, 1234567};
+    MatrixAllocator::Statistics before = statistics;
+    std::size_t totalBytes = 0;
+    for (int round = 0; round < 5; ++round){
+        void* blocks[4];
+        for (int k = 0; k < 4; ++k){
+            blocks[k] = MatrixAllocator::allocate<float>(sizes[k]);
+        }
+        if (round == 0){
+            totalBytes = statistics.bytesInUse - before.bytesInUse;
+            check_allocator(totalBytes >= (777 + 12345 + 54321 + 1234567) * sizeof(float),
+                    "bytes in use are less than the allocated size");
+        }
+        for (void* block: blocks){
+            MatrixAllocator::deallocate(block);
+        }
+    }
+    logging::enter();
+    logging::debug(MatrixAllocator::getStatisticsString());
+    logging::exit();
+    check_allocator(statistics.allocations - before.allocations == 20, "wrong number of allocations");
+    check_allocator(statistics.deallocations - before.deallocations == 20, "wrong number of deallocations");
+    check_allocator(statistics.systemAllocations - before.systemAllocations == 4,
+            "wrong number of system allocations");
+    check_allocator(statistics.poolHits - before.poolHits == 16, "wrong number of pool hits");
+    check_allocator(statistics.bytesInUse == before.bytesInUse, "the released bytes are still in use");
+    check_allocator(statistics.peakBytesInUse >= before.bytesInUse + totalBytes, "wrong peak memory usage");
+    check_allocator(statistics.bytesPooled >= totalBytes, "the released blocks were not pooled");
+
+    logging::progress(3, 4, "Pool limit");
+    MatrixAllocator::setPoolLimit(0);
+    check_allocator(statistics.bytesPooled == 0, "the pool was not trimmed to the new limit");
+    auto* third = MatrixAllocator::allocate<double>(1000);
+    systemAllocations = statistics.systemAllocations;
+    MatrixAllocator::deallocate(third);
+    check_allocator(statistics.bytesPooled == 0, "the block exceeding the pool limit was pooled");
+    MatrixAllocator::deallocate(MatrixAllocator::allocate<double>(1000));
+    check_allocator(statistics.systemAllocations == systemAllocations + 1,
+            "the block exceeding the pool limit was reused");
+    MatrixAllocator::setPoolLimit(oldLimit);
+    logging::progress(4, 4);
+}
@@ -0,0 +1,52 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int rows = 130, depth = 300, columns = 133;
+    data::ContiguousMatrix A(comm, depth, rows, depth, rows);
+    data::ContiguousMatrix B(comm, columns, depth, columns, depth);
+    data::LocalMatrix localA(comm, depth, rows, depth, rows);
+    data::LocalMatrix localB(comm, columns, depth, columns, depth);
+    data::ContiguousMatrix C(comm, columns, rows, columns, rows);
+    data::ContiguousMatrix D(comm, columns, rows, columns, rows);
+    auto fa = [](data::Matrix::Iterator& a){ return sin(a.getRow() * 1.3 + a.getColumn() * 0.7); };
+    auto fb = [](data::Matrix::Iterator& b){ return cos(b.getRow() * 0.9 - b.getColumn() * 0.4); };
+    A.fill(fa);
+    localA.fill(fa);
+    B.fill(fb);
+    localB.fill(fb);
+
+    logging::progress(0, 3, "Product of the synchronized matrices");
+    A.synchronize();
+    B.synchronize();
+    C.dot(A, B);
+
+    logging::progress(1, 3, "Distributed product of the local matrices");
+    D.distributedDot(localA, localB);
+
+    logging::progress(2, 3, "Comparison with the direct summation");
+    double error = 0.0, distributedError = 0.0;
+    for (auto c = C.begin(); c != C.end(); ++c){
+        int i = c.getRow(), j = c.getColumn();
+        double value = 0.0;
+        for (int k = 0; k < depth; ++k){
+            value += A.getValue(i, k) * B.getValue(k, j);
+        }
+        error = max(error, fabs(*c - value));
+        distributedError = max(distributedError, fabs(D.getValue(i, j) - value));
+    }
+    logging::enter();
+    logging::debug("Maximum error of dot(): " + std::to_string(error));
+    logging::debug("Maximum error of distributedDot(): " + std::to_string(distributedError));
+    logging::exit();
+    logging::progress(3, 3);
+}
@@ -0,0 +1,51 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    logging::progress(0, 1, "Matrix initialization");
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 37, height = 23;
+    data::LocalMatrix A(comm, width, height, width, height);
+    data::LocalMatrix B(comm, width, height, width, height);
+    data::ContiguousMatrix C(comm, width, height, width, height);
+    data::LocalMatrix D(comm, width, height, width, height);
+    B.fill([](data::Matrix::Iterator& b){ return sin(b.getRow() + b.getColumn()); });
+    C.fill([](data::Matrix::Iterator& c){ return cos(c.getRow() - c.getColumn()) + 2.0; });
+    D.fill([](data::Matrix::Iterator& d){ return 0.01 * d.getRow() * d.getColumn(); });
+
+    logging::progress(0, 1, "Evaluation of the fused expressions");
+    double error = 0.0;
+    A = 2.0 * B + 3.0 * C - D;
+    for (auto a = A.cbegin(), b = B.cbegin(), c = C.cbegin(), d = D.cbegin(); a != A.cend(); ++a, ++b, ++c, ++d){
+        error = std::max(error, fabs(*a - (2.0 * *b + 3.0 * *c - *d)));
+    }
+    A += 0.5 * (B - C) / C;
+    A = data::apply(B + C, [](double x) { return x > 2.0 ? x : 0.0; });
+    for (auto a = A.cbegin(), b = B.cbegin(), c = C.cbegin(); a != A.cend(); ++a, ++b, ++c){
+        error = std::max(error, fabs(*a - (*b + *c > 2.0 ? *b + *c : 0.0)));
+    }
+    double totalError;
+    comm.allReduce(&error, &totalError, 1, MPI_DOUBLE, MPI_MAX);
+
+    logging::enter();
+    logging::debug("Maximum difference from the element-by-element calculations: " + std::to_string(totalError));
+    logging::exit();
+
+    data::LocalMatrix E(comm, 5, 5, 5, 5);
+    try{
+        E = B + C;
+    } catch (simulation_exception& e){
+        logging::enter();
+        logging::debug("Expected exception: " + std::string(e.what()));
+        logging::exit();
+    }
+}
@@ -0,0 +1,49 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/MatrixStats.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 37, height = 23;
+    data::LocalMatrix A(comm, width, height, width, height);
+    data::ContiguousMatrix B(comm, width, height, width, height);
+    A.fill([](data::Matrix::Iterator& a){ return sin(a.getRow() * width + a.getColumn()); });
+    B.fill([](data::Matrix::Iterator& b){ return cos(b.getRow() - b.getColumn()) + 2.0; });
+
+    logging::progress(0, 2, "Batch computation of the statistics");
+    data::MatrixStats stats(comm);
+    int sumA = stats.addSum(A);
+    int meanB = stats.addMean(B);
+    int stdA = stats.addStd(A);
+    int errorAB = stats.addErrorfunc(A, B);
+    int covAB = stats.addCov(A, B);
+    int corrAB = stats.addCorr(A, B);
+    int maxA = stats.addMax(A);
+    int minB = stats.addMin(B);
+    stats.startCompute();
+    stats.waitCompute();
+
+    logging::progress(1, 2, "Comparison with the individual statistics");
+    int row, col, batchRow, batchCol;
+    double error = fabs(stats.getValue(sumA) - A.sum()) + fabs(stats.getValue(meanB) - B.sum() / (width * height)) +
+            fabs(stats.getValue(stdA) - A.std()) + fabs(stats.getValue(errorAB) - A.errorfunc(B)) +
+            fabs(stats.getValue(covAB) - A.cov(B)) + fabs(stats.getValue(corrAB) - A.corr(B)) +
+            fabs(stats.getValue(maxA) - A.max()) + fabs(stats.getValue(minB) - B.min());
+    int index = A.argmax(row, col);
+    int batchIndex = stats.getLocation(maxA, batchRow, batchCol);
+    logging::enter();
+    logging::debug("Total difference from the individual statistics: " + std::to_string(error));
+    logging::debug("argmax: " + std::to_string(index) + " (" + std::to_string(row) + ", " + std::to_string(col) +
+        "), batch: " + std::to_string(batchIndex) + " (" + std::to_string(batchRow) + ", " +
+        std::to_string(batchCol) + ")");
+    logging::exit();
+    logging::progress(2, 2);
+}
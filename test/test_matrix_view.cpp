@@ -0,0 +1,63 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/MatrixView.h"
+#include "../data/MatrixStats.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 37, height = 23;
+    data::LocalMatrix A(comm, width, height, width, height);
+    A.fill([](data::Matrix::Iterator& a){ return 1000.0 * a.getRow() + a.getColumn(); });
+
+    logging::progress(0, 3, "Iteration through the view");
+    data::MatrixView roi(A, 1, 2, 7, 6, 3, 5);
+    int localElements = 0;
+    double error = 0.0;
+    for (auto it = roi.begin(); it != roi.end(); ++it){
+        ++localElements;
+        error = max(error, fabs(*it - 1000.0 * (1 + 3 * it.getRow()) - (2 + 5 * it.getColumn())));
+    }
+
+    logging::progress(1, 3, "Copying the view to another matrix");
+    data::LocalMatrix B(comm, roi.getWidth(), roi.getHeight(), roi.getWidth(), roi.getHeight());
+    roi.copyTo(B);
+    for (auto b = B.begin(); b != B.end(); ++b){
+        error = max(error, fabs(*b - 1000.0 * (1 + 3 * b.getRow()) - (2 + 5 * b.getColumn())));
+    }
+
+    logging::progress(2, 3, "Reductions over the view");
+    /* B contains the same elements as the view, so its statistics are the reference */
+    int viewRow, viewCol, matrixRow, matrixCol;
+    double viewMax, matrixMax, matrixMin;
+    int viewIndex = roi.argmax(viewRow, viewCol, &viewMax);
+    int matrixIndex = B.argmax(matrixRow, matrixCol, &matrixMax);
+    int minRow, minCol;
+    B.argmin(minRow, minCol, &matrixMin);
+    double reductionError = fabs(roi.sum() - B.sum()) + fabs(roi.mean() - B.mean()) + fabs(roi.std() - B.std()) +
+            fabs(viewMax - matrixMax) + fabs(roi.min() - matrixMin);
+    data::MatrixStats stats(comm);
+    int viewSum = stats.addSum(roi);
+    int viewMin = stats.addMin(roi);
+    stats.compute();
+    reductionError += fabs(stats.getValue(viewSum) - B.sum());
+    stats.getLocation(viewMin, minRow, minCol);
+    if (viewIndex != matrixIndex || viewRow != matrixRow || viewCol != matrixCol || minRow != 0 || minCol != 0 ||
+            reductionError > 1e-6){
+        throw std::runtime_error("Matrix view reduction test failed");
+    }
+
+    logging::enter();
+    logging::debug("Difference between the view and the matrix statistics: " + std::to_string(reductionError));
+    logging::debug("Local elements of the view: " + std::to_string(localElements) + " of " +
+        std::to_string(roi.getSize()));
+    logging::debug("Maximum error: " + std::to_string(error));
+    logging::exit();
+    logging::progress(3, 3);
+}
@@ -0,0 +1,92 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/LuDecomposer.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int n = 203, m = 3;
+    data::ContiguousMatrix A(comm, n, n, 1.0, 1.0);
+    data::ContiguousMatrix B(comm, m, n, 1.0, 1.0);
+    data::ContiguousMatrix X(comm, m, n, 1.0, 1.0);
+
+    logging::progress(0, 4, "Mixed precision LU decomposition");
+    for (int i = 0; i < n * n; ++i){
+        A[i] = sin(1.3 * i * (i % 11 + 1)) + (i / n == i % n ? 3.0 : 0.0);
+    }
+    for (int i = 0; i < n * m; ++i){
+        B[i] = cos(0.7 * i);
+    }
+    data::LuDecomposer decomposer(A, "", 10, data::LuDecomposer::MixedPrecision);
+
+    logging::progress(1, 4, "Matrix division with iterative refinement");
+    decomposer.divide(X, B);
+
+    logging::progress(2, 4, "Solution check");
+    double error = 0.0;
+    for (int i = 0; i < n; ++i){
+        for (int c = 0; c < m; ++c){
+            double control = -B.getValue(i, c);
+            for (int k = 0; k < n; ++k){
+                control += A.getValue(i, k) * X.getValue(k, c);
+            }
+            error = max(error, abs(control));
+        }
+    }
+
+    logging::enter();
+    logging::debug("Precision: " + std::string(decomposer.getPrecision() == data::LuDecomposer::MixedPrecision ?
+        "mixed" : "double"));
+    logging::debug("Refinement iterations: " + std::to_string(decomposer.getRefinementIterations()));
+    logging::debug("Refinement residual: " + std::to_string(decomposer.getRefinementResidual()));
+    logging::debug("Maximum error: " + std::to_string(error));
+    logging::exit();
+    if (error > 1e-10){
+        throw std::runtime_error("Mixed precision solution check failed");
+    }
+    if (decomposer.getPrecision() != data::LuDecomposer::MixedPrecision ||
+            decomposer.getRefinementIterations() <= 0){
+        throw std::runtime_error("Mixed precision solution was not found by the iterative refinement");
+    }
+
+    logging::progress(3, 4, "Fallback to the double precision for the ill-conditioned matrix");
+    /* The condition number of the Hilbert matrix of order 10 is about 1e13, the float factors are useless */
+    const int h = 10;
+    data::ContiguousMatrix H(comm, h, h, 1.0, 1.0);
+    data::ContiguousMatrix C(comm, 1, h, 1.0, 1.0);
+    data::ContiguousMatrix Y(comm, 1, h, 1.0, 1.0);
+    for (int i = 0; i < h * h; ++i){
+        H[i] = 1.0 / (i / h + i % h + 1);
+    }
+    for (int i = 0; i < h; ++i){
+        C[i] = 1.0;
+    }
+    data::LuDecomposer hilbert(H, "", 10, data::LuDecomposer::MixedPrecision);
+    hilbert.divide(Y, C);
+    double hilbertError = 0.0;
+    for (int i = 0; i < h; ++i){
+        double control = -C[i];
+        for (int k = 0; k < h; ++k){
+            control += H.getValue(i, k) * Y[k];
+        }
+        hilbertError = max(hilbertError, abs(control));
+    }
+    logging::enter();
+    logging::debug("Hilbert matrix precision: " + std::string(hilbert.getPrecision() ==
+        data::LuDecomposer::MixedPrecision ? "mixed" : "double"));
+    logging::debug("Hilbert matrix maximum error: " + std::to_string(hilbertError));
+    logging::exit();
+    if (hilbert.getPrecision() != data::LuDecomposer::DoublePrecision){
+        throw std::runtime_error("The ill-conditioned matrix was not decomposed in double precision");
+    }
+    if (hilbertError > 1e-8){
+        throw std::runtime_error("Double precision fallback solution check failed");
+    }
+    logging::progress(4, 4);
+}
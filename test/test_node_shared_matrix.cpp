@@ -0,0 +1,43 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/NodeSharedMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    logging::progress(0, 1, "Matrix initialization");
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 53, height = 47;
+    data::NodeSharedMatrix A(comm, width, height, width, height);
+    data::ContiguousMatrix B(comm, width, height, width, height);
+
+    logging::enter();
+    logging::debug("Number of nodes: " + std::to_string(A.getNodeNumber()));
+    logging::debug("Node leader: " + std::to_string(A.isNodeLeader()));
+    logging::exit();
+
+    for (auto a = A.begin(), b = B.begin(); a != A.end(); ++a, ++b){
+        *a = *b = sin(0.3 * a.getColumn() + 0.7 * a.getRow());
+    }
+
+    logging::progress(0, 1, "Synchronization");
+    A.synchronize();
+    B.synchronize();
+
+    double error = 0.0;
+    for (int i = 0; i < width * height; ++i){
+        error = std::max(error, fabs(A[i] - B[i]));
+    }
+    double totalError;
+    comm.allReduce(&error, &totalError, 1, MPI_DOUBLE, MPI_MAX);
+
+    logging::enter();
+    logging::debug("Maximum difference from the contiguous matrix: " + std::to_string(totalError));
+    logging::exit();
+}
@@ -0,0 +1,52 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <algorithm>
+#include "../Application.h"
+#include "../data/ContiguousMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 37, height = 23;
+    data::ContiguousMatrix A(comm, width, height, 100.0, 80.0);
+
+    logging::progress(0, 3, "Filling the matrix");
+    A.fill([](data::Matrix::Iterator& a){
+        return a.getIndex() % 7 == 0 ? 3.0 : 100.0 * sin(1.7 * a.getIndex());
+    });
+    auto hist = A.histogram(10);
+    double p90 = A.percentile(90.0);
+    double median = A.median();
+    auto top = A.topK(5);
+
+    logging::progress(1, 3, "Sorting the synchronized matrix");
+    A.synchronize();
+    vector<double> sorted(width * height);
+    for (int i = 0; i < width * height; ++i){
+        sorted[i] = A[i];
+    }
+    sort(sorted.begin(), sorted.end());
+    double position = 0.9 * (width * height - 1);
+    int lower = (int)position;
+    double p90Expected = sorted[lower] + (position - lower) * (sorted[lower + 1] - sorted[lower]);
+
+    logging::progress(2, 3, "Comparison");
+    logging::enter();
+    logging::debug("Histogram: ");
+    for (int count: hist){
+        logging::debug(std::to_string(count));
+    }
+    logging::debug("90th percentile: " + std::to_string(p90) + " expected: " + std::to_string(p90Expected));
+    logging::debug("Median: " + std::to_string(median) + " expected: " +
+        std::to_string(sorted[width * height / 2]));
+    for (auto& item: top){
+        logging::debug("Top element: " + std::to_string(item.value) + " at " + std::to_string(item.index) +
+            " expected: " + std::to_string(A[item.index]));
+    }
+    logging::exit();
+    logging::progress(3, 3);
+}
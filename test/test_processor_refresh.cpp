@@ -0,0 +1,132 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../processors/Processor.h"
+#include "../stimuli/StationaryStimulus.h"
+#include "../models/abstract/glm/StimulusSaturation.h"
+
+/**
+ * The simplest processor that counts calls of its update()
+ */
+class CountingProcessor: public equ::Processor {
+private:
+    bool inputDriven;
+
+protected:
+    bool isOutputContiguous() override { return false; }
+    bool isInputDriven() override { return inputDriven; }
+    void finalizeProcessor(bool destruct = false) noexcept override {}
+    std::string getProcessorName() override { return "test:counting_processor"; }
+    void loadParameterList(const param::Object& source) override {}
+    void broadcastParameterList() override {}
+    void setParameter(const std::string& name, const void* pvalue) override {}
+
+public:
+    int updates = 0;
+
+    CountingProcessor(mpi::Communicator& comm, bool driven): Processor(comm), inputDriven(driven) {};
+
+    ~CountingProcessor() override {
+        finalizeProcessor(true);
+    }
+
+    void initialize() override {
+        output = new data::LocalMatrix(getCommunicator(), 8, 8, 1.0, 1.0);
+    }
+
+    void update(double time) override { ++updates; }
+};
+
+void check_updates(const std::string& stage, const CountingProcessor& processor, int expected){
+    logging::enter();
+    logging::debug(stage + ": " + std::to_string(processor.updates) + " updates");
+    logging::exit();
+    if (processor.updates != expected){
+        throw std::runtime_error("Processor refresh test failed: " + stage);
+    }
+}
+
+void test_main(){
+    using namespace std;
+
+    Application& app = Application::getInstance();
+    mpi::Communicator& comm = app.getAppCommunicator();
+
+    logging::progress(0, 3, "Refreshing the chain of the counting processors");
+    CountingProcessor source(comm, false), first(comm, true), second(comm, true);
+    first.addInputProcessor(&source);
+    second.addInputProcessor(&first);
+    source.initialize();
+    first.initialize();
+    second.initialize();
+
+    /* The first refresh always updates the processors because their inputs have not been seen yet */
+    for (auto* processor: {&source, &first, &second}){
+        processor->refresh(0.0);
+    }
+    check_updates("input-driven processor, the first refresh", first, 1);
+    check_updates("the next processor in the chain, the first refresh", second, 1);
+
+    /* The source always updates but its output is touched, so the chain shall be updated as well */
+    for (auto* processor: {&source, &first, &second}){
+        processor->refresh(1.0);
+    }
+    check_updates("input-driven processor after the input update", first, 2);
+    check_updates("the next processor after the input update", second, 2);
+
+    /* The source is not refreshed now, so the input versions of the chain are the same and the refresh is skipped */
+    if (first.isInputChanged() || second.isInputChanged() || second.refresh(2.0)){
+        throw std::runtime_error("Processor refresh test failed: the unchanged input was treated as changed");
+    }
+    check_updates("the skipped processor", second, 2);
+
+    logging::progress(1, 3, "Refreshing after touch()");
+    source.getOutput().touch();
+    if (!first.isInputChanged()){
+        throw std::runtime_error("Processor refresh test failed: touch() didn't change the input version");
+    }
+    first.refresh(3.0);
+    second.refresh(3.0);
+    check_updates("input-driven processor after touch()", first, 3);
+    check_updates("the next processor after touch()", second, 3);
+    first.refresh(4.0);
+    second.refresh(4.0);
+    check_updates("input-driven processor, the second refresh after touch()", first, 3);
+    check_updates("the next processor, the second refresh after touch()", second, 3);
+
+    logging::progress(2, 3, "Refreshing the stationary stimulus and the stimulus saturation");
+    app.createStimulus(comm);
+    auto* stimulus = dynamic_cast<stim::StationaryStimulus*>(&app.getStimulus());
+    if (stimulus != nullptr){
+        equ::StimulusSaturation* saturation = equ::StimulusSaturation::createStimulusSaturation(comm, "no");
+        saturation->setDarkCurrent(0.0);
+        saturation->setStimulusAmplification(1.0);
+        stimulus->initialize();
+        saturation->initialize();
+        int updates = 0;
+        double time = 0.0;
+        for (int i = 0; time < stimulus->getRecordLength(); ++i){
+            stimulus->refresh(time);
+            updates += saturation->refresh(time) ? 1 : 0;
+            time = 10.0 * i;
+        }
+        logging::enter();
+        logging::debug("Stimulus saturation updates: " + std::to_string(updates));
+        logging::exit();
+        /* The saturation shall be updated when the stimulus is switched on and off only */
+        if (updates > 3){
+            throw std::runtime_error("Processor refresh test failed: the stimulus saturation was not skipped");
+        }
+        delete saturation;
+        stimulus->finalize();
+    } else {
+        logging::enter();
+        logging::debug("The stimulus is not stationary, the stimulus saturation test is omitted");
+        logging::exit();
+    }
+    logging::progress(3, 3);
+}
@@ -0,0 +1,58 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/Convolver.h"
+#include "../data/RecursiveGaussianFilter.h"
+
+void test_main(){
+    using namespace std;
+
+    logging::progress(0, 1, "Matrix initialization");
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 120, height = 90;
+    data::ContiguousMatrix A(comm, width, height, width - 1, height - 1);
+    for (auto a = A.begin(); a != A.end(); ++a){
+        *a = sin(0.2 * a.getColumn()) + (a.getRow() > height/2 ? 1.0 : 0.0);
+    }
+    A.synchronize();
+
+    for (double radius: {1.5, 3.0, 8.0}){
+        logging::progress(0, 1, "Kernel radius: " + std::to_string(radius));
+
+        /* The direct kernel is twice as large as in GaussianSpatialKernel to make its truncation negligible */
+        int kernelSize = 2 * (int)round(4 * radius) + 1;
+        data::ContiguousMatrix K(comm, kernelSize, kernelSize, kernelSize - 1, kernelSize - 1);
+        for (auto k = K.begin(); k != K.end(); ++k){
+            double x = k.getColumnUm();
+            double y = k.getRowUm();
+            *k = exp(-(x*x + y*y)/(radius * radius));
+        }
+        K.synchronize();
+
+        data::LocalMatrix direct(comm, width, height, width - 1, height - 1);
+        data::LocalMatrix recursive(comm, width, height, width - 1, height - 1);
+        data::Convolver convolver(K, direct, true, data::Convolver::DirectMethod);
+        data::RecursiveGaussianFilter filter(radius / sqrt(2.0), radius / sqrt(2.0), recursive);
+        convolver.convolve(direct, A);
+        filter.filter(recursive, A);
+
+        double error = 0.0;
+        auto r = recursive.cbegin();
+        for (auto d = direct.cbegin(); d != direct.cend(); ++d, ++r){
+            error = std::max(error, fabs(*d - *r));
+        }
+        double totalError;
+        comm.allReduce(&error, &totalError, 1, MPI_DOUBLE, MPI_MAX);
+
+        logging::enter();
+        logging::debug("Maximum difference between direct and recursive filtering: " + std::to_string(totalError));
+        logging::debug(totalError < 1e-3 ? "Accuracy test passed" : "ACCURACY TEST FAILED");
+        logging::exit();
+    }
+}
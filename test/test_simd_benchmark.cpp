@@ -0,0 +1,63 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include <chrono>
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/simd/Kernels.h"
+
+template<typename F> double measure_time(mpi::Communicator& comm, int repeats, F f){
+    comm.barrier();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i){
+        f();
+    }
+    comm.barrier();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(finish - start).count() / repeats;
+}
+
+void print_result(const std::string& name, double seconds, int bytes){
+    logging::debug(name + ": " + std::to_string(seconds * 1e6) + " us/call, " +
+        std::to_string(bytes / seconds * 1e-9) + " GB/s per process");
+}
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 1024, height = 1024, repeats = 100;
+    data::LocalMatrix A(comm, width, height, width, height);
+    data::LocalMatrix B(comm, width, height, width, height);
+    data::LocalMatrix C(comm, width, height, width, height);
+    B.fill([](data::Matrix::Iterator& b){ return sin(b.getRow() + b.getColumn()); });
+    C.fill([](data::Matrix::Iterator& c){ return cos(c.getRow() - c.getColumn()) + 2.0; });
+    int bytes = A.getIfinish() - A.getIstart();
+    bytes *= sizeof(double);
+
+    for (int isa = data::simd::ScalarIsa; isa <= data::simd::Avx512Isa; ++isa){
+        logging::progress(isa, data::simd::Avx512Isa + 1, data::simd::getIsaName((data::simd::Isa)isa));
+        if (!data::simd::setIsa((data::simd::Isa)isa)){
+            logging::enter();
+            logging::debug("The instruction set is not supported");
+            logging::exit();
+            continue;
+        }
+        double result = 0.0;
+        logging::enter();
+        print_result("A = B + C", measure_time(comm, repeats, [&](){ A.add(B, C); }), 3 * bytes);
+        print_result("A = B + 0.5 * C", measure_time(comm, repeats, [&](){ A.add(B, 0.5, C); }), 3 * bytes);
+        print_result("A *= B", measure_time(comm, repeats, [&](){ A *= B; }), 3 * bytes);
+        print_result("A = 1 / C", measure_time(comm, repeats, [&](){ A.div(1.0, C); }), 2 * bytes);
+        print_result("A.fill(1.0)", measure_time(comm, repeats, [&](){ A.fill(1.0); }), bytes);
+        print_result("B.sum()", measure_time(comm, repeats, [&](){ result += B.sum(); }), bytes);
+        print_result("B.std()", measure_time(comm, repeats, [&](){ result += B.std(); }), bytes);
+        print_result("B.errorfunc(C)", measure_time(comm, repeats, [&](){ result += B.errorfunc(C); }), 2 * bytes);
+        print_result("B.corr(C)", measure_time(comm, repeats, [&](){ result += B.corr(C); }), 2 * bytes);
+        logging::debug("Control sum: " + std::to_string(result));
+        logging::exit();
+    }
+    logging::progress(data::simd::Avx512Isa + 1, data::simd::Avx512Isa + 1);
+}
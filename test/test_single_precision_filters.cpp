@@ -0,0 +1,89 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/LocalMatrix.h"
+#include "../data/ContiguousMatrix.h"
+#include "../data/Convolver.h"
+#include "../data/RecursiveGaussianFilter.h"
+
+/**
+ * Returns the maximum difference between the double and the single precision results over all processes
+ */
+double precision_difference(mpi::Communicator& comm, const data::LocalMatrix& A, const data::LocalMatrixF& Af){
+    double error = 0.0;
+    auto af = Af.cbegin();
+    for (auto a = A.cbegin(); a != A.cend(); ++a, ++af){
+        error = std::max(error, fabs(*a - *af));
+    }
+    double totalError;
+    comm.allReduce(&error, &totalError, 1, MPI_DOUBLE, MPI_MAX);
+    return totalError;
+}
+
+void check_precision(const std::string& name, double error){
+    logging::enter();
+    logging::debug(name + ": maximum difference from the double precision " + std::to_string(error));
+    logging::exit();
+    if (error > 1e-5){
+        throw std::runtime_error(name + " single precision check failed");
+    }
+}
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int width = 120, height = 90;
+    const double radius = 3.0;
+    data::ContiguousMatrix A(comm, width, height, width - 1, height - 1);
+    data::ContiguousMatrixF Af(comm, width, height, width - 1, height - 1);
+    auto source = [](auto& a){ return 0.5 + 0.4 * sin(0.2 * a.getColumn()) + (a.getRow() > height/2 ? 0.1 : 0.0); };
+    A.fill(source);
+    Af.fill(source);
+    A.synchronize();
+    Af.synchronize();
+
+    int kernelSize = 2 * (int)round(2 * radius) + 1;
+    data::ContiguousMatrix K(comm, kernelSize, kernelSize, kernelSize - 1, kernelSize - 1);
+    for (auto k = K.begin(); k != K.end(); ++k){
+        double x = k.getColumnUm();
+        double y = k.getRowUm();
+        *k = exp(-(x*x + y*y)/(radius * radius));
+    }
+    K.synchronize();
+
+    data::LocalMatrix output(comm, width, height, width - 1, height - 1);
+    data::LocalMatrixF outputF(comm, width, height, width - 1, height - 1);
+
+    logging::progress(0, 4, "Direct convolution");
+    data::Convolver direct(K, output, true, data::Convolver::DirectMethod);
+    data::Convolver directF(K, outputF, true, data::Convolver::DirectMethod);
+    direct.convolve(output, A);
+    directF.convolve(outputF, Af);
+    check_precision("Direct convolution", precision_difference(comm, output, outputF));
+
+    logging::progress(1, 4, "Separable convolution");
+    data::Convolver separable(K, output, true, data::Convolver::SeparableMethod);
+    data::Convolver separableF(K, outputF, true, data::Convolver::SeparableMethod);
+    separable.convolve(output, A);
+    separableF.convolve(outputF, Af);
+    check_precision("Separable convolution", precision_difference(comm, output, outputF));
+
+    logging::progress(2, 4, "Convolution overlapped with the halo exchange");
+    direct.convolveInterior(output, A);
+    direct.convolveBoundary(output, A);
+    directF.convolveInterior(outputF, Af);
+    directF.convolveBoundary(outputF, Af);
+    check_precision("Split convolution", precision_difference(comm, output, outputF));
+
+    logging::progress(3, 4, "Recursive gaussian filter");
+    data::RecursiveGaussianFilter filter(radius / sqrt(2.0), radius / sqrt(2.0), output);
+    data::RecursiveGaussianFilter filterF(radius / sqrt(2.0), radius / sqrt(2.0), outputF);
+    filter.filter(output, A);
+    filterF.filter(outputF, Af);
+    check_precision("Recursive gaussian filter", precision_difference(comm, output, outputF));
+    logging::progress(4, 4);
+}
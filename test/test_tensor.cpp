@@ -0,0 +1,46 @@
+//
+// (C) Sergei Kozhukhov, 2019
+// (C) the Institute of Higher Nervous Activity and Neurophysiology, Russian Academy of Sciences, 2019
+//
+
+#include "../Application.h"
+#include "../data/Tensor.h"
+#include "../data/LocalMatrix.h"
+
+void test_main(){
+    using namespace std;
+
+    mpi::Communicator& comm = Application::getInstance().getAppCommunicator();
+    const int channels = 4, width = 41, height = 29;
+    data::Tensor A(comm, channels, width, height, 100.0, 80.0);
+    data::Tensor B(comm, channels, width, height, 100.0, 80.0);
+    data::ContiguousMatrix K(comm, 7, 7, 17.0, 17.0, 1.0);
+
+    logging::progress(0, 3, "Filling the channels");
+    for (int c = 0; c < channels; ++c){
+        A[c].fill([c](data::Matrix::Iterator& a){ return sin(0.3 * a.getColumn() + 0.7 * a.getRow() + c); });
+    }
+    A.apply([](double x) { return x * x; });
+    A += 1.0;
+
+    logging::progress(1, 3, "Batched convolution");
+    data::Convolver convolver(K, B[0]);
+    A.convolve(convolver, B);
+    B.synchronize();
+
+    logging::progress(2, 3, "Comparison with the channel-by-channel convolution");
+    double error = 0.0;
+    for (int c = 0; c < channels; ++c){
+        A[c].synchronize();
+        data::LocalMatrix C(comm, width, height, 100.0, 80.0);
+        convolver.convolve(C, A[c]);
+        for (auto b = B[c].cbegin(), x = C.cbegin(); x != C.cend(); ++b, ++x){
+            error = max(error, fabs(*b - *x));
+        }
+    }
+
+    logging::enter();
+    logging::debug("Maximum error: " + std::to_string(error));
+    logging::exit();
+    logging::progress(3, 3);
+}
@@ -96,7 +96,14 @@ void test_main(){
     logging::debug("");
     logging::exit();
 
-
+    logging::enter();
+    logging::debug("Distributed transpose of the local matrix");
+    C.fill([](data::Matrix::Iterator& c){ return 10 * c.getRow() + c.getColumn(); });
+    B.distributedTranspose(C);
+    B.synchronize();
+    B.printLocal();
+    logging::debug("");
+    logging::exit();
 
     logging::progress(1, 1);
 }
\ No newline at end of file